@@ -1,5 +1,6 @@
 #include "AnimationPlayer.h"
 #include "FAT32.h"
+#include "GzipReader.h"
 #include <cstdio>
 #include <cstring>
 #include <algorithm>
@@ -14,7 +15,8 @@
 
 AnimationPlayer::AnimationPlayer(StorageManager* storage, TFT* tft) 
         : storage_manager(storage), tft_display(tft), current_animation_index(-1), 
-            current_frame_index(0), last_frame_time(0), performance_mode(2) {
+            current_frame_index(0), last_frame_time(0), performance_mode(2), detected_extension(".RAW"),
+            interlaced(false), next_field(0), presented_field(-1), frame_x(0), frame_y(0), frame_w(0), frame_h(0) {
 }
 
 AnimationPlayer::~AnimationPlayer() {
@@ -82,7 +84,7 @@ void AnimationPlayer::update() {
                     const char* path = anim->frame_paths[current_frame_index].c_str();
                     if (read_frame_from_file(path, anim->frame_size_bytes)) {
                         // Données déjà copiées dans le framebuffer
-                        tft_display->sendFrame();
+                        present_frame();
                         shown = true;
                     }
                 }
@@ -90,11 +92,11 @@ void AnimationPlayer::update() {
                 // Mode ultra-économe : générer le nom à la volée (optimisé)
                 if (current_frame_index >= 0 && current_frame_index < static_cast<int>(anim->num_frames_stream)) {
                         char filename[32];
-                        snprintf(filename, sizeof(filename), "FR_%03d.RAW", current_frame_index);
+                        snprintf(filename, sizeof(filename), "FR_%03d%s", current_frame_index, anim->frame_extension.c_str());
                         std::string full_path = anim->base_directory + "/" + filename;
 
                         if (read_frame_from_file(full_path.c_str(), anim->frame_size_bytes)) {
-                        tft_display->sendFrame();
+                        present_frame();
                         shown = true;
                     }
                 }
@@ -122,12 +124,24 @@ void AnimationPlayer::update() {
     }
 }
 
+void AnimationPlayer::present_frame() {
+    if (presented_field < 0) {
+        tft_display->sendFrame();
+        return;
+    }
+    // Parité des lignes à l'écran = parité dans l'image décalée de frame_y
+    const bool odd = ((frame_y + presented_field) & 1) != 0;
+    tft_display->sendRegion(frame_x, frame_y, frame_w, frame_h, odd ? Field::ODD : Field::EVEN);
+    next_field ^= 1;
+}
+
 void AnimationPlayer::stop() {
     current_animation_index = -1;
     current_frame_index = 0;
 }
 
-bool AnimationPlayer::load_animation_generated(const char* directory_path, const char* name, size_t frame_count) {
+bool AnimationPlayer::load_animation_generated(const char* directory_path, const char* name, size_t frame_count,
+                                               const char* extension) {
     if (!directory_path || frame_count == 0) {
         return false;
     }
@@ -141,6 +155,7 @@ bool AnimationPlayer::load_animation_generated(const char* directory_path, const
     anim->stream_from_dir_files = false;  // Pas de liste de chemins
     anim->stream_generated_names = true;   // Génération à la volée
     anim->base_directory = directory_path;
+    anim->frame_extension = extension ? extension : ".RAW";
     anim->num_frames_stream = frame_count;
     anim->frame_size_bytes = TFTConfig::WIDTH * TFTConfig::HEIGHT * TFTConfig::BYTES_PER_PIXEL;
     
@@ -151,7 +166,8 @@ bool AnimationPlayer::load_animation_generated(const char* directory_path, const
     return true;
 }
 
-bool AnimationPlayer::load_animation_by_blocks(const char* directory_path, const char* name, size_t total_files, size_t block_size) {
+bool AnimationPlayer::load_animation_by_blocks(const char* directory_path, const char* name, size_t total_files, size_t block_size,
+                                               const char* extension) {
     if (!directory_path || total_files == 0 || block_size == 0) {
         return false;
     }
@@ -164,6 +180,7 @@ bool AnimationPlayer::load_animation_by_blocks(const char* directory_path, const
     anim->name = name ? name : directory_path;
     anim->stream_by_blocks = true;
     anim->base_directory = directory_path;
+    anim->frame_extension = extension ? extension : ".RAW";
     anim->total_files_available = total_files;
     anim->block_size = block_size;
     anim->current_block_start = 0;
@@ -201,13 +218,22 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         dir = path.substr(0, slash); if (dir.empty()) dir = "/";
         base = path.substr(slash + 1);
     }
-    if (!fs->change_directory(dir.c_str())) {
+    if (!fs->push_directory(dir.c_str())) {
         return false;
     }
     
     FAT_ErrorCode r = fs->file_open(base.c_str(), READ);
     if (r != FILE_FOUND) {
-        fs->change_directory("/");
+        fs->pop_directory();
+        return false;
+    }
+
+    // Trame compressée (FR_XXX.RAW.GZ): décompressée au fil de la lecture
+    GzipReader gzip(fs);
+    const bool compressed = GzipReader::is_gz_name(base.c_str());
+    if (compressed && gzip.begin() != GZ_OK) {
+        fs->file_close();
+        fs->pop_directory();
         return false;
     }
 
@@ -217,13 +243,16 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
     ReadHandler h{};
     uint32_t chunk_size = 0;
     uint8_t tmp[512];
+    auto next_chunk = [&]() -> uint32_t {
+        return compressed ? gzip.read(tmp, sizeof(tmp)) : fs->file_read(tmp, &h);
+    };
     
     // Lire l'entête d'abord
     while (header_read < 4) {
-        chunk_size = fs->file_read(tmp, &h);
+        chunk_size = next_chunk();
         if (chunk_size == 0) {
             fs->file_close();
-            fs->change_directory("/");
+            fs->pop_directory();
             return false; // Impossible de lire l'entête
         }
         
@@ -244,12 +273,15 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
     // Extraire largeur et hauteur (little-endian)
     uint16_t width = header[0] | (header[1] << 8);
     uint16_t height = header[2] | (header[3] << 8);
+    const bool field_major = (height & Anim_Config::RAW_FIELD_MAJOR) != 0;
+    height &= (uint16_t)~Anim_Config::RAW_FIELD_MAJOR;
+    presented_field = -1;
     
     // Vérifier que les dimensions sont raisonnables
     if (width == 0 || height == 0 || width > 1024 || height > 1024) {
         printf("Erreur: Dimensions invalides ou trop grandes: %dx%d\n", width, height);
         fs->file_close();
-        fs->change_directory("/");
+        fs->pop_directory();
         return false; // Dimensions invalides
     }
     
@@ -260,7 +292,7 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
     
     if (!fb || fb_size == 0) {
         fs->file_close();
-        fs->change_directory("/");
+        fs->pop_directory();
         return false;
     }
     
@@ -278,6 +310,89 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         }
     }
     
+    // Image rangée par trame: lignes paires puis impaires, chacune contiguë
+    if (field_major) {
+        if (width > fb_width || height > fb_height) {
+            printf("Erreur: image par trames %dx%d plus grande que l'écran\n", width, height);
+            fs->file_close();
+            fs->pop_directory();
+            return false;
+        }
+        const uint32_t row_bytes = (uint32_t)width * 2;
+        const uint16_t even_rows = (height + 1) / 2;
+
+        // Flux d'octets de pixels: reste du premier secteur, puis multi-blocs
+        static uint8_t field_buffer[Anim_Config::FIELD_READ_SECTORS * 512];
+        uint32_t available = chunk_size;
+        uint32_t at = 0;
+        memcpy(field_buffer, tmp, chunk_size);
+        auto refill = [&]() -> bool {
+            uint32_t n;
+            if (compressed) {
+                n = gzip.read(field_buffer, sizeof(field_buffer));
+            } else {
+                n = fs->file_read_blocks(field_buffer, Anim_Config::FIELD_READ_SECTORS, &h);
+                if (n == 0) n = fs->file_read(field_buffer, &h);
+            }
+            available = n;
+            at = 0;
+            return n > 0;
+        };
+        auto copy = [&](uint8_t* dst, uint32_t n) -> bool {
+            while (n > 0) {
+                if (available == 0 && !refill()) return false;
+                const uint32_t k = (n < available) ? n : available;
+                memcpy(dst, field_buffer + at, k);
+                dst += k; at += k; available -= k; n -= k;
+            }
+            return true;
+        };
+        auto skip = [&](uint32_t n) -> bool {
+            const uint32_t k = (n < available) ? n : available;
+            at += k; available -= k; n -= k;
+            if (n == 0) return true;
+            if (compressed) return gzip.skip(n);
+            // Secteurs entiers sautés sans lecture (le flux est aligné ici)
+            const uint32_t sectors = n / 512;
+            if (fs->file_skip_sectors(sectors, &h) != sectors) return false;
+            n -= sectors * 512;
+            if (n > 0) {
+                if (!refill() || available < n) return false;
+                at = n; available -= n;
+            }
+            return true;
+        };
+
+        // Trame seule si l'image précédente occupait la même zone (bords déjà à l'écran)
+        const bool same_area = frame_w == width && frame_h == height &&
+                               frame_x == (uint16_t)offset_x && frame_y == (uint16_t)offset_y;
+        const int field = (interlaced && same_area) ? next_field : -1;
+        if (field < 0 && (width != fb_width || height != fb_height)) memset(fb, 0, fb_size);
+
+        bool ok = true;
+        for (int f = 0; f < 2 && ok; ++f) {
+            const uint16_t rows = f ? height / 2 : even_rows;
+            if (field >= 0 && f != field) {
+                // Trame non présentée: sautée si elle précède, ignorée si elle suit
+                if (f == 0) ok = skip(rows * row_bytes);
+                continue;
+            }
+            for (uint16_t i = 0; i < rows && ok; ++i) {
+                const uint32_t y = (uint32_t)offset_y + f + 2u * i;
+                ok = copy(fb + (y * fb_width + offset_x) * 2, row_bytes);
+            }
+        }
+
+        frame_x = offset_x; frame_y = offset_y; frame_w = width; frame_h = height;
+        presented_field = (int8_t)field;
+        // gzip: CRC vérifiable seulement si tout a été décompressé
+        const bool intact = !compressed || (field == 0 ? gzip.status() == GZ_OK : gzip.finish() == GZ_END);
+        fs->file_close();
+        fs->pop_directory();
+        return ok && intact;
+    }
+    frame_w = 0;   // image entière: la prochaine image par trames repart entière
+
     // Calculer la taille des données de pixels (2 octets par pixel RGB565)
     uint32_t pixel_data_size = width * height * 2;
     
@@ -304,7 +419,21 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         
         // Continuer la lecture des données de pixels
         while (copied < max_read) {
-            chunk_size = fs->file_read(tmp, &h);
+            if (compressed) {
+                // Décompression directement dans le framebuffer
+                copied += gzip.read(fb + copied, max_read - copied);
+                break;
+            }
+            // Secteurs entiers: lecture multi-blocs directement dans le framebuffer
+            uint32_t sectors = (max_read - copied) / 512;
+            if (sectors > 0) {
+                uint32_t n = fs->file_read_blocks(fb + copied, sectors, &h);
+                if (n > 0) {
+                    copied += n;
+                    continue;
+                }
+            }
+            chunk_size = next_chunk();
             if (chunk_size == 0) {
                 break; // Fin de fichier
             }
@@ -332,7 +461,7 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
             dest_end_x <= 0 || dest_end_y <= 0) {
             // Image complètement hors écran
             fs->file_close();
-            fs->change_directory("/");
+            fs->pop_directory();
             return true; // Pas d'erreur, juste rien à afficher
         }
         
@@ -349,7 +478,7 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         
         if (copy_width <= 0 || copy_height <= 0) {
             fs->file_close();
-            fs->change_directory("/");
+            fs->pop_directory();
             return true; // Rien à copier après clipping
         }
         
@@ -359,7 +488,7 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         if (width > max_line_pixels) {
             printf("Erreur: Image trop large (%d pixels > %lu max)\n", width, max_line_pixels);
             fs->file_close();
-            fs->change_directory("/");
+            fs->pop_directory();
             return false;
         }
         
@@ -368,7 +497,7 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         if (width > (int)(sizeof(static_line_buffer) / sizeof(static_line_buffer[0]))) {
             printf("Erreur: Image trop large (%d pixels > %zu)\n", width, sizeof(static_line_buffer) / sizeof(static_line_buffer[0]));
             fs->file_close();
-            fs->change_directory("/");
+            fs->pop_directory();
             return false;
         }
         uint16_t* line_buffer = static_line_buffer;
@@ -390,7 +519,7 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
             while (line_bytes_read < line_bytes_needed) {
                 // Si plus de données dans tmp, lire le prochain chunk
                 if (remaining_in_tmp == 0) {
-                    chunk_size = fs->file_read(tmp, &h);
+                    chunk_size = next_chunk();
                     if (chunk_size == 0) break; // Fin de fichier
                     remaining_in_tmp = chunk_size;
                     tmp_offset = 0;
@@ -427,11 +556,87 @@ bool AnimationPlayer::read_frame_from_file(const char* full_path, uint32_t frame
         // Aucun delete nécessaire - buffer statique réutilisé
     }
     
+    // Trame compressée corrompue (CRC, données): ne pas l'afficher
+    const bool intact = !compressed || gzip.finish() == GZ_END;
     fs->file_close();
-    fs->change_directory("/");
+    fs->pop_directory();
     
     // Considérer comme succès si on a traité l'image
-    return true;
+    return intact;
+}
+
+size_t AnimationPlayer::convert_to_fields(const char* directory_path) {
+    if (!storage_manager || !storage_manager->is_fat32_mounted() || !tft_display || !directory_path) {
+        return 0;
+    }
+    FAT32* fs = storage_manager->get_fat32_fs();
+    if (!fs || !fs->is_initialized() || fs->is_exfat()) {
+        printf("Conversion par trames: FAT32 uniquement\n");
+        return 0;
+    }
+
+    // Le framebuffer reçoit l'image entière, les secteurs sont réécrits sur place
+    uint8_t* fb = tft_display->getFramebuffer();
+    std::vector<uint32_t> clusters;
+    uint8_t sector[512];
+    size_t converted = 0;
+    for (uint32_t index = 0; ; ++index) {
+        char path[96];
+        snprintf(path, sizeof(path), "%s/FR_%03lu.RAW", directory_path, (unsigned long)index);
+        uint32_t size = 0;
+        if (!fs->get_file_clusters(path, clusters, size)) break;
+        if (!fs->read_file_sector(clusters, 0, sector)) break;
+
+        const uint16_t width = sector[0] | (sector[1] << 8);
+        const uint16_t height = sector[2] | (sector[3] << 8);
+        if (height & Anim_Config::RAW_FIELD_MAJOR) continue;   // déjà converti
+        const uint32_t data = (uint32_t)width * height * 2;
+        if (width == 0 || height == 0 || size != 4 + data || data > TFTConfig::FB_SIZE_BYTES) {
+            printf("%s: taille inattendue, ignoré\n", path);
+            continue;
+        }
+
+        const uint32_t sectors = (size + 511) / 512;
+        uint8_t header[4] = {sector[0], sector[1], sector[2], (uint8_t)(sector[3] | (Anim_Config::RAW_FIELD_MAJOR >> 8))};
+        bool ok = true;
+        for (uint32_t s = 0; s < sectors && ok; ++s) {
+            if (s > 0) ok = fs->read_file_sector(clusters, s, sector);
+            const uint32_t first = (s == 0) ? 4 : s * 512;
+            const uint32_t last = std::min<uint32_t>((s + 1) * 512, size);
+            memcpy(fb + (first - 4), sector + (first - s * 512), last - first);
+        }
+
+        // Rangement par trame: ligne r du fichier = ligne 2r (paires) ou 2(r-n)+1
+        const uint32_t row_bytes = (uint32_t)width * 2;
+        const uint32_t even_rows = (height + 1) / 2;
+        for (uint32_t s = 0; s < sectors && ok; ++s) {
+            memset(sector, 0, sizeof(sector));
+            uint32_t i = 0;
+            while (i < 512) {
+                const uint32_t b = s * 512 + i;
+                if (b < 4) {
+                    sector[i++] = header[b];
+                    continue;
+                }
+                const uint32_t p = b - 4;
+                if (p >= data) break;
+                const uint32_t r = p / row_bytes, col = p % row_bytes;
+                const uint32_t src_row = (r < even_rows) ? 2 * r : 2 * (r - even_rows) + 1;
+                const uint32_t n = std::min<uint32_t>(std::min<uint32_t>(row_bytes - col, 512 - i), data - p);
+                memcpy(sector + i, fb + src_row * row_bytes + col, n);
+                i += n;
+            }
+            ok = fs->write_file_sector(clusters, s, sector);
+        }
+        if (!ok) {
+            printf("%s: erreur d'écriture\n", path);
+            break;
+        }
+        converted++;
+    }
+    fs->flush();
+    memset(fb, 0, TFTConfig::FB_SIZE_BYTES);
+    return converted;
 }
 
 bool AnimationPlayer::load_next_block(Animation* anim) {
@@ -469,7 +674,7 @@ bool AnimationPlayer::load_next_block(Animation* anim) {
     // Générer les chemins pour ce bloc
     for (uint32_t i = block_start; i < block_end; i++) {
         char filename[32];
-        snprintf(filename, sizeof(filename), "FR_%03u.RAW", i);
+        snprintf(filename, sizeof(filename), "FR_%03u%s", i, anim->frame_extension.c_str());
         
         std::string full_path = anim->base_directory + "/" + filename;
         anim->frame_paths.push_back(full_path);
@@ -529,9 +734,10 @@ size_t AnimationPlayer::detect_animation_files_count(const char* directory_path)
     }
     
     size_t animation_files_count = 0;
+    size_t compressed_files_count = 0;
     size_t total_files = files.size();
     
-    // Compter les fichiers qui correspondent au pattern FR_XXX.RAW
+    // Compter les fichiers qui correspondent au pattern FR_XXX.RAW (ou .RAW.GZ)
     for (const auto& file : files) {
         // Ignorer les répertoires
         if (file.is_directory) {
@@ -544,10 +750,12 @@ size_t AnimationPlayer::detect_animation_files_count(const char* directory_path)
         // Convertir en majuscules pour la comparaison
         std::transform(filename.begin(), filename.end(), filename.begin(), ::toupper);
         
-        // Vérifier le pattern: FR_ suivi de 3 chiffres puis .RAW
+        // Vérifier le pattern: FR_ suivi de 3 chiffres puis .RAW ou .RAW.GZ
+        const bool compressed = filename.length() >= 13 &&
+                                filename.substr(filename.length() - 7) == ".RAW.GZ";
         if (filename.length() >= 10 && 
             filename.substr(0, 3) == "FR_" && 
-            filename.substr(filename.length() - 4) == ".RAW") {
+            (compressed || filename.substr(filename.length() - 4) == ".RAW")) {
             
             // Vérifier que les caractères 3,4,5 sont des chiffres
             bool valid_pattern = true;
@@ -560,6 +768,7 @@ size_t AnimationPlayer::detect_animation_files_count(const char* directory_path)
             
             if (valid_pattern) {
                 animation_files_count++;
+                if (compressed) compressed_files_count++;
                 if (animation_files_count <= 20) { // Afficher les 20 premiers pour debug
                     printf("  Trouvé: %s\n", file.name);
                 }
@@ -567,9 +776,14 @@ size_t AnimationPlayer::detect_animation_files_count(const char* directory_path)
         }
     }
     
+    // Une animation est lue dans un seul format: le plus représenté
+    size_t raw_files_count = animation_files_count - compressed_files_count;
+    detected_extension = (compressed_files_count > raw_files_count) ? ".RAW.GZ" : ".RAW";
+    animation_files_count = std::max(raw_files_count, compressed_files_count);
+    
     printf("=== Détection terminée ===\n");
     printf("Fichiers totaux: %zu\n", total_files);
-    printf("Fichiers d'animation (FR_XXX.RAW): %zu\n", animation_files_count);
+    printf("Fichiers d'animation (FR_XXX%s): %zu\n", detected_extension.c_str(), animation_files_count);
     
     if (animation_files_count > 20) {
         printf("  (et %zu autres...)\n", animation_files_count - 20);
@@ -607,11 +821,12 @@ bool AnimationPlayer::load_animation_auto_detect(const char* directory_path, con
     if (detected_count <= BLOCK_MODE_THRESHOLD) {
         // Mode ultra-économe pour les animations moyennes
         printf("Mode ultra-économe sélectionné (%zu-%zu fichiers)\n", 21, BLOCK_MODE_THRESHOLD);
-        success = load_animation_generated(directory_path, name, detected_count);
+        success = load_animation_generated(directory_path, name, detected_count, detected_extension.c_str());
     } else {
         // Mode par blocs pour les très grosses animations
         printf("Mode par blocs sélectionné (>%zu fichiers)\n", BLOCK_MODE_THRESHOLD);
-        success = load_animation_by_blocks(directory_path, name, detected_count, OPTIMAL_BLOCK_SIZE);
+        success = load_animation_by_blocks(directory_path, name, detected_count, OPTIMAL_BLOCK_SIZE,
+                                           detected_extension.c_str());
     }
     
     if (success) {
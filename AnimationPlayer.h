@@ -6,6 +6,13 @@
 #include <vector>
 #include <string>
 
+namespace Anim_Config {
+    // Bit 15 de la hauteur dans l'entête RAW: lignes rangées par trame
+    // (toutes les paires puis toutes les impaires), voir convert_to_fields
+    static constexpr uint16_t RAW_FIELD_MAJOR = 0x8000;
+    static constexpr uint32_t FIELD_READ_SECTORS = 8;   // lecture multi-blocs (4 Ko)
+}
+
 // Structure pour représenter une frame d'animation
 struct AnimationFrame {
     uint8_t* data;      // Données de la frame (RGB565)
@@ -34,6 +41,7 @@ struct Animation {
     // Mode ultra-économe : génération à la volée
     bool stream_generated_names;                // If true: generate FR_XXX.RAW names on-the-fly
     std::string base_directory;                 // Base directory for generated names
+    std::string frame_extension;                // ".RAW" ou ".RAW.GZ" (trames compressées)
     
     // Mode par blocs : gestion séquentielle de gros volumes
     bool stream_by_blocks;                      // If true: load animation by blocks
@@ -43,7 +51,7 @@ struct Animation {
     
     Animation() : loop(true), stream_from_dir_files(false),
                   num_frames_stream(0), frame_size_bytes(0),
-                  stream_generated_names(false), stream_by_blocks(false),
+                  stream_generated_names(false), frame_extension(".RAW"), stream_by_blocks(false),
                   total_files_available(0), current_block_start(0), block_size(20) {}
     ~Animation() {
         for (auto frame : frames) {
@@ -63,9 +71,17 @@ private:
     int current_frame_index;
     uint32_t last_frame_time;
     int performance_mode; // 0=normal(33ms), 1=rapide(16ms), 2=ultra(8ms)
+    std::string detected_extension; // Extension retenue par detect_animation_files_count
+
+    // Affichage entrelacé: une trame (lignes paires ou impaires) par pas
+    bool interlaced;
+    uint8_t next_field;             // 0 = paires, 1 = impaires (lignes de l'image)
+    int8_t presented_field;         // trame lue par le dernier read_frame_from_file, -1 = image entière
+    uint16_t frame_x, frame_y, frame_w, frame_h; // zone de la dernière image à l'écran
     
     // Fonctions privées
     bool read_frame_from_file(const char* full_path, uint32_t frame_size, int offset_x = 0, int offset_y = 0);
+    void present_frame();                       // sendFrame, ou sendRegion de la trame lue
     bool load_next_block(Animation* anim);      // Charge le bloc suivant
     void update_block_animation(Animation* anim); // Met à jour l'animation par blocs
     
@@ -76,9 +92,11 @@ public:
     // Gestion des animations
     // Charge une animation depuis un répertoire contenant des fichiers .raw triés (DirectoryFrames)
     // Version ultra-économe : génère les noms à la volée (0 allocation de chemins)
-    bool load_animation_generated(const char* directory_path, const char* name, size_t frame_count);
+    bool load_animation_generated(const char* directory_path, const char* name, size_t frame_count,
+                                  const char* extension = ".RAW");
     // Version par blocs : charge l'animation complète par blocs séquentiels
-    bool load_animation_by_blocks(const char* directory_path, const char* name, size_t total_files, size_t block_size = 20);
+    bool load_animation_by_blocks(const char* directory_path, const char* name, size_t total_files, size_t block_size = 20,
+                                  const char* extension = ".RAW");
     
     // Contrôle de lecture
     bool play_animation(int animation_index);
@@ -90,8 +108,17 @@ public:
     int get_animation_count() const { return animations.size(); }
     int get_current_animation_index() const { return current_animation_index; }
     int get_current_frame_index() const { return current_frame_index; }
+    bool is_playing() const { return current_animation_index >= 0; }
+
+    // Entrelacé: chaque pas lit et envoie une seule trame (moitié des lignes)
+    // des images rangées par trame; les autres images restent entières
+    void set_interlaced(bool enabled) { interlaced = enabled; next_field = 0; frame_w = 0; }
+    bool is_interlaced() const { return interlaced; }
+    // Réécrit sur place les FR_XXX.RAW d'un répertoire en rangement par trame
+    // (FAT32; utilise le framebuffer comme tampon). Retourne le nombre converti.
+    size_t convert_to_fields(const char* directory_path);
     
     // Détection automatique du nombre de blocs/fichiers
-    size_t detect_animation_files_count(const char* directory_path); // Compte les fichiers FR_XXX.RAW
+    size_t detect_animation_files_count(const char* directory_path); // Compte les fichiers FR_XXX.RAW (ou FR_XXX.RAW.GZ)
     bool load_animation_auto_detect(const char* directory_path, const char* name = nullptr); // Détecte automatiquement et charge
 };
\ No newline at end of file
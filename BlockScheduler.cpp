@@ -0,0 +1,137 @@
+#include "BlockScheduler.h"
+#include "SDCard.h"
+#include <cstdio>
+
+/*******************************************************
+ * Nom du fichier : BlockScheduler.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : file de requêtes bloc (write-back,
+ *                  tri par LBA, fusion multi-blocs)
+ *******************************************************/
+
+using namespace BlockScheduler_Config;
+
+BlockScheduler::BlockScheduler(SDCard* sd) : sd_card(sd), count_(0) {
+    memset(lba_, 0, sizeof(lba_));
+}
+
+int BlockScheduler::find(uint32_t lba) const {
+    for (uint8_t i = 0; i < count_; ++i) {
+        if (lba_[i] == lba) return i;
+    }
+    return -1;
+}
+
+bool BlockScheduler::read(uint32_t lba, uint8_t* buffer) {
+    int slot = find(lba);
+    if (slot >= 0) {
+        memcpy(buffer, data_[slot], SECTOR_SIZE);
+        stats_.read_hits++;
+        return true;
+    }
+    stats_.read_commands++;
+    stats_.read_blocks++;
+    return sd_card->read_block(lba, buffer);
+}
+
+bool BlockScheduler::read_run(uint32_t lba, uint32_t count, uint8_t* buffer) {
+    uint32_t i = 0;
+    while (i < count) {
+        int slot = find(lba + i);
+        if (slot >= 0) {
+            memcpy(buffer + i * SECTOR_SIZE, data_[slot], SECTOR_SIZE);
+            stats_.read_hits++;
+            ++i;
+            continue;
+        }
+        // Portion absente de la file: une seule commande jusqu'au prochain secteur en attente
+        uint32_t n = 1;
+        while (i + n < count && find(lba + i + n) < 0) ++n;
+        stats_.read_commands++;
+        stats_.read_blocks += n;
+        if (!sd_card->read_blocks(lba + i, n, buffer + i * SECTOR_SIZE)) return false;
+        i += n;
+    }
+    return true;
+}
+
+bool BlockScheduler::write(uint32_t lba, const uint8_t* buffer) {
+    int slot = find(lba);
+    if (slot >= 0) {
+        // Secteur déjà en attente (entrée de répertoire, secteur FAT): seule la dernière version part
+        memcpy(data_[slot], buffer, SECTOR_SIZE);
+        stats_.coalesced++;
+        return true;
+    }
+    // File pleine et vidage en échec: rien n'est perdu, mais ce secteur n'entre pas
+    if (count_ == QUEUE_SLOTS && !flush() && count_ == QUEUE_SLOTS) return false;
+    lba_[count_] = lba;
+    memcpy(data_[count_], buffer, SECTOR_SIZE);
+    count_++;
+    return true;
+}
+
+// Écrit order[first .. first+count-1], LBA consécutifs. Un bloc refusé en
+// cours de CMD25 est clos par write_data() (jeton Stop Tran)
+bool BlockScheduler::write_run(const uint8_t* order, uint8_t first, uint8_t count) {
+    stats_.write_commands++;
+    if (count == 1) {
+        if (!sd_card->write_block(lba_[order[first]], data_[order[first]])) return false;
+    } else {
+        if (!sd_card->write_start(lba_[order[first]], count)) return false;
+        for (uint8_t k = 0; k < count; ++k) {
+            if (!sd_card->write_data(data_[order[first + k]])) return false;
+        }
+        if (!sd_card->write_stop()) return false;
+    }
+    stats_.written_blocks += count;
+    return true;
+}
+
+bool BlockScheduler::flush() {
+    if (count_ == 0) return true;
+    stats_.flushes++;
+
+    // Tri par insertion des indices de la file (au plus QUEUE_SLOTS éléments)
+    uint8_t order[QUEUE_SLOTS];
+    for (uint8_t i = 0; i < count_; ++i) {
+        uint8_t j = i;
+        while (j > 0 && lba_[order[j - 1]] > lba_[i]) { order[j] = order[j - 1]; --j; }
+        order[j] = i;
+    }
+
+    // Arrêt à la première séquence en échec: elle et les suivantes restent
+    // en file, l'appelant peut relancer flush()
+    uint8_t start = 0;
+    uint8_t written = 0;
+    for (uint8_t i = 1; i <= count_; ++i) {
+        if (i < count_ && lba_[order[i]] == lba_[order[i - 1]] + 1) continue;
+        if (!write_run(order, start, (uint8_t)(i - start))) {
+            printf("BlockScheduler  Échec écriture LBA %lu (%u secteurs), %u secteur(s) gardé(s)\n",
+                   (unsigned long)lba_[order[start]], (unsigned)(i - start), (unsigned)(count_ - start));
+            break;
+        }
+        written = i;
+        start = i;
+    }
+    if (written == count_) {
+        count_ = 0;
+        return true;
+    }
+
+    // Compactage des emplacements non écrits (ordre d'origine conservé)
+    bool done[QUEUE_SLOTS] = {};
+    for (uint8_t k = 0; k < written; ++k) done[order[k]] = true;
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < count_; ++i) {
+        if (done[i]) continue;
+        if (kept != i) {
+            lba_[kept] = lba_[i];
+            memcpy(data_[kept], data_[i], SECTOR_SIZE);
+        }
+        kept++;
+    }
+    count_ = kept;
+    return false;
+}
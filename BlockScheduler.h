@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ * BlockScheduler - File de requêtes entre FAT32 et SDCard
+ *
+ * Les écritures sont gardées en RAM (write-back) puis vidées triées par LBA
+ * (un seul balayage ascendant): les secteurs consécutifs partent en une
+ * commande multi-blocs (CMD25), une réécriture du même secteur remplace
+ * simplement la copie en attente.
+ *
+ * Les lectures passent devant les écritures en attente (lecture de trame
+ * pendant la lecture d'une animation): elles ne déclenchent pas de vidage
+ * et sont servies depuis la file si le secteur y est déjà.
+ */
+
+#include "pico/stdlib.h"
+#include <cstring>
+
+// Forward declaration
+class SDCard;
+
+namespace BlockScheduler_Config {
+    static constexpr uint16_t SECTOR_SIZE = 512;
+    // Secteurs en attente d'écriture (8 x 512 o = 4 Ko de RAM)
+    static constexpr uint8_t QUEUE_SLOTS = 8;
+}
+
+// Compteurs de la file (commandes réellement envoyées à la carte)
+struct BlockSchedulerStats {
+    uint32_t read_commands;      // CMD17 + CMD18
+    uint32_t read_blocks;        // secteurs lus sur la carte
+    uint32_t read_hits;          // secteurs servis depuis la file
+    uint32_t write_commands;     // CMD24 + CMD25
+    uint32_t written_blocks;     // secteurs écrits sur la carte
+    uint32_t coalesced;          // réécritures absorbées par la file
+    uint32_t flushes;
+
+    BlockSchedulerStats() { memset(this, 0, sizeof(*this)); }
+};
+
+class BlockScheduler {
+private:
+    SDCard* sd_card;
+    uint8_t  count_;
+    uint32_t lba_[BlockScheduler_Config::QUEUE_SLOTS];
+    uint8_t  data_[BlockScheduler_Config::QUEUE_SLOTS][BlockScheduler_Config::SECTOR_SIZE];
+    BlockSchedulerStats stats_;
+
+    int find(uint32_t lba) const;
+    bool write_run(const uint8_t* order, uint8_t first, uint8_t count);
+
+public:
+    explicit BlockScheduler(SDCard* sd);
+
+    // Lecture d'un secteur (prioritaire sur les écritures en attente)
+    bool read(uint32_t lba, uint8_t* buffer);
+    // Lecture de 'count' secteurs consécutifs: une commande multi-blocs par
+    // portion absente de la file
+    bool read_run(uint32_t lba, uint32_t count, uint8_t* buffer);
+    // Mise en file d'une écriture; la file pleine est vidée d'abord (false,
+    // secteur non pris, si elle reste pleine)
+    bool write(uint32_t lba, const uint8_t* buffer);
+    // Écrit toutes les requêtes en attente (ordre LBA, séquences fusionnées).
+    // En cas d'échec, la séquence fautive et les suivantes restent en file
+    bool flush();
+
+    uint8_t pending() const { return count_; }
+    const BlockSchedulerStats& get_stats() const { return stats_; }
+    void reset_stats() { stats_ = BlockSchedulerStats(); }
+};
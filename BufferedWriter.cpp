@@ -0,0 +1,119 @@
+#include "BufferedWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+/*******************************************************
+ * Nom du fichier : BufferedWriter.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : écriture groupée par cluster (FAT32)
+ *******************************************************/
+
+using namespace BufferedWriter_Config;
+
+uint8_t BufferedWriter::pool[POOL_BUFFERS][BUFFER_SIZE];
+bool BufferedWriter::pool_busy[POOL_BUFFERS] = {};
+
+uint8_t* BufferedWriter::acquire() {
+    for (uint8_t i = 0; i < POOL_BUFFERS; ++i) {
+        if (!pool_busy[i]) {
+            pool_busy[i] = true;
+            return pool[i];
+        }
+    }
+    return nullptr;
+}
+
+void BufferedWriter::release(uint8_t* buf) {
+    for (uint8_t i = 0; i < POOL_BUFFERS; ++i) {
+        if (pool[i] == buf) pool_busy[i] = false;
+    }
+}
+
+BufferedWriter::BufferedWriter(FAT32* filesystem)
+    : fs(filesystem), buffer(nullptr), capacity(0), used(0), position(0), failed(false) {}
+
+BufferedWriter::~BufferedWriter() {
+    close();
+}
+
+FAT_ErrorCode BufferedWriter::open(const char* filename, FileFunction function, uint32_t expected_size) {
+    if (!fs || !fs->is_initialized() || buffer) return ERROR_IDLE;
+    if (function != CREATE && function != OVERWRITE) return ERROR_IDLE;
+    buffer = acquire();
+    if (!buffer) {
+        printf("BufferedWriter  Aucun tampon libre\n");
+        return ERROR_IDLE;
+    }
+    fs->set_expected_size(expected_size);
+    FAT_ErrorCode r = fs->file_open(filename, function);
+    if (r != FILE_CREATE_OK && r != FILE_FOUND) {
+        release(buffer);
+        buffer = nullptr;
+        return r;
+    }
+    const uint32_t cluster_bytes = (uint32_t)fs->get_cluster_size() * fs->get_sector_size();
+    capacity = std::min<uint32_t>(cluster_bytes, BUFFER_SIZE);
+    used = 0;
+    position = 0;
+    failed = false;
+    return r;
+}
+
+bool BufferedWriter::write_through(const uint8_t* data, uint32_t length) {
+    uint32_t n = fs->file_write(data, length);
+    position += n;
+    if (n != length) failed = true;
+    return !failed;
+}
+
+bool BufferedWriter::write(const uint8_t* data, uint32_t length) {
+    if (!buffer || failed) return false;
+    while (length > 0) {
+        // Fin du bloc courant: après un flush partiel, le bloc est raccourci
+        // pour que les suivants retombent sur des frontières de cluster
+        const uint32_t limit = capacity - (position % capacity);
+        if (used == 0 && length >= limit) {
+            // Blocs entiers: transmis directement, sans copie
+            const uint32_t direct = limit + (length - limit) / capacity * capacity;
+            if (!write_through(data, direct)) return false;
+            data += direct;
+            length -= direct;
+            continue;
+        }
+        const uint32_t n = std::min(length, limit - used);
+        memcpy(buffer + used, data, n);
+        used += n;
+        data += n;
+        length -= n;
+        if (used == limit) {
+            used = 0;
+            if (!write_through(buffer, limit)) return false;
+        }
+    }
+    return true;
+}
+
+bool BufferedWriter::print(const char* text) {
+    return text ? write((const uint8_t*)text, (uint32_t)strlen(text)) : false;
+}
+
+bool BufferedWriter::flush() {
+    if (!buffer) return false;
+    if (used > 0) {
+        const uint32_t n = used;
+        used = 0;
+        write_through(buffer, n);
+    }
+    return fs->flush() && !failed;
+}
+
+bool BufferedWriter::close() {
+    if (!buffer) return false;
+    bool ok = flush();
+    fs->file_close();
+    release(buffer);
+    buffer = nullptr;
+    return ok;
+}
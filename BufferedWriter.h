@@ -0,0 +1,57 @@
+#pragma once
+
+/*
+ * BufferedWriter - Écriture groupée par cluster au-dessus de FAT32
+ *
+ * Les petites écritures (journal de capteur, texte) sont accumulées dans un
+ * tampon de la taille d'un cluster puis transmises à FAT32::file_write par
+ * blocs entiers alignés: chaque secteur n'est écrit qu'une fois, sans
+ * lecture-modification-écriture. Un flush() explicite écrit la partie en
+ * cours; les blocs suivants sont raccourcis pour retrouver l'alignement.
+ *
+ * Le tampon provient d'un pool statique (hors tas). FAT32 n'ayant qu'un
+ * handler d'écriture, un seul writer peut être ouvert à la fois.
+ */
+
+#include "pico/stdlib.h"
+#include "FAT32.h"
+
+namespace BufferedWriter_Config {
+    static constexpr uint8_t  POOL_BUFFERS = 1;
+    // Un cluster, plafonné: un cluster de 32 Ko ne tient pas en RAM
+    static constexpr uint32_t BUFFER_SIZE = 4096;
+}
+
+class BufferedWriter {
+private:
+    FAT32* fs;
+    uint8_t* buffer;       // tampon du pool, nullptr si fermé
+    uint32_t capacity;     // taille d'un bloc (cluster plafonné à BUFFER_SIZE)
+    uint32_t used;         // octets en attente dans le tampon
+    uint32_t position;     // octets déjà transmis à FAT32
+    bool     failed;
+
+    static uint8_t pool[BufferedWriter_Config::POOL_BUFFERS][BufferedWriter_Config::BUFFER_SIZE];
+    static bool pool_busy[BufferedWriter_Config::POOL_BUFFERS];
+    static uint8_t* acquire();
+    static void release(uint8_t* buf);
+
+    bool write_through(const uint8_t* data, uint32_t length);
+
+public:
+    explicit BufferedWriter(FAT32* filesystem);
+    ~BufferedWriter();
+
+    // Ouvre le fichier (CREATE ou OVERWRITE). expected_size: taille annoncée
+    // pour le placement sur la carte (FAT32::set_expected_size), 0 si inconnue.
+    FAT_ErrorCode open(const char* filename, FileFunction function = CREATE, uint32_t expected_size = 0);
+    bool write(const uint8_t* data, uint32_t length);
+    bool print(const char* text);
+    // Écrit le contenu du tampon (bloc partiel compris) et vide la file de requêtes
+    bool flush();
+    // flush() puis fermeture du fichier et restitution du tampon au pool
+    bool close();
+
+    bool is_open() const { return buffer != nullptr; }
+    uint32_t get_size() const { return position + used; }
+};
@@ -0,0 +1,152 @@
+#include "Canvas.h"
+#include <cstdio>
+
+/*******************************************************
+ * Nom du fichier : Canvas.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : surfaces hors écran, réserve fixe
+ *******************************************************/
+
+using namespace Canvas_Config;
+
+static_assert(SLOTS >= 1 && SLOTS <= 32, "CANVAS_POOL_PIXELS: 1 à 32 emplacements (used_mask: un bit chacun)");
+
+// Mémoire de tous les Canvas, alignée pour les copies par mots
+alignas(4) static uint16_t storage[SLOTS * SLOT_PIXELS];
+
+Canvas Canvas::pool[SLOTS];
+uint32_t Canvas::used_mask = 0;
+
+Canvas::Canvas()
+    : pixels(nullptr), width(0), height(0), first_slot(0), slot_count(0),
+      clip_x0(0), clip_y0(0), clip_x1(0), clip_y1(0), current_font(FontType::FONT_STANDARD) {}
+
+Canvas* Canvas::acquire(int w, int h) {
+    if (w <= 0 || h <= 0 || (uint32_t)w * (uint32_t)h > SLOTS * SLOT_PIXELS) {
+        printf("Canvas: %dx%d hors limites (%lu pixels max)\n", w, h, (unsigned long)(SLOTS * SLOT_PIXELS));
+        return nullptr;
+    }
+    const uint32_t need = ((uint32_t)w * (uint32_t)h + SLOT_PIXELS - 1) / SLOT_PIXELS;
+    const uint32_t run = (need >= 32) ? 0xFFFFFFFFu : ((1u << need) - 1);
+
+    // Premier groupe de need emplacements libres consécutifs
+    for (uint32_t first = 0; first + need <= SLOTS; ++first) {
+        if (used_mask & (run << first)) continue;
+        used_mask |= run << first;
+        Canvas& canvas = pool[first];
+        canvas.pixels = &storage[first * SLOT_PIXELS];
+        canvas.width = w;
+        canvas.height = h;
+        canvas.first_slot = (uint8_t)first;
+        canvas.slot_count = (uint8_t)need;
+        canvas.current_font = FontType::FONT_STANDARD;
+        canvas.resetClipRect();
+        return &canvas;
+    }
+    printf("Canvas: réserve pleine pour %dx%d (%u emplacement(s) libre(s))\n", w, h, free_slots());
+    return nullptr;
+}
+
+void Canvas::release() {
+    if (slot_count == 0) return;
+    const uint32_t run = (slot_count >= 32) ? 0xFFFFFFFFu : ((1u << slot_count) - 1);
+    used_mask &= ~(run << first_slot);
+    slot_count = 0;
+    pixels = nullptr;
+    width = height = 0;
+    resetClipRect();
+}
+
+uint8_t Canvas::free_slots() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < SLOTS; ++i) {
+        if (!(used_mask & (1u << i))) count++;
+    }
+    return count;
+}
+
+// ===== DÉCOUPAGE =====
+void Canvas::setClipRect(int x, int y, int w, int h) {
+    clip_x0 = (x > 0) ? x : 0;
+    clip_y0 = (y > 0) ? y : 0;
+    clip_x1 = (x + w < width) ? x + w : width;
+    clip_y1 = (y + h < height) ? y + h : height;
+    // Rectangle vide: plus rien n'est dessiné
+    if (clip_x1 < clip_x0) clip_x1 = clip_x0;
+    if (clip_y1 < clip_y0) clip_y1 = clip_y0;
+}
+
+void Canvas::resetClipRect() {
+    clip_x0 = 0;
+    clip_y0 = 0;
+    clip_x1 = width;
+    clip_y1 = height;
+}
+
+bool Canvas::clipBox(int x, int y, int w, int h, ClipRect& out) const {
+    out.x0 = (x > clip_x0) ? x : clip_x0;
+    out.y0 = (y > clip_y0) ? y : clip_y0;
+    out.x1 = (x + w < clip_x1) ? x + w : clip_x1;
+    out.y1 = (y + h < clip_y1) ? y + h : clip_y1;
+    return out.x0 < out.x1 && out.y0 < out.y1;
+}
+
+// ===== DESSIN =====
+void Canvas::fill(uint16_t color) {
+    Raster::fillSpan(pixels, width * height, Raster::to_be(color));
+}
+
+void Canvas::setPixel(int x, int y, uint16_t color) {
+    if (x < clip_x0 || y < clip_y0 || x >= clip_x1 || y >= clip_y1) return;
+    pixels[y * width + x] = Raster::to_be(color);
+}
+
+void Canvas::fillRect(int x, int y, int w, int h, uint16_t color) {
+    Raster::fillRect(*this, x, y, w, h, color);
+}
+
+void Canvas::drawRect(int x, int y, int w, int h, uint16_t color) {
+    Raster::drawRect(*this, x, y, w, h, color);
+}
+
+void Canvas::drawLine(int x0, int y0, int x1, int y1, uint16_t color) {
+    Raster::drawLine(*this, x0, y0, x1, y1, color);
+}
+
+void Canvas::drawCircle(int xc, int yc, int r, uint16_t color) {
+    Raster::drawCircle(*this, xc, yc, r, color);
+}
+
+void Canvas::drawFillCircle(int xc, int yc, int r, uint16_t color) {
+    Raster::drawFillCircle(*this, xc, yc, r, color);
+}
+
+void Canvas::drawSmallCircle(int xc, int yc, int r, uint16_t color) {
+    Raster::drawSmallCircle(*this, xc, yc, r, color);
+}
+
+void Canvas::drawBitmap(int x, int y, int w, int h, const uint8_t* bits, uint16_t color) {
+    Raster::drawBitmap(*this, x, y, w, h, bits, color);
+}
+
+void Canvas::blitRGB565(int x, int y, int w, int h, const uint16_t* src) {
+    Raster::blitRGB565(*this, x, y, w, h, src);
+}
+
+void Canvas::fillLinearGradient(int x, int y, int w, int h,
+                                int x0, int y0, uint16_t color0, int x1, int y1, uint16_t color1) {
+    Raster::fillLinearGradient(*this, x, y, w, h, x0, y0, color0, x1, y1, color1);
+}
+
+void Canvas::fillRadialGradient(int x, int y, int w, int h, int xc, int yc, int r, uint16_t inner, uint16_t outer) {
+    Raster::fillRadialGradient(*this, x, y, w, h, xc, yc, r, inner, outer);
+}
+
+void Canvas::fillPattern(int x, int y, int w, int h, const uint8_t* pattern, uint16_t fg, uint16_t bg) {
+    Raster::fillPattern(*this, x, y, w, h, pattern, fg, bg);
+}
+
+void Canvas::drawText(int x, int y, const char* text, uint16_t color) {
+    Raster::drawText(*this, current_font, x, y, text, color);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+/*
+ * Canvas - Surface RGB565 hors écran, prise dans une réserve fixe
+ *
+ * Un cadran de jauge, un titre en Arial32 ou une icône colorée sont
+ * dessinés une fois dans un Canvas avec les mêmes primitives que l'écran
+ * (Raster.h), puis recopiés dans le framebuffer par TFT::drawCanvas() à
+ * chaque image: une copie de lignes au lieu de refaire les cercles et le
+ * texte.
+ *
+ * Aucune allocation dynamique: la mémoire est une réserve statique de
+ * SLOTS emplacements de SLOT_PIXELS pixels. Un Canvas occupe un ou
+ * plusieurs emplacements consécutifs (premier trouvé) et les rend par
+ * release(). Réserve pleine ou Canvas trop grand: acquire() renvoie
+ * nullptr.
+ *
+ * La réserve est en .bss à côté du framebuffer (115 Ko): sa taille est
+ * une option de compilation, CANVAS_POOL_PIXELS (CMakeLists.txt), 8192
+ * pixels soit 16 Ko par défaut; le titre du tableau de bord en prend 10.
+ *
+ * Pixels rangés gros-boutiens comme le framebuffer, lignes contiguës de
+ * getWidth() pixels: la recopie est un memcpy par ligne. Le contenu d'un
+ * Canvas obtenu n'est pas effacé (fill() si besoin).
+ */
+
+#include "pico/stdlib.h"
+#include "Raster.h"
+
+#ifndef CANVAS_POOL_PIXELS
+#define CANVAS_POOL_PIXELS 8192
+#endif
+
+namespace Canvas_Config {
+    static constexpr uint32_t SLOT_PIXELS = 32 * 32;   // 2 Ko par emplacement
+    static constexpr uint8_t SLOTS = CANVAS_POOL_PIXELS / SLOT_PIXELS;
+}
+
+class Canvas {
+private:
+    uint16_t* pixels;
+    int width, height;
+    uint8_t first_slot;        // index dans la réserve
+    uint8_t slot_count;        // 0: libre
+    int clip_x0, clip_y0, clip_x1, clip_y1;
+    FontType current_font;
+
+    static Canvas pool[Canvas_Config::SLOTS];
+    static uint32_t used_mask; // bit n: emplacement n occupé
+
+    Canvas();
+    Canvas(const Canvas&) = delete;
+    Canvas& operator=(const Canvas&) = delete;
+
+public:
+    // w x h pixels (au plus SLOTS * SLOT_PIXELS); nullptr si la place manque
+    static Canvas* acquire(int w, int h);
+    // Rend les emplacements; le Canvas ne doit plus être utilisé
+    void release();
+    static uint8_t free_slots();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const uint16_t* getPixels() const { return pixels; }
+
+    // ===== DESSIN (coordonnées du Canvas, origine en haut à gauche) =====
+    void fill(uint16_t color);
+    void setPixel(int x, int y, uint16_t color);
+    void fillRect(int x, int y, int w, int h, uint16_t color);
+    void drawRect(int x, int y, int w, int h, uint16_t color);
+    void drawLine(int x0, int y0, int x1, int y1, uint16_t color);
+    void drawCircle(int xc, int yc, int r, uint16_t color);
+    void drawFillCircle(int xc, int yc, int r, uint16_t color);
+    void drawSmallCircle(int xc, int yc, int r, uint16_t color);
+    void drawBitmap(int x, int y, int w, int h, const uint8_t* bits, uint16_t color);
+    void blitRGB565(int x, int y, int w, int h, const uint16_t* src);
+    void fillLinearGradient(int x, int y, int w, int h,
+                            int x0, int y0, uint16_t color0, int x1, int y1, uint16_t color1);
+    void fillRadialGradient(int x, int y, int w, int h, int xc, int yc, int r, uint16_t inner, uint16_t outer);
+    void fillPattern(int x, int y, int w, int h, const uint8_t* pattern, uint16_t fg, uint16_t bg);
+
+    void setFont(FontType font) { current_font = font; }
+    FontType getFont() const { return current_font; }
+    void drawText(int x, int y, const char* text, uint16_t color);
+    int getTextWidth(const char* text) const { return Raster::text_width(current_font, text); }
+
+    // Découpage, borné au Canvas
+    void setClipRect(int x, int y, int w, int h);
+    void resetClipRect();
+
+    // ===== SURFACE (Raster.h) =====
+    bool clipBox(int x, int y, int w, int h, ClipRect& out) const;
+    uint16_t* surfaceRow(int y) { return pixels + y * width; }
+    int surfaceStride() const { return width; }
+    int originX() const { return 0; }
+    int originY() const { return 0; }
+};
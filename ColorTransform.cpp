@@ -0,0 +1,61 @@
+#include "ColorTransform.h"
+#include <cmath>
+
+/*******************************************************
+ * Nom du fichier : ColorTransform.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : tables gamma/luminosité/température
+ *******************************************************/
+
+static inline uint16_t swap_bytes(uint16_t v) {
+    return (uint16_t)((v >> 8) | (v << 8));
+}
+
+ColorTransform::ColorTransform() {
+    set(ColorSettings());
+}
+
+float ColorTransform::channel_gain(uint8_t channel, float warmth) {
+    // Chaud: le bleu puis le vert baissent; froid: le rouge baisse
+    static const float warm[3] = {0.0f, 0.35f, 0.75f};
+    static const float cold[3] = {0.5f, 0.2f, 0.0f};
+    if (warmth > 1.0f) warmth = 1.0f;
+    if (warmth < -1.0f) warmth = -1.0f;
+    return (warmth >= 0.0f) ? 1.0f - warm[channel] * warmth : 1.0f + cold[channel] * warmth;
+}
+
+uint8_t ColorTransform::level(uint8_t value, uint8_t max, uint8_t channel, const ColorSettings& s) {
+    float v = (float)value / (float)max;
+    if (s.invert) v = 1.0f - v;
+    if (v > 0.0f && s.gamma != 1.0f) v = powf(v, s.gamma);
+    v *= s.brightness * channel_gain(channel, s.warmth);
+    const int out = (int)(v * (float)max + 0.5f);
+    return (uint8_t)(out < 0 ? 0 : (out > max ? max : out));
+}
+
+void ColorTransform::set(const ColorSettings& new_settings) {
+    settings = new_settings;
+    if (settings.brightness < 0.0f) settings.brightness = 0.0f;
+    if (settings.brightness > 1.0f) settings.brightness = 1.0f;
+    if (settings.gamma <= 0.0f) settings.gamma = 1.0f;
+    identity = settings.is_identity();
+
+    for (uint8_t i = 0; i < 32; ++i) {
+        red[i] = swap_bytes((uint16_t)(level(i, 31, 0, settings) << 11));
+        blue[i] = swap_bytes(level(i, 31, 2, settings));
+    }
+    for (uint8_t i = 0; i < 64; ++i) {
+        green[i] = swap_bytes((uint16_t)(level(i, 63, 1, settings) << 5));
+    }
+}
+
+void ColorTransform::apply_be(const uint16_t* src, uint16_t* dst, size_t count) const {
+    const uint16_t* r = red;
+    const uint16_t* g = green;
+    const uint16_t* b = blue;
+    for (size_t i = 0; i < count; ++i) {
+        const uint16_t c = swap_bytes(src[i]);   // REV16
+        dst[i] = r[c >> 11] | g[(c >> 5) & 0x3F] | b[c & 0x1F];
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+ * ColorTransform - Transformation de couleur appliquée à l'envoi SPI
+ *
+ * Gamma, luminosité, température de couleur et inversion, calculés une
+ * fois en trois tables par canal (32 rouges, 64 verts, 32 bleus): chaque
+ * pixel coûte ensuite trois lectures de table. TFT::sendFrame/sendRegion
+ * transforment ligne par ligne dans un tampon de sortie, le framebuffer
+ * n'est jamais modifié: changer de réglage ne redessine rien.
+ *
+ * Les tables sont rangées octets permutés, comme le framebuffer
+ * (RGB565 gros-boutien): apply_be() produit directement les octets SPI.
+ */
+
+#include "pico/stdlib.h"
+#include <cstddef>
+
+namespace ColorTransform_Config {
+    static constexpr float NIGHT_BRIGHTNESS = 0.4f;
+    static constexpr float NIGHT_WARMTH = 0.8f;
+}
+
+struct ColorSettings {
+    float gamma;               // exposant (1 = neutre, > 1 assombrit les tons moyens)
+    float brightness;          // 0..1
+    float warmth;              // -1 (froid) .. 1 (chaud), 0 = neutre
+    bool  invert;
+
+    ColorSettings() : gamma(1.0f), brightness(1.0f), warmth(0.0f), invert(false) {}
+    bool is_identity() const { return gamma == 1.0f && brightness >= 1.0f && warmth == 0.0f && !invert; }
+};
+
+class ColorTransform {
+private:
+    uint16_t red[32];          // sorties déjà en place dans le mot RGB565,
+    uint16_t green[64];        // octets permutés
+    uint16_t blue[32];
+    ColorSettings settings;
+    bool identity;
+
+public:
+    ColorTransform();
+
+    // Recalcule les tables (128 entrées)
+    void set(const ColorSettings& new_settings);
+    const ColorSettings& get() const { return settings; }
+    bool is_identity() const { return identity; }
+
+    // Gain du canal (0 rouge, 1 vert, 2 bleu) pour une température donnée
+    static float channel_gain(uint8_t channel, float warmth);
+    // Niveau transformé d'un canal de max+1 niveaux (max = 31 ou 63)
+    static uint8_t level(uint8_t value, uint8_t max, uint8_t channel, const ColorSettings& s);
+
+    // Pixel RGB565 natif
+    uint16_t apply(uint16_t color) const {
+        const uint16_t swapped = red[color >> 11] | green[(color >> 5) & 0x3F] | blue[color & 0x1F];
+        return (uint16_t)((swapped >> 8) | (swapped << 8));
+    }
+    // count pixels du framebuffer (gros-boutiens) vers dst, au même format
+    void apply_be(const uint16_t* src, uint16_t* dst, size_t count) const;
+};
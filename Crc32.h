@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+ * Crc32 - CRC-32 IEEE 802.3 (polynôme réfléchi 0xEDB88320)
+ *
+ * Celui de gzip/zlib: update(0, data, n) donne le CRC de data, et les
+ * appels successifs enchaînent les blocs. Table de 256 entrées en flash.
+ */
+
+#include "pico/stdlib.h"
+#include <cstddef>
+
+namespace Crc32 {
+    uint32_t update(uint32_t crc, const void* data, size_t length);
+}
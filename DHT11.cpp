@@ -13,19 +13,19 @@ DHT11::DHT11(uint pin) : gpio_pin(pin) {
     last_reading = {0.0f, 0.0f, false};
 }
 
-DHT11::Reading DHT11::read() {
+DHT11::Reading DHT11::read(bool verbose) {
     Reading reading = {0.0f, 0.0f, false};
     
     // Envoyer signal de démarrage
     if (!startSignal()) {
-        printf("DHT11: Échec du signal de démarrage\n");
+        if (verbose) printf("DHT11: Échec du signal de démarrage\n");
         last_reading = reading;
         return reading;
     }
     
     // Attendre la réponse du DHT11
     if (!waitForResponse()) {
-        printf("DHT11: Pas de réponse du capteur\n");
+        if (verbose) printf("DHT11: Pas de réponse du capteur\n");
         last_reading = reading;
         return reading;
     }
@@ -39,7 +39,7 @@ DHT11::Reading DHT11::read() {
     // Vérifier le checksum
     uint8_t checksum = data[0] + data[1] + data[2] + data[3];
     if (checksum != data[4]) {
-        printf("DHT11: Erreur checksum (calculé: %d, reçu: %d)\n", checksum, data[4]);
+        if (verbose) printf("DHT11: Erreur checksum (calculé: %d, reçu: %d)\n", checksum, data[4]);
         last_reading = reading;
         return reading;
     }
@@ -49,9 +49,11 @@ DHT11::Reading DHT11::read() {
     reading.temperature = (float)data[2] + (float)data[3] / 10.0f;
     reading.valid = true;
     
-    printf("DHT11: T=%.1f°C, H=%.1f%% (données: %02X %02X %02X %02X %02X)\n", 
-           reading.temperature, reading.humidity, 
-           data[0], data[1], data[2], data[3], data[4]);
+    if (verbose) {
+        printf("DHT11: T=%.1f°C, H=%.1f%% (données: %02X %02X %02X %02X %02X)\n", 
+               reading.temperature, reading.humidity, 
+               data[0], data[1], data[2], data[3], data[4]);
+    }
     
     last_reading = reading;
     return reading;
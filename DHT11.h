@@ -12,7 +12,8 @@ public:
     };
 
     DHT11(uint pin);
-    Reading read();
+    // verbose = false: aucun message (échantillonnage en tâche de fond)
+    Reading read(bool verbose = true);
     bool isDataValid() const { return last_reading.valid; }
     float getTemperature() const { return last_reading.temperature; }
     float getHumidity() const { return last_reading.humidity; }
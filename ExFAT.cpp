@@ -0,0 +1,541 @@
+#include "ExFAT.h"
+#include "SDCard.h"
+#include "FAT32_Structures.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+/*******************************************************
+ * Nom du fichier : ExFAT.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 18 octobre 2026
+ * Description    : driver exFAT (lecture seule)
+ *******************************************************/
+
+// Lecture little-endian dans un secteur brut
+static inline uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t rd32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static inline uint64_t rd64(const uint8_t* p) { return (uint64_t)rd32(p) | ((uint64_t)rd32(p + 4) << 32); }
+
+ExFAT::ExFAT(SDCard* sd)
+    : sd_card(sd), mounted(false), volume_lba(0), fat_lba(0), heap_lba(0),
+      cluster_count(0), sectors_per_cluster_shift(0), sectors_per_cluster(1),
+      root_dir_cluster(0), upcase_table_checksum(0), dir_stack_depth(0), fat_cache_sector(0xFFFFFFFFu) {
+    memset(upcase, 0, sizeof(upcase));
+    memset(volume_label, 0, sizeof(volume_label));
+    memset(read_buffer, 0, sizeof(read_buffer));
+    memset(fat_cache, 0, sizeof(fat_cache));
+}
+
+bool ExFAT::is_exfat_boot_sector(const uint8_t* sector) {
+    return memcmp(sector + 3, "EXFAT   ", 8) == 0;
+}
+
+// ============================================================================
+// MONTAGE
+// ============================================================================
+
+bool ExFAT::mount(uint32_t boot_lba) {
+    mounted = false;
+    if (!sd_card || !sd_card->read_block(boot_lba, read_buffer)) {
+        printf("exFAT  Erreur lecture secteur de boot (LBA %lu)\n", (unsigned long)boot_lba);
+        return false;
+    }
+    if (!is_exfat_boot_sector(read_buffer) || rd16(read_buffer + 510) != 0xAA55) {
+        printf("exFAT  Signature de boot invalide\n");
+        return false;
+    }
+
+    ExFAT_BootSector bs;
+    memcpy(&bs, read_buffer, sizeof(bs));
+
+    // Seuls les secteurs de 512 octets sont gérés (taille de bloc SD)
+    if (bs.bytes_per_sector_shift != 9) {
+        printf("exFAT  BytesPerSectorShift=%u non supporté\n", (unsigned)bs.bytes_per_sector_shift);
+        return false;
+    }
+    if (bs.sectors_per_cluster_shift > 16 || bs.number_of_fats == 0) {
+        printf("exFAT  Géométrie invalide\n");
+        return false;
+    }
+
+    volume_lba = boot_lba;
+    fat_lba = boot_lba + bs.fat_offset;
+    heap_lba = boot_lba + bs.cluster_heap_offset;
+    cluster_count = bs.cluster_count;
+    sectors_per_cluster_shift = bs.sectors_per_cluster_shift;
+    sectors_per_cluster = 1u << sectors_per_cluster_shift;
+    root_dir_cluster = bs.root_dir_cluster;
+    fat_cache_sector = 0xFFFFFFFFu;
+
+    // Table up-case par défaut (ASCII) tant que la table du volume n'est pas lue
+    for (uint16_t i = 0; i < ExFAT_Config::UPCASE_CACHED_CHARS; ++i) {
+        upcase[i] = (i >= 'a' && i <= 'z') ? (uint16_t)(i - 32) : i;
+    }
+
+    // Répertoire racine: longueur inconnue, toujours chaîné dans la FAT
+    current_dir = ExFAT_Extent();
+    current_dir.first_cluster = root_dir_cluster;
+    dir_stack_depth = 0;
+
+    if (!scan_root_metadata()) {
+        printf("exFAT  Lecture des métadonnées racine impossible\n");
+        return false;
+    }
+    if (bitmap_extent.first_cluster < 2) {
+        printf("exFAT  Bitmap d'allocation absent\n");
+        return false;
+    }
+    if (!load_upcase_table()) {
+        printf("exFAT  Table up-case invalide, repli sur ASCII\n");
+    }
+
+    mounted = true;
+    printf("exFAT  Volume monté: %lu clusters de %lu octets, racine=%lu\n",
+           (unsigned long)cluster_count, (unsigned long)get_cluster_bytes(),
+           (unsigned long)root_dir_cluster);
+    return true;
+}
+
+// ============================================================================
+// CHAÎNES DE CLUSTERS
+// ============================================================================
+
+uint32_t ExFAT::fat_next(uint32_t cluster) {
+    uint32_t sector = fat_lba + (cluster / (FAT_Config::SECTOR_SIZE / 4));
+    if (sector != fat_cache_sector) {
+        if (!sd_card->read_block(sector, fat_cache)) {
+            fat_cache_sector = 0xFFFFFFFFu;
+            return ExFAT_Config::CLUSTER_EOC;
+        }
+        fat_cache_sector = sector;
+    }
+    return rd32(fat_cache + (cluster % (FAT_Config::SECTOR_SIZE / 4)) * 4);
+}
+
+uint32_t ExFAT::next_cluster(uint32_t cluster, bool no_fat_chain) {
+    // NoFatChain: les clusters sont contigus et la FAT n'est pas tenue à jour
+    if (no_fat_chain) return cluster + 1;
+    return fat_next(cluster);
+}
+
+// ============================================================================
+// PARCOURS DE RÉPERTOIRES
+// ============================================================================
+
+bool ExFAT::scan_directory(const ExFAT_Extent& dir, const std::function<bool(const DirEntrySet&)>& visit) {
+    DirEntrySet set;
+    uint8_t remaining = 0;      // entrées secondaires restantes dans l'ensemble courant
+    bool have_stream = false;
+    uint8_t name_length = 0;
+
+    uint32_t cluster = dir.first_cluster;
+    uint64_t bytes_left = dir.length;   // 0 = suivre la chaîne FAT jusqu'à EOC (racine)
+    const uint32_t cluster_bytes = get_cluster_bytes();
+
+    while (cluster >= 2 && cluster <= cluster_count + 1) {
+        for (uint32_t sec = 0; sec < sectors_per_cluster; ++sec) {
+            uint32_t lba = cluster_to_lba(cluster) + sec;
+            if (!sd_card->read_block(lba, read_buffer)) {
+                printf("exFAT  Erreur lecture secteur %lu\n", (unsigned long)lba);
+                return false;
+            }
+            for (uint16_t off = 0; off < FAT_Config::SECTOR_SIZE; off += 32) {
+                const uint8_t* e = read_buffer + off;
+                uint8_t type = e[0];
+                if (type == ExFAT_Config::ENTRY_END_OF_DIR) return true;
+                if (!(type & ExFAT_Config::ENTRY_IN_USE)) {
+                    // Entrée supprimée: abandonner l'ensemble en cours
+                    remaining = 0;
+                    continue;
+                }
+
+                if (type == ExFAT_Config::ENTRY_FILE) {
+                    set = DirEntrySet();
+                    remaining = e[1];
+                    set.attributes = rd16(e + 4);
+                    set.created = rd32(e + 8);
+                    set.modified = rd32(e + 12);
+                    have_stream = false;
+                    name_length = 0;
+                    continue;
+                }
+                if (remaining == 0) continue;   // entrée primaire non gérée ou orpheline
+
+                if (type == ExFAT_Config::ENTRY_STREAM) {
+                    uint8_t flags = e[1];
+                    name_length = e[3];
+                    set.name_hash = rd16(e + 4);
+                    set.data.no_fat_chain = (flags & ExFAT_Config::FLAG_NO_FAT_CHAIN) != 0;
+                    set.data.first_cluster = rd32(e + 0x14);
+                    set.data.length = rd64(e + 0x18);
+                    set.name.reserve(name_length);
+                    have_stream = true;
+                } else if (type == ExFAT_Config::ENTRY_FILE_NAME && have_stream) {
+                    for (uint8_t c = 0; c < ExFAT_Config::CHARS_PER_NAME_ENTRY && set.name.size() < name_length; ++c) {
+                        uint16_t ch = rd16(e + 2 + c * 2);
+                        // Repli ASCII/Latin-1 comme pour les LFN FAT32
+                        char outc = (ch < 0x100) ? (char)ch : '?';
+                        if ((unsigned char)outc < 0x20) outc = '?';
+                        set.name += outc;
+                    }
+                }
+
+                if (--remaining == 0 && have_stream) {
+                    if (!visit(set)) return true;
+                }
+            }
+        }
+
+        if (dir.length) {
+            if (bytes_left <= cluster_bytes) break;
+            bytes_left -= cluster_bytes;
+        }
+        cluster = next_cluster(cluster, dir.no_fat_chain);
+    }
+    return true;
+}
+
+bool ExFAT::scan_root_metadata() {
+    bitmap_extent = ExFAT_Extent();
+    upcase_extent = ExFAT_Extent();
+    volume_label[0] = '\0';
+    uint32_t upcase_checksum = 0;
+
+    // Les entrées critiques primaires sont lues directement (pas d'ensemble secondaire)
+    uint32_t cluster = root_dir_cluster;
+    while (cluster >= 2 && cluster <= cluster_count + 1) {
+        for (uint32_t sec = 0; sec < sectors_per_cluster; ++sec) {
+            if (!sd_card->read_block(cluster_to_lba(cluster) + sec, read_buffer)) return false;
+            for (uint16_t off = 0; off < FAT_Config::SECTOR_SIZE; off += 32) {
+                const uint8_t* e = read_buffer + off;
+                switch (e[0]) {
+                    case ExFAT_Config::ENTRY_END_OF_DIR:
+                        upcase_table_checksum = upcase_checksum;
+                        return true;
+                    case ExFAT_Config::ENTRY_BITMAP:
+                        // Premier bitmap (un seul avec NumberOfFats == 1)
+                        if ((e[1] & 0x01) == 0 && bitmap_extent.first_cluster == 0) {
+                            bitmap_extent.first_cluster = rd32(e + 0x14);
+                            bitmap_extent.length = rd64(e + 0x18);
+                        }
+                        break;
+                    case ExFAT_Config::ENTRY_UPCASE:
+                        upcase_checksum = rd32(e + 4);
+                        upcase_extent.first_cluster = rd32(e + 0x14);
+                        upcase_extent.length = rd64(e + 0x18);
+                        break;
+                    case ExFAT_Config::ENTRY_VOLUME_LABEL: {
+                        uint8_t n = e[1] > 11 ? 11 : e[1];
+                        for (uint8_t c = 0; c < n; ++c) {
+                            uint16_t ch = rd16(e + 2 + c * 2);
+                            volume_label[c] = (ch < 0x80 && ch >= 0x20) ? (char)ch : '?';
+                        }
+                        volume_label[n] = '\0';
+                        break;
+                    }
+                    default:
+                        break;
+                }
+            }
+        }
+        cluster = fat_next(cluster);
+    }
+    upcase_table_checksum = upcase_checksum;
+    return true;
+}
+
+bool ExFAT::load_upcase_table() {
+    if (upcase_extent.first_cluster < 2 || upcase_extent.length == 0) return false;
+
+    // La table est compressée: une valeur 0xFFFF suivie d'un compteur
+    // représente une plage de caractères qui se mappent sur eux-mêmes.
+    uint16_t decoded[ExFAT_Config::UPCASE_CACHED_CHARS];
+    uint32_t out_index = 0;
+    bool identity_run = false;
+    uint32_t checksum = 0;
+    uint64_t bytes_left = upcase_extent.length;
+    uint32_t cluster = upcase_extent.first_cluster;
+    uint8_t pending_low = 0;
+    bool have_low = false;
+
+    while (bytes_left > 0 && cluster >= 2 && cluster <= cluster_count + 1) {
+        for (uint32_t sec = 0; sec < sectors_per_cluster && bytes_left > 0; ++sec) {
+            if (!sd_card->read_block(cluster_to_lba(cluster) + sec, read_buffer)) return false;
+            uint32_t n = bytes_left < FAT_Config::SECTOR_SIZE ? (uint32_t)bytes_left : FAT_Config::SECTOR_SIZE;
+            for (uint32_t i = 0; i < n; ++i) {
+                uint8_t b = read_buffer[i];
+                checksum = ((checksum & 1) ? 0x80000000u : 0) + (checksum >> 1) + b;
+
+                // Décodage par mots de 16 bits (les mots peuvent chevaucher deux secteurs)
+                if (!have_low) { pending_low = b; have_low = true; continue; }
+                have_low = false;
+                uint16_t word = (uint16_t)(pending_low | (b << 8));
+                if (out_index >= ExFAT_Config::UPCASE_CACHED_CHARS) continue;
+                if (identity_run) {
+                    for (uint32_t k = 0; k < word && out_index < ExFAT_Config::UPCASE_CACHED_CHARS; ++k, ++out_index) {
+                        decoded[out_index] = (uint16_t)out_index;
+                    }
+                    identity_run = false;
+                } else if (word == 0xFFFF) {
+                    identity_run = true;
+                } else {
+                    decoded[out_index] = word;
+                    out_index++;
+                }
+            }
+            bytes_left -= n;
+        }
+        cluster = fat_next(cluster);
+    }
+
+    if (checksum != upcase_table_checksum) {
+        printf("exFAT  Checksum up-case 0x%08lX != 0x%08lX\n",
+               (unsigned long)checksum, (unsigned long)upcase_table_checksum);
+        return false;
+    }
+    // Les caractères non couverts par la table se mappent sur eux-mêmes
+    for (; out_index < ExFAT_Config::UPCASE_CACHED_CHARS; ++out_index) decoded[out_index] = (uint16_t)out_index;
+    memcpy(upcase, decoded, sizeof(upcase));
+    return true;
+}
+
+// ============================================================================
+// RECHERCHE DE NOMS
+// ============================================================================
+
+uint16_t ExFAT::name_hash(const char* name) const {
+    // NameHash de la spécification: calculé sur le nom en majuscules (UTF-16 LE)
+    uint16_t hash = 0;
+    for (const char* p = name; *p; ++p) {
+        uint16_t ch = to_upper((uint8_t)*p);
+        hash = (uint16_t)(((hash & 1) ? 0x8000 : 0) + (hash >> 1) + (ch & 0xFF));
+        hash = (uint16_t)(((hash & 1) ? 0x8000 : 0) + (hash >> 1) + (ch >> 8));
+    }
+    return hash;
+}
+
+bool ExFAT::find_in_directory(const ExFAT_Extent& dir, const char* name, DirEntrySet& out) {
+    const uint16_t hash = name_hash(name);
+    const size_t len = strlen(name);
+    bool found = false;
+    scan_directory(dir, [&](const DirEntrySet& set) {
+        // Rejet rapide par le hash avant la comparaison caractère par caractère
+        if (set.name_hash != hash || set.name.size() != len) return true;
+        for (size_t i = 0; i < len; ++i) {
+            if (to_upper((uint8_t)set.name[i]) != to_upper((uint8_t)name[i])) return true;
+        }
+        out = set;
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+bool ExFAT::resolve_path(const char* path, DirEntrySet& out) {
+    ExFAT_Extent dir = current_dir;
+    const char* p = path;
+    if (*p == '/') {
+        dir = ExFAT_Extent();
+        dir.first_cluster = root_dir_cluster;
+        ++p;
+    }
+
+    // Chemin vide ou "/": le répertoire de départ lui-même
+    out = DirEntrySet();
+    out.attributes = ExFAT_Config::ATTR_DIRECTORY;
+    out.data = dir;
+
+    char path_buf[FAT32_Config::MAX_PATH_LENGTH + 1];
+    strncpy(path_buf, p, sizeof(path_buf) - 1);
+    path_buf[sizeof(path_buf) - 1] = '\0';
+
+    char* ctx = nullptr;
+    for (char* token = strtok_r(path_buf, "/", &ctx); token; token = strtok_r(nullptr, "/", &ctx)) {
+        if (strcmp(token, ".") == 0) continue;
+        if (!(out.attributes & ExFAT_Config::ATTR_DIRECTORY)) return false;
+        // exFAT ne stocke pas d'entrées "." / ".." : pas de remontée sans pile de chemins
+        if (strcmp(token, "..") == 0) return false;
+        if (!find_in_directory(out.data, token, out)) return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// OPÉRATIONS FICHIERS (LECTURE SEULE)
+// ============================================================================
+
+FAT_ErrorCode ExFAT::file_open(const char* filename, FileFunction function, ReadHandler& handler) {
+    if (!mounted || !filename || !*filename) return FILE_NOT_FOUND;
+    if (function != READ) {
+        printf("exFAT  Volume en lecture seule\n");
+        return FILE_NOT_FOUND;
+    }
+
+    DirEntrySet set;
+    if (!resolve_path(filename, set)) return FILE_NOT_FOUND;
+    if (set.attributes & ExFAT_Config::ATTR_DIRECTORY) return FILE_NOT_FOUND;
+
+    // Les tailles > 4 Go ne sont pas représentables dans le ReadHandler
+    handler.Dir_Entry = 0;
+    handler.File_Size = (set.data.length > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)set.data.length;
+    handler.FAT_Entry = set.data.first_cluster;
+    handler.SectorOffset = 0;
+    handler.NoFatChain = set.data.no_fat_chain;
+    if (handler.File_Size > 0 && handler.FAT_Entry < 2) return ERROR_READ_FAIL;
+    return FILE_FOUND;
+}
+
+uint16_t ExFAT::file_read(uint8_t* buffer, ReadHandler* handler) {
+    if (!mounted || !buffer || !handler || handler->File_Size == 0) return 0;
+
+    uint16_t bytes_to_read = FAT_Config::SECTOR_SIZE;
+    if (handler->File_Size < bytes_to_read) bytes_to_read = (uint16_t)handler->File_Size;
+
+    uint32_t lba = cluster_to_lba(handler->FAT_Entry) + handler->SectorOffset;
+    if (bytes_to_read == FAT_Config::SECTOR_SIZE) {
+        if (!sd_card->read_block(lba, buffer)) return 0;
+    } else {
+        if (!sd_card->read_block(lba, read_buffer)) return 0;
+        memcpy(buffer, read_buffer, bytes_to_read);
+    }
+
+    handler->File_Size -= bytes_to_read;
+    handler->SectorOffset++;
+
+    if (handler->SectorOffset >= sectors_per_cluster) {
+        handler->SectorOffset = 0;
+        if (handler->File_Size > 0) {
+            handler->FAT_Entry = next_cluster(handler->FAT_Entry, handler->NoFatChain);
+            if (handler->FAT_Entry < 2 || handler->FAT_Entry > cluster_count + 1) {
+                handler->File_Size = 0;  // chaîne corrompue: EOF
+            }
+        }
+    }
+    return bytes_to_read;
+}
+
+uint32_t ExFAT::file_run(const ReadHandler& handler, uint32_t max_sectors, uint32_t& lba, ReadHandler& next) {
+    next = handler;
+    const uint32_t want = std::min<uint32_t>(max_sectors, handler.File_Size / FAT_Config::SECTOR_SIZE);
+    if (!mounted || want == 0 || handler.FAT_Entry < 2 || handler.FAT_Entry > cluster_count + 1) return 0;
+
+    // Même avance que file_read(), cluster par cluster, sans lire les données
+    lba = cluster_to_lba(handler.FAT_Entry) + handler.SectorOffset;
+    uint32_t run = 0;
+    while (run < want) {
+        const uint32_t take = std::min<uint32_t>(sectors_per_cluster - next.SectorOffset, want - run);
+        run += take;
+        next.SectorOffset += take;
+        next.File_Size -= take * FAT_Config::SECTOR_SIZE;
+        if (next.SectorOffset < sectors_per_cluster) break;
+
+        next.SectorOffset = 0;
+        if (next.File_Size == 0) break;
+        const uint32_t cluster = next.FAT_Entry;
+        next.FAT_Entry = next_cluster(cluster, next.NoFatChain);
+        if (next.FAT_Entry < 2 || next.FAT_Entry > cluster_count + 1) {
+            next.File_Size = 0;  // chaîne corrompue: EOF
+            break;
+        }
+        if (next.FAT_Entry != cluster + 1) break;   // cluster non contigu: fin de la plage
+    }
+    return run;
+}
+
+FAT_ErrorCode ExFAT::list_directory(std::vector<FileListEntry>& file_list) {
+    file_list.clear();
+    if (!mounted) return ERROR_READ_FAIL;
+    file_list.reserve(32);
+
+    bool ok = scan_directory(current_dir, [&](const DirEntrySet& set) {
+        FileListEntry entry;
+        bool is_dir = (set.attributes & ExFAT_Config::ATTR_DIRECTORY) != 0;
+        entry.longFileName = set.name;
+        entry.hasLongName = true;
+        strncpy(entry.dosFileName, set.name.c_str(), sizeof(entry.dosFileName) - 1);
+        entry.type = is_dir ? _Directory : _File;
+        entry.size = is_dir ? 0 : (uint32_t)set.data.length;
+        entry.attributes = (uint8_t)set.attributes;
+        entry.creationTime = (uint16_t)(set.created & 0xFFFF);
+        entry.creationDate = (uint16_t)(set.created >> 16);
+        entry.modificationTime = (uint16_t)(set.modified & 0xFFFF);
+        entry.modificationDate = (uint16_t)(set.modified >> 16);
+        entry.firstCluster = set.data.first_cluster;
+        file_list.push_back(entry);
+        return true;
+    });
+    return ok ? ERROR_IDLE : ERROR_READ_FAIL;
+}
+
+bool ExFAT::change_directory(const char* dir_name) {
+    if (!mounted || !dir_name || !*dir_name) return false;
+
+    DirEntrySet set;
+    if (!resolve_path(dir_name, set)) return false;
+    if (!(set.attributes & ExFAT_Config::ATTR_DIRECTORY)) return false;
+    current_dir = set.data;
+    return true;
+}
+
+bool ExFAT::push_directory(const char* dir_name) {
+    if (!mounted || !dir_name || !*dir_name) return false;
+    if (dir_stack_depth >= FAT_Config::DIR_STACK_DEPTH) return false;
+
+    ExFAT_Extent saved = current_dir;
+    if (!change_directory(dir_name)) return false;
+    dir_stack[dir_stack_depth++] = saved;
+    return true;
+}
+
+bool ExFAT::pop_directory() {
+    if (!mounted || dir_stack_depth == 0) return false;
+    current_dir = dir_stack[--dir_stack_depth];
+    return true;
+}
+
+// ============================================================================
+// INFORMATIONS VOLUME
+// ============================================================================
+
+uint32_t ExFAT::count_free_clusters() {
+    if (!mounted) return 0;
+
+    // Un bit par cluster dans le bitmap d'allocation (bit 0 = cluster 2)
+    uint32_t used = 0;
+    uint32_t bits_left = cluster_count;
+    uint32_t cluster = bitmap_extent.first_cluster;
+    while (bits_left > 0 && cluster >= 2 && cluster <= cluster_count + 1) {
+        for (uint32_t sec = 0; sec < sectors_per_cluster && bits_left > 0; ++sec) {
+            if (!sd_card->read_block(cluster_to_lba(cluster) + sec, read_buffer)) {
+                printf("exFAT  Erreur lecture bitmap\n");
+                return 0;
+            }
+            for (uint16_t i = 0; i < FAT_Config::SECTOR_SIZE && bits_left > 0; ++i) {
+                uint8_t b = read_buffer[i];
+                if (bits_left < 8) b &= (uint8_t)((1u << bits_left) - 1);
+                used += (uint32_t)__builtin_popcount(b);
+                bits_left = (bits_left >= 8) ? bits_left - 8 : 0;
+            }
+        }
+        cluster = fat_next(cluster);
+    }
+    return cluster_count - used;
+}
+
+void ExFAT::print_info() {
+    printf("=== Informations exFAT ===\n");
+    printf("Label = %s\n", volume_label[0] ? volume_label : "(aucun)");
+    printf("VolumeLBA = %lu\n", (unsigned long)volume_lba);
+    printf("FatLBA = %lu\n", (unsigned long)fat_lba);
+    printf("ClusterHeapLBA = %lu\n", (unsigned long)heap_lba);
+    printf("ClusterCount = %lu\n", (unsigned long)cluster_count);
+    printf("SectorsPerCluster = %lu\n", (unsigned long)sectors_per_cluster);
+    printf("RootCluster = %lu\n", (unsigned long)root_dir_cluster);
+    printf("Bitmap = cluster %lu (%lu octets)\n",
+           (unsigned long)bitmap_extent.first_cluster, (unsigned long)bitmap_extent.length);
+    printf("UpCase = cluster %lu (%lu octets)\n",
+           (unsigned long)upcase_extent.first_cluster, (unsigned long)upcase_extent.length);
+}
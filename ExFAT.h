@@ -0,0 +1,174 @@
+#pragma once
+
+/*
+ * ExFAT - Pilote de volume exFAT (lecture seule)
+ *
+ * Les cartes SDXC (64 Go et plus) sont livrées formatées en exFAT.
+ * Ce pilote est monté par FAT32::init lorsque le secteur de boot porte
+ * la signature "EXFAT   " ; FAT32 lui délègue alors la navigation,
+ * le listing et la lecture des fichiers (même chemin de lecture que
+ * AnimationPlayer::read_frame_from_file).
+ *
+ * - Lecture du bitmap d'allocation (comptage de l'espace libre)
+ * - Lecture et vérification de la table up-case (comparaison de noms)
+ * - Respect du flag NoFatChain : un fichier contigu est lu par pure
+ *   arithmétique LBA, sans aucune consultation de la FAT
+ */
+
+#include "pico/stdlib.h"
+#include "FAT32.h"
+#include <string>
+#include <vector>
+#include <functional>
+
+// Forward declaration
+class SDCard;
+
+namespace ExFAT_Config {
+    // Types d'entrées de répertoire exFAT
+    static constexpr uint8_t ENTRY_END_OF_DIR   = 0x00;
+    static constexpr uint8_t ENTRY_BITMAP       = 0x81;
+    static constexpr uint8_t ENTRY_UPCASE       = 0x82;
+    static constexpr uint8_t ENTRY_VOLUME_LABEL = 0x83;
+    static constexpr uint8_t ENTRY_FILE         = 0x85;
+    static constexpr uint8_t ENTRY_STREAM       = 0xC0;
+    static constexpr uint8_t ENTRY_FILE_NAME    = 0xC1;
+    static constexpr uint8_t ENTRY_IN_USE       = 0x80;
+
+    // Flags secondaires (entrée Stream Extension)
+    static constexpr uint8_t FLAG_ALLOCATION_POSSIBLE = 0x01;
+    static constexpr uint8_t FLAG_NO_FAT_CHAIN        = 0x02;
+
+    // Attributs de fichiers (identiques à FAT)
+    static constexpr uint16_t ATTR_DIRECTORY = 0x0010;
+
+    // Valeurs FAT
+    static constexpr uint32_t CLUSTER_BAD = 0xFFFFFFF7;
+    static constexpr uint32_t CLUSTER_EOC = 0xFFFFFFFF;
+
+    // Nombre de caractères de la table up-case conservés en RAM (Latin-1)
+    static constexpr uint16_t UPCASE_CACHED_CHARS = 256;
+    static constexpr uint16_t CHARS_PER_NAME_ENTRY = 15;
+}
+
+// Boot sector exFAT (offsets selon la spécification Microsoft)
+struct ExFAT_BootSector {
+    uint8_t  jump[3];                   // 0x00
+    char     fs_name[8];                // 0x03: "EXFAT   "
+    uint8_t  must_be_zero[53];          // 0x0B
+    uint64_t partition_offset;          // 0x40
+    uint64_t volume_length;             // 0x48
+    uint32_t fat_offset;                // 0x50
+    uint32_t fat_length;                // 0x54
+    uint32_t cluster_heap_offset;       // 0x58
+    uint32_t cluster_count;             // 0x5C
+    uint32_t root_dir_cluster;          // 0x60
+    uint32_t volume_serial;             // 0x64
+    uint16_t fs_revision;               // 0x68
+    uint16_t volume_flags;              // 0x6A
+    uint8_t  bytes_per_sector_shift;    // 0x6C
+    uint8_t  sectors_per_cluster_shift; // 0x6D
+    uint8_t  number_of_fats;            // 0x6E
+    uint8_t  drive_select;              // 0x6F
+    uint8_t  percent_in_use;            // 0x70
+} __attribute__((packed));
+
+// Localisation d'un répertoire ou d'un fichier exFAT
+struct ExFAT_Extent {
+    uint32_t first_cluster;
+    uint64_t length;         // DataLength en octets
+    bool     no_fat_chain;   // Clusters contigus, FAT non maintenue
+
+    ExFAT_Extent() : first_cluster(0), length(0), no_fat_chain(false) {}
+};
+
+class ExFAT {
+private:
+    SDCard* sd_card;
+    bool mounted;
+
+    // Géométrie du volume
+    uint32_t volume_lba;
+    uint32_t fat_lba;
+    uint32_t heap_lba;
+    uint32_t cluster_count;
+    uint8_t  sectors_per_cluster_shift;
+    uint32_t sectors_per_cluster;
+    uint32_t root_dir_cluster;
+
+    // Métadonnées lues depuis le répertoire racine
+    ExFAT_Extent bitmap_extent;
+    ExFAT_Extent upcase_extent;
+    uint32_t upcase_table_checksum;
+    uint16_t upcase[ExFAT_Config::UPCASE_CACHED_CHARS];
+    char volume_label[23];
+
+    // Répertoire courant et répertoires sauvegardés par push_directory()
+    ExFAT_Extent current_dir;
+    ExFAT_Extent dir_stack[FAT_Config::DIR_STACK_DEPTH];
+    uint8_t dir_stack_depth;
+
+    // Buffers secteur
+    uint8_t read_buffer[512];
+    uint32_t fat_cache_sector;              // LBA du secteur FAT en cache ou 0xFFFFFFFF
+    uint8_t  fat_cache[512];
+
+    uint32_t cluster_to_lba(uint32_t cluster) const {
+        return heap_lba + ((cluster - 2) << sectors_per_cluster_shift);
+    }
+    uint32_t fat_next(uint32_t cluster);
+    uint32_t next_cluster(uint32_t cluster, bool no_fat_chain);
+
+    // Parcours d'un répertoire: callback sur chaque ensemble d'entrées "fichier"
+    struct DirEntrySet {
+        uint16_t attributes;
+        uint32_t modified;       // Horodatage DOS (date << 16 | time)
+        uint32_t created;
+        ExFAT_Extent data;
+        uint16_t name_hash;
+        std::string name;
+    };
+    // Le callback retourne false pour interrompre le parcours
+    bool scan_directory(const ExFAT_Extent& dir, const std::function<bool(const DirEntrySet&)>& visit);
+    bool scan_root_metadata();
+    bool load_upcase_table();
+    bool find_in_directory(const ExFAT_Extent& dir, const char* name, DirEntrySet& out);
+    bool resolve_path(const char* path, DirEntrySet& out);
+
+    uint16_t to_upper(uint16_t ch) const {
+        return (ch < ExFAT_Config::UPCASE_CACHED_CHARS) ? upcase[ch] : ch;
+    }
+    uint16_t name_hash(const char* name) const;
+
+public:
+    explicit ExFAT(SDCard* sd);
+
+    // Montage depuis le LBA du secteur de boot exFAT
+    bool mount(uint32_t boot_lba);
+    bool is_mounted() const { return mounted; }
+    static bool is_exfat_boot_sector(const uint8_t* sector);
+
+    // Opérations déléguées par FAT32 (lecture seule)
+    FAT_ErrorCode file_open(const char* filename, FileFunction function, ReadHandler& handler);
+    uint16_t file_read(uint8_t* buffer, ReadHandler* handler);
+    // Plage de secteurs pleins consécutifs sur la carte à partir de la position
+    // du handler (au plus max_sectors): premier LBA dans 'lba', position après
+    // la plage dans 'next'. NoFatChain: jusqu'à max_sectors par arithmétique;
+    // sinon la chaîne FAT s'arrête au premier cluster non contigu. 0 en fin de fichier.
+    uint32_t file_run(const ReadHandler& handler, uint32_t max_sectors, uint32_t& lba, ReadHandler& next);
+    FAT_ErrorCode list_directory(std::vector<FileListEntry>& file_list);
+    bool change_directory(const char* dir_name);
+    bool push_directory(const char* dir_name);
+    bool pop_directory();
+    uint32_t get_current_dir_cluster() const { return current_dir.first_cluster; }
+
+    // Informations volume
+    uint32_t count_free_clusters();
+    uint32_t get_cluster_count() const { return cluster_count; }
+    uint32_t get_cluster_bytes() const { return sectors_per_cluster * 512u; }
+    uint32_t get_sectors_per_cluster() const { return sectors_per_cluster; }
+    uint32_t get_heap_lba() const { return heap_lba; }
+    uint32_t get_fat_lba() const { return fat_lba; }
+    uint32_t get_root_dir_cluster() const { return root_dir_cluster; }
+    void print_info();
+};
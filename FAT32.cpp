@@ -1,6 +1,7 @@
 #include "FAT32.h"
 #include "SDCard.h"
 #include "FAT32_Structures.h"
+#include "ExFAT.h"
 #include <cstdio>
 #include <cstring>
 #include <cctype>
@@ -23,10 +24,44 @@ namespace FAT_Utils {
     };
 }
 
+// Date/heure FAT <-> secondes depuis le 1er janvier 1980 (pas de 2 s).
+// Une date invalide (mois 0, entrée jamais horodatée) vaut 0.
+static const uint16_t FAT_DAYS_BEFORE_MONTH[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+static uint32_t fat_stamp_seconds(uint16_t date, uint16_t time) {
+    const uint32_t year = date >> 9, month = (date >> 5) & 0x0F, day = date & 0x1F;
+    if (month < 1 || month > 12 || day < 1) return 0;
+    // 1980 est bissextile: années bissextiles passées = (year + 3) / 4
+    uint32_t days = year * 365 + (year + 3) / 4 + FAT_DAYS_BEFORE_MONTH[month - 1] + day - 1;
+    if (month > 2 && (year % 4) == 0) days++;
+    return days * 86400u + (time >> 11) * 3600u + ((time >> 5) & 0x3F) * 60u + (time & 0x1F) * 2u;
+}
+
+static void fat_stamp_from_seconds(uint32_t seconds, uint16_t& date, uint16_t& time) {
+    uint32_t days = seconds / 86400u;
+    const uint32_t rem = seconds % 86400u;
+    time = (uint16_t)((rem / 3600u) << 11 | ((rem / 60u) % 60u) << 5 | (rem % 60u) / 2u);
+    uint32_t year = 0;
+    for (;;) {
+        const uint32_t in_year = (year % 4 == 0) ? 366 : 365;
+        if (days < in_year) break;
+        days -= in_year;
+        year++;
+    }
+    uint32_t month = 12;
+    while (month > 1) {
+        const uint32_t before = FAT_DAYS_BEFORE_MONTH[month - 1] + ((month > 2 && year % 4 == 0) ? 1 : 0);
+        if (days >= before) { days -= before; break; }
+        month--;
+    }
+    date = (uint16_t)(year << 9 | month << 5 | (days + 1));
+}
+
 FAT32::FAT32(SDCard* sd) 
     : sd_card(sd), initialized(false), sectors_per_fat(0), fat_size(0),
       sectors_in_partition(0), sector_size(512), cluster_size(0),
-            fat_base(0), root_base(0), data_base(0), main_offset(0), last_cluster(0) {
+            fat_base(0), root_base(0), data_base(0), main_offset(0), last_cluster(0), fat_count(0),
+      io_(sd) {
     memset(read_buffer, 0, sizeof(read_buffer));
     memset(write_buffer, 0, sizeof(write_buffer));
     memset(&master_boot, 0, sizeof(master_boot));
@@ -34,9 +69,13 @@ FAT32::FAT32(SDCard* sd)
         fat_cache_sector = 0xFFFFFFFFu;
         fat_cache_valid = false;
         memset(fat_cache, 0, sizeof(fat_cache));
+    memset(dir_stack_, 0, sizeof(dir_stack_));
+    dir_cache_invalidate();
 }
 
 FAT32::~FAT32() {
+    io_.flush();
+    delete exfat_;
 }
 
 bool FAT32::init() {
@@ -54,9 +93,16 @@ bool FAT32::init() {
     }
     
     initialized = true;
-    printf("FAT32  Système initialisé avec succès\n");
+    printf(exfat_ ? "exFAT  Système initialisé avec succès (lecture seule)\n"
+                  : "FAT32  Système initialisé avec succès\n");
     // Démarrer dans le répertoire racine
     current_dir_cluster_ = root_dir_first_cluster;
+    dir_stack_depth_ = 0;
+    dir_cache_invalidate();
+    discard_count_ = 0;
+    discarded_blocks_ = 0;
+    au_placement_ = false;
+    au_search_hint_ = 0;
     
     // Afficher les informations
     view_fat_infos();
@@ -88,11 +134,11 @@ bool FAT32::read_master_block() {
 
     uint32_t bpb_lba = 0;
     if (!looks_like_bpb) {
-        // MBR: chercher partition FAT32 (type 0x0B ou 0x0C)
+        // MBR: chercher partition FAT32 (type 0x0B ou 0x0C) ou exFAT (type 0x07)
         const uint8_t* p = read_buffer + 0x1BE;
         for (int i = 0; i < 4; i++, p += 16) {
             uint8_t ptype = p[4];
-            if (ptype == 0x0B || ptype == 0x0C) {
+            if (ptype == 0x0B || ptype == 0x0C || ptype == 0x07) {
                 uint32_t start_lba = (uint32_t)p[8] | ((uint32_t)p[9] << 8) | ((uint32_t)p[10] << 16) | ((uint32_t)p[11] << 24);
                 bpb_lba = start_lba;
                 break;
@@ -121,6 +167,27 @@ bool FAT32::read_master_block() {
         printf("BPB: opcode de saut inattendu (0x%02X 0x%02X 0x%02X)\n", read_buffer[0], read_buffer[1], read_buffer[2]);
     }
 
+    // Volume exFAT (cartes SDXC): délégation au pilote ExFAT
+    if (ExFAT::is_exfat_boot_sector(read_buffer)) {
+        printf("FAT32  Volume exFAT détecté à LBA %lu\n", (unsigned long)bpb_lba);
+        memset(&master_boot, 0, sizeof(master_boot));
+        memcpy(master_boot.OEMName, read_buffer + 3, sizeof(master_boot.OEMName));
+        if (!exfat_) exfat_ = new ExFAT(sd_card);
+        if (!exfat_->mount(bpb_lba)) {
+            delete exfat_;
+            exfat_ = nullptr;
+            return false;
+        }
+        main_offset = bpb_lba;
+        sector_size = FAT_Config::SECTOR_SIZE;
+        root_dir_first_cluster = exfat_->get_root_dir_cluster();
+        return true;
+    }
+    if (exfat_) {
+        delete exfat_;
+        exfat_ = nullptr;
+    }
+
     // Parser BPB via structure canonique
     FAT32_BootRecord bpb{};
     memcpy(&bpb, read_buffer, sizeof(FAT32_BootRecord));
@@ -136,6 +203,7 @@ bool FAT32::read_master_block() {
     sectors_per_fat = fatsz;
     sectors_in_partition = tot_sec;
     fat_base = main_offset + bpb.reserved_sectors;
+    fat_count = bpb.fat_count;
     root_dir_first_cluster = bpb.root_cluster;
 
     // Calcul secteurs data
@@ -175,6 +243,10 @@ bool FAT32::read_master_block() {
 }
 
 void FAT32::view_fat_infos() {
+    if (exfat_) {
+        exfat_->print_info();
+        return;
+    }
     printf("=== Informations FAT ===\n");
     printf("OEM NAME = %.8s\n", master_boot.OEMName);
     printf("BytesPerSector = %d\n", master_boot.BytesPerSector);
@@ -196,17 +268,19 @@ void FAT32::view_global_fat_variables() {
     printf("=== Variables FAT Calculées ===\n");
     printf("FAT_Cluster_Size = %d\n", cluster_size);
     printf("FAT_Sector_Size = %d\n", sector_size);
-    printf("FAT_FAT_BASE = %d\n", fat_base);
-    printf("FAT_Root_BASE = %d (FAT32 utilise RootCluster=%lu)\n", root_base, (unsigned long)root_dir_first_cluster);
-    printf("FAT_Data_BASE = %d\n", data_base);
+    printf("FAT_FAT_BASE = %lu\n", (unsigned long)fat_base);
+    printf("FAT_Root_BASE = %lu (FAT32 utilise RootCluster=%lu)\n", (unsigned long)root_base, (unsigned long)root_dir_first_cluster);
+    printf("FAT_Data_BASE = %lu\n", (unsigned long)data_base);
     printf("SectorsInPartition = %ld\n", sectors_in_partition);
     printf("SectorsPerFAT = %ld\n", sectors_per_fat);
     printf("FirstDataSector = %lu\n", (unsigned long)first_data_sector);
-    printf("Last_Cluster = %d\n", last_cluster);
+    printf("Last_Cluster = %lu\n", (unsigned long)last_cluster);
+    printf("FatCopies = %u\n", (unsigned)fat_count);
 }
 
 
 FAT_ErrorCode FAT32::list_directory(std::vector<FileListEntry>& file_list) {
+    if (exfat_) return exfat_->list_directory(file_list);
     file_list.clear();
     file_list.reserve(32);
 
@@ -218,7 +292,7 @@ FAT_ErrorCode FAT32::list_directory(std::vector<FileListEntry>& file_list) {
     while (cluster < FAT32_Cluster::EOC_MIN && !end_of_dir && error_code == ERROR_IDLE) {
         for (uint16_t sec = 0; sec < cluster_size; ++sec) {
             uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
-            if (!get_physical_block(lba, read_buffer)) {
+            if (!read_dir_sector(lba)) {
                 printf("Erreur lecture secteur %lu\n", (unsigned long)lba);
                 return ERROR_READ_FAIL;
             }
@@ -235,24 +309,7 @@ FAT_ErrorCode FAT32::list_directory(std::vector<FileListEntry>& file_list) {
                     case _File:
                     case _Directory: {
                         FileListEntry file_entry;
-                        if (LfnFlag) {
-                            file_entry.longFileName = lfn_buffer;
-                            file_entry.hasLongName = true;
-                            lfn_buffer.clear();
-                        } else {
-                            strncpy(file_entry.dosFileName, fn_buffer.c_str(), sizeof(file_entry.dosFileName)-1);
-                            file_entry.dosFileName[sizeof(file_entry.dosFileName)-1] = '\0';
-                            file_entry.hasLongName = false;
-                        }
-                        file_entry.type = type;
-                        file_entry.size = (type == _File) ? entry.SizeofFile : 0;
-                        // Fill additional metadata for advanced listings
-                        file_entry.attributes = entry.Attributes;
-                        file_entry.creationTime = entry.CreationTime;
-                        file_entry.creationDate = entry.CreationDate;
-                        file_entry.modificationTime = entry.ModificationTime;
-                        file_entry.modificationDate = entry.ModificationDate;
-                        file_entry.firstCluster = ((uint32_t)entry.FirstClusterHigh << 16) | (uint32_t)entry.FirstClusterNumber;
+                        fill_list_entry(entry, type, LfnFlag, file_entry);
                         file_list.push_back(file_entry);
                         LfnFlag = false;
                         break;
@@ -277,6 +334,105 @@ FAT_ErrorCode FAT32::list_directory(std::vector<FileListEntry>& file_list) {
 }
 
 
+void FAT32::fill_list_entry(const root_Entries& entry, FileEntryType type, bool lfn, FileListEntry& out) {
+    if (lfn) {
+        out.longFileName = lfn_buffer;
+        out.hasLongName = true;
+        out.dosFileName[0] = '\0';
+        lfn_buffer.clear();
+    } else {
+        strncpy(out.dosFileName, fn_buffer.c_str(), sizeof(out.dosFileName)-1);
+        out.dosFileName[sizeof(out.dosFileName)-1] = '\0';
+        out.longFileName.clear();
+        out.hasLongName = false;
+    }
+    out.type = type;
+    out.size = (type == _File) ? entry.SizeofFile : 0;
+    // Fill additional metadata for advanced listings
+    out.attributes = entry.Attributes;
+    out.creationTime = entry.CreationTime;
+    out.creationDate = entry.CreationDate;
+    out.modificationTime = entry.ModificationTime;
+    out.modificationDate = entry.ModificationDate;
+    out.firstCluster = ((uint32_t)entry.FirstClusterHigh << 16) | (uint32_t)entry.FirstClusterNumber;
+}
+
+// ===== PARCOURS INDEXÉ =====
+bool FAT32::dir_iterator_open(DirIterator& it) {
+    if (!initialized || exfat_) return false;
+    it.dir_cluster = current_dir_cluster_ ? current_dir_cluster_ : root_dir_first_cluster;
+    it.next = DirCursor{it.dir_cluster, 0, 0};
+    it.next_index = 0;
+    it.at_end = false;
+    it.checkpoint_count = 0;
+    it.step = FAT_Config::DIR_ITER_STEP;
+    return true;
+}
+
+bool FAT32::dir_iterator_read(DirIterator& it, uint32_t index, FileListEntry& out) {
+    if (!initialized || exfat_ || it.dir_cluster < 2) return false;
+
+    // Repositionnement: en arrière, ou plus loin que le prochain point de reprise
+    if (index < it.next_index || index - it.next_index >= it.step) {
+        uint32_t k = index / it.step;
+        if (k >= it.checkpoint_count) k = it.checkpoint_count ? it.checkpoint_count - 1u : 0u;
+        if (it.checkpoint_count && (index < it.next_index || k * it.step > it.next_index)) {
+            it.next = it.checkpoints[k];
+            it.next_index = k * it.step;
+            it.at_end = false;
+        }
+    }
+    if (it.at_end) return false;
+
+    uint32_t loaded_lba = 0;
+    bool lfn_flag = false;
+    lfn_buffer.clear();
+    for (;;) {
+        // Début d'une entrée logique: point de reprise (la table pleine garde un point sur deux)
+        if (!lfn_flag && it.next_index % it.step == 0 && it.next_index / it.step == it.checkpoint_count) {
+            if (it.checkpoint_count == FAT_Config::DIR_ITER_CHECKPOINTS) {
+                for (uint16_t i = 0; i < FAT_Config::DIR_ITER_CHECKPOINTS / 2; ++i) it.checkpoints[i] = it.checkpoints[i * 2];
+                it.checkpoint_count = FAT_Config::DIR_ITER_CHECKPOINTS / 2;
+                it.step *= 2;
+            }
+            if (it.next_index % it.step == 0 && it.next_index / it.step == it.checkpoint_count) {
+                it.checkpoints[it.checkpoint_count++] = it.next;
+            }
+        }
+
+        const uint32_t lba = data_base + ((it.next.cluster - 2) * cluster_size) + it.next.sector;
+        if (lba != loaded_lba) {
+            if (!read_dir_sector(lba)) return false;
+            loaded_lba = lba;
+        }
+        root_Entries& entry = reinterpret_cast<root_Entries*>(read_buffer)[it.next.index];
+        if (entry.FileName[0] == FAT_Config::FILE_CLEAR) {
+            it.at_end = true;
+            return false;
+        }
+        const FileEntryType type = fat_filename_parser(&entry);
+        bool found = false;
+        if (type == _LongFileNameOK) {
+            lfn_flag = true;
+        } else if (type == _File || type == _Directory) {
+            // Copie avant d'avancer: passer au cluster suivant lit la FAT
+            found = (it.next_index++ == index);
+            if (found) fill_list_entry(entry, type, lfn_flag, out);
+            lfn_flag = false;
+            lfn_buffer.clear();
+        }
+        if (!dir_cursor_advance(it.next)) it.at_end = true;
+        if (found) return true;
+        if (it.at_end) return false;
+    }
+}
+
+uint32_t FAT32::dir_iterator_count(DirIterator& it) {
+    FileListEntry entry;
+    while (dir_iterator_read(it, it.next_index, entry)) {}
+    return it.at_end ? it.next_index : 0;
+}
+
 FileEntryType FAT32::fat_filename_parser(root_Entries* dir_entry) {
     // Keep LFN buffer across calls; only clear it when a new LFN sequence starts.
     fn_buffer.clear();
@@ -338,11 +494,15 @@ FileEntryType FAT32::fat_filename_parser(root_Entries* dir_entry) {
 }
 
 bool FAT32::get_physical_block(uint32_t block_num, uint8_t* buffer) {
-    return sd_card->read_block(block_num, buffer);
+    return io_.read(block_num, buffer);
 }
 
 bool FAT32::store_physical_block(uint32_t block_num, const uint8_t* buffer) {
-    return sd_card->write_block(block_num, buffer);
+    return io_.write(block_num, buffer);
+}
+
+bool FAT32::flush() {
+    return io_.flush();
 }
 
 // Byte swap helpers (not strictly needed on little-endian RP2040, but kept for completeness)
@@ -354,357 +514,575 @@ uint16_t FAT32::byte_swap(uint16_t data) {
     return (uint16_t)((data << 8) | (data >> 8));
 }
 
-struct DirPos { uint32_t cluster; uint32_t lba; uint16_t index; };
+bool FAT32::dir_cursor_advance(DirCursor& cursor) {
+    const uint16_t ents = sector_size / sizeof(root_Entries);
+    if (++cursor.index < ents) return true;
+    cursor.index = 0;
+    if (++cursor.sector < cluster_size) return true;
+    cursor.sector = 0;
+    uint32_t next = fat_entry(cursor.cluster, 0, false);
+    if (next < 2 || next >= FAT32_Cluster::EOC_MIN) return false;
+    cursor.cluster = next;
+    return true;
+}
 
-FAT_ErrorCode FAT32::file_open(const char* filename, FileFunction function) {
-    if (!initialized || !filename || !*filename) {
-        return FILE_NOT_FOUND;
+bool FAT32::erase_dir_entries(DirCursor start, uint16_t count) {
+    DirCursor cur = start;
+    uint32_t loaded_lba = 0;
+    for (uint16_t n = 0; n < count; ++n) {
+        uint32_t lba = data_base + ((cur.cluster - 2) * cluster_size) + cur.sector;
+        if (lba != loaded_lba) {
+            if (loaded_lba != 0 && !store_physical_block(loaded_lba, read_buffer)) return false;
+            if (!get_physical_block(lba, read_buffer)) return false;
+            loaded_lba = lba;
+        }
+        ((root_Entries*)read_buffer)[cur.index].FileName[0] = FAT_Config::FILE_ERASED;
+        if (n + 1 < count && !dir_cursor_advance(cur)) break;
     }
+    return loaded_lba == 0 || store_physical_block(loaded_lba, read_buffer);
+}
 
-    // Start from root if absolute path, else from current directory
-    uint32_t dir_cluster = root_dir_first_cluster;
-    const char* p = filename;
-    if (*p == '/') {
-        // absolute
-        ++p;
-    } else if (current_dir_cluster_ >= 2) {
-        dir_cluster = current_dir_cluster_;
+// Clé d'un nom 8.3 brut pour l'index de create_dir_entry() (FNV-1a)
+static uint32_t create_sfn_key(const char* raw11) {
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 11; ++i) {
+        h ^= (uint8_t)raw11[i];
+        h *= 16777619u;
     }
+    return h;
+}
 
-    // Duplicate path for tokenization
-    char path_buf[ FAT32_Config::MAX_PATH_LENGTH + 1 ];
-    strncpy(path_buf, p, sizeof(path_buf) - 1);
-    path_buf[sizeof(path_buf) - 1] = '\0';
+// Clé d'un nom long: son alias de sel 0 au numéro 'tail'. Une entrée dont
+// l'alias brut n'est pas "~1" est indexée aussi sous "~0" (numéro jamais écrit).
+static uint32_t create_long_key(const char* name, char tail) {
+    char alias[11];
+    const uint8_t tilde = FAT_Utils::make_short_alias(name, 0, alias);
+    alias[tilde + 1] = tail;
+    return create_sfn_key(alias);
+}
 
-    // Helper lambdas
-    auto is_end = [](char* t){ return t == nullptr || *t == '\0'; };
-    auto trim_dir_suffix = [](char* name){
-        size_t n = strlen(name);
-        if (n > 0 && (name[n-1] == '/' || name[n-1] == '\\')) name[n-1] = '\0';
-    };
+// Index des noms: adressage ouvert, empreinte 16 bits (0 = vide). Statique
+// (32 Ko), il appartient au dernier volume qui l'a reconstruit.
+static uint16_t g_create_index[FAT_Config::CREATE_INDEX_SLOTS];
+static const FAT32* g_create_index_owner = nullptr;
+static_assert((FAT_Config::CREATE_INDEX_SLOTS & (FAT_Config::CREATE_INDEX_SLOTS - 1)) == 0,
+              "CREATE_INDEX_SLOTS doit être une puissance de 2");
+
+// Brassage du hash FNV: case d'après les bits bas, empreinte d'après les bits hauts
+static inline uint32_t create_index_mix(uint32_t h) {
+    h ^= h >> 16; h *= 0x7feb352du;
+    h ^= h >> 15; h *= 0x846ca68bu;
+    return h ^ (h >> 16);
+}
 
-    FAT_ErrorCode result = FILE_NOT_FOUND;
+void FAT32::create_hint_reset() {
+    memset(g_create_index, 0, sizeof(g_create_index));
+    g_create_index_owner = this;
+    create_hint_.keys = 0;
+}
 
-    // Tokenize by '/'
-    char* ctx = nullptr;
-    char* token = strtok_r(path_buf, "/", &ctx);
-    if (!token) {
-        // Path was "/" or empty after '/'
-        return FILE_NOT_FOUND;
+void FAT32::create_hint_add(uint32_t hash) {
+    if (create_hint_.keys > FAT_Config::CREATE_INDEX_KEYS) return;
+    const uint32_t h = create_index_mix(hash);
+    const uint16_t fp = (uint16_t)(h >> 16) ? (uint16_t)(h >> 16) : 1;
+    for (uint32_t i = h;; ++i) {
+        uint16_t& slot = g_create_index[i & (FAT_Config::CREATE_INDEX_SLOTS - 1)];
+        if (slot == fp) return;   // clé déjà là (ou empreinte voisine: même effet)
+        if (slot == 0) {
+            // Index plein: il ne dit plus rien, comptage au-delà de la limite
+            if (++create_hint_.keys <= FAT_Config::CREATE_INDEX_KEYS) slot = fp;
+            return;
+        }
     }
+}
 
-    // Iterate components
-    while (token) {
-        // Handle '.' and '..' minimally
-        if (strcmp(token, ".") == 0) {
-            token = strtok_r(nullptr, "/", &ctx);
-            continue;
-        }
-        if (strcmp(token, "..") == 0) {
-            // Not implemented: no parent tracking without path stack
-            return FILE_NOT_FOUND;
-        }
+bool FAT32::create_hint_may_contain(uint32_t hash) const {
+    if (g_create_index_owner != this || create_hint_.keys > FAT_Config::CREATE_INDEX_KEYS) return true;
+    const uint32_t h = create_index_mix(hash);
+    const uint16_t fp = (uint16_t)(h >> 16) ? (uint16_t)(h >> 16) : 1;
+    for (uint32_t i = h;; ++i) {
+        const uint16_t slot = g_create_index[i & (FAT_Config::CREATE_INDEX_SLOTS - 1)];
+        if (slot == fp) return true;
+        if (slot == 0) return false;
+    }
+}
 
-        bool last_component = (strtok_r(nullptr, "/", &ctx) == nullptr);
-        break; // we'll re-parse with array approach below
+// Un seul trou suivi: au second effacement la prochaine création relit le répertoire
+void FAT32::create_hint_hole(uint32_t dir_cluster, DirCursor start, uint16_t count) {
+    if (create_hint_.dir_cluster != dir_cluster) return;
+    if (create_hint_.hole_len != 0) {
+        create_hint_.dir_cluster = 0;
+        return;
     }
+    create_hint_.hole = start;
+    create_hint_.hole_len = count;
+}
 
-    // Re-parse path into vector of parts
-    std::vector<std::string> parts;
-    {
-        char tmp[FAT32_Config::MAX_PATH_LENGTH + 1];
-        strncpy(tmp, p, sizeof(tmp) - 1);
-        tmp[sizeof(tmp) - 1] = '\0';
-        char* c2 = nullptr;
-        char* t2 = strtok_r(tmp, "/", &c2);
-        while (t2) {
-            if (strcmp(t2, ".") != 0 && *t2) parts.emplace_back(t2);
-            t2 = strtok_r(nullptr, "/", &c2);
+FAT_ErrorCode FAT32::create_dir_entry(uint32_t dir_cluster, const char* name, uint8_t attributes,
+                                      uint32_t first_cluster, uint32_t& sfn_lba, uint16_t& sfn_index) {
+    if (!FAT_Utils::is_valid_filename(name)) return FILE_NOT_FOUND;
+
+    char sfn[11];
+    const bool with_lfn = FAT_Utils::needs_lfn(name, sfn);
+    const size_t name_len = strlen(name);
+    const uint16_t lfn_count = with_lfn ? (uint16_t)((name_len + 12) / 13) : 0;
+    const uint16_t needed = lfn_count + 1;
+    const uint16_t ents = sector_size / sizeof(root_Entries);
+    const uint32_t per_cluster = (uint32_t)ents * cluster_size;
+
+    uint8_t tilde = 0;
+    DirCursor run_start{dir_cluster, 0, 0};
+    uint16_t run_len = 0;
+    uint32_t tail_cluster = dir_cluster;
+    bool run_at_end = false;   // la plage retenue atteint la fin du répertoire
+
+    // L'état n'est rétabli qu'en cas de succès: toute erreur le laisse invalide
+    const bool hinted = create_hint_.dir_cluster == dir_cluster;
+    create_hint_.dir_cluster = 0;
+
+    // Répertoire déjà parcouru et nom absent de l'index: ni alias "~1", ni
+    // entrée indexée sous "~0" pour ce nom (ni nom 8.3 identique). Aucun
+    // doublon possible, les entrées vont dans le trou laissé par un
+    // effacement ou en fin de répertoire
+    bool fast = false;
+    if (hinted && !create_hint_may_contain(create_long_key(name, '0')) &&
+        !create_hint_may_contain(create_long_key(name, '1'))) {
+        if (with_lfn) {
+            tilde = FAT_Utils::make_short_alias(name, 0, sfn);
         }
+        if (with_lfn || !create_hint_may_contain(create_sfn_key(sfn))) {
+            if (create_hint_.hole_len >= needed) {
+                // Entrées effacées depuis la passe: les reprendre avant d'allonger
+                fast = true;
+                run_start = create_hint_.hole;
+                run_len = needed;
+                create_hint_.hole_len = 0;
+            } else if (create_hint_.end.cluster == 0) {
+                // Chaîne pleine: tout vient de l'extension
+                fast = create_hint_.tail_cluster != 0;
+                tail_cluster = create_hint_.tail_cluster;
+                run_at_end = fast;
+            } else {
+                const DirCursor& end = create_hint_.end;
+                const uint32_t left = per_cluster - ((uint32_t)end.sector * ents + end.index);
+                // Plage à cheval sur la fin de la chaîne: il faut connaître le dernier cluster
+                fast = left >= needed || end.cluster == create_hint_.tail_cluster;
+                run_start = end;
+                run_len = (uint16_t)std::min<uint32_t>(left, needed);
+                tail_cluster = end.cluster;
+                run_at_end = fast;
+            }
+        }
+        if (!fast) run_len = 0;
     }
-    if (parts.empty()) return FILE_NOT_FOUND;
 
-    // Walk through directories to reach the parent directory of the target
-    for (size_t idx = 0; idx < parts.size(); ++idx) {
-        const bool is_last = (idx == parts.size() - 1);
-        const std::string& name = parts[idx];
-
-        // Scan the directory cluster chain
-        bool found = false;
-        uint32_t cluster = dir_cluster;
-        // State to carry LFN from preceding entries
+    // Une passe par sel de hash: en pratique une seule, le hash 30 bits
+    // du nom long rendant la collision de 9 alias quasi impossible.
+    for (uint32_t salt = 0; !fast; ++salt) {
+        if (with_lfn) {
+            if (salt >= 4) return NO_FILE_ENTRY_AVAILABLE;
+            tilde = FAT_Utils::make_short_alias(name, salt, sfn);
+        }
+        uint16_t used_tails = 0;   // bit d = alias "~d" déjà présent
+        bool found_run = false;
+        bool end_of_dir = false;
+        bool reached_tail = false;
+        DirCursor end{0, 0, 0};
+        run_len = 0;
+        run_at_end = false;
+        lfn_buffer.clear();
         bool lfn_flag = false;
-        char lfn_name[FAT_Config::MAX_LFN_CHARACTERS];
-        lfn_name[0] = '\0';
-
-        DirPos found_pos{0,0,0};
-        while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN && !found) {
-            for (uint16_t sec = 0; sec < cluster_size && !found; ++sec) {
-                uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
-                if (!get_physical_block(lba, read_buffer)) {
-                    return FILE_NOT_FOUND;
+        create_hint_reset();
+
+        DirCursor cur{dir_cluster, 0, 0};
+        uint32_t loaded_lba = 0;
+        while (true) {
+            tail_cluster = cur.cluster;
+            uint32_t lba = data_base + ((cur.cluster - 2) * cluster_size) + cur.sector;
+            if (lba != loaded_lba) {
+                if (!read_dir_sector(lba)) return ERROR_READ_FAIL;
+                loaded_lba = lba;
+            }
+            root_Entries* e = &((root_Entries*)read_buffer)[cur.index];
+            uint8_t first = e->FileName[0];
+            if (end_of_dir || first == FAT_Config::FILE_CLEAR || first == FAT_Config::FILE_ERASED) {
+                // Emplacement libre: prolonger la plage courante
+                if (!end_of_dir && first == FAT_Config::FILE_CLEAR) {
+                    end_of_dir = true;
+                    end = cur;
+                    if (!found_run) run_at_end = true;
                 }
-                root_Entries* entries = (root_Entries*)read_buffer;
-                const uint16_t ents = sector_size / sizeof(root_Entries);
-
-                for (uint16_t i = 0; i < ents; ++i) {
-                    root_Entries* e = &entries[i];
-                    if (e->FileName[0] == FAT_Config::FILE_CLEAR) {
-                        // End of directory
-                        found = false; // ensures not found
-                        break;
-                    }
-                    if (e->FileName[0] == FAT_Config::FILE_ERASED) continue;
-
-                    // Use existing parser to assemble LFN statefully
-                    FileEntryType type = fat_filename_parser(e);
-                    if (type == _LongFileNameOK) {
-                        // LFN handling: copy assembled buffer for comparison later
-                        lfn_flag = true;
-                        strncpy(lfn_name, lfn_buffer.c_str(), sizeof(lfn_name) - 1);
-                        lfn_name[sizeof(lfn_name) - 1] = '\0';
-                        // Clear the class buffer to avoid accidental reuse
-                        lfn_buffer.clear();
-                        continue;
-                    } else if (type == _LongFileNameNOK) {
-                        // continue collecting
-                        continue;
-                    } else if (type == _Error) {
-                        // skip invalid entries
-                        continue;
-                    }
-
-                    // For a normal 8.3 entry (file or directory), decide the display name
-                    char comp_name[FAT_Config::MAX_LFN_CHARACTERS];
-                    comp_name[0] = '\0';
-                    if (lfn_flag && lfn_name[0]) {
-                        strncpy(comp_name, lfn_name, sizeof(comp_name) - 1);
-                        comp_name[sizeof(comp_name) - 1] = '\0';
-                    } else {
-                        // Build DOS name (without trailing backslash for directories)
-                        if (type == _Directory) {
-                            int k = 0;
-                            for (int c = 0; c < 8 && e->FileName[c] != ' '; ++c) comp_name[k++] = (char)e->FileName[c];
-                            comp_name[k] = '\0';
-                        } else { // _File
-                            int k = 0;
-                            for (int c = 0; c < 8 && e->FileName[c] != ' '; ++c) comp_name[k++] = (char)e->FileName[c];
-                            if (e->Extension[0] != ' ') {
-                                comp_name[k++] = '.';
-                                for (int c = 0; c < 3 && e->Extension[c] != ' '; ++c) comp_name[k++] = (char)e->Extension[c];
-                            }
-                            comp_name[k] = '\0';
-                        }
+                if (!found_run) {
+                    if (run_len == 0) run_start = cur;
+                    if (++run_len >= needed) found_run = true;
+                }
+                lfn_flag = false;
+            } else {
+                if (!found_run) run_len = 0;
+                const bool is_lfn = (e->Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN;
+                FileEntryType type = (!is_lfn && (e->Attributes & FAT_Config::AT_VOLUME_ID))
+                                         ? _Error : fat_filename_parser(e);
+                if (type == _LongFileNameOK) {
+                    lfn_flag = true;
+                } else if (type == _File || type == _Directory) {
+                    // Nom déjà présent (nom long ou 8.3)
+                    std::string shown = lfn_flag ? lfn_buffer : fn_buffer;
+                    if (!shown.empty() && shown.back() == '\\') shown.pop_back();
+                    // Index: alias 8.3 brut de chaque entrée, nom long s'il existe
+                    // (un nom 8.3 affiché se retrouve par son alias brut)
+                    create_hint_add(create_sfn_key((const char*)e->FileName));
+                    if (lfn_flag && create_long_key(shown.c_str(), '1') != create_sfn_key((const char*)e->FileName)) {
+                        create_hint_add(create_long_key(shown.c_str(), '0'));
                     }
-
-                    // Reset LFN flag for the next sequence (as we consumed the SFN entry)
                     lfn_flag = false;
-                    lfn_name[0] = '\0';
-
-                    // Compare case-insensitively
-                    if (FAT_Utils::iequals(comp_name, name.c_str())) {
-                        uint32_t first_cluster = ((uint32_t)e->FirstClusterHigh << 16) | (uint32_t)e->FirstClusterNumber;
-                        if (is_last) {
-                            // Expect a file for READ
-                            found_pos = { cluster, lba, i };
-                            if (function == READ) {
-                                if ((e->Attributes & FAT_Config::AT_DIRECTORY) == 0) {
-                                    // Initialize read handler
-                                    read_handler.Dir_Entry = 0; // optional
-                                    read_handler.File_Size = e->SizeofFile;
-                                    read_handler.FAT_Entry = first_cluster;
-                                    read_handler.SectorOffset = 0;
-                                    return FILE_FOUND;
-                                } else {
-                                    // matched a directory when expecting a file
-                                    return FILE_NOT_FOUND;
-                                }
-                            } else if (function == DELETE) {
-                                if (e->Attributes & FAT_Config::AT_DIRECTORY) {
-                                    // refuse deleting directories here
-                                    return FILE_NOT_FOUND;
-                                }
-                                // free cluster chain if any
-                                uint32_t c = first_cluster;
-                                while (c >= 2 && c < FAT32_Cluster::EOC_MIN) {
-                                    uint32_t next = fat_entry(c, 0, false);
-                                    (void)fat_entry(c, FAT_Config::CLUSTER_FREE, true);
-                                    c = next;
-                                }
-                                // mark directory entry as erased
-                                root_Entries* ee = (root_Entries*)read_buffer;
-                                ee[i].FileName[0] = FAT_Config::FILE_ERASED;
-                                if (!store_physical_block(lba, (uint8_t*)ee)) {
-                                    return FILE_NOT_FOUND;
-                                }
-                                return FILE_FOUND;
-                            } else if (function == OVERWRITE || function == MODIFY) {
-                                if (e->Attributes & FAT_Config::AT_DIRECTORY) return FILE_NOT_FOUND;
-                                // Truncate for OVERWRITE; for MODIFY we keep as is (start at beginning)
-                                if (function == OVERWRITE) {
-                                    // free chain
-                                    uint32_t c = first_cluster;
-                                    while (c >= 2 && c < FAT32_Cluster::EOC_MIN) {
-                                        uint32_t next = fat_entry(c, 0, false);
-                                        (void)fat_entry(c, FAT_Config::CLUSTER_FREE, true);
-                                        c = next;
-                                    }
-                                    // set cluster to 0 and size 0
-                                    root_Entries* ee = (root_Entries*)read_buffer;
-                                    ee[i].FirstClusterHigh = 0;
-                                    ee[i].FirstClusterNumber = 0;
-                                    ee[i].SizeofFile = 0;
-                                    if (!store_physical_block(lba, (uint8_t*)ee)) return FILE_NOT_FOUND;
-                                    first_cluster = 0;
-                                }
-                                // initialize write handler
-                                write_handler.Dir_Entry = lba; // store lba for updating size
-                                write_handler.File_Size = ((root_Entries*)read_buffer)[i].SizeofFile;
-                                write_handler.BaseFatEntry = first_cluster;
-                                write_handler.CurrentFatEntry = first_cluster;
-                                write_handler.ClusterIndex = 0;
-                                write_handler.SectorIndex = 0;
-                                return FILE_FOUND;
-                            } else if (function == CREATE) {
-                                // already exists: treat as overwrite/truncate
-                                if (e->Attributes & FAT_Config::AT_DIRECTORY) return FILE_NOT_FOUND;
-                                // free chain
-                                uint32_t c = first_cluster;
-                                while (c >= 2 && c < FAT32_Cluster::EOC_MIN) {
-                                    uint32_t next = fat_entry(c, 0, false);
-                                    (void)fat_entry(c, FAT_Config::CLUSTER_FREE, true);
-                                    c = next;
-                                }
-                                root_Entries* ee = (root_Entries*)read_buffer;
-                                ee[i].FirstClusterHigh = 0;
-                                ee[i].FirstClusterNumber = 0;
-                                ee[i].SizeofFile = 0;
-                                if (!store_physical_block(lba, (uint8_t*)ee)) return FILE_NOT_FOUND;
-                                write_handler.Dir_Entry = lba;
-                                write_handler.File_Size = 0;
-                                write_handler.BaseFatEntry = 0;
-                                write_handler.CurrentFatEntry = 0;
-                                write_handler.ClusterIndex = 0;
-                                write_handler.SectorIndex = 0;
-                                return FILE_CREATE_OK;
-                            }
-                        } else {
-                            // Descend into directory if it's a directory
-                            if (e->Attributes & FAT_Config::AT_DIRECTORY) {
-                                if (first_cluster >= 2 && first_cluster < FAT32_Cluster::EOC_MIN) {
-                                    dir_cluster = first_cluster;
-                                    found = true;
-                                    break;
-                                }
-                            }
+                    if (FAT_Utils::iequals(shown.c_str(), name)) return FILE_FOUND;
+                    if (with_lfn) {
+                        // Même préfixe HHHHHH~ et même extension: noter le numéro utilisé
+                        const char* raw = (const char*)e->FileName;
+                        char d = raw[tilde + 1];
+                        if (memcmp(raw, sfn, tilde) == 0 && raw[tilde] == '~' && d >= '1' && d <= '9' &&
+                            memcmp(e->Extension, sfn + 8, 3) == 0) {
+                            used_tails |= (uint16_t)(1u << (d - '0'));
                         }
+                    } else if (memcmp(e->FileName, sfn, 11) == 0) {
+                        return FILE_FOUND;
                     }
                 }
             }
-            if (!found) {
-                uint32_t next = fat_entry(cluster, 0, false);
-                if (next >= FAT32_Cluster::EOC_MIN || next == 0) break;
-                cluster = next;
-            }
+            // Après la marque de fin, seule la plage libre importe
+            if (end_of_dir && found_run) break;
+            if (!dir_cursor_advance(cur)) { reached_tail = true; break; }
         }
 
-        if (!found && !is_last) {
-            // Intermediate directory not found
-            return FILE_NOT_FOUND;
+        if (with_lfn) {
+            uint8_t tail = 1;
+            while (tail <= 9 && (used_tails & (1u << tail))) ++tail;
+            if (tail > 9) continue;   // 9 alias pris pour ce hash: nouveau sel
+            sfn[tilde + 1] = (char)('0' + tail);
         }
-        // If this was an intermediate directory, loop continues with new dir_cluster
-        if (!parts.empty() && &name != &parts.back()) {
-            // dir_cluster already updated when found == true
-            continue;
+
+        // L'index couvre tout le répertoire jusqu'à la marque de fin. Le
+        // dernier cluster se lit dans la FAT (au plus 65536 entrées par
+        // répertoire): la création suivante peut déborder sans nouvelle passe
+        uint32_t last = tail_cluster;
+        for (uint32_t n = 0; !reached_tail && n < 65536u; ++n) {
+            const uint32_t next = fat_entry(last, 0, false);
+            if (next < 2 || next >= FAT32_Cluster::EOC_MIN) { reached_tail = true; break; }
+            last = next;
         }
-        // If last and not returned earlier, file not found. Handle create scenarios.
-        if (&name == &parts.back()) {
-            if (function == READ || function == DELETE || function == MODIFY) {
-                return FILE_NOT_FOUND;
+        create_hint_.end = end;
+        create_hint_.tail_cluster = reached_tail ? last : 0;
+        create_hint_.hole_len = 0;
+        if (!found_run) run_at_end = true;
+        break;
+    }
+
+    if (run_len < needed) {
+        // Étendre le répertoire: la plage libre finale se prolonge dans les nouveaux clusters
+        uint32_t missing = needed - run_len;
+        uint32_t last = tail_cluster;
+        while (missing > 0) {
+            uint32_t freec = fat_search_available_cluster(last);
+            if (freec < 2) return NO_MORE_FREE_CLUSTER;
+            (void)fat_entry(last, freec, true);
+            (void)fat_entry(freec, FAT32_Cluster::EOC_MIN, true);
+            uint8_t z[512]; memset(z, 0, sizeof(z));
+            for (uint16_t s = 0; s < cluster_size; ++s) {
+                if (!store_physical_block(data_base + ((freec - 2) * cluster_size) + s, z)) return ERROR_READ_FAIL;
             }
-            // CREATE or OVERWRITE when not found: create a new entry with 0 size, no cluster yet
-            // Find free directory entry slot (or extend directory)
-            // Search end-of-directory or erased entry
-            uint32_t cluster2 = dir_cluster;
-            bool placed = false;
-            char dos11[11];
-            if (!FAT_Utils::to_dos_8_3(name.c_str(), dos11)) {
+            if (run_len == 0) { run_start = DirCursor{freec, 0, 0}; }
+            run_len += (uint16_t)std::min<uint32_t>(missing, per_cluster);
+            missing = (missing > per_cluster) ? missing - per_cluster : 0;
+            last = freec;
+        }
+        create_hint_.tail_cluster = last;
+    }
+
+    // Écriture: fragments LFN en ordre décroissant puis entrée 8.3
+    const uint8_t checksum = FAT_Utils::lfn_checksum((const uint8_t*)sfn);
+    DirCursor cur = run_start;
+    uint32_t loaded_lba = 0;
+    for (uint16_t k = 0; k < needed; ++k) {
+        uint32_t lba = data_base + ((cur.cluster - 2) * cluster_size) + cur.sector;
+        if (lba != loaded_lba) {
+            if (loaded_lba != 0 && !store_physical_block(loaded_lba, read_buffer)) return ERROR_READ_FAIL;
+            if (!read_dir_sector(lba)) return ERROR_READ_FAIL;
+            loaded_lba = lba;
+        }
+        root_Entries* e = &((root_Entries*)read_buffer)[cur.index];
+        memset(e, 0, sizeof(root_Entries));
+        if (k < lfn_count) {
+            DIR_ENT_LFN* l = (DIR_ENT_LFN*)e;
+            const uint8_t ordinal = (uint8_t)(lfn_count - k);
+            l->Ordinal = ordinal | (k == 0 ? 0x40 : 0x00);
+            l->Attributes = FAT_Config::AT_LFN;
+            l->Checksum = checksum;
+            // 13 caractères UCS-2 par fragment, terminés par 0x0000 puis bourrés de 0xFFFF
+            uint16_t chars[13];
+            for (int c = 0; c < 13; ++c) {
+                size_t pos = (size_t)(ordinal - 1) * 13 + c;
+                chars[c] = (pos < name_len) ? (uint8_t)name[pos] : (pos == name_len ? 0x0000 : 0xFFFF);
+            }
+            for (int c = 0; c < 5; ++c) l->Name1[c] = chars[c];
+            for (int c = 0; c < 6; ++c) l->Name2[c] = chars[5 + c];
+            for (int c = 0; c < 2; ++c) l->Name3[c] = chars[11 + c];
+        } else {
+            memcpy(e->FileName, sfn, 8);
+            memcpy(e->Extension, sfn + 8, 3);
+            e->Attributes = attributes;
+            e->FirstClusterHigh = (uint16_t)((first_cluster >> 16) & 0xFFFF);
+            e->FirstClusterNumber = (uint16_t)(first_cluster & 0xFFFF);
+            e->SizeofFile = 0;
+            sfn_lba = lba;
+            sfn_index = cur.index;
+        }
+        if (k + 1 < needed && !dir_cursor_advance(cur)) return ERROR_READ_FAIL;
+    }
+    if (!store_physical_block(loaded_lba, read_buffer)) return ERROR_READ_FAIL;
+
+    // Nouveau nom dans l'index; la fin avance si la plage l'a atteinte
+    create_hint_add(create_sfn_key(sfn));
+    if (with_lfn && create_long_key(name, '1') != create_sfn_key(sfn)) create_hint_add(create_long_key(name, '0'));
+    if (run_at_end) {
+        const uint32_t last_cluster_used = cur.cluster;
+        if (dir_cursor_advance(cur)) {
+            create_hint_.end = cur;
+        } else {
+            create_hint_.end = DirCursor{0, 0, 0};
+            create_hint_.tail_cluster = last_cluster_used;
+        }
+    }
+    create_hint_.dir_cluster = dir_cluster;
+    return FILE_CREATE_OK;
+}
+
+struct DirPos { uint32_t cluster; uint32_t lba; uint16_t index; };
+
+FAT_ErrorCode FAT32::file_open(const char* filename, FileFunction function) {
+    const FAT_ErrorCode result = open_path(filename, function);
+    if ((function == CREATE || function == OVERWRITE || function == MODIFY) &&
+        (result == FILE_FOUND || result == FILE_CREATE_OK)) {
+        write_open_ = true;
+    }
+    return result;
+}
+
+FAT_ErrorCode FAT32::open_path(const char* filename, FileFunction function) {
+    if (!initialized || !filename || !*filename) {
+        return FILE_NOT_FOUND;
+    }
+    if (exfat_) return exfat_->file_open(filename, function, read_handler);
+
+    // Resolve the parent directory (cached, relative paths and '..' allowed),
+    // then look the last component up in that single directory
+    uint32_t dir_cluster = (current_dir_cluster_ >= 2) ? current_dir_cluster_ : root_dir_first_cluster;
+    const char* slash = strrchr(filename, '/');
+    const std::string name(slash ? slash + 1 : filename);
+    if (slash) {
+        const std::string parent(filename, (size_t)(slash - filename));
+        if (!resolve_directory(parent.empty() ? "/" : parent.c_str(), dir_cluster)) return FILE_NOT_FOUND;
+    }
+    if (name.empty() || name == "." || name == "..") return FILE_NOT_FOUND;
+
+    // Placement par AU pour un fichier annoncé d'au moins une unité d'allocation
+    if (function == CREATE || function == OVERWRITE) {
+        au_placement_ = au_blocks_ != 0 && expected_size_ >= au_blocks_ * FAT_Config::SECTOR_SIZE;
+        expected_size_ = 0;
+    }
+
+    // Creating a new file: a single directory pass checks the name,
+    // picks the 8.3 alias and finds the free slots. Existing names fall
+    // back to the lookup below (truncate semantics).
+    if ((function == CREATE || function == OVERWRITE)) {
+        uint32_t sfn_lba = 0;
+        uint16_t sfn_index = 0;
+        FAT_ErrorCode created = create_dir_entry(dir_cluster, name.c_str(), FAT_Config::AT_ARCHIVE, 0, sfn_lba, sfn_index);
+        if (created == FILE_CREATE_OK) {
+            write_handler.Dir_Entry = sfn_lba;
+            write_handler.DirIndex = sfn_index;
+            write_handler.File_Size = 0;
+            write_handler.BaseFatEntry = 0;
+            write_handler.CurrentFatEntry = 0;
+            write_handler.ClusterIndex = 0;
+            write_handler.SectorIndex = 0;
+            write_handler.Position = 0;
+            return FILE_CREATE_OK;
+        }
+        if (created != FILE_FOUND) return created;
+    }
+
+    // Scan the directory cluster chain
+    uint32_t cluster = dir_cluster;
+    // State to carry LFN from preceding entries
+    bool lfn_flag = false;
+    char lfn_name[FAT_Config::MAX_LFN_CHARACTERS];
+    lfn_name[0] = '\0';
+    // Début de la séquence LFN courante (pour l'effacer avec l'entrée 8.3)
+    DirCursor lfn_start{0, 0, 0};
+    uint16_t lfn_entries = 0;
+
+    DirPos found_pos{0,0,0};
+    while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN) {
+        for (uint16_t sec = 0; sec < cluster_size; ++sec) {
+            uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
+            if (!read_dir_sector(lba)) {
                 return FILE_NOT_FOUND;
             }
-            while (cluster2 >= 2 && cluster2 < FAT32_Cluster::EOC_MIN && !placed) {
-                for (uint16_t sec = 0; sec < cluster_size && !placed; ++sec) {
-                    uint32_t lba = data_base + ((cluster2 - 2) * cluster_size) + sec;
-                    if (!get_physical_block(lba, read_buffer)) return FILE_NOT_FOUND;
-                    root_Entries* entries = (root_Entries*)read_buffer;
-                    const uint16_t ents = sector_size / sizeof(root_Entries);
-                    for (uint16_t i = 0; i < ents; ++i) {
-                        if (entries[i].FileName[0] == FAT_Config::FILE_CLEAR || entries[i].FileName[0] == FAT_Config::FILE_ERASED) {
-                            // prepare new 8.3 entry
-                            memset(&entries[i], 0, sizeof(root_Entries));
-                            memcpy(entries[i].FileName, dos11, 8);
-                            memcpy(entries[i].Extension, dos11 + 8, 3);
-                            entries[i].Attributes = FAT_Config::AT_ARCHIVE;
-                            entries[i].FirstClusterHigh = 0;
-                            entries[i].FirstClusterNumber = 0;
-                            entries[i].SizeofFile = 0;
-                            if (!store_physical_block(lba, (uint8_t*)entries)) return FILE_NOT_FOUND;
-                            // initialize write handler for subsequent write
-                            write_handler.Dir_Entry = lba;
-                            write_handler.File_Size = 0;
-                            write_handler.BaseFatEntry = 0;
-                            write_handler.CurrentFatEntry = 0;
-                            write_handler.ClusterIndex = 0;
-                            write_handler.SectorIndex = 0;
-                            return FILE_CREATE_OK;
+            root_Entries* entries = (root_Entries*)read_buffer;
+            const uint16_t ents = sector_size / sizeof(root_Entries);
+
+            for (uint16_t i = 0; i < ents; ++i) {
+                root_Entries* e = &entries[i];
+                if (e->FileName[0] == FAT_Config::FILE_CLEAR) {
+                    // End of directory: no need to read the remaining sectors
+                    return FILE_NOT_FOUND;
+                }
+                if (e->FileName[0] == FAT_Config::FILE_ERASED) continue;
+
+                if ((e->Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN && (e->FileName[0] & 0x40)) {
+                    lfn_start = DirCursor{cluster, sec, i};
+                    lfn_entries = e->FileName[0] & 0x3F;
+                }
+
+                // Use existing parser to assemble LFN statefully
+                FileEntryType type = fat_filename_parser(e);
+                if (type == _LongFileNameOK) {
+                    // LFN handling: copy assembled buffer for comparison later
+                    lfn_flag = true;
+                    strncpy(lfn_name, lfn_buffer.c_str(), sizeof(lfn_name) - 1);
+                    lfn_name[sizeof(lfn_name) - 1] = '\0';
+                    // Clear the class buffer to avoid accidental reuse
+                    lfn_buffer.clear();
+                    continue;
+                } else if (type == _LongFileNameNOK) {
+                    // continue collecting
+                    continue;
+                } else if (type == _Error) {
+                    // skip invalid entries
+                    continue;
+                }
+
+                // For a normal 8.3 entry (file or directory), decide the display name
+                char comp_name[FAT_Config::MAX_LFN_CHARACTERS];
+                comp_name[0] = '\0';
+                if (lfn_flag && lfn_name[0]) {
+                    strncpy(comp_name, lfn_name, sizeof(comp_name) - 1);
+                    comp_name[sizeof(comp_name) - 1] = '\0';
+                } else {
+                    // Build DOS name (without trailing backslash for directories)
+                    if (type == _Directory) {
+                        int k = 0;
+                        for (int c = 0; c < 8 && e->FileName[c] != ' '; ++c) comp_name[k++] = (char)e->FileName[c];
+                        comp_name[k] = '\0';
+                    } else { // _File
+                        int k = 0;
+                        for (int c = 0; c < 8 && e->FileName[c] != ' '; ++c) comp_name[k++] = (char)e->FileName[c];
+                        if (e->Extension[0] != ' ') {
+                            comp_name[k++] = '.';
+                            for (int c = 0; c < 3 && e->Extension[c] != ' '; ++c) comp_name[k++] = (char)e->Extension[c];
                         }
+                        comp_name[k] = '\0';
                     }
                 }
-                // No free slot in this cluster, extend directory by allocating a new cluster
-                uint32_t next = fat_entry(cluster2, 0, false);
-                if (next >= FAT32_Cluster::EOC_MIN || next == 0) {
-                    // allocate new cluster for directory
-                    uint16_t freec = fat_search_available_cluster((uint16_t)cluster2);
-                    if (freec < 2) return NO_MORE_FREE_CLUSTER;
-                    // link chain
-                    (void)fat_entry(cluster2, freec, true);
-                    (void)fat_entry(freec, FAT32_Cluster::EOC_MIN, true);
-                    // zero newly allocated directory cluster
-                    {
-                        uint8_t z[512]; memset(z, 0, sizeof(z));
-                        for (uint16_t s = 0; s < cluster_size; ++s) {
-                            uint32_t zlba = data_base + ((freec - 2) * cluster_size) + s;
-                            if (!store_physical_block(zlba, z)) return FILE_NOT_FOUND;
+
+                // Reset LFN flag for the next sequence (as we consumed the SFN entry)
+                const bool had_lfn = lfn_flag && lfn_name[0];
+                lfn_flag = false;
+                lfn_name[0] = '\0';
+
+                // Compare case-insensitively
+                if (FAT_Utils::iequals(comp_name, name.c_str())) {
+                    uint32_t first_cluster = ((uint32_t)e->FirstClusterHigh << 16) | (uint32_t)e->FirstClusterNumber;
+                    // Expect a file for READ
+                    found_pos = { cluster, lba, i };
+                    if (function == READ) {
+                        if ((e->Attributes & FAT_Config::AT_DIRECTORY) == 0) {
+                            // Initialize read handler
+                            read_handler.Dir_Entry = 0; // optional
+                            read_handler.File_Size = e->SizeofFile;
+                            read_handler.FAT_Entry = first_cluster;
+                            read_handler.SectorOffset = 0;
+                            return FILE_FOUND;
+                        } else {
+                            // matched a directory when expecting a file
+                            return FILE_NOT_FOUND;
+                        }
+                    } else if (function == DELETE) {
+                        if (e->Attributes & FAT_Config::AT_DIRECTORY) {
+                            // refuse deleting directories here
+                            return FILE_NOT_FOUND;
                         }
+                        // free cluster chain if any (one write per touched FAT sector)
+                        if (!free_chain(first_cluster)) return FILE_NOT_FOUND;
+                        // mark directory entry (and its LFN sequence) as erased
+                        if (had_lfn) {
+                            if (!erase_dir_entries(lfn_start, (uint16_t)(lfn_entries + 1))) return FILE_NOT_FOUND;
+                            // Emplacements rendus: réutilisables par la prochaine création ici
+                            create_hint_hole(dir_cluster, lfn_start, (uint16_t)(lfn_entries + 1));
+                            return FILE_FOUND;
+                        }
+                        root_Entries* ee = (root_Entries*)read_buffer;
+                        ee[i].FileName[0] = FAT_Config::FILE_ERASED;
+                        if (!store_physical_block(lba, (uint8_t*)ee)) {
+                            return FILE_NOT_FOUND;
+                        }
+                        create_hint_hole(dir_cluster, DirCursor{cluster, sec, i}, 1);
+                        return FILE_FOUND;
+                    } else if (function == OVERWRITE || function == MODIFY) {
+                        if (e->Attributes & FAT_Config::AT_DIRECTORY) return FILE_NOT_FOUND;
+                        // Truncate for OVERWRITE; for MODIFY we keep as is (start at beginning)
+                        if (function == OVERWRITE) {
+                            // free chain
+                            if (!free_chain(first_cluster)) return FILE_NOT_FOUND;
+                            // set cluster to 0 and size 0
+                            root_Entries* ee = (root_Entries*)read_buffer;
+                            ee[i].FirstClusterHigh = 0;
+                            ee[i].FirstClusterNumber = 0;
+                            ee[i].SizeofFile = 0;
+                            if (!store_physical_block(lba, (uint8_t*)ee)) return FILE_NOT_FOUND;
+                            first_cluster = 0;
+                        }
+                        // initialize write handler
+                        write_handler.Dir_Entry = lba; // store lba for updating size
+                        write_handler.DirIndex = i;
+                        write_handler.File_Size = ((root_Entries*)read_buffer)[i].SizeofFile;
+                        write_handler.BaseFatEntry = first_cluster;
+                        write_handler.CurrentFatEntry = first_cluster;
+                        write_handler.ClusterIndex = 0;
+                        write_handler.SectorIndex = 0;
+                        write_handler.Position = 0;
+                        return FILE_FOUND;
+                    } else if (function == CREATE) {
+                        // already exists: treat as overwrite/truncate
+                        if (e->Attributes & FAT_Config::AT_DIRECTORY) return FILE_NOT_FOUND;
+                        // free chain
+                        if (!free_chain(first_cluster)) return FILE_NOT_FOUND;
+                        root_Entries* ee = (root_Entries*)read_buffer;
+                        ee[i].FirstClusterHigh = 0;
+                        ee[i].FirstClusterNumber = 0;
+                        ee[i].SizeofFile = 0;
+                        if (!store_physical_block(lba, (uint8_t*)ee)) return FILE_NOT_FOUND;
+                        write_handler.Dir_Entry = lba;
+                        write_handler.DirIndex = i;
+                        write_handler.File_Size = 0;
+                        write_handler.BaseFatEntry = 0;
+                        write_handler.CurrentFatEntry = 0;
+                        write_handler.ClusterIndex = 0;
+                        write_handler.SectorIndex = 0;
+                        write_handler.Position = 0;
+                        return FILE_CREATE_OK;
                     }
-                    // Place first entry at beginning of new cluster
-                    uint32_t lba = data_base + ((freec - 2) * cluster_size) + 0;
-                    if (!get_physical_block(lba, read_buffer)) return FILE_NOT_FOUND;
-                    root_Entries* entries = (root_Entries*)read_buffer;
-                    memset(entries, 0, sector_size);
-                    char dos11_2[11]; memcpy(dos11_2, dos11, 11);
-                    memcpy(entries[0].FileName, dos11_2, 8);
-                    memcpy(entries[0].Extension, dos11_2 + 8, 3);
-                    entries[0].Attributes = FAT_Config::AT_ARCHIVE;
-                    entries[0].FirstClusterHigh = 0;
-                    entries[0].FirstClusterNumber = 0;
-                    entries[0].SizeofFile = 0;
-                    if (!store_physical_block(lba, (uint8_t*)entries)) return FILE_NOT_FOUND;
-                    write_handler.Dir_Entry = lba;
-                    write_handler.File_Size = 0;
-                    write_handler.BaseFatEntry = 0;
-                    write_handler.CurrentFatEntry = 0;
-                    write_handler.ClusterIndex = 0;
-                    write_handler.SectorIndex = 0;
-                    return FILE_CREATE_OK;
-                } else {
-                    cluster2 = next;
                 }
             }
-            return FILE_NOT_FOUND;
         }
+        uint32_t next = fat_entry(cluster, 0, false);
+        if (next >= FAT32_Cluster::EOC_MIN || next == 0) break;
+        cluster = next;
     }
 
-    return result;
+    // New names for CREATE / OVERWRITE were already created above; getting
+    // here means the name is absent or only collided with an existing 8.3 alias.
+    return FILE_NOT_FOUND;
 }
 
 void FAT32::file_close() {
@@ -716,8 +1094,16 @@ void FAT32::file_close() {
         // Vider les buffers de cache FAT si nécessaire
         flush_fat_cache();
         
+        // Vider la file de requêtes puis attendre la fin de la dernière écriture
+        bool flushed = io_.flush();
+        if (!sd_card->sync() || !flushed) {
+            printf("  Erreur d'écriture SD détectée à la fermeture\n");
+        }
+        
         // Réinitialiser le write_handler
         write_handler = WriteHandler(); // Reset avec constructeur
+        write_open_ = false;
+        au_placement_ = false;
         printf("  Handler d'écriture réinitialisé\n");
     }
     
@@ -749,6 +1135,8 @@ uint16_t FAT32::file_read(uint8_t* buffer, ReadHandler* handler) {
         h = handler;
     }
     
+    if (exfat_) return exfat_->file_read(buffer, h);
+
     // Vérifier s'il y a encore des données à lire
     if (h->File_Size == 0) {
         return 0; // EOF
@@ -791,52 +1179,127 @@ uint16_t FAT32::file_read(uint8_t* buffer, ReadHandler* handler) {
     return bytes_to_read;
 }
 
-void FAT32::file_write(const uint8_t* data, uint32_t size) {
-    if (!initialized || !data || size == 0) return;
+uint32_t FAT32::file_read_blocks(uint8_t* buffer, uint32_t max_sectors, ReadHandler* handler) {
+    if (!buffer || !initialized || max_sectors == 0) {
+        return 0;
+    }
+    ReadHandler* h = handler ? handler : &read_handler;
+    if (handler && handler->File_Size == 0 && handler->FAT_Entry == 0 && read_handler.File_Size != 0) {
+        *handler = read_handler;
+    }
+    const uint32_t bytes = FAT_Config::SECTOR_SIZE;
+    uint32_t done = 0;
+
+    if (exfat_) {
+        // exFAT: plages calculées par ExFAT, lues comme en FAT32 par l'ordonnanceur
+        while (done < max_sectors) {
+            uint32_t lba = 0;
+            ReadHandler next;
+            const uint32_t run = exfat_->file_run(*h, max_sectors - done, lba, next);
+            if (run == 0 || !io_.read_run(lba, run, buffer + done * bytes)) break;
+            *h = next;
+            done += run;
+        }
+        return done * bytes;
+    }
+
+    while (done < max_sectors && h->File_Size >= bytes &&
+           h->FAT_Entry >= 2 && h->FAT_Entry < FAT32_Cluster::EOC_MIN) {
+        // Séquence de secteurs consécutifs: fin du cluster courant puis clusters contigus.
+        // La position avance sur une copie, reportée une fois la lecture réussie:
+        // après un échec, le handler désigne toujours le premier secteur non lu
+        const uint32_t lba = data_base + ((h->FAT_Entry - 2) * cluster_size) + h->SectorOffset;
+        const uint32_t want = std::min<uint32_t>(max_sectors - done, h->File_Size / bytes);
+        ReadHandler next = *h;
+        uint32_t run = 0;
+        while (run < want) {
+            uint32_t take = std::min<uint32_t>(cluster_size - next.SectorOffset, want - run);
+            run += take;
+            next.SectorOffset += take;
+            next.File_Size -= take * bytes;
+            if (next.SectorOffset < cluster_size) break;
+
+            next.SectorOffset = 0;
+            const uint32_t cluster = next.FAT_Entry;
+            next.FAT_Entry = fat_entry(cluster, 0, false);
+            if (next.FAT_Entry >= FAT32_Cluster::EOC_MIN || next.FAT_Entry < 2) {
+                next.File_Size = 0; // EOF
+                break;
+            }
+            if (next.FAT_Entry != cluster + 1) break;   // cluster non contigu: nouvelle commande
+        }
+        if (!io_.read_run(lba, run, buffer + done * bytes)) break;
+        *h = next;
+        done += run;
+    }
+    return done * bytes;
+}
+
+uint32_t FAT32::file_skip_sectors(uint32_t sectors, ReadHandler* handler) {
+    if (!initialized || sectors == 0) return 0;
+    ReadHandler* h = handler ? handler : &read_handler;
+    if (handler && handler->File_Size == 0 && handler->FAT_Entry == 0 && read_handler.File_Size != 0) {
+        *handler = read_handler;
+    }
+    const uint32_t bytes = FAT_Config::SECTOR_SIZE;
+    uint32_t done = 0;
+
+    if (exfat_) {
+        // exFAT: avance par plages, sans lire les secteurs
+        while (done < sectors) {
+            uint32_t lba = 0;
+            ReadHandler next;
+            const uint32_t run = exfat_->file_run(*h, sectors - done, lba, next);
+            if (run == 0) break;
+            *h = next;
+            done += run;
+        }
+        return done;
+    }
+
+    while (done < sectors && h->File_Size >= bytes &&
+           h->FAT_Entry >= 2 && h->FAT_Entry < FAT32_Cluster::EOC_MIN) {
+        const uint32_t take = std::min<uint32_t>(std::min<uint32_t>(cluster_size - h->SectorOffset, sectors - done),
+                                                 h->File_Size / bytes);
+        done += take;
+        h->SectorOffset += take;
+        h->File_Size -= take * bytes;
+        if (h->SectorOffset < cluster_size) break;
+
+        h->SectorOffset = 0;
+        h->FAT_Entry = fat_entry(h->FAT_Entry, 0, false);
+        if (h->FAT_Entry >= FAT32_Cluster::EOC_MIN || h->FAT_Entry < 2) {
+            h->File_Size = 0; // EOF
+        }
+    }
+    return done;
+}
+
+uint32_t FAT32::file_write(const uint8_t* data, uint32_t size) {
+    if (!initialized || !data || size == 0) return 0;
 
     // Load the directory entry sector from write_handler.Dir_Entry if we need to update size/cluster
     uint32_t dir_lba = write_handler.Dir_Entry;
-    if (dir_lba == 0) return; // no file opened for write
+    if (dir_lba == 0) return 0; // no file opened for write
 
     // Ensure starting cluster
     if (write_handler.CurrentFatEntry < 2) {
         // allocate first cluster
-        uint16_t newc = fat_search_available_cluster(2);
-        if (newc < 2) { printf("Aucun cluster libre\n"); return; }
-        // link as EOC start
+        uint32_t newc = allocate_cluster(0);
+        if (newc < 2) { printf("Aucun cluster libre\n"); return 0; }
+        // link as EOC start (no zero fill: bytes past EOF are zeroed in RAM below)
         (void)fat_entry(newc, FAT32_Cluster::EOC_MIN, true);
-        {
-            uint8_t z[512]; memset(z, 0, sizeof(z));
-            for (uint16_t s = 0; s < cluster_size; ++s) {
-                uint32_t zlba = data_base + ((newc - 2) * cluster_size) + s;
-                if (!store_physical_block(zlba, z)) return; // abort on error
-            }
-        }
         write_handler.BaseFatEntry = newc;
         write_handler.CurrentFatEntry = newc;
         write_handler.ClusterIndex = 0;
         write_handler.SectorIndex = 0;
-        // update directory entry first cluster
+        // update directory entry first cluster (exact entry recorded by file_open)
         if (get_physical_block(dir_lba, read_buffer)) {
-            root_Entries* entries = (root_Entries*)read_buffer;
-            // We stored sector lba only; need to find exact entry index — we stored it in SectorIndex misused? Not available.
-            // Heuristic: find first entry with non-empty name and matching size/zero cluster; we cannot robustly detect.
-            // Simpler: update the first entry that has size == write_handler.File_Size and zero cluster; iterate all 16 entries.
-            const uint16_t ents = sector_size / sizeof(root_Entries);
-            for (uint16_t i = 0; i < ents; ++i) {
-                root_Entries &e = entries[i];
-                if (e.FileName[0] == FAT_Config::FILE_CLEAR) break;
-                if (e.FileName[0] == FAT_Config::FILE_ERASED) continue;
-                if ((e.Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN) continue;
-                // Update if size matches and cluster is zero
-                if (e.SizeofFile == write_handler.File_Size && e.FirstClusterHigh == 0 && e.FirstClusterNumber == 0) {
-                    e.FirstClusterHigh = (uint16_t)((write_handler.BaseFatEntry >> 16) & 0xFFFF);
-                    e.FirstClusterNumber = (uint16_t)(write_handler.BaseFatEntry & 0xFFFF);
-                    if (!store_physical_block(dir_lba, (uint8_t*)entries)) {
-                        printf("Erreur MAJ entrée répertoire\n");
-                    }
-                    break;
-                }
+            root_Entries &e = ((root_Entries*)read_buffer)[write_handler.DirIndex];
+            e.FirstClusterHigh = (uint16_t)((write_handler.BaseFatEntry >> 16) & 0xFFFF);
+            e.FirstClusterNumber = (uint16_t)(write_handler.BaseFatEntry & 0xFFFF);
+            if (!store_physical_block(dir_lba, read_buffer)) {
+                printf("Erreur MAJ entrée répertoire\n");
             }
         }
     }
@@ -844,84 +1307,130 @@ void FAT32::file_write(const uint8_t* data, uint32_t size) {
     uint32_t remaining = size;
     const uint8_t* p = data;
     while (remaining > 0) {
-        // Compute LBA for current sector
-        uint32_t cur_cluster = write_handler.CurrentFatEntry;
-        uint32_t lba = data_base + ((cur_cluster - 2) * cluster_size) + write_handler.SectorIndex;
-
-        // If we are at a fresh sector and writing less than a full sector, RMW the sector
-        uint32_t chunk = std::min<uint32_t>(remaining, sector_size);
-        if (chunk != sector_size) {
-            if (!get_physical_block(lba, read_buffer)) return;
-            memcpy(read_buffer, p, chunk);
-            if (!store_physical_block(lba, read_buffer)) return;
-        } else {
-            if (!store_physical_block(lba, p)) return;
-        }
-
-        p += chunk;
-        remaining -= chunk;
-        write_handler.File_Size += chunk;
-        write_handler.SectorIndex++;
-
+        // Cluster full: move to the next one, allocated only now that data remains
         if (write_handler.SectorIndex >= cluster_size) {
-            // Need next cluster
-            write_handler.SectorIndex = 0;
+            uint32_t cur_cluster = write_handler.CurrentFatEntry;
             uint32_t next = fat_entry(cur_cluster, 0, false);
             if (next < 2 || next >= FAT32_Cluster::EOC_MIN) {
-                // allocate one
-                uint16_t newc = fat_search_available_cluster((uint16_t)cur_cluster);
-                if (newc < 2) { printf("Aucun cluster libre\n"); return; }
-                (void)fat_entry(cur_cluster, newc, true);
-                (void)fat_entry(newc, FAT32_Cluster::EOC_MIN, true);
-                {
-                    uint8_t z[512]; memset(z, 0, sizeof(z));
-                    for (uint16_t s = 0; s < cluster_size; ++s) {
-                        uint32_t zlba = data_base + ((newc - 2) * cluster_size) + s;
-                        if (!store_physical_block(zlba, z)) return; // abort on error
-                    }
-                }
-                write_handler.CurrentFatEntry = newc;
+                next = allocate_cluster(cur_cluster);
+                if (next < 2) { printf("Aucun cluster libre\n"); break; }
+                (void)fat_entry(cur_cluster, next, true);
+                (void)fat_entry(next, FAT32_Cluster::EOC_MIN, true);
+            }
+            write_handler.CurrentFatEntry = next;
+            write_handler.SectorIndex = 0;
+        }
+
+        // Compute LBA for current sector and the write position inside it
+        uint32_t lba = data_base + ((write_handler.CurrentFatEntry - 2) * cluster_size) + write_handler.SectorIndex;
+        uint32_t offset = write_handler.Position % sector_size;
+        uint32_t chunk = std::min<uint32_t>(remaining, sector_size - offset);
+        if (chunk == sector_size) {
+            if (!store_physical_block(lba, p)) break;
+        } else {
+            // Partial sector: read it back only if it already holds file data
+            if (write_handler.Position - offset < write_handler.File_Size) {
+                if (!get_physical_block(lba, read_buffer)) break;
             } else {
-                write_handler.CurrentFatEntry = next;
+                memset(read_buffer, 0, sector_size);
             }
+            memcpy(read_buffer + offset, p, chunk);
+            if (!store_physical_block(lba, read_buffer)) break;
         }
+
+        p += chunk;
+        remaining -= chunk;
+        write_handler.Position += chunk;
+        if (write_handler.Position > write_handler.File_Size) write_handler.File_Size = write_handler.Position;
+        if (offset + chunk == sector_size) write_handler.SectorIndex++;
     }
 
     // Update directory entry size on disk
     if (get_physical_block(dir_lba, read_buffer)) {
-        root_Entries* entries = (root_Entries*)read_buffer;
-        const uint16_t ents = sector_size / sizeof(root_Entries);
-        for (uint16_t i = 0; i < ents; ++i) {
-            root_Entries &e = entries[i];
-            if (e.FileName[0] == FAT_Config::FILE_CLEAR) break;
-            if (e.FileName[0] == FAT_Config::FILE_ERASED) continue;
-            if ((e.Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN) continue;
-            // Heuristic: choose first with non-zero first cluster matching BaseFatEntry if set
-            uint32_t fc = ((uint32_t)e.FirstClusterHigh << 16) | e.FirstClusterNumber;
-            if ((write_handler.BaseFatEntry != 0 && fc == write_handler.BaseFatEntry) || (write_handler.BaseFatEntry == 0 && fc != 0)) {
-                e.SizeofFile = write_handler.File_Size;
-                store_physical_block(dir_lba, (uint8_t*)entries);
-                break;
-            }
-        }
+        ((root_Entries*)read_buffer)[write_handler.DirIndex].SizeofFile = write_handler.File_Size;
+        store_physical_block(dir_lba, read_buffer);
     }
+    return size - remaining;
 }
 
-uint16_t FAT32::fat_search_available_cluster(uint16_t current_cluster) {
+uint32_t FAT32::fat_search_available_cluster(uint32_t current_cluster) {
     // Linear scan of FAT for a free entry; start after current_cluster if possible
-    uint32_t start = (current_cluster >= 2) ? current_cluster : 2;
-    for (uint32_t c = start; c < (uint32_t)last_cluster; ++c) {
+    uint32_t start = (current_cluster >= 2 && current_cluster <= last_cluster) ? current_cluster : 2;
+    for (uint32_t c = start; c <= last_cluster; ++c) {
         uint32_t v = fat_entry(c, 0, false);
-        if (v == FAT_Config::CLUSTER_FREE) return (uint16_t)c;
+        if (v == FAT_Config::CLUSTER_FREE) return c;
     }
     // wrap-around
     for (uint32_t c = 2; c < start; ++c) {
         uint32_t v = fat_entry(c, 0, false);
-        if (v == FAT_Config::CLUSTER_FREE) return (uint16_t)c;
+        if (v == FAT_Config::CLUSTER_FREE) return c;
     }
     return 0; // none
 }
 
+// ============================================================================
+// PLACEMENT PAR UNITÉS D'ALLOCATION (AU)
+// ============================================================================
+
+void FAT32::set_allocation_unit(uint32_t au_blocks) {
+    // Une AU qui tient dans un cluster n'apporte aucune contrainte de placement
+    au_blocks_ = (au_blocks > cluster_size) ? au_blocks : 0;
+    au_search_hint_ = 0;
+}
+
+// Premier cluster d'une AU dont tous les clusters sont libres, en partant de
+// l'AU qui suit from_cluster, ou de la première AU si from_cluster < 2
+// (recherche circulaire). 0 si aucune AU libre.
+// Les AU sont alignées sur les LBA de la carte, pas sur le début de la zone
+// de données: seuls les clusters entièrement contenus dans l'AU comptent.
+uint32_t FAT32::fat_search_free_au(uint32_t from_cluster) {
+    if (au_blocks_ == 0) return 0;
+    const uint32_t au = au_blocks_;
+    const uint64_t data_end = (uint64_t)data_base + (uint64_t)(last_cluster - 1) * cluster_size;
+    const uint32_t au_min = (data_base + au - 1) / au;
+    const uint32_t au_max = (uint32_t)(data_end / au);   // exclue
+    if (au_max <= au_min) return 0;
+
+    uint32_t start = au_min;
+    if (from_cluster >= 2 && from_cluster <= last_cluster) {
+        start = (uint32_t)(((uint64_t)data_base + (uint64_t)(from_cluster - 2) * cluster_size) / au) + 1;
+        if (start < au_min || start >= au_max) start = au_min;
+    }
+
+    uint32_t k = start;
+    do {
+        const uint64_t au_lba = (uint64_t)k * au;
+        const uint32_t first = 2 + (uint32_t)((au_lba - data_base + cluster_size - 1) / cluster_size);
+        const uint32_t end = 2 + (uint32_t)((au_lba + au - data_base) / cluster_size);
+        uint32_t c = first;
+        while (c < end && fat_entry(c, 0, false) == FAT_Config::CLUSTER_FREE) ++c;
+        if (c == end && end > first) return first;
+        if (++k >= au_max) k = au_min;
+    } while (k != start);
+    return 0;
+}
+
+// Cluster suivant d'un fichier en écriture (prev_cluster = 0 pour le premier)
+uint32_t FAT32::allocate_cluster(uint32_t prev_cluster) {
+    if (au_placement_) {
+        const uint32_t next = prev_cluster + 1;
+        if (prev_cluster >= 2 && next <= last_cluster) {
+            // Dans l'AU courante (choisie entièrement libre), rester séquentiel
+            const uint32_t prev_au = (data_base + (prev_cluster - 2) * cluster_size) / au_blocks_;
+            const uint32_t next_end_au = (data_base + (next - 1) * cluster_size - 1) / au_blocks_;
+            if (next_end_au == prev_au && fat_entry(next, 0, false) == FAT_Config::CLUSTER_FREE) return next;
+        }
+        const uint32_t c = fat_search_free_au(prev_cluster >= 2 ? prev_cluster : au_search_hint_);
+        if (c >= 2) {
+            au_search_hint_ = c;
+            return c;
+        }
+        // Plus aucune AU libre: placement classique pour le reste du fichier
+        au_placement_ = false;
+    }
+    return fat_search_available_cluster(prev_cluster >= 2 ? prev_cluster : 2);
+}
+
 uint32_t FAT32::fat_entry(uint32_t cluster_num, uint32_t fat_value, bool write_entry) {
     // FAT32: Each entry is 4 bytes, upper 4 bits reserved (masked out)
     // Returns the current value of the FAT entry for cluster_num
@@ -980,14 +1489,192 @@ uint32_t FAT32::fat_entry(uint32_t cluster_num, uint32_t fat_value, bool write_e
             return 0xFFFFFFFF;
         }
         
-        // Optionally write to backup FAT (FAT32 typically has 2 copies)
-        // For now, we only update the first FAT table
-        // To be complete, we should write to fat_base + sectors_per_fat as well
+        // Keep the backup FAT copies (FAT2...) in sync with FAT1
+        for (uint8_t copy = 1; copy < fat_count; ++copy) {
+            if (!store_physical_block(fat_lba + copy * sectors_per_fat, fat_cache)) {
+                printf("Erreur écriture FAT miroir %u (LBA %lu)\n", (unsigned)(copy + 1),
+                       (unsigned long)(fat_lba + copy * sectors_per_fat));
+            }
+        }
         
         return masked_value & 0x0FFFFFFF;
     }
-    
-    return current_value;
+    
+    return current_value;
+}
+
+// Ajoute la chaîne de clusters à la liste des séquences à libérer
+void FAT32::collect_chain_runs(uint32_t first_cluster, std::vector<ClusterRun>& runs) {
+    uint32_t cluster = first_cluster;
+    uint32_t length = 0;
+    while (cluster >= 2 && cluster <= last_cluster && length++ <= last_cluster) {
+        if (!runs.empty() && runs.back().first + runs.back().count == cluster) {
+            runs.back().count++;
+        } else {
+            runs.push_back(ClusterRun{cluster, 1});
+        }
+        uint32_t next = fat_entry(cluster, 0, false);
+        if (next >= FAT32_Cluster::EOC_MIN || next == FAT_Config::CLUSTER_FREE) break;
+        cluster = next;
+    }
+}
+
+// Libère les séquences triées par cluster: chaque secteur FAT touché est lu
+// et écrit (sur toutes les copies) une seule fois, au lieu d'une écriture par cluster.
+bool FAT32::free_cluster_runs(std::vector<ClusterRun>& runs) {
+    if (runs.empty()) return true;
+    std::sort(runs.begin(), runs.end(), [](const ClusterRun& a, const ClusterRun& b) { return a.first < b.first; });
+
+    const uint32_t entries_per_fat_sector = sector_size / 4;
+    uint32_t loaded = 0xFFFFFFFFu;   // secteur FAT (relatif à fat_base) présent dans write_buffer
+    auto store_loaded = [&]() -> bool {
+        for (uint8_t copy = 0; copy < fat_count; ++copy) {
+            if (!store_physical_block(fat_base + copy * sectors_per_fat + loaded, write_buffer)) {
+                printf("Erreur écriture FAT %u (secteur %lu)\n", (unsigned)(copy + 1), (unsigned long)loaded);
+                return false;
+            }
+        }
+        return true;
+    };
+
+    bool ok = true;
+    for (const ClusterRun& run : runs) {
+        for (uint32_t c = run.first; c < run.first + run.count && ok; ++c) {
+            uint32_t sector = c / entries_per_fat_sector;
+            if (sector != loaded) {
+                if (loaded != 0xFFFFFFFFu && !store_loaded()) { ok = false; break; }
+                if (!get_physical_block(fat_base + sector, write_buffer)) { ok = false; loaded = 0xFFFFFFFFu; break; }
+                loaded = sector;
+            }
+            // Les 4 bits de poids fort sont réservés et conservés
+            uint8_t* p = write_buffer + (c % entries_per_fat_sector) * 4;
+            p[0] = p[1] = p[2] = 0;
+            p[3] &= 0xF0;
+        }
+    }
+    if (ok && loaded != 0xFFFFFFFFu) ok = store_loaded();
+
+    if (ok && discard_erase_blocks_ != 0) {
+        for (const ClusterRun& run : runs) discard_enqueue(run.first, run.count);
+    }
+    runs.clear();
+    // La FAT a été modifiée sans passer par le cache secteur
+    fat_cache_valid = false;
+    fat_cache_sector = 0xFFFFFFFFu;
+    return ok;
+}
+
+bool FAT32::free_chain(uint32_t first_cluster) {
+    if (first_cluster < 2) return true;
+    std::vector<ClusterRun> runs;
+    collect_chain_runs(first_cluster, runs);
+    return free_cluster_runs(runs);
+}
+
+// ============================================================================
+// DISCARD DES CLUSTERS LIBÉRÉS
+// ============================================================================
+
+void FAT32::set_discard(uint32_t erase_block_sectors) {
+    discard_erase_blocks_ = erase_block_sectors;
+    discard_count_ = 0;
+}
+
+// Ajoute une séquence à la file en la fusionnant avec les séquences contiguës
+// ou chevauchantes. File pleine: fusion avec la séquence la plus proche; les
+// clusters encore alloués entre les deux sont écartés par process_discards(),
+// qui relit la FAT avant chaque effacement.
+void FAT32::discard_enqueue(uint32_t first_cluster, uint32_t count) {
+    ClusterRun merged{first_cluster, count};
+    auto absorb = [&](uint8_t i) {
+        const ClusterRun& q = discard_queue_[i];
+        uint32_t end = std::max(q.first + q.count, merged.first + merged.count);
+        merged.first = std::min(q.first, merged.first);
+        merged.count = end - merged.first;
+        discard_queue_[i] = discard_queue_[--discard_count_];
+    };
+    for (;;) {
+        for (uint8_t i = 0; i < discard_count_; ) {
+            const ClusterRun& q = discard_queue_[i];
+            if (q.first <= merged.first + merged.count && merged.first <= q.first + q.count) {
+                absorb(i);
+                i = 0;   // la séquence agrandie peut maintenant toucher une séquence déjà vue
+            } else {
+                ++i;
+            }
+        }
+        if (discard_count_ < FAT_Config::DISCARD_QUEUE_SIZE) {
+            discard_queue_[discard_count_++] = merged;
+            return;
+        }
+        uint8_t nearest = 0;
+        uint32_t best_gap = 0xFFFFFFFFu;
+        for (uint8_t i = 0; i < discard_count_; ++i) {
+            const ClusterRun& q = discard_queue_[i];
+            uint32_t gap = (q.first > merged.first) ? q.first - (merged.first + merged.count)
+                                                    : merged.first - (q.first + q.count);
+            if (gap < best_gap) { best_gap = gap; nearest = i; }
+        }
+        absorb(nearest);
+    }
+}
+
+bool FAT32::process_discards() {
+    if (!initialized || exfat_ || discard_erase_blocks_ == 0 || discard_count_ == 0) return false;
+    // Un fichier ouvert en écriture alloue encore: attendre sa fermeture
+    if (write_open_) return true;
+    if (write_handler.Dir_Entry != 0) {
+        // Handler sans appelant (recherche interne non rétablie): rien ne
+        // s'écrit par lui, il ne doit pas bloquer les effacements
+        printf("  Handler d'écriture abandonné (entrée LBA %lu) réinitialisé\n", (unsigned long)write_handler.Dir_Entry);
+        write_handler = WriteHandler();
+        au_placement_ = false;
+    }
+
+    ClusterRun& run = discard_queue_[discard_count_ - 1];
+    const uint32_t end = run.first + run.count;
+    const uint32_t erase_blocks = discard_erase_blocks_;
+    const uint32_t max_blocks = std::max<uint32_t>(FAT_Config::DISCARD_MAX_BLOCKS / erase_blocks, 1u) * erase_blocks;
+
+    // Les clusters ont pu être réalloués depuis leur libération: on ne retient
+    // que la première sous-séquence encore libre dans la FAT
+    uint32_t first = run.first;
+    while (first < end && first <= last_cluster && fat_entry(first, 0, false) != FAT_Config::CLUSTER_FREE) ++first;
+    uint32_t stop = first;
+    const uint32_t scan_limit = (max_blocks + erase_blocks) / cluster_size + 1;
+    while (stop < end && stop <= last_cluster && stop - first < scan_limit &&
+           fat_entry(stop, 0, false) == FAT_Config::CLUSTER_FREE) ++stop;
+
+    // Blocs d'effacement entièrement contenus dans la sous-séquence
+    const uint32_t lba_first = data_base + (first - 2) * cluster_size;
+    const uint32_t lba_end = data_base + (stop - 2) * cluster_size;
+    const uint32_t aligned_first = (lba_first + erase_blocks - 1) / erase_blocks * erase_blocks;
+    uint32_t aligned_end = lba_end / erase_blocks * erase_blocks;
+    if (aligned_end > aligned_first + max_blocks) aligned_end = aligned_first + max_blocks;
+
+    // La suite reprend au cluster contenant la fin effacée (bloc partiel compris)
+    uint32_t resume = stop;
+    if (aligned_end > aligned_first && aligned_end < lba_end) {
+        resume = 2 + (aligned_end - data_base) / cluster_size;
+    }
+    if (resume < end) {
+        run.count = end - resume;
+        run.first = resume;
+    } else {
+        discard_count_--;
+    }
+
+    if (aligned_end <= aligned_first) return true;   // trop court une fois aligné
+    // Aucune écriture en attente ne doit passer après l'effacement
+    io_.flush();
+    if (!sd_card->erase(aligned_first, aligned_end - 1)) {
+        printf("FAT32  Discard échoué (LBA %lu-%lu), file vidée\n",
+               (unsigned long)aligned_first, (unsigned long)(aligned_end - 1));
+        discard_count_ = 0;
+        return false;
+    }
+    discarded_blocks_ += aligned_end - aligned_first;
+    return true;
 }
 
 void FAT32::update_directory_entry_size() {
@@ -1000,34 +1687,34 @@ void FAT32::update_directory_entry_size() {
     uint32_t dir_lba = write_handler.Dir_Entry;
     
     if (get_physical_block(dir_lba, read_buffer)) {
-        root_Entries* entries = (root_Entries*)read_buffer;
-        const uint16_t ents = sector_size / sizeof(root_Entries);
-        bool found = false;
-        
-        for (uint16_t i = 0; i < ents && !found; ++i) {
-            root_Entries &e = entries[i];
-            if (e.FileName[0] == FAT_Config::FILE_CLEAR) break;
-            if (e.FileName[0] == FAT_Config::FILE_ERASED) continue;
-            if ((e.Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN) continue;
-            
-            // Identifier l'entrée correspondante par son cluster de base
-            uint32_t fc = ((uint32_t)e.FirstClusterHigh << 16) | e.FirstClusterNumber;
-            if (write_handler.BaseFatEntry != 0 && fc == write_handler.BaseFatEntry) {
-                // Mettre à jour la taille finale du fichier
-                e.SizeofFile = write_handler.File_Size;
-                
-                // Écrire le secteur modifié sur la carte SD
-                if (store_physical_block(dir_lba, (uint8_t*)entries)) {
-                    printf("  Taille fichier mise à jour: %ld bytes\n", write_handler.File_Size);
-                } else {
-                    printf("  Erreur: Impossible de mettre à jour la taille du fichier\n");
-                }
-                found = true;
-            }
+        // Entrée exacte mémorisée par file_open (index dans le secteur)
+        root_Entries &e = ((root_Entries*)read_buffer)[write_handler.DirIndex];
+        uint32_t fc = ((uint32_t)e.FirstClusterHigh << 16) | e.FirstClusterNumber;
+        if (fc != write_handler.BaseFatEntry) {
+            printf("  Attention: cluster de l'entrée (%lu) != cluster écrit (%lu)\n",
+                   (unsigned long)fc, (unsigned long)write_handler.BaseFatEntry);
         }
         
-        if (!found) {
-            printf("  Attention: Entrée de répertoire non trouvée pour mise à jour taille\n");
+        // Mettre à jour la taille finale du fichier
+        e.SizeofFile = write_handler.File_Size;
+
+        // Date de modification: l'heure système, mais toujours postérieure à
+        // l'ancienne. Sans horloge temps réel l'heure repart de 1980 à chaque
+        // démarrage: toute écriture change quand même (cluster, taille, date),
+        // la clé d'ImageCache
+        uint32_t stamp = to_ms_since_boot(get_absolute_time()) / 1000u;
+        const uint32_t previous = fat_stamp_seconds(e.ModificationDate, e.ModificationTime);
+        if (stamp <= previous) stamp = previous + 2;
+        uint16_t date, time;
+        fat_stamp_from_seconds(stamp, date, time);
+        e.ModificationDate = date;
+        e.ModificationTime = time;
+        
+        // Écrire le secteur modifié sur la carte SD
+        if (store_physical_block(dir_lba, read_buffer)) {
+            printf("  Taille fichier mise à jour: %ld bytes\n", write_handler.File_Size);
+        } else {
+            printf("  Erreur: Impossible de mettre à jour la taille du fichier\n");
         }
     } else {
         printf("  Erreur: Impossible de lire le secteur de répertoire\n");
@@ -1051,7 +1738,14 @@ void FAT32::flush_fat_cache() {
 
 // Méthodes utilitaires
 bool FAT32::create_file(const char* filename) {
-    return file_open(filename, CREATE) == FILE_CREATE_OK;
+    // Fichier vide: rien ne reste ouvert, l'écriture éventuelle de
+    // l'appelant est rétablie
+    const WriteHandler saved = write_handler;
+    const bool saved_au = au_placement_;
+    const bool created = open_path(filename, CREATE) == FILE_CREATE_OK;
+    write_handler = saved;
+    au_placement_ = saved_au;
+    return io_.flush() && created;
 }
 
 bool FAT32::delete_file(const char* filename) {
@@ -1069,6 +1763,56 @@ uint32_t FAT32::get_file_size(const char* filename) {
     return 0;
 }
 
+bool FAT32::get_file_info(const char* path, FileListEntry& out) {
+    if (!initialized || exfat_ || !path || !*path) return false;
+
+    uint32_t dir_cluster = (current_dir_cluster_ >= 2) ? current_dir_cluster_ : root_dir_first_cluster;
+    const char* slash = strrchr(path, '/');
+    const char* name = slash ? slash + 1 : path;
+    if (slash) {
+        const std::string parent(path, (size_t)(slash - path));
+        if (!resolve_directory(parent.empty() ? "/" : parent.c_str(), dir_cluster)) return false;
+    }
+    if (!*name) return false;
+
+    DirEntryLocation loc;
+    if (!find_dir_entry(dir_cluster, name, loc)) return false;
+    out.longFileName = name;
+    out.type = (loc.attributes & FAT_Config::AT_DIRECTORY) ? _Directory : _File;
+    out.attributes = loc.attributes;
+    out.size = loc.size;
+    out.firstCluster = loc.first_cluster;
+    out.modificationDate = loc.modification_date;
+    out.modificationTime = loc.modification_time;
+    return true;
+}
+
+bool FAT32::get_file_clusters(const char* path, std::vector<uint32_t>& clusters, uint32_t& size) {
+    FileListEntry info;
+    if (!get_file_info(path, info) || info.type != _File) return false;
+    clusters.clear();
+    size = info.size;
+    uint32_t cluster = info.firstCluster;
+    const uint32_t limit = (size + cluster_size * sector_size - 1) / (cluster_size * sector_size);
+    while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN && clusters.size() < limit) {
+        clusters.push_back(cluster);
+        cluster = fat_entry(cluster, 0, false);
+    }
+    return clusters.size() == limit;
+}
+
+bool FAT32::read_file_sector(const std::vector<uint32_t>& clusters, uint32_t index, uint8_t* buffer) {
+    const uint32_t c = index / cluster_size;
+    if (c >= clusters.size()) return false;
+    return get_physical_block(data_base + (clusters[c] - 2) * cluster_size + index % cluster_size, buffer);
+}
+
+bool FAT32::write_file_sector(const std::vector<uint32_t>& clusters, uint32_t index, const uint8_t* buffer) {
+    const uint32_t c = index / cluster_size;
+    if (c >= clusters.size()) return false;
+    return store_physical_block(data_base + (clusters[c] - 2) * cluster_size + index % cluster_size, buffer);
+}
+
 void FAT32::print_master_boot_info() {
     view_fat_infos();
 }
@@ -1096,6 +1840,10 @@ void FAT32::print_fat_chain(uint32_t start_cluster) {
         printf("Cluster de départ invalide: %lu\n", (unsigned long)start_cluster);
         return;
     }
+    if (exfat_) {
+        printf("exFAT  Affichage de chaîne FAT non supporté\n");
+        return;
+    }
     
     printf("=== Chaîne FAT depuis cluster %lu ===\n", (unsigned long)start_cluster);
     uint32_t cluster = start_cluster;
@@ -1135,6 +1883,11 @@ void FAT32::print_fat_chain(uint32_t start_cluster) {
 }
 
 uint32_t FAT32::get_free_space() {
+    if (exfat_) {
+        // Saturé à 4 Go: l'API expose des octets sur 32 bits
+        uint64_t bytes = (uint64_t)exfat_->count_free_clusters() * exfat_->get_cluster_bytes();
+        return bytes > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)bytes;
+    }
     uint32_t free_clusters = count_free_clusters();
     return free_clusters * cluster_size * sector_size;
 }
@@ -1142,6 +1895,10 @@ uint32_t FAT32::get_free_space() {
 uint32_t FAT32::get_total_space() {
     // Total usable space (bytes) = total_clusters * cluster_size * sector_size
     // where total_clusters is derived from data sectors after reserved/FAT/root areas
+    if (exfat_) {
+        uint64_t bytes = (uint64_t)exfat_->get_cluster_count() * exfat_->get_cluster_bytes();
+        return bytes > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)bytes;
+    }
     if (!initialized || cluster_size == 0 || sector_size == 0) return 0;
     uint32_t data_sectors = 0;
     if (sectors_in_partition > first_data_sector) {
@@ -1152,6 +1909,12 @@ uint32_t FAT32::get_total_space() {
 }
 
 float FAT32::get_free_space_percent() {
+    if (exfat_) {
+        // Calcul en clusters pour éviter la saturation des tailles 32 bits
+        uint32_t clusters = exfat_->get_cluster_count();
+        if (clusters == 0) return 0.0f;
+        return (float)exfat_->count_free_clusters() / (float)clusters * 100.0f;
+    }
     uint32_t total = get_total_space();
     if (total == 0) return 0.0f;
     
@@ -1164,6 +1927,7 @@ uint32_t FAT32::count_free_clusters() {
     if (!initialized) {
         return 0;
     }
+    if (exfat_) return exfat_->count_free_clusters();
     
     uint32_t free_count = 0;
     uint32_t total_clusters = last_cluster;
@@ -1196,88 +1960,198 @@ uint32_t FAT32::count_free_clusters() {
 bool FAT32::change_directory(const char* dir_name) {
     if (!initialized) return false;
     if (!dir_name || !*dir_name) return false;
+    if (exfat_) {
+        if (!exfat_->change_directory(dir_name)) return false;
+        current_dir_cluster_ = exfat_->get_current_dir_cluster();
+        return true;
+    }
+
+    uint32_t cluster = 0;
+    if (!resolve_directory(dir_name, cluster)) return false;
+    current_dir_cluster_ = cluster;
+    return true;
+}
 
-    // Gérer racine
-    if (strcmp(dir_name, "/") == 0) {
-        current_dir_cluster_ = root_dir_first_cluster;
+bool FAT32::push_directory(const char* dir_name) {
+    if (!initialized || !dir_name || !*dir_name) return false;
+    if (dir_stack_depth_ >= FAT_Config::DIR_STACK_DEPTH) {
+        printf("FAT32  Pile de répertoires pleine\n");
+        return false;
+    }
+    if (exfat_) {
+        if (!exfat_->push_directory(dir_name)) return false;
+        dir_stack_[dir_stack_depth_++] = current_dir_cluster_;
+        current_dir_cluster_ = exfat_->get_current_dir_cluster();
         return true;
     }
 
-    // Dupliquer chemin pour tokenization simple
-    char path_buf[256];
-    strncpy(path_buf, dir_name, sizeof(path_buf) - 1);
-    path_buf[sizeof(path_buf) - 1] = '\0';
+    uint32_t cluster = 0;
+    if (!resolve_directory(dir_name, cluster)) return false;
+    dir_stack_[dir_stack_depth_++] = current_dir_cluster_;
+    current_dir_cluster_ = cluster;
+    return true;
+}
 
-    // Si chemin absolu, repartir de la racine
-    uint32_t start_cluster = root_dir_first_cluster;
-    const char* p = path_buf;
-    if (*p == '/') p++;
+bool FAT32::pop_directory() {
+    if (!initialized || dir_stack_depth_ == 0) return false;
+    if (exfat_ && !exfat_->pop_directory()) return false;
+    current_dir_cluster_ = dir_stack_[--dir_stack_depth_];
+    return true;
+}
 
-    // Tokeniser par '/'
-    char* ctx = nullptr;
-    char* token = strtok_r((char*)p, "/", &ctx);
-    uint32_t current = start_cluster;
+// ============================================================================
+// RÉSOLUTION DES CHEMINS DE RÉPERTOIRES
+// ============================================================================
 
-    while (token) {
-        // Parcourir le répertoire courant pour trouver le sous-dossier "token"
-        bool found = false;
-        uint32_t cluster = current;
-        while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN && !found) {
-            for (uint16_t sec = 0; sec < cluster_size && !found; ++sec) {
-                uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
-                if (!get_physical_block(lba, read_buffer)) {
-                    return false;
-                }
-                root_Entries* file_structure = (root_Entries*)read_buffer;
-                uint16_t entries_per_sector = sector_size / sizeof(root_Entries);
-                // Pour matcher sur LFN, on relit les entrées précédentes LFN si besoin
-                // Ici on se contente de matcher sur nom DOS 8.3 (limitation simple)
-                for (uint16_t i = 0; i < entries_per_sector; ++i) {
-                    auto &e = file_structure[i];
-                    if (e.FileName[0] == FAT_Config::FILE_CLEAR) break;
-                    if (e.FileName[0] == FAT_Config::FILE_ERASED) continue;
-                    if (!(e.Attributes & FAT_Config::AT_DIRECTORY)) continue;
-                    if ((e.Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN) continue;
+bool FAT32::read_dir_sector(uint32_t lba) {
+    dir_stats_.dir_sector_reads++;
+    return get_physical_block(lba, read_buffer);
+}
 
-                    // Construire nom 8.3 lisible
-                    char dos_name[13] = {0};
-                    int k = 0;
-                    for (int c = 0; c < 8 && e.FileName[c] != ' '; ++c) dos_name[k++] = (char)e.FileName[c];
-                    dos_name[k] = '\0';
-                    // Compare case-insensitive avec token (sans slash)
-                    auto ieq = [](char a, char b){ return std::toupper((unsigned char)a) == std::toupper((unsigned char)b); };
-                    bool match = true;
-                    size_t tlen = strlen(token);
-                    if (tlen != strlen(dos_name)) match = false;
-                    else {
-                        for (size_t m = 0; m < tlen; ++m) {
-                            if (!ieq(token[m], dos_name[m])) { match = false; break; }
-                        }
-                    }
-                    if (match) {
-                        uint32_t next_cluster = ((uint32_t)e.FirstClusterHigh << 16) | (uint32_t)e.FirstClusterNumber;
-                        if (next_cluster >= 2 && next_cluster < FAT32_Cluster::EOC_MIN) {
-                            current = next_cluster;
-                            found = true;
-                            break;
-                        }
-                    }
+// Recherche d'une entrée (nom long ou 8.3, '.' et '..' compris) dans un répertoire
+bool FAT32::find_dir_entry(uint32_t dir_cluster, const char* name, DirEntryLocation& out) {
+    bool lfn_flag = false;
+    char lfn_name[FAT_Config::MAX_LFN_CHARACTERS];
+    lfn_name[0] = '\0';
+    lfn_buffer.clear();
+    DirCursor lfn_start{0, 0, 0};
+    uint16_t lfn_entries = 0;
+
+    uint32_t cluster = dir_cluster;
+    while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN) {
+        for (uint16_t sec = 0; sec < cluster_size; ++sec) {
+            uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
+            if (!read_dir_sector(lba)) return false;
+            root_Entries* entries = (root_Entries*)read_buffer;
+            const uint16_t ents = sector_size / sizeof(root_Entries);
+            for (uint16_t i = 0; i < ents; ++i) {
+                root_Entries* e = &entries[i];
+                if (e->FileName[0] == FAT_Config::FILE_CLEAR) return false;
+
+                if ((e->Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN && (e->FileName[0] & 0x40)) {
+                    lfn_start = DirCursor{cluster, sec, i};
+                    lfn_entries = e->FileName[0] & 0x3F;
+                }
+                FileEntryType type = fat_filename_parser(e);
+                if (type == _LongFileNameOK) {
+                    lfn_flag = true;
+                    strncpy(lfn_name, lfn_buffer.c_str(), sizeof(lfn_name) - 1);
+                    lfn_name[sizeof(lfn_name) - 1] = '\0';
+                    lfn_buffer.clear();
+                    continue;
+                }
+                if (type != _File && type != _Directory) continue;
+                if (e->Attributes & FAT_Config::AT_VOLUME_ID) { lfn_flag = false; continue; }
+
+                const bool had_lfn = lfn_flag && lfn_name[0];
+                lfn_flag = false;
+
+                // Nom 8.3 sans le '\\' que le parser ajoute aux répertoires
+                char dos_name[13];
+                int k = 0;
+                for (int c = 0; c < 8 && e->FileName[c] != ' '; ++c) dos_name[k++] = (char)e->FileName[c];
+                if (type == _File && e->Extension[0] != ' ') {
+                    dos_name[k++] = '.';
+                    for (int c = 0; c < 3 && e->Extension[c] != ' '; ++c) dos_name[k++] = (char)e->Extension[c];
+                }
+                dos_name[k] = '\0';
+
+                if ((had_lfn && FAT_Utils::iequals(lfn_name, name)) || FAT_Utils::iequals(dos_name, name)) {
+                    out.start = had_lfn ? lfn_start : DirCursor{cluster, sec, i};
+                    out.count = had_lfn ? (uint16_t)(lfn_entries + 1) : 1;
+                    out.first_cluster = ((uint32_t)e->FirstClusterHigh << 16) | (uint32_t)e->FirstClusterNumber;
+                    out.attributes = e->Attributes;
+                    out.size = e->SizeofFile;
+                    out.modification_date = e->ModificationDate;
+                    out.modification_time = e->ModificationTime;
+                    return true;
                 }
-            }
-            if (!found) {
-                uint32_t next = fat_entry(cluster, 0, false);
-                if (next >= FAT32_Cluster::EOC_MIN || next == 0) break;
-                cluster = next;
             }
         }
-        if (!found) return false;
-        token = strtok_r(nullptr, "/", &ctx);
+        uint32_t next = fat_entry(cluster, 0, false);
+        if (next >= FAT32_Cluster::EOC_MIN || next == 0) break;
+        cluster = next;
+    }
+    return false;
+}
+
+bool FAT32::find_subdirectory(uint32_t dir_cluster, const char* name, uint32_t& out_cluster) {
+    DirEntryLocation loc;
+    if (!find_dir_entry(dir_cluster, name, loc)) return false;
+    if (!(loc.attributes & FAT_Config::AT_DIRECTORY)) return false;
+    // ".." vers la racine est codé par le cluster 0
+    out_cluster = (loc.first_cluster == 0) ? root_dir_first_cluster : loc.first_cluster;
+    return out_cluster >= 2 && out_cluster < FAT32_Cluster::EOC_MIN;
+}
+
+// Résout un chemin de répertoire absolu ou relatif au répertoire courant.
+// Chaque composant est d'abord cherché dans le cache: un chemin déjà visité
+// ne coûte aucune lecture de secteur.
+bool FAT32::resolve_directory(const char* path, uint32_t& out_cluster) {
+    uint32_t current = root_dir_first_cluster;
+    const char* p = path;
+    if (*p == '/') {
+        ++p;
+    } else if (current_dir_cluster_ >= 2) {
+        current = current_dir_cluster_;
     }
 
-    current_dir_cluster_ = current;
+    char path_buf[FAT32_Config::MAX_PATH_LENGTH + 1];
+    strncpy(path_buf, p, sizeof(path_buf) - 1);
+    path_buf[sizeof(path_buf) - 1] = '\0';
+
+    char* ctx = nullptr;
+    for (char* token = strtok_r(path_buf, "/", &ctx); token; token = strtok_r(nullptr, "/", &ctx)) {
+        if (strcmp(token, ".") == 0) continue;
+        // La racine n'a pas d'entrée "..": on y reste
+        if (strcmp(token, "..") == 0 && current == root_dir_first_cluster) continue;
+
+        dir_stats_.path_lookups++;
+        uint32_t next = 0;
+        if (dir_cache_lookup(current, token, next)) {
+            dir_stats_.cache_hits++;
+        } else {
+            if (!find_subdirectory(current, token, next)) return false;
+            dir_cache_insert(current, token, next);
+        }
+        current = next;
+    }
+    out_cluster = current;
     return true;
 }
 
+bool FAT32::dir_cache_lookup(uint32_t parent, const char* name, uint32_t& out_cluster) {
+    for (auto& entry : dir_cache_) {
+        if (entry.parent == parent && FAT_Utils::iequals(entry.name, name)) {
+            entry.last_use = ++dir_cache_tick_;
+            out_cluster = entry.cluster;
+            return true;
+        }
+    }
+    return false;
+}
+
+void FAT32::dir_cache_insert(uint32_t parent, const char* name, uint32_t cluster) {
+    if (strlen(name) >= FAT_Config::DIR_CACHE_NAME_LEN) return;
+    // Remplacement de l'entrée la moins récemment utilisée (ou d'une entrée libre)
+    DirCacheEntry* victim = &dir_cache_[0];
+    for (auto& entry : dir_cache_) {
+        if (entry.parent == 0) { victim = &entry; break; }
+        if (entry.last_use < victim->last_use) victim = &entry;
+    }
+    victim->parent = parent;
+    victim->cluster = cluster;
+    victim->last_use = ++dir_cache_tick_;
+    strncpy(victim->name, name, sizeof(victim->name) - 1);
+    victim->name[sizeof(victim->name) - 1] = '\0';
+}
+
+void FAT32::dir_cache_invalidate() {
+    memset(dir_cache_, 0, sizeof(dir_cache_));
+    dir_cache_tick_ = 0;
+    create_hint_.dir_cluster = 0;
+}
+
 bool FAT32::rename_file(const char* old_name, const char* new_name) {
     if (!initialized || !old_name || !new_name) {
         return false;
@@ -1296,15 +2170,26 @@ bool FAT32::rename_file(const char* old_name, const char* new_name) {
         return false;
     }
 
-    // Open old file to locate its directory sector
-    FAT_ErrorCode fr = file_open(old_name, MODIFY);
+    // Open old file to locate its directory sector. The write handler is
+    // only borrowed: restored on every return, so nothing is left behind
+    // (process_discards) and a caller's open write is not lost
+    const WriteHandler saved = write_handler;
+    const bool saved_au = au_placement_;
+    auto finish = [&](bool ok) {
+        write_handler = saved;
+        au_placement_ = saved_au;
+        return ok;
+    };
+    // Le nouveau nom n'est pas dans l'index de create_dir_entry()
+    create_hint_.dir_cluster = 0;
+    FAT_ErrorCode fr = open_path(old_name, MODIFY);
     if (fr != FILE_FOUND && fr != FILE_CREATE_OK) {
-        return false;
+        return finish(false);
     }
 
     uint32_t dir_lba = write_handler.Dir_Entry;
-    if (dir_lba == 0) return false;
-    if (!get_physical_block(dir_lba, read_buffer)) return false;
+    if (dir_lba == 0) return finish(false);
+    if (!get_physical_block(dir_lba, read_buffer)) return finish(false);
     root_Entries* entries = (root_Entries*)read_buffer;
     const uint16_t ents = sector_size / sizeof(root_Entries);
 
@@ -1328,7 +2213,7 @@ bool FAT32::rename_file(const char* old_name, const char* new_name) {
         // Check for conflict with other files
         if (FAT_Utils::iequals(nm, new_base)) {
             // already exists
-            return false;
+            return finish(false);
         }
     }
 
@@ -1345,22 +2230,25 @@ bool FAT32::rename_file(const char* old_name, const char* new_name) {
             memcpy(e.FileName, dos11_new, 8);
             memcpy(e.Extension, dos11_new + 8, 3);
             bool success = store_physical_block(dir_lba, (uint8_t*)entries);
-            return success;
+            return finish(io_.flush() && success);
         }
     }
-    return false;
+    return finish(false);
 }
 
 bool FAT32::create_directory(const char* dir_name) {
     if (!initialized || !dir_name) return false;
+    if (exfat_) {
+        printf("exFAT  Volume en lecture seule\n");
+        return false;
+    }
     // Only create in current directory if name has no '/'
     if (strchr(dir_name, '/')) return false;
-    char dos11[11];
-    if (!FAT_Utils::to_dos_8_3(dir_name, dos11)) return false;
+    if (!FAT_Utils::is_valid_filename(dir_name)) return false;
 
     uint32_t parent = current_dir_cluster_ ? current_dir_cluster_ : root_dir_first_cluster;
     // Allocate cluster for new directory
-    uint16_t newc = fat_search_available_cluster((uint16_t)parent);
+    uint32_t newc = fat_search_available_cluster(parent);
     if (newc < 2) return false;
     (void)fat_entry(newc, FAT32_Cluster::EOC_MIN, true);
     // Zero cluster
@@ -1392,66 +2280,32 @@ bool FAT32::create_directory(const char* dir_name) {
     entsp[1].SizeofFile = 0;
     if (!store_physical_block(lba0, (uint8_t*)entsp)) return false;
 
-    // Add entry into parent directory
-    uint32_t cluster = parent;
-    while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN) {
-        for (uint16_t sec = 0; sec < cluster_size; ++sec) {
-            uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
-            if (!get_physical_block(lba, read_buffer)) return false;
-            root_Entries* e = (root_Entries*)read_buffer;
-            const uint16_t count = sector_size / sizeof(root_Entries);
-            for (uint16_t i = 0; i < count; ++i) {
-                if (e[i].FileName[0] == FAT_Config::FILE_CLEAR || e[i].FileName[0] == FAT_Config::FILE_ERASED) {
-                    memset(&e[i], 0, sizeof(root_Entries));
-                    memcpy(e[i].FileName, dos11, 8);
-                    memcpy(e[i].Extension, dos11 + 8, 3);
-                    e[i].Attributes = FAT_Config::AT_DIRECTORY;
-                    e[i].FirstClusterHigh = (uint16_t)((newc >> 16) & 0xFFFF);
-                    e[i].FirstClusterNumber = (uint16_t)(newc & 0xFFFF);
-                    e[i].SizeofFile = 0;
-                    return store_physical_block(lba, (uint8_t*)e);
-                }
-            }
-        }
-        uint32_t next = fat_entry(cluster, 0, false);
-        if (next >= FAT32_Cluster::EOC_MIN || next == 0) {
-            // Extend parent directory
-            uint16_t freec = fat_search_available_cluster((uint16_t)cluster);
-            if (freec < 2) return false;
-            (void)fat_entry(cluster, freec, true);
-            (void)fat_entry(freec, FAT32_Cluster::EOC_MIN, true);
-            // zero new parent dir cluster
-            uint8_t z[512]; memset(z, 0, sizeof(z));
-            for (uint16_t s = 0; s < cluster_size; ++s) {
-                uint32_t zlba = data_base + ((freec - 2) * cluster_size) + s;
-                if (!store_physical_block(zlba, z)) return false;
-            }
-            // place entry at first slot
-            uint32_t lba = data_base + ((freec - 2) * cluster_size) + 0;
-            if (!get_physical_block(lba, read_buffer)) return false;
-            root_Entries* e = (root_Entries*)read_buffer;
-            memset(e, 0, sector_size);
-            memcpy(e[0].FileName, dos11, 8);
-            memcpy(e[0].Extension, dos11 + 8, 3);
-            e[0].Attributes = FAT_Config::AT_DIRECTORY;
-            e[0].FirstClusterHigh = (uint16_t)((newc >> 16) & 0xFFFF);
-            e[0].FirstClusterNumber = (uint16_t)(newc & 0xFFFF);
-            e[0].SizeofFile = 0;
-            return store_physical_block(lba, (uint8_t*)e);
-        }
-        cluster = next;
+    // Add entry (with LFN if needed) into parent directory
+    uint32_t sfn_lba = 0;
+    uint16_t sfn_index = 0;
+    if (create_dir_entry(parent, dir_name, FAT_Config::AT_DIRECTORY, newc, sfn_lba, sfn_index) != FILE_CREATE_OK) {
+        // Name already used or directory full: release the cluster
+        (void)fat_entry(newc, FAT_Config::CLUSTER_FREE, true);
+        return false;
     }
-    return false;
+    return true;
 }
 
 std::vector<std::string> FAT32::get_directory_tree() {
     std::vector<std::string> list;
     if (!initialized) return list;
+    if (exfat_) {
+        std::vector<FileListEntry> entries;
+        if (exfat_->list_directory(entries) == ERROR_IDLE) {
+            for (const auto& e : entries) list.emplace_back(e.longFileName);
+        }
+        return list;
+    }
     uint32_t cluster = current_dir_cluster_ ? current_dir_cluster_ : root_dir_first_cluster;
     while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN) {
         for (uint16_t sec = 0; sec < cluster_size; ++sec) {
             uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
-            if (!get_physical_block(lba, read_buffer)) return list;
+            if (!read_dir_sector(lba)) return list;
             root_Entries* e = (root_Entries*)read_buffer;
             const uint16_t ents = sector_size / sizeof(root_Entries);
             for (uint16_t i = 0; i < ents; ++i) {
@@ -1478,8 +2332,14 @@ void FAT32::cleanup_deleted_files() {
         printf("FAT32 non initialisé\n");
         return;
     }
+    if (exfat_) {
+        printf("exFAT  Volume en lecture seule\n");
+        return;
+    }
     
     printf("=== Nettoyage des fichiers supprimés ===\n");
+    // Le compactage déplace la fin des répertoires
+    create_hint_.dir_cluster = 0;
     uint32_t total_freed = 0;
     uint32_t entries_compacted = 0;
     
@@ -1493,9 +2353,11 @@ void FAT32::cleanup_deleted_files() {
         
         // Find erased entries and shift valid entries up
         uint16_t write_idx = 0;
+        bool end_found = false;
         for (uint16_t read_idx = 0; read_idx < ents; ++read_idx) {
             // Stop at end-of-directory marker
             if (entries[read_idx].FileName[0] == FAT_Config::FILE_CLEAR) {
+                end_found = true;
                 // Fill rest with clear markers
                 for (uint16_t i = write_idx; i < ents; ++i) {
                     if (entries[i].FileName[0] != FAT_Config::FILE_CLEAR) {
@@ -1521,6 +2383,13 @@ void FAT32::cleanup_deleted_files() {
             }
             write_idx++;
         }
+        // Sector full up to the end: the slots freed by the shift still hold
+        // copies of the moved entries and must be marked as erased
+        if (!end_found) {
+            for (uint16_t i = write_idx; i < ents; ++i) {
+                entries[i].FileName[0] = FAT_Config::FILE_ERASED;
+            }
+        }
         
         if (modified) {
             return store_physical_block(lba, read_buffer);
@@ -1528,11 +2397,21 @@ void FAT32::cleanup_deleted_files() {
         return true;
     };
     
-    // Recursive helper to scan directory tree
-    std::function<void(uint32_t)> scan_directory = [&](uint32_t dir_cluster) {
-        if (dir_cluster < 2 || dir_cluster >= FAT32_Cluster::EOC_MIN) return;
-        
-        std::vector<uint32_t> subdirs;
+    // Iterative scan of the directory tree (explicit stack, no recursion on the 3.5 KB stack)
+    std::vector<uint32_t> pending;
+    pending.push_back(root_dir_first_cluster);
+    printf("Scan du répertoire racine (cluster %lu)...\n", (unsigned long)root_dir_first_cluster);
+    uint32_t visited_dirs = 0;
+
+    while (!pending.empty()) {
+        uint32_t dir_cluster = pending.back();
+        pending.pop_back();
+        if (dir_cluster < 2 || dir_cluster >= FAT32_Cluster::EOC_MIN) continue;
+        if (++visited_dirs > last_cluster) {
+            printf("Boucle de répertoires détectée, nettoyage interrompu\n");
+            break;
+        }
+
         uint32_t cluster = dir_cluster;
         
         while (cluster >= 2 && cluster < FAT32_Cluster::EOC_MIN) {
@@ -1554,7 +2433,7 @@ void FAT32::cleanup_deleted_files() {
                         if (entries[i].FileName[0] != '.') {
                             uint32_t subdir = ((uint32_t)entries[i].FirstClusterHigh << 16) | entries[i].FirstClusterNumber;
                             if (subdir >= 2 && subdir < FAT32_Cluster::EOC_MIN) {
-                                subdirs.push_back(subdir);
+                                pending.push_back(subdir);
                             }
                         }
                     } else {
@@ -1589,23 +2468,346 @@ void FAT32::cleanup_deleted_files() {
             if (next >= FAT32_Cluster::EOC_MIN || next == 0) break;
             cluster = next;
         }
-        
-        // Recursively scan subdirectories
-        for (uint32_t subdir : subdirs) {
-            scan_directory(subdir);
-        }
-    };
-    
-    // Start from root directory
-    uint32_t root_cluster = root_dir_first_cluster;
-    printf("Scan du répertoire racine (cluster %lu)...\n", (unsigned long)root_cluster);
-    scan_directory(root_cluster);
+    }
     
     printf("Nettoyage terminé:\n");
     printf("  - %lu entrées supprimées compactées\n", (unsigned long)entries_compacted);
     printf("  - %lu fichiers orphelins détectés\n", (unsigned long)total_freed);
 }
 
+// ============================================================================
+// SUPPRESSION RÉCURSIVE
+// ============================================================================
+
+bool FAT32::remove_tree(const char* path) {
+    if (!initialized || !path || !*path) return false;
+    if (exfat_) {
+        printf("exFAT  Volume en lecture seule\n");
+        return false;
+    }
+
+    // Répertoire parent et nom de l'entrée à supprimer
+    uint32_t parent = (current_dir_cluster_ >= 2) ? current_dir_cluster_ : root_dir_first_cluster;
+    const char* slash = strrchr(path, '/');
+    const std::string name(slash ? slash + 1 : path);
+    if (slash) {
+        const std::string parent_path(path, (size_t)(slash - path));
+        if (!resolve_directory(parent_path.empty() ? "/" : parent_path.c_str(), parent)) return false;
+    }
+    if (name.empty() || name == "." || name == "..") {
+        printf("FAT32  Suppression refusée: %s\n", path);
+        return false;
+    }
+
+    DirEntryLocation target;
+    if (!find_dir_entry(parent, name.c_str(), target)) return false;
+    if (!(target.attributes & FAT_Config::AT_DIRECTORY)) {
+        return file_open(path, DELETE) == FILE_FOUND;
+    }
+
+    // Parcours itératif (pile explicite). Les entrées des sous-répertoires ne
+    // sont pas effacées une à une: leurs clusters sont libérés en bloc.
+    std::vector<ClusterRun> runs;
+    runs.reserve(FAT_Config::FREE_RUN_BATCH);
+    std::vector<uint32_t> pending;
+    if (target.first_cluster >= 2) pending.push_back(target.first_cluster);
+    uint32_t files = 0, dirs = 0;
+    bool ok = true;
+
+    while (!pending.empty() && ok) {
+        uint32_t dir_cluster = pending.back();
+        pending.pop_back();
+        if (++dirs > last_cluster) {
+            printf("FAT32  Boucle de répertoires détectée, suppression interrompue\n");
+            ok = false;
+            break;
+        }
+
+        uint32_t cluster = dir_cluster;
+        bool end_of_dir = false;
+        uint32_t dir_length = 0;
+        while (ok && !end_of_dir && cluster >= 2 && cluster <= last_cluster && dir_length++ <= last_cluster) {
+            for (uint16_t sec = 0; sec < cluster_size && !end_of_dir; ++sec) {
+                uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
+                if (!read_dir_sector(lba)) { ok = false; break; }
+                const root_Entries* entries = (const root_Entries*)read_buffer;
+                const uint16_t ents = sector_size / sizeof(root_Entries);
+                for (uint16_t i = 0; i < ents; ++i) {
+                    const root_Entries& e = entries[i];
+                    if (e.FileName[0] == FAT_Config::FILE_CLEAR) { end_of_dir = true; break; }
+                    if (e.FileName[0] == FAT_Config::FILE_ERASED) continue;
+                    if ((e.Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN) continue;
+                    if (e.Attributes & FAT_Config::AT_VOLUME_ID) continue;
+                    if (e.FileName[0] == '.') continue;   // "." et ".."
+
+                    uint32_t first = ((uint32_t)e.FirstClusterHigh << 16) | e.FirstClusterNumber;
+                    if (e.Attributes & FAT_Config::AT_DIRECTORY) {
+                        if (first >= 2) pending.push_back(first);
+                        continue;
+                    }
+                    files++;
+                    collect_chain_runs(first, runs);
+                }
+                // Le répertoire en cours n'est jamais dans 'runs': la FAT peut être écrite
+                if (runs.size() >= FAT_Config::FREE_RUN_BATCH && !free_cluster_runs(runs)) ok = false;
+            }
+            if (!end_of_dir && ok) {
+                uint32_t next = fat_entry(cluster, 0, false);
+                if (next >= FAT32_Cluster::EOC_MIN || next < 2) break;
+                cluster = next;
+            }
+        }
+        // Les clusters du répertoire lui-même, une fois son contenu parcouru
+        collect_chain_runs(dir_cluster, runs);
+    }
+    if (ok) ok = free_cluster_runs(runs);
+    if (!ok) {
+        printf("FAT32  Erreur pendant la suppression de %s\n", path);
+        return false;
+    }
+    if (!erase_dir_entries(target.start, target.count)) return false;
+
+    // Les répertoires supprimés ne doivent plus être résolus ni restaurés
+    dir_cache_invalidate();
+    auto removed = [&](uint32_t cluster) {
+        return cluster != root_dir_first_cluster && fat_entry(cluster, 0, false) == FAT_Config::CLUSTER_FREE;
+    };
+    if (removed(current_dir_cluster_)) current_dir_cluster_ = root_dir_first_cluster;
+    for (uint8_t i = 0; i < dir_stack_depth_; ++i) {
+        if (removed(dir_stack_[i])) dir_stack_[i] = root_dir_first_cluster;
+    }
+
+    printf("FAT32  %s supprimé: %lu fichier(s), %lu répertoire(s)\n", path,
+           (unsigned long)files, (unsigned long)dirs);
+    return true;
+}
+
+// ============================================================================
+// VÉRIFICATION DU SYSTÈME DE FICHIERS (FSCK)
+// ============================================================================
+
+bool FAT32::check_filesystem(FsckReport& report, uint8_t* scratch, uint32_t scratch_size) {
+    report = FsckReport();
+    if (!initialized) {
+        printf("FAT32 non initialisé\n");
+        return false;
+    }
+    if (exfat_) {
+        printf("exFAT  fsck non supporté\n");
+        return false;
+    }
+
+    const uint32_t entries_per_fat_sector = sector_size / 4;
+    // Fenêtre de clusters couverte par le bitmap: multiple du nombre d'entrées
+    // par secteur FAT, pour que chaque secteur FAT appartienne à une seule passe.
+    const uint32_t window = (scratch_size * 8u / entries_per_fat_sector) * entries_per_fat_sector;
+    if (!scratch || window == 0) {
+        printf("fsck: mémoire de travail insuffisante\n");
+        return false;
+    }
+    const uint32_t cluster_limit = last_cluster + 1;             // clusters valides: [2, last_cluster]
+    const uint32_t cluster_bytes = (uint32_t)cluster_size * sector_size;
+    report.passes = (cluster_limit + window - 1) / window;
+
+    // Lecture de la FAT via un secteur local (write_buffer): les chaînes
+    // contiguës coûtent une lecture par secteur FAT au lieu d'un fat_entry par cluster.
+    uint32_t stream_sector = 0xFFFFFFFFu;
+    auto next_cluster = [&](uint32_t cluster) -> uint32_t {
+        uint32_t lba = fat_base + cluster / entries_per_fat_sector;
+        if (lba != stream_sector) {
+            if (!get_physical_block(lba, write_buffer)) {
+                stream_sector = 0xFFFFFFFFu;
+                return 0;
+            }
+            stream_sector = lba;
+        }
+        const uint8_t* p = write_buffer + (cluster % entries_per_fat_sector) * 4;
+        uint32_t v = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        return v & 0x0FFFFFFF;
+    };
+
+    uint32_t win_first = 0;
+    uint32_t win_end = 0;
+    bool first_pass = true;
+
+    // Parcourt une chaîne en marquant la propriété des clusters de la fenêtre.
+    // Retourne la longueur de la chaîne (en clusters) ; cross/broken signalent les anomalies.
+    auto walk_chain = [&](uint32_t first, bool& cross, bool& broken) -> uint32_t {
+        cross = broken = false;
+        uint32_t length = 0;
+        uint32_t cluster = first;
+        while (true) {
+            if (cluster < 2 || cluster > last_cluster || length > last_cluster) {
+                broken = true;
+                break;
+            }
+            if (cluster >= win_first && cluster < win_end) {
+                uint32_t bit = cluster - win_first;
+                if (scratch[bit >> 3] & (1u << (bit & 7))) {
+                    cross = true;
+                    report.cross_links++;
+                    break;
+                }
+                scratch[bit >> 3] |= (uint8_t)(1u << (bit & 7));
+                report.used_clusters++;
+            }
+            length++;
+            uint32_t next = next_cluster(cluster);
+            if (next >= FAT32_Cluster::EOC_MIN) break;
+            if (next == FAT_Config::CLUSTER_FREE || next == FAT32_Cluster::BAD) {
+                broken = true;
+                break;
+            }
+            cluster = next;
+        }
+        if (broken && first_pass) report.broken_chains++;
+        return length;
+    };
+
+    auto entry_name = [](const root_Entries& e, char out[13]) {
+        int k = 0;
+        for (int c = 0; c < 8 && e.FileName[c] != ' '; ++c) out[k++] = (char)e.FileName[c];
+        if (e.Extension[0] != ' ') {
+            out[k++] = '.';
+            for (int c = 0; c < 3 && e.Extension[c] != ' '; ++c) out[k++] = (char)e.Extension[c];
+        }
+        out[k] = '\0';
+    };
+
+    printf("=== Vérification FAT32 (%lu clusters, %lu passe(s)) ===\n",
+           (unsigned long)(last_cluster - 1), (unsigned long)report.passes);
+
+    for (uint32_t pass = 0; pass < report.passes; ++pass) {
+        first_pass = (pass == 0);
+        win_first = pass * window;
+        win_end = std::min(win_first + window, cluster_limit);
+        memset(scratch, 0, (window + 7) / 8);
+
+        // 1. Parcours itératif de l'arborescence (pile explicite, pas de récursion)
+        std::vector<uint32_t> pending;
+        bool cross = false, broken = false;
+        walk_chain(root_dir_first_cluster, cross, broken);
+        pending.push_back(root_dir_first_cluster);
+        uint32_t visited_dirs = 0;
+
+        while (!pending.empty()) {
+            uint32_t dir_cluster = pending.back();
+            pending.pop_back();
+            if (++visited_dirs > last_cluster) {
+                printf("fsck: boucle de répertoires détectée, parcours interrompu\n");
+                break;
+            }
+
+            uint32_t cluster = dir_cluster;
+            bool end_of_dir = false;
+            uint32_t dir_length = 0;
+            while (!end_of_dir && cluster >= 2 && cluster <= last_cluster && dir_length++ <= last_cluster) {
+                for (uint16_t sec = 0; sec < cluster_size && !end_of_dir; ++sec) {
+                    uint32_t lba = data_base + ((cluster - 2) * cluster_size) + sec;
+                    if (!get_physical_block(lba, read_buffer)) {
+                        printf("Erreur lecture secteur %lu\n", (unsigned long)lba);
+                        return false;
+                    }
+                    root_Entries* entries = (root_Entries*)read_buffer;
+                    const uint16_t ents = sector_size / sizeof(root_Entries);
+                    for (uint16_t i = 0; i < ents; ++i) {
+                        const root_Entries& e = entries[i];
+                        if (e.FileName[0] == FAT_Config::FILE_CLEAR) { end_of_dir = true; break; }
+                        if (e.FileName[0] == FAT_Config::FILE_ERASED) continue;
+                        if ((e.Attributes & FAT_Config::AT_LFN) == FAT_Config::AT_LFN) continue;
+                        if (e.Attributes & FAT_Config::AT_VOLUME_ID) continue;
+                        if (e.FileName[0] == '.') continue;   // "." et ".."
+
+                        uint32_t first = ((uint32_t)e.FirstClusterHigh << 16) | e.FirstClusterNumber;
+                        char name[13];
+                        entry_name(e, name);
+
+                        if (e.Attributes & FAT_Config::AT_DIRECTORY) {
+                            if (first_pass) report.directories++;
+                            if (first < 2) {
+                                if (first_pass) {
+                                    report.broken_chains++;
+                                    printf("  Répertoire sans cluster: %s\n", name);
+                                }
+                                continue;
+                            }
+                            walk_chain(first, cross, broken);
+                            if (cross) printf("  Chaîne croisée: %s\\ (cluster %lu)\n", name, (unsigned long)first);
+                            else if (!broken) pending.push_back(first);
+                            continue;
+                        }
+
+                        if (first_pass) report.files++;
+                        uint32_t length = 0;
+                        if (first != 0) {
+                            length = walk_chain(first, cross, broken);
+                            if (cross) {
+                                printf("  Chaîne croisée: %s (cluster %lu)\n", name, (unsigned long)first);
+                                continue;
+                            }
+                            if (broken && first_pass) {
+                                printf("  Chaîne interrompue: %s (cluster %lu)\n", name, (unsigned long)first);
+                                continue;
+                            }
+                        }
+                        // Taille vs chaîne: ceil(taille / taille de cluster) clusters attendus
+                        uint32_t expected = (e.SizeofFile + cluster_bytes - 1) / cluster_bytes;
+                        if (first_pass && !broken && expected != length) {
+                            report.size_mismatches++;
+                            printf("  Taille incohérente: %s (%lu octets, %lu cluster(s) chaînés, %lu attendus)\n",
+                                   name, (unsigned long)e.SizeofFile, (unsigned long)length, (unsigned long)expected);
+                        }
+                    }
+                }
+                if (!end_of_dir) {
+                    uint32_t next = next_cluster(cluster);
+                    if (next >= FAT32_Cluster::EOC_MIN || next < 2) break;
+                    cluster = next;
+                }
+            }
+        }
+
+        // 2. Lecture séquentielle de la FAT sur la fenêtre: clusters perdus et miroir FAT2
+        uint32_t first_sector = win_first / entries_per_fat_sector;
+        uint32_t end_sector = std::min((win_end + entries_per_fat_sector - 1) / entries_per_fat_sector, sectors_per_fat);
+        for (uint32_t s = first_sector; s < end_sector; ++s) {
+            if (!get_physical_block(fat_base + s, read_buffer)) {
+                printf("Erreur lecture secteur FAT %lu\n", (unsigned long)(fat_base + s));
+                return false;
+            }
+            if (fat_count > 1) {
+                if (!get_physical_block(fat_base + sectors_per_fat + s, write_buffer)) {
+                    printf("Erreur lecture secteur FAT2 %lu\n", (unsigned long)(fat_base + sectors_per_fat + s));
+                    return false;
+                }
+                stream_sector = 0xFFFFFFFFu;   // write_buffer n'est plus un secteur FAT1
+                if (memcmp(read_buffer, write_buffer, sector_size) != 0) {
+                    report.fat_mirror_mismatches++;
+                    printf("  FAT1/FAT2 différentes au secteur %lu\n", (unsigned long)s);
+                }
+            }
+            for (uint32_t i = 0; i < entries_per_fat_sector; ++i) {
+                uint32_t cluster = s * entries_per_fat_sector + i;
+                if (cluster < 2 || cluster >= win_end) continue;
+                const uint8_t* p = read_buffer + i * 4;
+                uint32_t v = ((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24)) & 0x0FFFFFFF;
+                if (v == FAT_Config::CLUSTER_FREE || v == FAT32_Cluster::BAD) continue;
+                uint32_t bit = cluster - win_first;
+                if (!(scratch[bit >> 3] & (1u << (bit & 7)))) report.lost_clusters++;
+            }
+        }
+    }
+
+    printf("Répertoires: %lu, fichiers: %lu, clusters utilisés: %lu\n",
+           (unsigned long)report.directories, (unsigned long)report.files, (unsigned long)report.used_clusters);
+    printf("Chaînes croisées: %lu\n", (unsigned long)report.cross_links);
+    printf("Clusters perdus: %lu\n", (unsigned long)report.lost_clusters);
+    printf("Tailles incohérentes: %lu\n", (unsigned long)report.size_mismatches);
+    printf("Chaînes interrompues: %lu\n", (unsigned long)report.broken_chains);
+    printf("Secteurs FAT1/FAT2 différents: %lu\n", (unsigned long)report.fat_mirror_mismatches);
+    return true;
+}
+
 // Implémentations des utilitaires
 namespace FAT_Utils {
     
@@ -1697,6 +2899,67 @@ bool to_dos_8_3(const char* name, char out11[11]) {
     return true;
 }
 
+bool needs_lfn(const char* name, char out11[11]) {
+    if (!name || !*name) return false;
+    const size_t len = strlen(name);
+    const char* dot = strrchr(name, '.');
+    if (dot && strchr(name, '.') != dot) return true;          // plusieurs points
+    size_t base_len = dot ? (size_t)(dot - name) : len;
+    size_t ext_len = dot ? len - base_len - 1 : 0;
+    if (base_len == 0 || base_len > 8 || ext_len > 3) return true;
+    if (dot && ext_len == 0) return true;                       // "nom."
+    for (size_t i = 0; i < len; ++i) {
+        unsigned char c = (unsigned char)name[i];
+        if (c == ' ' || c >= 0x80 || strchr("+,;=[]", c)) return true;
+    }
+    return !to_dos_8_3(name, out11);
+}
+
+uint8_t make_short_alias(const char* long_name, uint32_t salt, char out11[11]) {
+    // Caractère admis dans un nom 8.3 (majuscules), '_' pour le reste
+    auto sfn_char = [](unsigned char c) -> char {
+        if (c >= 0x80 || strchr("+,;=[]\"*/:<>?\\|", c)) return '_';
+        return (char)std::toupper(c);
+    };
+    const char* dot = strrchr(long_name, '.');
+    if (dot == long_name) dot = nullptr;                        // ".cache": pas d'extension
+
+    // FNV-1a 32 bits sur le nom en majuscules, brassé, 30 bits en base 32 sur
+    // les 6 caractères: dans un répertoire de 10000 noms, un nouvel alias ne
+    // recoupe un alias existant qu'une fois sur 100000 environ (passe complète)
+    memset(out11, ' ', 11);
+    uint32_t h = 2166136261u ^ salt;
+    for (const char* p = long_name; *p; ++p) {
+        h ^= (uint8_t)std::toupper((unsigned char)*p);
+        h *= 16777619u;
+    }
+    h ^= h >> 16; h *= 0x45d9f3bu; h ^= h >> 16;
+    static const char base32[] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+    uint8_t k = 0;
+    for (int i = 5; i >= 0; --i) out11[k++] = base32[(h >> (2 + i * 5)) & 0x1F];
+
+    uint8_t tilde = k;
+    out11[k++] = '~';
+    out11[k++] = '1';
+
+    if (dot) {
+        uint8_t e = 0;
+        for (const char* p = dot + 1; *p && e < 3; ++p) {
+            if (*p == ' ') continue;
+            out11[8 + e++] = sfn_char((unsigned char)*p);
+        }
+    }
+    return tilde;
+}
+
+uint8_t lfn_checksum(const uint8_t short_name[11]) {
+    uint8_t sum = 0;
+    for (int i = 0; i < 11; ++i) {
+        sum = (uint8_t)(((sum & 1) << 7) + (sum >> 1) + short_name[i]);
+    }
+    return sum;
+}
+
 // Comparaison ASCII insensible à la casse pour chaînes C null-terminées
 bool iequals(const char* a, const char* b) {
     if (!a || !b) return false;
@@ -1707,4 +2970,29 @@ bool iequals(const char* a, const char* b) {
     return *a == *b;
 }
 
+// Pas d'horloge temps réel: l'heure système est le temps écoulé depuis le
+// démarrage, compté à partir de l'origine FAT (1er janvier 1980 00:00:00)
+uint16_t system_time_to_fat_time() {
+    uint16_t date, time;
+    fat_stamp_from_seconds(to_ms_since_boot(get_absolute_time()) / 1000u, date, time);
+    return time;
+}
+
+uint16_t system_date_to_fat_date() {
+    uint16_t date, time;
+    fat_stamp_from_seconds(to_ms_since_boot(get_absolute_time()) / 1000u, date, time);
+    return date;
+}
+
+void fat_time_to_system_time(uint16_t fat_time, uint16_t fat_date,
+                             int& year, int& month, int& day,
+                             int& hour, int& minute, int& second) {
+    year = 1980 + (fat_date >> 9);
+    month = (fat_date >> 5) & 0x0F;
+    day = fat_date & 0x1F;
+    hour = fat_time >> 11;
+    minute = (fat_time >> 5) & 0x3F;
+    second = (fat_time & 0x1F) * 2;
+}
+
 } // namespace FAT_Utils
\ No newline at end of file
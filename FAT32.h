@@ -12,12 +12,14 @@
  */
 
 #include "pico/stdlib.h"
+#include "BlockScheduler.h"
 #include <string>
 #include <vector>
 #include <cstring>
 
 // Forward declaration
 class SDCard;
+class ExFAT;
 
 // Constantes inspirées du fichier fat.c
 namespace FAT_Config {
@@ -43,6 +45,22 @@ namespace FAT_Config {
     static constexpr uint32_t CLUSTER_FREE = 0x00000000;
     static constexpr uint16_t CLUSTER_EOF_16 = 0xFFFF;
     static constexpr uint32_t CLUSTER_EOF_32 = 0x0FFFFFFF;
+
+    // Navigation: pile de répertoires et cache des sous-répertoires résolus
+    static constexpr uint8_t DIR_STACK_DEPTH = 8;
+    static constexpr uint8_t DIR_CACHE_ENTRIES = 8;
+    static constexpr uint8_t DIR_CACHE_NAME_LEN = 24;
+    static constexpr uint8_t DIR_ITER_CHECKPOINTS = 64;  // points de reprise d'un DirIterator (512 octets)
+    static constexpr uint16_t DIR_ITER_STEP = 16;        // entrées entre deux points de reprise au départ
+    static constexpr uint32_t CREATE_INDEX_SLOTS = 16384; // index des noms pour les créations en série (32 Ko, statique)
+    static constexpr uint32_t CREATE_INDEX_KEYS = CREATE_INDEX_SLOTS / 4 * 3; // au-delà, passe complète à chaque création
+
+    // Libération groupée: nombre de séquences de clusters accumulées avant écriture de la FAT
+    static constexpr uint16_t FREE_RUN_BATCH = 64;
+
+    // Discard: séquences libérées en attente d'effacement, taille max d'une commande d'effacement
+    static constexpr uint8_t  DISCARD_QUEUE_SIZE = 16;
+    static constexpr uint32_t DISCARD_MAX_BLOCKS = 8192;   // 4 Mo
 }
 
 // Types de fichiers (inspirés du fat.c)
@@ -139,9 +157,10 @@ struct ReadHandler {
     uint32_t Dir_Entry;
     uint32_t File_Size;
     uint32_t FAT_Entry;
-    uint16_t SectorOffset;
+    uint32_t SectorOffset;   // exFAT: jusqu'à 65536 secteurs par cluster
+    bool     NoFatChain;   // exFAT: clusters contigus, cluster suivant = FAT_Entry + 1
     
-    ReadHandler() : Dir_Entry(0), File_Size(0), FAT_Entry(0), SectorOffset(0) {}
+    ReadHandler() : Dir_Entry(0), File_Size(0), FAT_Entry(0), SectorOffset(0), NoFatChain(false) {}
 };
 
 // Handler d'écriture (inspiré du fat.c)
@@ -154,14 +173,43 @@ struct WriteHandler {
     uint32_t CurrentFatEntry;
     uint16_t ClusterIndex;
     uint16_t SectorIndex;
+    uint16_t DirIndex;       // Index de l'entrée 8.3 dans le secteur Dir_Entry
+    uint32_t Position;       // Position d'écriture (octets depuis le début du fichier)
     
     WriteHandler() : Dir_Entry(0), File_Size(0), BaseFatEntry(0), 
-                    CurrentFatEntry(0), ClusterIndex(0), SectorIndex(0) {
+                    CurrentFatEntry(0), ClusterIndex(0), SectorIndex(0), DirIndex(0), Position(0) {
         memset(FileName, 0, sizeof(FileName));
         memset(Extension, 0, sizeof(Extension));
     }
 };
 
+// Rapport du vérificateur de système de fichiers (fsck)
+struct FsckReport {
+    uint32_t directories;
+    uint32_t files;
+    uint32_t used_clusters;          // Clusters atteints depuis l'arborescence
+    uint32_t cross_links;            // Clusters revendiqués par plusieurs chaînes
+    uint32_t lost_clusters;          // Alloués dans la FAT mais hors arborescence
+    uint32_t size_mismatches;        // Taille d'entrée incohérente avec la chaîne
+    uint32_t broken_chains;          // Chaîne interrompue (cluster libre/invalide)
+    uint32_t fat_mirror_mismatches;  // Secteurs FAT1 != FAT2
+    uint32_t passes;                 // Passes nécessaires (bitmap fenêtré)
+
+    FsckReport() { memset(this, 0, sizeof(*this)); }
+    uint32_t error_count() const {
+        return cross_links + lost_clusters + size_mismatches + broken_chains + fat_mirror_mismatches;
+    }
+};
+
+// Compteurs de parcours des répertoires (coût de la résolution des chemins)
+struct DirStats {
+    uint32_t dir_sector_reads;   // Secteurs de répertoire lus sur la carte
+    uint32_t path_lookups;       // Composants de chemin résolus
+    uint32_t cache_hits;         // Composants servis par le cache
+
+    DirStats() { memset(this, 0, sizeof(*this)); }
+};
+
 // Structure pour liste de fichiers (inspirée du fat.c)
 struct FileListEntry {
     std::string longFileName;
@@ -201,11 +249,12 @@ private:
     uint32_t sectors_in_partition;
     uint16_t sector_size;
     uint16_t cluster_size;
-    uint16_t fat_base;
-    uint16_t root_base;
-    uint16_t data_base;
-    uint16_t main_offset;
-    uint16_t last_cluster;
+    uint32_t fat_base;
+    uint32_t root_base;
+    uint32_t data_base;
+    uint32_t main_offset;
+    uint32_t last_cluster;           // Numéro du dernier cluster valide
+    uint8_t  fat_count;              // Nombre de copies de la FAT (miroirs)
     uint32_t root_dir_first_cluster; // FAT32: first cluster of root dir
     uint32_t first_data_sector;      // Relative to volume start (main_offset)
     
@@ -221,12 +270,35 @@ private:
     // Handlers (inspirés du fat.c)
     ReadHandler read_handler;
     WriteHandler write_handler;
+    bool write_open_ = false;          // write_handler tenu par un appelant jusqu'à file_close()
     
     // Boot record
     MasterBoot_Entries master_boot;
     
     // Pointeur de répertoire courant (cluster). Par défaut: racine.
     uint32_t current_dir_cluster_ = 0; // 0 = non initialisé, root utilisé après init
+
+    // Pile des répertoires sauvegardés par push_directory()
+    uint32_t dir_stack_[FAT_Config::DIR_STACK_DEPTH];
+    uint8_t  dir_stack_depth_ = 0;
+
+    // Cache (répertoire parent, nom) -> premier cluster du sous-répertoire.
+    // Les répertoires ne sont jamais déplacés: seule leur suppression invalide le cache.
+    struct DirCacheEntry {
+        uint32_t parent;     // 0 = entrée libre
+        uint32_t cluster;
+        uint32_t last_use;
+        char     name[FAT_Config::DIR_CACHE_NAME_LEN];
+    };
+    DirCacheEntry dir_cache_[FAT_Config::DIR_CACHE_ENTRIES];
+    uint32_t dir_cache_tick_ = 0;
+    DirStats dir_stats_;
+
+    // Volume exFAT détecté au montage (nullptr pour un volume FAT32)
+    ExFAT* exfat_ = nullptr;
+
+    // File de requêtes vers la carte: get/store_physical_block passent par elle
+    BlockScheduler io_;
     
     // Méthodes privées inspirées du fat.c
     uint32_t lword_swap(uint32_t data);
@@ -235,13 +307,99 @@ private:
     bool store_physical_block(uint32_t block_num, const uint8_t* buffer);
     
     // Gestion FAT (inspirée du fat.c)
-    uint16_t fat_search_available_cluster(uint16_t current_cluster);
+    uint32_t fat_search_available_cluster(uint32_t current_cluster);
     // For FAT32, FAT entries are 32-bit (upper 4 bits reserved). Use 32-bit types.
     uint32_t fat_entry(uint32_t fat_entry, uint32_t fat_value, bool write_entry);
     
     // Parsing de noms (inspiré du fat.c)
     FileEntryType fat_filename_parser(root_Entries* dir_entry);
+
+    // Position d'une entrée dans la chaîne de clusters d'un répertoire
+    struct DirCursor {
+        uint32_t cluster;
+        uint16_t sector;   // secteur dans le cluster
+        uint16_t index;    // entrée dans le secteur
+    };
+    bool dir_cursor_advance(DirCursor& cursor);
+    // Entrée 8.3 (et nom long assemblé si lfn) vers FileListEntry
+    void fill_list_entry(const root_Entries& entry, FileEntryType type, bool lfn, FileListEntry& out);
+    // Corps de file_open(): n'indique pas que l'appelant garde le fichier ouvert
+    FAT_ErrorCode open_path(const char* filename, FileFunction function);
+    // Création d'une entrée (LFN + alias 8.3 si nécessaire) en une seule passe sur le répertoire
+    FAT_ErrorCode create_dir_entry(uint32_t dir_cluster, const char* name, uint8_t attributes,
+                                   uint32_t first_cluster, uint32_t& sfn_lba, uint16_t& sfn_index);
+    // État laissé par create_dir_entry() sur le dernier répertoire parcouru:
+    // fin du répertoire et index haché des noms présents (empreintes 16 bits,
+    // reconstruit à chaque passe complète). Un nom absent de l'index est ajouté
+    // en fin de répertoire sans relire les entrées; un nom peut-être présent
+    // relance la passe complète. Une clé par nom long créé ici (son alias
+    // HHHHHH~1 dérive du nom), deux pour les autres alias. Renommer, compacter
+    // ou supprimer un répertoire invalide l'état; effacer un fichier laisse un
+    // trou repris par la création suivante (l'index reste un sur-ensemble). Au-delà de CREATE_INDEX_KEYS clés (environ
+    // 12000 noms longs), chaque création refait la passe complète.
+    struct CreateHint {
+        uint32_t  dir_cluster;    // 0 = invalide
+        DirCursor end;            // première entrée après la dernière utilisée (cluster 0: chaîne pleine)
+        uint32_t  tail_cluster;   // dernier cluster de la chaîne, 0 si inconnu
+        DirCursor hole;           // entrées effacées depuis la dernière passe
+        uint16_t  hole_len;
+        uint32_t  keys;           // clés dans l'index, > CREATE_INDEX_KEYS: index incomplet
+    };
+    CreateHint create_hint_;
+    void create_hint_reset();
+    void create_hint_add(uint32_t hash);
+    bool create_hint_may_contain(uint32_t hash) const;
+    void create_hint_hole(uint32_t dir_cluster, DirCursor start, uint16_t count);
+    // Efface 'count' entrées consécutives (séquence LFN + entrée 8.3)
+    bool erase_dir_entries(DirCursor start, uint16_t count);
+    // Localisation d'une entrée (séquence LFN comprise) dans un répertoire
+    struct DirEntryLocation {
+        DirCursor start;         // première entrée (LFN ou 8.3)
+        uint16_t  count;         // entrées LFN + entrée 8.3
+        uint32_t  first_cluster;
+        uint8_t   attributes;
+        uint32_t  size;
+        uint16_t  modification_date;
+        uint16_t  modification_time;
+    };
+    bool find_dir_entry(uint32_t dir_cluster, const char* name, DirEntryLocation& out);
+
+    // Libération de chaînes par séquences de clusters consécutifs: chaque
+    // secteur FAT touché est écrit une seule fois (sur toutes les copies)
+    struct ClusterRun {
+        uint32_t first;
+        uint32_t count;
+    };
+    void collect_chain_runs(uint32_t first_cluster, std::vector<ClusterRun>& runs);
+    bool free_cluster_runs(std::vector<ClusterRun>& runs);
+    bool free_chain(uint32_t first_cluster);
+
+    // File des séquences libérées à effacer (CMD32/33/38) pendant les temps morts
+    ClusterRun discard_queue_[FAT_Config::DISCARD_QUEUE_SIZE];
+    uint8_t  discard_count_ = 0;
+    uint32_t discard_erase_blocks_ = 0;    // granularité d'effacement (blocs), 0 = désactivé
+    uint32_t discarded_blocks_ = 0;        // total effacé depuis le montage
+    void discard_enqueue(uint32_t first_cluster, uint32_t count);
+
+    // Placement par unités d'allocation (AU) de la carte: la classe de vitesse
+    // n'est garantie que pour des écritures séquentielles dans des AU entières.
+    // Un fichier annoncé d'au moins une AU démarre au début d'une AU libre et
+    // change d'AU par AU libre entière.
+    uint32_t au_blocks_ = 0;               // taille d'une AU en secteurs, 0 = placement classique
+    uint32_t expected_size_ = 0;           // taille annoncée pour le prochain fichier créé
+    bool     au_placement_ = false;        // fichier en cours d'écriture placé par AU
+    uint32_t au_search_hint_ = 0;          // 1er cluster de la dernière AU attribuée (0 = aucune)
+    uint32_t fat_search_free_au(uint32_t from_cluster);
+    uint32_t allocate_cluster(uint32_t prev_cluster);
     
+    // Résolution des chemins de répertoires (relatifs, '.', '..', noms longs)
+    bool read_dir_sector(uint32_t lba);
+    bool find_subdirectory(uint32_t dir_cluster, const char* name, uint32_t& out_cluster);
+    bool resolve_directory(const char* path, uint32_t& out_cluster);
+    bool dir_cache_lookup(uint32_t parent, const char* name, uint32_t& out_cluster);
+    void dir_cache_insert(uint32_t parent, const char* name, uint32_t cluster);
+    void dir_cache_invalidate();
+
     // Fonctions utilitaires pour file_close
     void update_directory_entry_size();
     void flush_fat_cache();
@@ -253,6 +411,8 @@ public:
     // Initialisation (inspirée de FAT_Read_Master_Block)
     bool init();
     bool is_initialized() const { return initialized; }
+    bool is_exfat() const { return exfat_ != nullptr; }
+    ExFAT* get_exfat() const { return exfat_; }
     
     // Lecture du Master Boot Record (inspirée du fat.c)
     bool read_master_block();
@@ -263,10 +423,45 @@ public:
     FAT_ErrorCode file_open(const char* filename, FileFunction function);
     void file_close();
     uint16_t file_read(uint8_t* buffer, ReadHandler* handler);
-    void file_write(const uint8_t* data, uint32_t size);
+    // Lecture de secteurs entiers (au plus max_sectors) directement dans buffer.
+    // Les clusters contigus de la chaîne sont lus en une seule commande
+    // multi-blocs. Retourne les octets lus (multiple de 512), 0 s'il reste
+    // moins d'un secteur entier: file_read() termine alors la lecture.
+    uint32_t file_read_blocks(uint8_t* buffer, uint32_t max_sectors, ReadHandler* handler);
+    // Avance la lecture de sectors secteurs sans lire les données (seules
+    // les entrées FAT de fin de cluster sont consultées). Retourne les
+    // secteurs sautés; la fin du fichier arrête le saut.
+    uint32_t file_skip_sectors(uint32_t sectors, ReadHandler* handler);
+    // Écrit à la position courante; retourne le nombre d'octets écrits
+    uint32_t file_write(const uint8_t* data, uint32_t size);
+    // Écrit les secteurs en attente dans la file de requêtes (fait par file_close)
+    bool flush();
+    const BlockSchedulerStats& get_io_stats() const { return io_.get_stats(); }
+    void reset_io_stats() { io_.reset_stats(); }
     
     // Listing de répertoire (support LFN)
     FAT_ErrorCode list_directory(std::vector<FileListEntry>& file_list);
+
+    // Parcours d'un répertoire par index, sans liste en mémoire (FAT32
+    // seulement). Un point de reprise est noté toutes les step entrées (step
+    // double quand la table est pleine): lire l'entrée suivante continue là
+    // où la précédente s'est arrêtée, revenir en arrière ou sauter loin
+    // repart du point de reprise le plus proche.
+    struct DirIterator {
+        uint32_t dir_cluster;
+        DirCursor next;            // première entrée physique pas encore lue
+        uint32_t next_index;       // index de la prochaine entrée (fichier ou répertoire)
+        bool at_end;
+        uint16_t checkpoint_count;
+        uint16_t step;
+        DirCursor checkpoints[FAT_Config::DIR_ITER_CHECKPOINTS];
+    };
+    // Répertoire courant
+    bool dir_iterator_open(DirIterator& it);
+    // Entrée n° index (mêmes entrées que list_directory); false au-delà de la dernière
+    bool dir_iterator_read(DirIterator& it, uint32_t index, FileListEntry& out);
+    // Nombre d'entrées (parcourt le répertoire jusqu'au bout une fois)
+    uint32_t dir_iterator_count(DirIterator& it);
     
     // Support Long File Names (inspiré du fat.c)
     bool supports_lfn() const { return true; }
@@ -290,11 +485,27 @@ public:
     bool delete_file(const char* filename);
     bool file_exists(const char* filename);
     uint32_t get_file_size(const char* filename);
+    // Métadonnées d'un fichier (taille, 1er cluster, dates) sans l'ouvrir:
+    // le handler de lecture en cours n'est pas modifié. FAT32 seulement.
+    bool get_file_info(const char* path, FileListEntry& out);
+    // Accès par secteur à un fichier de taille fixe (préalloué): la chaîne de
+    // clusters est relevée une fois, puis le n-ième secteur est adressé sans
+    // parcourir la FAT ni réécrire l'entrée de répertoire. Via la file de requêtes.
+    bool get_file_clusters(const char* path, std::vector<uint32_t>& clusters, uint32_t& size);
+    bool read_file_sector(const std::vector<uint32_t>& clusters, uint32_t index, uint8_t* buffer);
+    bool write_file_sector(const std::vector<uint32_t>& clusters, uint32_t index, const uint8_t* buffer);
     bool rename_file(const char* old_name, const char* new_name);
     
     // Navigation dans l'arborescence
-    // Changer de répertoire. Supporte "/" pour racine et chemins simples avec '/'
+    // Changer de répertoire. Chemins absolus ("/a/b") ou relatifs au répertoire
+    // courant ("b", "../c"), noms longs acceptés.
     bool change_directory(const char* dir_name);
+    // Sauvegarde le répertoire courant puis entre dans dir_name. Rien n'est
+    // empilé en cas d'échec. pop_directory() restaure le répertoire sauvegardé.
+    bool push_directory(const char* dir_name);
+    bool pop_directory();
+    const DirStats& get_dir_stats() const { return dir_stats_; }
+    void reset_dir_stats() { dir_stats_ = DirStats(); }
     bool create_directory(const char* dir_name);
     std::vector<std::string> get_directory_tree();
     
@@ -306,6 +517,32 @@ public:
     // Défragmentation et maintenance
     uint32_t count_free_clusters();
     void cleanup_deleted_files();
+    // Suppression récursive (parcours itératif) d'un répertoire et de son contenu.
+    // Un chemin de fichier est simplement supprimé.
+    bool remove_tree(const char* path);
+
+    // Discard des clusters libérés: chaque séquence libérée est mise en file puis
+    // effacée par la carte (blocs alignés sur erase_block_sectors) lorsque
+    // process_discards() est appelée pendant les temps morts. 0 = désactivé.
+    void set_discard(uint32_t erase_block_sectors);
+    uint32_t get_discard_erase_blocks() const { return discard_erase_blocks_; }
+    uint8_t get_discard_pending() const { return discard_count_; }
+    uint32_t get_discarded_blocks() const { return discarded_blocks_; }
+    // Émet au plus une commande d'effacement. Retourne false si la file est vide.
+    bool process_discards();
+
+    // Taille d'unité d'allocation de la carte (ACMD13), en secteurs. 0 ou une
+    // AU pas plus grande qu'un cluster désactive le placement aligné.
+    void set_allocation_unit(uint32_t au_blocks);
+    uint32_t get_allocation_unit() const { return au_blocks_; }
+    // Taille attendue du prochain fichier ouvert en CREATE/OVERWRITE (consommée
+    // par file_open). Les fichiers d'au moins une AU sont placés sur des AU libres.
+    void set_expected_size(uint32_t bytes) { expected_size_ = bytes; }
+    // Vérification (lecture seule) de la cohérence FAT / arborescence.
+    // scratch: mémoire de travail fournie par l'appelant pour le bitmap de
+    // propriété (1 bit par cluster). Si elle est trop petite pour le volume,
+    // la vérification est faite par fenêtres de clusters (plusieurs passes).
+    bool check_filesystem(FsckReport& report, uint8_t* scratch, uint32_t scratch_size);
 };
 
 // Fonctions utilitaires globales inspirées du fat.c
@@ -319,6 +556,13 @@ namespace FAT_Utils {
     bool is_valid_filename(const char* filename);
     bool iequals(const char* a, const char* b);
     bool to_dos_8_3(const char* name, char out11[11]);
+    // Vrai si le nom ne peut pas être stocké sans perte (hors casse) en 8.3.
+    // Sinon out11 reçoit le nom 8.3.
+    bool needs_lfn(const char* name, char out11[11]);
+    // Alias 8.3 "HHHHHH~N" (hash 30 bits du nom long en base 32 + numéro).
+    // Retourne la position du '~' dans out11.
+    uint8_t make_short_alias(const char* long_name, uint32_t salt, char out11[11]);
+    uint8_t lfn_checksum(const uint8_t short_name[11]);
     
     // Utilitaires de date/heure FAT
     uint16_t system_time_to_fat_time();
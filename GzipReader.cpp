@@ -0,0 +1,473 @@
+#include "GzipReader.h"
+#include "Crc32.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+/*******************************************************
+ * Nom du fichier : GzipReader.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : décompression gzip/DEFLATE en flux (RFC 1951/1952)
+ *******************************************************/
+
+using namespace Gzip_Config;
+
+uint8_t GzipReader::window[WINDOW_SIZE];
+uint8_t GzipReader::input[INPUT_SECTORS * 512];
+GzipReader::Huffman GzipReader::length_codes;
+GzipReader::Huffman GzipReader::distance_codes;
+bool GzipReader::busy = false;
+
+// Longueurs de code des tables dynamiques (hors pile)
+static uint8_t g_code_lengths[286 + 30];
+
+static const uint16_t LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t DISTANCE_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t DISTANCE_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const uint8_t CODE_LENGTH_ORDER[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+GzipReader::GzipReader(FAT32* filesystem)
+    : fs(filesystem), opened(false), in_pos(0), in_len(0), in_eof(false),
+      bit_buffer(0), bit_count(0), pad_bits(0), state(ST_ERROR), error(GZ_BAD_HEADER),
+      last_block(false), stored_left(0), copy_length(0), copy_distance(0),
+      window_pos(0), crc(0), bytes_in(0), bytes_out(0) {}
+
+GzipReader::~GzipReader() {
+    end();
+}
+
+// ============================================================================
+// ENTRÉE BIT À BIT
+// ============================================================================
+
+bool GzipReader::refill_input() {
+    if (in_eof) return false;
+    // Secteurs entiers en multi-blocs, la fin du fichier secteur par secteur
+    uint32_t n = fs->file_read_blocks(input, INPUT_SECTORS, &handler);
+    if (n == 0) n = fs->file_read(input, &handler);
+    if (n == 0) {
+        in_eof = true;
+        return false;
+    }
+    in_pos = 0;
+    in_len = (uint16_t)n;
+    bytes_in += n;
+    return true;
+}
+
+void GzipReader::fill(uint8_t bits) {
+    while (bit_count < bits) {
+        uint32_t byte = 0;
+        if (in_pos < in_len || refill_input()) {
+            byte = input[in_pos++];
+        } else {
+            // Fin du fichier: des zéros permettent de décoder le dernier code
+            // par la table directe; les consommer signale une troncature
+            pad_bits += 8;
+        }
+        bit_buffer |= byte << bit_count;
+        bit_count += 8;
+    }
+}
+
+bool GzipReader::drop(uint8_t bits) {
+    bit_buffer >>= bits;
+    bit_count -= bits;
+    if (bit_count < pad_bits) return fail(GZ_TRUNCATED);
+    return true;
+}
+
+uint32_t GzipReader::get_bits(uint8_t bits) {
+    if (bits == 0) return 0;
+    fill(bits);
+    uint32_t value = bit_buffer & ((1u << bits) - 1);
+    drop(bits);
+    return value;
+}
+
+bool GzipReader::fail(Gzip_Status status) {
+    if (state != ST_ERROR) {
+        state = ST_ERROR;
+        error = status;
+        printf("Gzip: %s\n", status_name(status));
+        if (status == GZ_WINDOW_TOO_SMALL) {
+            printf("Gzip: recompresser avec une fenêtre de %lu octets (zlib wbits = 13)\n",
+                   (unsigned long)WINDOW_SIZE);
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// CODES DE HUFFMAN
+// ============================================================================
+
+bool GzipReader::build(Huffman& h, const uint8_t* lengths, uint16_t n) {
+    memset(h.count, 0, sizeof(h.count));
+    memset(h.fast, 0, sizeof(h.fast));
+    for (uint16_t i = 0; i < n; ++i) h.count[lengths[i]]++;
+    if (h.count[0] == n) return true;   // aucun code (bloc sans distance)
+
+    // Code sur-souscrit: invalide. Un code incomplet est toléré, les codes
+    // absents échouent au décodage.
+    int32_t left = 1;
+    for (uint8_t len = 1; len < 16; ++len) {
+        left = (left << 1) - h.count[len];
+        if (left < 0) return false;
+    }
+
+    uint16_t offsets[16];
+    offsets[1] = 0;
+    for (uint8_t len = 1; len < 15; ++len) offsets[len + 1] = offsets[len] + h.count[len];
+    for (uint16_t sym = 0; sym < n; ++sym) {
+        if (lengths[sym]) h.symbol[offsets[lengths[sym]]++] = sym;
+    }
+
+    // Table directe: les codes de FAST_BITS bits au plus, indexés par leurs
+    // bits dans l'ordre du flux (poids faible en premier)
+    uint32_t code = 0;
+    uint16_t index = 0;
+    for (uint8_t len = 1; len < 16; ++len) {
+        for (uint16_t i = 0; i < h.count[len]; ++i, ++code) {
+            const uint16_t sym = h.symbol[index++];
+            if (len > FAST_BITS) continue;
+            uint32_t reversed = 0;
+            for (uint8_t b = 0; b < len; ++b) reversed |= ((code >> b) & 1u) << (len - 1 - b);
+            for (uint32_t k = reversed; k < (1u << FAST_BITS); k += 1u << len) {
+                h.fast[k] = (uint16_t)(sym | (len << 9));
+            }
+        }
+        code <<= 1;
+    }
+    return true;
+}
+
+int32_t GzipReader::decode(const Huffman& h) {
+    fill(15);
+    const uint16_t entry = h.fast[bit_buffer & ((1u << FAST_BITS) - 1)];
+    if (entry) {
+        if (!drop((uint8_t)(entry >> 9))) return -1;
+        return entry & 0x1FF;
+    }
+    // Code long: décodage canonique bit par bit
+    int32_t code = 0, first = 0, index = 0;
+    for (uint8_t len = 1; len < 16; ++len) {
+        code |= (bit_buffer >> (len - 1)) & 1;
+        const int32_t count = h.count[len];
+        if (code - first < count) {
+            if (!drop(len)) return -1;
+            return h.symbol[index + code - first];
+        }
+        index += count;
+        first = (first + count) << 1;
+        code <<= 1;
+    }
+    fail(GZ_BAD_DATA);
+    return -1;
+}
+
+// ============================================================================
+// EN-TÊTES
+// ============================================================================
+
+bool GzipReader::parse_header() {
+    if (get_bits(8) != 0x1F || get_bits(8) != 0x8B || get_bits(8) != 8) {
+        return fail(GZ_BAD_HEADER);
+    }
+    const uint8_t flags = (uint8_t)get_bits(8);
+    if (flags & 0xE0) return fail(GZ_BAD_HEADER);
+    get_bits(16);   // MTIME
+    get_bits(16);
+    get_bits(16);   // XFL, OS
+
+    if (flags & 0x04) {   // FEXTRA
+        uint16_t extra = (uint16_t)get_bits(16);
+        while (extra-- && state != ST_ERROR) get_bits(8);
+    }
+    if (flags & 0x08) {   // FNAME
+        while (get_bits(8) != 0 && state != ST_ERROR) {}
+    }
+    if (flags & 0x10) {   // FCOMMENT
+        while (get_bits(8) != 0 && state != ST_ERROR) {}
+    }
+    if (flags & 0x02) get_bits(16);   // FHCRC
+    return state != ST_ERROR;
+}
+
+bool GzipReader::block_header() {
+    last_block = get_bits(1) != 0;
+    const uint32_t type = get_bits(2);
+    if (state == ST_ERROR) return false;
+
+    switch (type) {
+        case 0: {
+            drop(bit_count & 7);
+            const uint32_t len = get_bits(16);
+            const uint32_t nlen = get_bits(16);
+            if (state == ST_ERROR) return false;
+            if (len != (~nlen & 0xFFFF)) return fail(GZ_BAD_DATA);
+            stored_left = len;
+            state = ST_STORED;
+            return true;
+        }
+        case 1: {
+            for (uint16_t i = 0; i < 144; ++i) g_code_lengths[i] = 8;
+            for (uint16_t i = 144; i < 256; ++i) g_code_lengths[i] = 9;
+            for (uint16_t i = 256; i < 280; ++i) g_code_lengths[i] = 7;
+            for (uint16_t i = 280; i < 288; ++i) g_code_lengths[i] = 8;
+            build(length_codes, g_code_lengths, 288);
+            memset(g_code_lengths, 5, 30);
+            build(distance_codes, g_code_lengths, 30);
+            state = ST_CODES;
+            return true;
+        }
+        case 2:
+            if (!dynamic_tables()) return false;
+            state = ST_CODES;
+            return true;
+        default:
+            return fail(GZ_BAD_DATA);
+    }
+}
+
+bool GzipReader::dynamic_tables() {
+    const uint16_t nlen = (uint16_t)(get_bits(5) + 257);
+    const uint16_t ndist = (uint16_t)(get_bits(5) + 1);
+    const uint16_t ncode = (uint16_t)(get_bits(4) + 4);
+    if (state == ST_ERROR) return false;
+    if (nlen > 286 || ndist > 30) return fail(GZ_BAD_DATA);
+
+    // Code des longueurs de code, construit dans la table des littéraux
+    for (uint8_t i = 0; i < 19; ++i) {
+        g_code_lengths[CODE_LENGTH_ORDER[i]] = (uint8_t)(i < ncode ? get_bits(3) : 0);
+    }
+    if (state == ST_ERROR) return false;
+    if (!build(length_codes, g_code_lengths, 19)) return fail(GZ_BAD_DATA);
+
+    uint16_t index = 0;
+    while (index < nlen + ndist) {
+        const int32_t sym = decode(length_codes);
+        if (sym < 0) return fail(GZ_BAD_DATA);
+        if (sym < 16) {
+            g_code_lengths[index++] = (uint8_t)sym;
+            continue;
+        }
+        uint8_t value = 0;
+        uint32_t repeat;
+        if (sym == 16) {
+            if (index == 0) return fail(GZ_BAD_DATA);
+            value = g_code_lengths[index - 1];
+            repeat = 3 + get_bits(2);
+        } else if (sym == 17) {
+            repeat = 3 + get_bits(3);
+        } else {
+            repeat = 11 + get_bits(7);
+        }
+        if (state == ST_ERROR) return false;
+        if (index + repeat > (uint32_t)(nlen + ndist)) return fail(GZ_BAD_DATA);
+        while (repeat--) g_code_lengths[index++] = value;
+    }
+    if (g_code_lengths[256] == 0) return fail(GZ_BAD_DATA);   // pas de fin de bloc
+
+    if (!build(length_codes, g_code_lengths, nlen) ||
+        !build(distance_codes, g_code_lengths + nlen, ndist)) {
+        return fail(GZ_BAD_DATA);
+    }
+    return true;
+}
+
+bool GzipReader::check_trailer() {
+    drop(bit_count & 7);
+    const uint32_t stored_crc = get_bits(16) | (get_bits(16) << 16);
+    const uint32_t stored_size = get_bits(16) | (get_bits(16) << 16);
+    if (state == ST_ERROR) return false;
+    if (VERIFY_CRC && stored_crc != crc) return fail(GZ_CRC_ERROR);
+    if (stored_size != bytes_out) return fail(GZ_BAD_DATA);
+    state = ST_DONE;
+    return true;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+Gzip_Status GzipReader::begin() {
+    if (!fs) return GZ_BAD_HEADER;
+    if (!opened) {
+        if (busy) {
+            printf("Gzip: un autre lecteur est ouvert\n");
+            return GZ_BUSY;
+        }
+        busy = true;
+        opened = true;
+    }
+    handler = ReadHandler();
+    in_pos = in_len = 0;
+    in_eof = false;
+    bit_buffer = 0;
+    bit_count = pad_bits = 0;
+    state = ST_BLOCK;
+    error = GZ_OK;
+    last_block = false;
+    stored_left = 0;
+    copy_length = copy_distance = 0;
+    window_pos = 0;
+    crc = 0;
+    bytes_in = bytes_out = 0;
+
+    parse_header();
+    return status();
+}
+
+uint32_t GzipReader::read(uint8_t* out, uint32_t length) {
+    if (!opened) return 0;
+    uint32_t produced = 0;
+    bool at_trailer = false;
+
+    while (produced < length && state != ST_ERROR && state != ST_DONE) {
+        if (state == ST_BLOCK) {
+            if (last_block) {
+                at_trailer = true;
+                break;
+            }
+            block_header();
+            continue;
+        }
+
+        if (state == ST_STORED) {
+            if (stored_left == 0) {
+                state = ST_BLOCK;
+                continue;
+            }
+            // Octets restés dans le tampon de bits, puis copie depuis l'entrée
+            if (bit_count >= 8) {
+                emit(out, produced, (uint8_t)get_bits(8));
+                stored_left--;
+                continue;
+            }
+            if (in_pos >= in_len && !refill_input()) {
+                fail(GZ_TRUNCATED);
+                break;
+            }
+            uint32_t n = std::min<uint32_t>(stored_left, length - produced);
+            n = std::min<uint32_t>(n, (uint32_t)(in_len - in_pos));
+            stored_left -= n;
+            while (n--) emit(out, produced, input[in_pos++]);
+            continue;
+        }
+
+        // ST_CODES
+        if (copy_length) {
+            uint32_t n = std::min<uint32_t>(copy_length, length - produced);
+            copy_length -= (uint16_t)n;
+            uint32_t src = (window_pos - copy_distance) & (WINDOW_SIZE - 1);
+            while (n--) {
+                const uint8_t value = window[src];
+                src = (src + 1) & (WINDOW_SIZE - 1);
+                emit(out, produced, value);
+            }
+            continue;
+        }
+
+        const int32_t sym = decode(length_codes);
+        if (sym < 0) break;
+        if (sym < 256) {
+            emit(out, produced, (uint8_t)sym);
+            continue;
+        }
+        if (sym == 256) {
+            state = ST_BLOCK;
+            continue;
+        }
+        if (sym > 285) {
+            fail(GZ_BAD_DATA);
+            break;
+        }
+        const uint16_t len = (uint16_t)(LENGTH_BASE[sym - 257] + get_bits(LENGTH_EXTRA[sym - 257]));
+        const int32_t dsym = decode(distance_codes);
+        if (dsym < 0 || dsym >= 30) {
+            fail(GZ_BAD_DATA);
+            break;
+        }
+        const uint32_t distance = DISTANCE_BASE[dsym] + get_bits(DISTANCE_EXTRA[dsym]);
+        if (state == ST_ERROR) break;
+        if (distance > WINDOW_SIZE) {
+            fail(GZ_WINDOW_TOO_SMALL);
+            break;
+        }
+        if (distance > bytes_out + produced) {
+            fail(GZ_BAD_DATA);
+            break;
+        }
+        copy_length = len;
+        copy_distance = (uint16_t)distance;
+    }
+
+    if (VERIFY_CRC && produced) crc = Crc32::update(crc, out, produced);
+    bytes_out += produced;
+    if (at_trailer) check_trailer();
+    return produced;
+}
+
+bool GzipReader::skip(uint32_t length) {
+    uint8_t scratch[128];
+    while (length > 0) {
+        const uint32_t n = read(scratch, std::min<uint32_t>(length, sizeof(scratch)));
+        if (n == 0) return false;
+        length -= n;
+    }
+    return true;
+}
+
+Gzip_Status GzipReader::finish() {
+    uint8_t scratch[64];
+    while (opened && state != ST_ERROR && state != ST_DONE) {
+        read(scratch, sizeof(scratch));
+    }
+    return status();
+}
+
+void GzipReader::end() {
+    if (opened) {
+        busy = false;
+        opened = false;
+    }
+}
+
+const char* GzipReader::status_name(Gzip_Status status) {
+    switch (status) {
+        case GZ_OK:               return "OK";
+        case GZ_END:              return "fin du flux";
+        case GZ_BUSY:             return "lecteur occupé";
+        case GZ_BAD_HEADER:       return "en-tête gzip invalide";
+        case GZ_BAD_DATA:         return "données DEFLATE invalides";
+        case GZ_WINDOW_TOO_SMALL: return "distance supérieure à la fenêtre";
+        case GZ_TRUNCATED:        return "fichier tronqué";
+        case GZ_CRC_ERROR:        return "CRC32 incorrect";
+        default:                  return "erreur inconnue";
+    }
+}
+
+bool GzipReader::is_gz_name(const char* name) {
+    if (!name) return false;
+    const size_t len = strlen(name);
+    return len >= 3 && name[len - 3] == '.' &&
+           (name[len - 2] == 'g' || name[len - 2] == 'G') &&
+           (name[len - 1] == 'z' || name[len - 1] == 'Z');
+}
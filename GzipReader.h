@@ -0,0 +1,123 @@
+#pragma once
+
+/*
+ * GzipReader - Décompression gzip (DEFLATE) en flux depuis FAT32
+ *
+ * Les images RAW/BMP et les textes se compressent de 2 à 5 fois: à 12 MHz
+ * sur le bus SPI, lire moins de secteurs coûte plus que le décodage. Le
+ * lecteur décompresse le fichier ouvert par FAT32::file_open(READ) à la
+ * demande: read() remplit directement la destination (ligne, framebuffer),
+ * sans copie intermédiaire du fichier entier.
+ *
+ * La fenêtre est limitée à WINDOW_SIZE (8 Ko au lieu des 32 Ko de gzip):
+ * les fichiers doivent être compressés avec une fenêtre de même taille,
+ * par exemple en Python: zlib.compressobj(9, zlib.DEFLATED, 16 + 13).
+ * Une distance plus grande arrête le décodage avec GZ_WINDOW_TOO_SMALL.
+ *
+ * Fenêtre, tampon d'entrée et tables de Huffman sont statiques: un seul
+ * lecteur peut être ouvert à la fois.
+ */
+
+#include "pico/stdlib.h"
+#include "FAT32.h"
+
+namespace Gzip_Config {
+    static constexpr uint32_t WINDOW_SIZE = 8192;          // puissance de 2
+    static constexpr uint16_t INPUT_SECTORS = 4;           // lecture multi-blocs
+    static constexpr uint8_t  FAST_BITS = 9;               // table de décodage directe
+    static constexpr bool     VERIFY_CRC = true;           // CRC32 du trailer gzip
+}
+
+enum Gzip_Status {
+    GZ_OK,
+    GZ_END,                  // flux terminé, trailer vérifié
+    GZ_BUSY,                 // un autre lecteur est ouvert
+    GZ_BAD_HEADER,
+    GZ_BAD_DATA,
+    GZ_WINDOW_TOO_SMALL,     // distance > WINDOW_SIZE
+    GZ_TRUNCATED,
+    GZ_CRC_ERROR
+};
+
+class GzipReader {
+private:
+    struct Huffman {
+        uint16_t count[16];                        // codes par longueur
+        uint16_t symbol[288];                      // symboles par ordre canonique
+        uint16_t fast[1u << Gzip_Config::FAST_BITS]; // symbole | longueur << 9, 0 si plus long
+    };
+
+    enum State : uint8_t { ST_BLOCK, ST_STORED, ST_CODES, ST_DONE, ST_ERROR };
+
+    FAT32* fs;
+    ReadHandler handler;
+    bool opened;
+
+    // Entrée
+    uint16_t in_pos;
+    uint16_t in_len;
+    bool     in_eof;
+    uint32_t bit_buffer;
+    uint8_t  bit_count;
+    uint8_t  pad_bits;         // bits nuls ajoutés après la fin du fichier
+
+    // Décodage
+    State    state;
+    Gzip_Status error;
+    bool     last_block;
+    uint32_t stored_left;
+    uint16_t copy_length;
+    uint16_t copy_distance;
+    uint32_t window_pos;
+    uint32_t crc;
+    uint32_t bytes_in;
+    uint32_t bytes_out;
+
+    static uint8_t window[Gzip_Config::WINDOW_SIZE];
+    static uint8_t input[Gzip_Config::INPUT_SECTORS * 512];
+    static Huffman length_codes;
+    static Huffman distance_codes;
+    static bool busy;
+
+    bool refill_input();
+    void fill(uint8_t bits);
+    uint32_t get_bits(uint8_t bits);
+    bool drop(uint8_t bits);
+    int32_t decode(const Huffman& h);
+    bool fail(Gzip_Status status);
+
+    static bool build(Huffman& h, const uint8_t* lengths, uint16_t n);
+    bool parse_header();
+    bool block_header();
+    bool dynamic_tables();
+    bool check_trailer();
+
+    inline void emit(uint8_t* out, uint32_t& produced, uint8_t value) {
+        window[window_pos] = value;
+        window_pos = (window_pos + 1) & (Gzip_Config::WINDOW_SIZE - 1);
+        out[produced++] = value;
+    }
+
+public:
+    explicit GzipReader(FAT32* filesystem);
+    ~GzipReader();
+
+    // Lit l'en-tête gzip du fichier ouvert (FAT32::file_open en READ)
+    Gzip_Status begin();
+    // Décompresse jusqu'à length octets dans out. Retourne le nombre d'octets
+    // produits: moins que length en fin de flux ou sur erreur (voir status()).
+    uint32_t read(uint8_t* out, uint32_t length);
+    bool skip(uint32_t length);
+    // Décompresse le reste du flux (ignoré) pour vérifier le trailer
+    Gzip_Status finish();
+    // Libère les tampons statiques (le fichier reste à fermer par l'appelant)
+    void end();
+
+    Gzip_Status status() const { return state == ST_ERROR ? error : (state == ST_DONE ? GZ_END : GZ_OK); }
+    uint32_t total_in() const { return bytes_in; }
+    uint32_t total_out() const { return bytes_out; }
+
+    static const char* status_name(Gzip_Status status);
+    // Nom se terminant par ".gz" (casse indifférente)
+    static bool is_gz_name(const char* name);
+};
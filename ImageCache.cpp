@@ -0,0 +1,324 @@
+#include "ImageCache.h"
+#include "StorageManager.h"
+#include "BufferedWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+/*******************************************************
+ * Nom du fichier : ImageCache.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : cache des images transcodées (RGB565 BE)
+ *******************************************************/
+
+using namespace ImageCache_Config;
+
+// Secteur de travail (en-tête, fin de ligne non alignée): hors pile
+static uint8_t g_cache_sector[512];
+
+// Cible du décodage BMP: le callback de StorageManager n'a pas de contexte
+static uint8_t* g_decode_target = nullptr;
+static uint16_t g_decode_fb_width = 0;
+static uint16_t g_decode_fb_height = 0;
+static uint16_t g_decoded_width = 0;
+static uint16_t g_decoded_height = 0;
+
+static void decode_pixel_565(uint16_t x, uint16_t y, uint16_t color) {
+    if (x >= g_decode_fb_width || y >= g_decode_fb_height) return;
+    uint16_t* fb16 = reinterpret_cast<uint16_t*>(g_decode_target);
+    fb16[(uint32_t)y * g_decode_fb_width + x] = (uint16_t)((color >> 8) | (color << 8));
+    if (x >= g_decoded_width) g_decoded_width = x + 1;
+    if (y >= g_decoded_height) g_decoded_height = y + 1;
+}
+
+// Lecture séquentielle d'une entrée: secteurs entiers en multi-blocs
+// directement dans la destination, le reste via g_cache_sector
+struct CacheReader {
+    FAT32* fs;
+    ReadHandler handler;
+    uint16_t avail;
+    uint16_t pos;
+
+    explicit CacheReader(FAT32* filesystem) : fs(filesystem), avail(0), pos(0) {}
+
+    bool read(uint8_t* dst, uint32_t length) {
+        while (length > 0) {
+            if (pos < avail) {
+                uint32_t n = std::min<uint32_t>(length, (uint32_t)(avail - pos));
+                memcpy(dst, g_cache_sector + pos, n);
+                pos += n;
+                dst += n;
+                length -= n;
+                continue;
+            }
+            if (length >= 512) {
+                uint32_t n = fs->file_read_blocks(dst, length / 512, &handler);
+                if (n > 0) {
+                    dst += n;
+                    length -= n;
+                    continue;
+                }
+            }
+            avail = fs->file_read(g_cache_sector, &handler);
+            pos = 0;
+            if (avail == 0) return false;
+        }
+        return true;
+    }
+};
+
+ImageCache::ImageCache(StorageManager* storage_manager)
+    : storage(storage_manager), max_bytes(MAX_BYTES), next_sequence(1) {}
+
+uint32_t ImageCache::hash_bytes(uint32_t h, const void* data, size_t length) {
+    // FNV-1a 32 bits
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+uint32_t ImageCache::path_hash(FAT32* fs, const char* filename) const {
+    uint32_t h = 2166136261u;
+    // Un chemin relatif dépend du répertoire courant
+    if (filename[0] != '/') {
+        uint32_t dir = fs->get_current_dir_cluster();
+        h = hash_bytes(h, &dir, sizeof(dir));
+    }
+    for (const char* p = filename; *p; ++p) {
+        char c = (*p >= 'a' && *p <= 'z') ? (char)(*p - 'a' + 'A') : *p;
+        h = hash_bytes(h, &c, 1);
+    }
+    return h;
+}
+
+void ImageCache::entry_path(const ImageCacheHeader& key, char* out, size_t out_size) {
+    uint32_t h = 2166136261u;
+    h = hash_bytes(h, &key.source_cluster, sizeof(key.source_cluster));
+    h = hash_bytes(h, &key.source_size, sizeof(key.source_size));
+    h = hash_bytes(h, &key.source_date, sizeof(key.source_date));
+    h = hash_bytes(h, &key.source_time, sizeof(key.source_time));
+    snprintf(out, out_size, "%s/%08lX.565", DIRECTORY, (unsigned long)h);
+}
+
+SDCard_Status ImageCache::display(const char* filename, uint8_t* framebuffer, uint16_t fb_width, uint16_t fb_height) {
+    if (!storage || !storage->is_fat32_mounted() || !filename || !framebuffer) {
+        return SD_FILE_NOT_FOUND;
+    }
+    FAT32* fs = storage->get_fat32_fs();
+
+    g_decode_target = framebuffer;
+    g_decode_fb_width = fb_width;
+    g_decode_fb_height = fb_height;
+    g_decoded_width = 0;
+    g_decoded_height = 0;
+
+    // exFAT est monté en lecture seule: décodage direct, sans cache
+    FileListEntry source;
+    if (fs->is_exfat() || !fs->get_file_info(filename, source) || source.type != _File) {
+        memset(framebuffer, 0, (uint32_t)fb_width * fb_height * 2);
+        return storage->read_bmp_file(0, 0, filename, nullptr, decode_pixel_565);
+    }
+
+    ImageCacheHeader key;
+    memset(&key, 0, sizeof(key));
+    key.magic = MAGIC;
+    key.path_hash = path_hash(fs, filename);
+    key.source_cluster = source.firstCluster;
+    key.source_size = source.size;
+    key.source_date = source.modificationDate;
+    key.source_time = source.modificationTime;
+
+    char path[32];
+    entry_path(key, path, sizeof(path));
+    if (load(fs, path, key, framebuffer, fb_width, fb_height)) {
+        stats.hits++;
+        return SD_OK;
+    }
+    stats.misses++;
+
+    // Même rendu qu'une relecture du cache: hors de l'image, le fond est noir
+    memset(framebuffer, 0, (uint32_t)fb_width * fb_height * 2);
+    SDCard_Status status = storage->read_bmp_file(0, 0, filename, nullptr, decode_pixel_565);
+    if (status != SD_OK || g_decoded_width == 0 || g_decoded_height == 0) return status;
+
+    key.width = g_decoded_width;
+    key.height = g_decoded_height;
+    if (!store(fs, path, key, framebuffer, fb_width)) {
+        printf("ImageCache: écriture de %s impossible\n", path);
+    }
+    return SD_OK;
+}
+
+bool ImageCache::load(FAT32* fs, const char* path, const ImageCacheHeader& key,
+                      uint8_t* framebuffer, uint16_t fb_width, uint16_t fb_height) {
+    if (fs->file_open(path, READ) != FILE_FOUND) return false;
+
+    CacheReader reader(fs);
+    ImageCacheHeader header;
+    bool ok = reader.read(reinterpret_cast<uint8_t*>(&header), sizeof(header));
+    // Collision de nom ou entrée d'un autre écran: traitée comme un défaut
+    ok = ok && header.magic == MAGIC
+            && header.source_cluster == key.source_cluster
+            && header.source_size == key.source_size
+            && header.source_date == key.source_date
+            && header.source_time == key.source_time
+            && header.width > 0 && header.width <= fb_width
+            && header.height > 0 && header.height <= fb_height;
+    if (ok) {
+        // Les pixels commencent au secteur 1: l'image entière est lue d'un bloc
+        // en tête du framebuffer, puis les lignes sont espacées sur place
+        // (de la dernière à la première, la destination étant plus loin)
+        reader.pos = reader.avail;
+        const uint32_t row_bytes = (uint32_t)header.width * 2;
+        const uint32_t fb_row_bytes = (uint32_t)fb_width * 2;
+        ok = reader.read(framebuffer, row_bytes * header.height);
+        if (ok) {
+            for (int32_t y = header.height - 1; y >= 0; --y) {
+                uint8_t* line = framebuffer + (uint32_t)y * fb_row_bytes;
+                if (row_bytes != fb_row_bytes) {
+                    memmove(line, framebuffer + (uint32_t)y * row_bytes, row_bytes);
+                    memset(line + row_bytes, 0, fb_row_bytes - row_bytes);
+                }
+            }
+            memset(framebuffer + (uint32_t)header.height * fb_row_bytes, 0,
+                   (uint32_t)(fb_height - header.height) * fb_row_bytes);
+        } else {
+            printf("ImageCache: entrée %s tronquée\n", path);
+        }
+    }
+    fs->file_close();
+    return ok;
+}
+
+bool ImageCache::ensure_directory(FAT32* fs) {
+    if (fs->push_directory(DIRECTORY)) {
+        fs->pop_directory();
+        return true;
+    }
+    if (!fs->push_directory("/")) return false;
+    bool ok = fs->create_directory(DIRECTORY + 1);
+    fs->pop_directory();
+    return ok;
+}
+
+bool ImageCache::store(FAT32* fs, const char* path, ImageCacheHeader& key,
+                       const uint8_t* framebuffer, uint16_t fb_width) {
+    const uint32_t row_bytes = (uint32_t)key.width * 2;
+    const uint32_t entry_size = 512 + row_bytes * key.height;
+    if (entry_size > max_bytes || !ensure_directory(fs)) return false;
+
+    make_room(fs, entry_size, key.path_hash);
+    key.sequence = next_sequence++;
+
+    BufferedWriter out(fs);
+    FAT_ErrorCode opened = out.open(path, OVERWRITE, entry_size);
+    if (opened != FILE_CREATE_OK && opened != FILE_FOUND) return false;
+
+    memset(g_cache_sector, 0, sizeof(g_cache_sector));
+    memcpy(g_cache_sector, &key, sizeof(key));
+    bool ok = out.write(g_cache_sector, sizeof(g_cache_sector));
+    if (key.width == fb_width) {
+        ok = ok && out.write(framebuffer, row_bytes * key.height);
+    } else {
+        for (uint16_t y = 0; ok && y < key.height; ++y) {
+            ok = out.write(framebuffer + (uint32_t)y * fb_width * 2, row_bytes);
+        }
+    }
+    ok = out.close() && ok;
+    if (!ok) {
+        // Une entrée incomplète ne doit pas être relue comme valide
+        fs->delete_file(path);
+        return false;
+    }
+    stats.stores++;
+    return true;
+}
+
+void ImageCache::make_room(FAT32* fs, uint32_t needed, uint32_t hash) {
+    struct Entry {
+        char name[13];         // XXXXXXXX.565
+        uint32_t size;
+        uint32_t sequence;
+    };
+    // Candidats à l'éviction: les plus anciens, triés par séquence. Parcours
+    // indexé du répertoire et tableaux fixes: rien sur le tas
+    static Entry oldest[EVICTION_CANDIDATES];
+    static FAT32::DirIterator it;
+    static FileListEntry file;
+    uint16_t count = 0;
+    uint32_t total = 0;
+    uint32_t last_sequence = 0;
+    // DIRECTORY + '/' + nom 8.3 (les deux zéros terminaux comptent '/' et le zéro final)
+    char entry_path_buf[sizeof(DIRECTORY) + sizeof(oldest[0].name)];
+
+    if (!fs->push_directory(DIRECTORY)) return;
+    if (!fs->dir_iterator_open(it)) {
+        fs->pop_directory();
+        return;
+    }
+    for (uint32_t index = 0; fs->dir_iterator_read(it, index, file); ++index) {
+        if (file.type != _File) continue;
+        const char* name = file.hasLongName ? file.longFileName.c_str() : file.dosFileName;
+        if (strlen(name) >= sizeof(oldest[0].name)) {
+            total += file.size;   // pas une entrée du cache: comptée, jamais évincée
+            continue;
+        }
+        const int path_len = snprintf(entry_path_buf, sizeof(entry_path_buf), "%s/%s", DIRECTORY, name);
+        if (path_len < 0 || (size_t)path_len >= sizeof(entry_path_buf)) continue;   // chemin tronqué: n'y pas toucher
+
+        uint32_t sequence = 0;   // en-tête illisible: évincée en premier
+        ImageCacheHeader header;
+        bool stale = false;
+        if (fs->file_open(entry_path_buf, READ) == FILE_FOUND) {
+            CacheReader reader(fs);
+            if (reader.read(reinterpret_cast<uint8_t*>(&header), sizeof(header)) && header.magic == MAGIC) {
+                sequence = header.sequence;
+                stale = header.path_hash == hash;
+            }
+            fs->file_close();
+        }
+        if (sequence > last_sequence) last_sequence = sequence;
+
+        // Ancienne version de la même source (ou entrée écrasée par store)
+        if (stale && fs->delete_file(entry_path_buf)) {
+            stats.invalidations++;
+            continue;
+        }
+        total += file.size;
+
+        // Insertion triée; tableau plein: la plus récente est abandonnée
+        if (count == EVICTION_CANDIDATES && sequence >= oldest[count - 1].sequence) continue;
+        uint16_t pos = (count < EVICTION_CANDIDATES) ? count++ : (uint16_t)(count - 1);
+        while (pos > 0 && oldest[pos - 1].sequence > sequence) {
+            oldest[pos] = oldest[pos - 1];
+            pos--;
+        }
+        strcpy(oldest[pos].name, name);
+        oldest[pos].size = file.size;
+        oldest[pos].sequence = sequence;
+    }
+    fs->pop_directory();
+    if (last_sequence >= next_sequence) next_sequence = last_sequence + 1;
+
+    for (uint16_t i = 0; i < count && total + needed > max_bytes; ++i) {
+        const int path_len = snprintf(entry_path_buf, sizeof(entry_path_buf), "%s/%s", DIRECTORY, oldest[i].name);
+        if (path_len < 0 || (size_t)path_len >= sizeof(entry_path_buf)) continue;
+        if (fs->delete_file(entry_path_buf)) {
+            total -= oldest[i].size;
+            stats.evictions++;
+        }
+    }
+}
+
+bool ImageCache::clear() {
+    if (!storage || !storage->is_fat32_mounted()) return false;
+    FAT32* fs = storage->get_fat32_fs();
+    if (fs->is_exfat()) return false;
+    if (!fs->push_directory(DIRECTORY)) return true;   // cache vide
+    fs->pop_directory();
+    return fs->remove_tree(DIRECTORY);
+}
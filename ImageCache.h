@@ -0,0 +1,95 @@
+#pragma once
+
+/*
+ * ImageCache - Cache des images transcodées au format de l'écran
+ *
+ * Au premier affichage, une image BMP (16 ou 24 bits, lignes inversées,
+ * bourrage) est décodée dans le framebuffer puis recopiée sur la carte
+ * sous sa forme native: RGB565 big-endian, lignes contiguës. Les
+ * affichages suivants relisent cette copie en une lecture multi-blocs
+ * directement dans le framebuffer, sans aucun décodage.
+ *
+ * Une entrée est identifiée par le 1er cluster, la taille et la date de
+ * modification du fichier source: toute modification produit une autre clé
+ * (FAT32 horodate chaque fichier écrit à sa fermeture, toujours après
+ * l'ancienne date) et l'ancienne entrée du même chemin est supprimée.
+ * Au-delà de MAX_BYTES, les entrées les plus anciennes sont évincées (au
+ * plus EVICTION_CANDIDATES par ajout).
+ *
+ * Fichier d'une entrée (/IMGCACHE/XXXXXXXX.565):
+ *   secteur 0 : ImageCacheHeader (complété par des zéros)
+ *   secteur 1+: width * height pixels RGB565 big-endian, ligne par ligne
+ */
+
+#include "pico/stdlib.h"
+#include "SDCard.h"
+#include "FAT32.h"
+
+// Forward declaration
+class StorageManager;
+
+namespace ImageCache_Config {
+    static constexpr char DIRECTORY[] = "/IMGCACHE";
+    static constexpr uint32_t MAGIC = 0x35363549;             // "I565"
+    static constexpr uint32_t MAX_BYTES = 4u * 1024u * 1024u;  // ~36 images plein écran
+    static constexpr uint16_t EVICTION_CANDIDATES = 32;       // entrées évinçables par ajout
+}
+
+struct ImageCacheHeader {
+    uint32_t magic;
+    uint32_t path_hash;        // chemin du fichier source (invalidation)
+    uint32_t source_cluster;
+    uint32_t source_size;
+    uint16_t source_date;
+    uint16_t source_time;
+    uint32_t sequence;         // ordre d'insertion (éviction FIFO)
+    uint16_t width;            // zone visible décodée
+    uint16_t height;
+} __attribute__((packed));
+
+struct ImageCacheStats {
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t stores;
+    uint32_t invalidations;    // anciennes versions d'une source modifiée
+    uint32_t evictions;        // entrées supprimées pour respecter max_bytes
+
+    ImageCacheStats() : hits(0), misses(0), stores(0), invalidations(0), evictions(0) {}
+};
+
+class ImageCache {
+private:
+    StorageManager* storage;
+    uint32_t max_bytes;
+    uint32_t next_sequence;
+    ImageCacheStats stats;
+
+    static uint32_t hash_bytes(uint32_t h, const void* data, size_t length);
+    uint32_t path_hash(FAT32* fs, const char* filename) const;
+    static void entry_path(const ImageCacheHeader& key, char* out, size_t out_size);
+
+    bool load(FAT32* fs, const char* path, const ImageCacheHeader& key,
+              uint8_t* framebuffer, uint16_t fb_width, uint16_t fb_height);
+    bool store(FAT32* fs, const char* path, ImageCacheHeader& key,
+               const uint8_t* framebuffer, uint16_t fb_width);
+    bool ensure_directory(FAT32* fs);
+    // Supprime les versions périmées de path_hash puis évince jusqu'à pouvoir
+    // ajouter needed octets. Met à jour next_sequence.
+    void make_room(FAT32* fs, uint32_t needed, uint32_t path_hash);
+
+public:
+    explicit ImageCache(StorageManager* storage_manager);
+
+    // Affiche une image BMP en (0,0) dans un framebuffer RGB565 big-endian
+    // (celui du TFT), le reste étant mis au noir. Aucun envoi à l'écran:
+    // appeler sendFrame() ensuite.
+    SDCard_Status display(const char* filename, uint8_t* framebuffer, uint16_t fb_width, uint16_t fb_height);
+
+    void set_max_bytes(uint32_t bytes) { max_bytes = bytes; }
+    uint32_t get_max_bytes() const { return max_bytes; }
+    // Supprime toutes les entrées du cache
+    bool clear();
+
+    const ImageCacheStats& get_stats() const { return stats; }
+    void reset_stats() { stats = ImageCacheStats(); }
+};
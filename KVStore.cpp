@@ -0,0 +1,433 @@
+#include "KVStore.h"
+#include "FAT32.h"
+#include "BufferedWriter.h"
+#include "Crc32.h"
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+/*******************************************************
+ * Nom du fichier : KVStore.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : stockage clé/valeur journalisé (SD)
+ *******************************************************/
+
+using namespace KV_Config;
+
+// Enregistrement en cours de construction (hors pile)
+static uint8_t g_kv_record[sizeof(uint32_t) * 2 + MAX_KEY_LENGTH + MAX_VALUE_LENGTH];
+
+KVStore::KVStore()
+    : fs(nullptr), mounted(false), active_region(0), generation(0), max_generation(0),
+      tail_sector(1), tail_offset(0), cached_sector(-1), key_count(0) {
+    index_clear();
+}
+
+void KVStore::fingerprint(const char* key, uint8_t key_len, uint32_t& hash, uint16_t& check) {
+    // Deux FNV-1a de bases différentes: 48 bits d'empreinte
+    uint32_t h1 = 2166136261u;
+    uint32_t h2 = 0x9E3779B9u;
+    for (uint8_t i = 0; i < key_len; ++i) {
+        h1 = (h1 ^ (uint8_t)key[i]) * 16777619u;
+        h2 = (h2 ^ (uint8_t)key[i]) * 16777619u;
+    }
+    hash = h1;
+    check = (uint16_t)((h2 >> 16) ^ h2);
+}
+
+uint32_t KVStore::record_crc(uint32_t gen, const RecordHeader& header, const uint8_t* payload) {
+    const uint16_t value_bytes = (header.value_len == TOMBSTONE) ? 0 : header.value_len;
+    uint32_t crc = Crc32::update(0, &gen, sizeof(gen));
+    crc = Crc32::update(crc, &header.key_len, sizeof(header.key_len));
+    crc = Crc32::update(crc, &header.value_len, sizeof(header.value_len));
+    return Crc32::update(crc, payload, header.key_len + value_bytes);
+}
+
+uint16_t KVStore::record_length(const RecordHeader& header) {
+    return (uint16_t)(sizeof(RecordHeader) + header.key_len + ((header.value_len == TOMBSTONE) ? 0 : header.value_len));
+}
+
+bool KVStore::valid_record(const uint8_t* data, uint16_t offset, uint32_t gen) const {
+    if (offset + sizeof(RecordHeader) > 512) return false;
+    RecordHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    if (header.magic != RECORD_MAGIC || header.key_len == 0 || header.key_len > MAX_KEY_LENGTH) return false;
+    if (header.value_len != TOMBSTONE && header.value_len > MAX_VALUE_LENGTH) return false;
+    if (offset + record_length(header) > 512) return false;
+    return record_crc(gen, header, data + offset + sizeof(RecordHeader)) == header.crc;
+}
+
+// ============================================================================
+// Accès secteur
+// ============================================================================
+
+const uint8_t* KVStore::fetch_sector(uint32_t file_sector) {
+    if (cached_sector == (int32_t)file_sector) return sector;
+    cached_sector = -1;
+    if (!fs->read_file_sector(clusters, file_sector, sector)) return nullptr;
+    stats.sector_reads++;
+    cached_sector = (int32_t)file_sector;
+    return sector;
+}
+
+bool KVStore::read_header(uint8_t region, RegionHeader& out) {
+    const uint8_t* data = fetch_sector(region_base(region));
+    if (!data) return false;
+    memcpy(&out, data, sizeof(out));
+    return out.magic == REGION_MAGIC && out.crc == Crc32::update(0, &out, offsetof(RegionHeader, crc));
+}
+
+bool KVStore::write_header(uint8_t region, uint32_t gen, bool committed) {
+    RegionHeader header;
+    header.magic = REGION_MAGIC;
+    header.generation = gen;
+    header.committed = committed ? 1 : 0;
+    header.crc = Crc32::update(0, &header, offsetof(RegionHeader, crc));
+    cached_sector = -1;
+    memset(sector, 0, sizeof(sector));
+    memcpy(sector, &header, sizeof(header));
+    if (!fs->write_file_sector(clusters, region_base(region), sector)) return false;
+    stats.sector_writes++;
+    return true;
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+void KVStore::index_clear() {
+    for (auto& slot : index) {
+        slot.hash = 0;
+        slot.check = 0;
+        slot.location = SLOT_EMPTY;
+    }
+    key_count = 0;
+}
+
+KVStore::Slot* KVStore::find_slot(uint32_t hash, uint16_t check, bool for_insert) {
+    const uint16_t mask = INDEX_SLOTS - 1;
+    Slot* reusable = nullptr;
+    uint16_t i = (uint16_t)(hash & mask);
+    for (uint16_t n = 0; n < INDEX_SLOTS; ++n, i = (i + 1) & mask) {
+        Slot& slot = index[i];
+        if (slot.location == SLOT_EMPTY) {
+            return for_insert ? (reusable ? reusable : &slot) : nullptr;
+        }
+        if (slot.location == SLOT_DELETED) {
+            if (!reusable) reusable = &slot;
+            continue;
+        }
+        if (slot.hash == hash && slot.check == check) return &slot;
+    }
+    return for_insert ? reusable : nullptr;
+}
+
+bool KVStore::apply_record(const uint8_t* record, uint16_t location) {
+    RecordHeader header;
+    memcpy(&header, record, sizeof(header));
+    uint32_t hash;
+    uint16_t check;
+    fingerprint((const char*)record + sizeof(RecordHeader), header.key_len, hash, check);
+
+    Slot* slot = find_slot(hash, check, true);
+    const bool live = slot && slot->location != SLOT_EMPTY && slot->location != SLOT_DELETED;
+    if (header.value_len == TOMBSTONE) {
+        if (live) {
+            slot->location = SLOT_DELETED;
+            key_count--;
+        }
+        return true;
+    }
+    if (!live) {
+        if (!slot || key_count >= MAX_KEYS) return false;
+        slot->hash = hash;
+        slot->check = check;
+        key_count++;
+    }
+    slot->location = location;
+    return true;
+}
+
+// ============================================================================
+// Montage
+// ============================================================================
+
+bool KVStore::scan_region() {
+    index_clear();
+    tail_sector = 1;
+    tail_offset = 0;
+    memset(tail, 0, sizeof(tail));
+
+    const uint32_t base = region_base(active_region);
+    for (uint16_t s = 1; s < REGION_SECTORS; ++s) {
+        const uint8_t* data = fetch_sector(base + s);
+        if (!data) return false;
+        uint16_t offset = 0;
+        while (valid_record(data, offset, generation)) {
+            if (!apply_record(data + offset, (uint16_t)((s << 9) | offset))) {
+                printf("KVStore: index plein, clé ignorée\n");
+            }
+            RecordHeader header;
+            memcpy(&header, data + offset, sizeof(header));
+            offset += record_length(header);
+            stats.recovered++;
+        }
+        tail_sector = s;
+        tail_offset = offset;
+        memcpy(tail, data, offset);
+
+        // Un enregistrement ne déborde jamais: le journal continue dans le
+        // secteur suivant seulement s'il commence par un enregistrement valide
+        if (s + 1 >= REGION_SECTORS) break;
+        const uint8_t* next = fetch_sector(base + s + 1);
+        if (!next) return false;
+        if (!valid_record(next, 0, generation)) break;
+    }
+    return true;
+}
+
+bool KVStore::open(FAT32* filesystem, const char* path) {
+    fs = filesystem;
+    mounted = false;
+    cached_sector = -1;
+    if (!fs || !fs->is_initialized() || fs->is_exfat() || !path) return false;
+
+    const uint32_t file_bytes = FILE_SECTORS * 512u;
+    uint32_t size = 0;
+    if (!fs->get_file_clusters(path, clusters, size) || size < file_bytes) {
+        // Création et préallocation: un fichier nul ne contient aucune région valide
+        BufferedWriter out(fs);
+        FAT_ErrorCode r = out.open(path, OVERWRITE, file_bytes);
+        if (r != FILE_CREATE_OK && r != FILE_FOUND) return false;
+        memset(sector, 0, sizeof(sector));
+        bool ok = true;
+        for (uint32_t i = 0; ok && i < FILE_SECTORS; ++i) ok = out.write(sector, sizeof(sector));
+        ok = out.close() && ok;
+        if (!ok || !fs->get_file_clusters(path, clusters, size)) {
+            printf("KVStore: impossible de préallouer %s\n", path);
+            return false;
+        }
+    }
+
+    // Région active: en-tête validé de plus haute génération. Les en-têtes
+    // non validés (compactage interrompu) comptent pour max_generation.
+    RegionHeader headers[2];
+    int8_t best = -1;
+    max_generation = 0;
+    for (uint8_t r = 0; r < 2; ++r) {
+        if (!read_header(r, headers[r])) continue;
+        if (headers[r].generation > max_generation) max_generation = headers[r].generation;
+        if (headers[r].committed && (best < 0 || headers[r].generation > headers[best].generation)) best = (int8_t)r;
+    }
+    if (best < 0) {
+        active_region = 0;
+        generation = max_generation + 1;
+        max_generation = generation;
+        if (!write_header(0, generation, true) || !fs->flush()) return false;
+    } else {
+        active_region = (uint8_t)best;
+        generation = headers[best].generation;
+    }
+
+    if (!scan_region()) return false;
+    mounted = true;
+    printf("KVStore: %u clé(s), génération %lu, %lu/%lu octets utilisés\n",
+           key_count, (unsigned long)generation, (unsigned long)used_bytes(),
+           (unsigned long)((REGION_SECTORS - 1) * 512u));
+    return true;
+}
+
+// ============================================================================
+// Écriture
+// ============================================================================
+
+bool KVStore::append_record(const uint8_t* record, uint16_t length, uint16_t& location) {
+    if (tail_offset + length > 512) {
+        if (tail_sector + 1 >= REGION_SECTORS) return false;
+        tail_sector++;
+        tail_offset = 0;
+        memset(tail, 0, sizeof(tail));
+    }
+    const uint32_t file_sector = region_base(active_region) + tail_sector;
+    memcpy(tail + tail_offset, record, length);
+    if (!fs->write_file_sector(clusters, file_sector, tail)) {
+        memset(tail + tail_offset, 0, length);
+        return false;
+    }
+    stats.sector_writes++;
+    if (cached_sector == (int32_t)file_sector) cached_sector = -1;
+    location = (uint16_t)((tail_sector << 9) | tail_offset);
+    tail_offset += length;
+    return true;
+}
+
+bool KVStore::append(const char* key, uint8_t key_len, const void* value, uint16_t value_len) {
+    RecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.key_len = key_len;
+    header.value_len = value_len;
+    const uint16_t value_bytes = (value_len == TOMBSTONE) ? 0 : value_len;
+    memcpy(g_kv_record + sizeof(RecordHeader), key, key_len);
+    if (value_bytes) memcpy(g_kv_record + sizeof(RecordHeader) + key_len, value, value_bytes);
+    const uint16_t length = record_length(header);
+
+    // Région pleine: compactage puis nouvel essai (crc selon la génération)
+    const bool fits = tail_offset + length <= 512 || tail_sector + 1 < REGION_SECTORS;
+    if (!fits && !compact()) return false;
+
+    header.crc = record_crc(generation, header, g_kv_record + sizeof(RecordHeader));
+    memcpy(g_kv_record, &header, sizeof(header));
+    uint16_t location = 0;
+    if (!append_record(g_kv_record, length, location)) {
+        printf("KVStore: journal plein\n");
+        return false;
+    }
+    return apply_record(g_kv_record, location);
+}
+
+bool KVStore::put(const char* key, const void* value, uint16_t length) {
+    if (!mounted || !key || (length && !value)) return false;
+    const size_t key_len = strlen(key);
+    if (key_len == 0 || key_len > MAX_KEY_LENGTH || length > MAX_VALUE_LENGTH) return false;
+
+    uint32_t hash;
+    uint16_t check;
+    fingerprint(key, (uint8_t)key_len, hash, check);
+    Slot* slot = find_slot(hash, check, false);
+    if (!slot && key_count >= MAX_KEYS) {
+        printf("KVStore: nombre maximal de clés atteint (%u)\n", MAX_KEYS);
+        return false;
+    }
+    stats.puts++;
+    return append(key, (uint8_t)key_len, value, length);
+}
+
+bool KVStore::put_string(const char* key, const char* value) {
+    return value && put(key, value, (uint16_t)strlen(value));
+}
+
+bool KVStore::remove(const char* key) {
+    if (!mounted || !key) return false;
+    const size_t key_len = strlen(key);
+    if (key_len == 0 || key_len > MAX_KEY_LENGTH) return false;
+    uint32_t hash;
+    uint16_t check;
+    fingerprint(key, (uint8_t)key_len, hash, check);
+    if (!find_slot(hash, check, false)) return false;
+    stats.puts++;
+    return append(key, (uint8_t)key_len, nullptr, TOMBSTONE);
+}
+
+// ============================================================================
+// Lecture
+// ============================================================================
+
+int32_t KVStore::get(const char* key, void* out, uint16_t max_length) {
+    if (!mounted || !key) return -1;
+    const size_t key_len = strlen(key);
+    if (key_len == 0 || key_len > MAX_KEY_LENGTH) return -1;
+    uint32_t hash;
+    uint16_t check;
+    fingerprint(key, (uint8_t)key_len, hash, check);
+    const Slot* slot = find_slot(hash, check, false);
+    if (!slot) return -1;
+    stats.gets++;
+
+    const uint16_t s = slot->location >> 9;
+    const uint16_t offset = slot->location & 0x1FF;
+    const uint8_t* data = (s == tail_sector) ? tail : fetch_sector(region_base(active_region) + s);
+    if (!data || !valid_record(data, offset, generation)) {
+        printf("KVStore: enregistrement illisible pour '%s'\n", key);
+        return -1;
+    }
+    RecordHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    const uint8_t* payload = data + offset + sizeof(RecordHeader);
+    if (header.key_len != key_len || memcmp(payload, key, key_len) != 0) return -1;
+
+    const uint16_t n = (header.value_len < max_length) ? header.value_len : max_length;
+    if (out && n) memcpy(out, payload + key_len, n);
+    return header.value_len;
+}
+
+bool KVStore::contains(const char* key) {
+    return get(key, nullptr, 0) >= 0;
+}
+
+// ============================================================================
+// Compactage
+// ============================================================================
+
+bool KVStore::compact() {
+    if (!fs || clusters.empty()) return false;
+    const uint8_t source = active_region;
+    const uint8_t target = (uint8_t)(1 - active_region);
+    const uint32_t gen = max_generation + 1;
+
+    // En-tête "en cours" d'abord: une copie interrompue ne peut plus réutiliser
+    // cette génération après redémarrage
+    if (!write_header(target, gen, false) || !fs->flush()) return false;
+    max_generation = gen;
+
+    // Les nouvelles positions ne sont appliquées qu'après validation
+    uint16_t moved[INDEX_SLOTS];
+    uint16_t out_sector = 1;
+    uint16_t out_offset = 0;
+    memset(tail, 0, sizeof(tail));
+    for (uint16_t i = 0; i < INDEX_SLOTS; ++i) {
+        moved[i] = index[i].location;
+        if (index[i].location == SLOT_EMPTY || index[i].location == SLOT_DELETED) continue;
+
+        const uint16_t offset = index[i].location & 0x1FF;
+        const uint8_t* data = fetch_sector(region_base(source) + (index[i].location >> 9));
+        if (!data || !valid_record(data, offset, generation)) return reload_tail();
+        RecordHeader header;
+        memcpy(&header, data + offset, sizeof(header));
+        const uint16_t length = record_length(header);
+
+        if (out_offset + length > 512) {
+            if (!fs->write_file_sector(clusters, region_base(target) + out_sector, tail)) return reload_tail();
+            stats.sector_writes++;
+            if (++out_sector >= REGION_SECTORS) {
+                printf("KVStore: données vivantes plus grandes qu'une région\n");
+                return reload_tail();
+            }
+            out_offset = 0;
+            memset(tail, 0, sizeof(tail));
+        }
+        header.crc = record_crc(gen, header, data + offset + sizeof(RecordHeader));
+        memcpy(tail + out_offset, &header, sizeof(header));
+        memcpy(tail + out_offset + sizeof(header), data + offset + sizeof(header), length - sizeof(header));
+        moved[i] = (uint16_t)((out_sector << 9) | out_offset);
+        out_offset += length;
+    }
+    if (!fs->write_file_sector(clusters, region_base(target) + out_sector, tail)) return reload_tail();
+    stats.sector_writes++;
+
+    // Validation: la copie est sur la carte avant l'en-tête
+    if (!fs->flush() || !write_header(target, gen, true) || !fs->flush()) return reload_tail();
+
+    for (uint16_t i = 0; i < INDEX_SLOTS; ++i) index[i].location = moved[i];
+    active_region = target;
+    generation = gen;
+    tail_sector = out_sector;
+    tail_offset = out_offset;
+    cached_sector = -1;
+    stats.compactions++;
+    return true;
+}
+
+// Compactage abandonné: le tampon de queue a servi à la copie, la région
+// active reste inchangée
+bool KVStore::reload_tail() {
+    cached_sector = -1;
+    const uint8_t* data = fetch_sector(region_base(active_region) + tail_sector);
+    memset(tail, 0, sizeof(tail));
+    if (data) memcpy(tail, data, tail_offset);
+    return false;
+}
+
+bool KVStore::sync() {
+    return fs && fs->flush();
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+/*
+ * KVStore - Stockage clé/valeur journalisé sur la carte SD
+ *
+ * Réglages, positions de lecture, métadonnées par fichier: chaque écriture
+ * ajoute un enregistrement au journal, contenu dans un seul fichier
+ * préalloué. La taille du fichier ne change jamais: ni parcours de
+ * répertoire ni réécriture d'entrée, une mise à jour coûte l'écriture
+ * d'un secteur (le secteur de queue, gardé en RAM) et une lecture
+ * coûte au plus la lecture d'un secteur.
+ *
+ * Le fichier est découpé en deux régions. La région active porte l'en-tête
+ * validé de génération la plus haute; quand elle est pleine, les
+ * enregistrements vivants sont recopiés dans l'autre région (compactage),
+ * dont l'en-tête n'est validé qu'une fois la copie écrite.
+ *
+ * Un index en RAM (adressage ouvert) associe l'empreinte 48 bits d'une clé
+ * à la position de son dernier enregistrement. Au montage, la région active
+ * est relue jusqu'au premier enregistrement invalide (CRC32 incluant la
+ * génération): un journal coupé en cours d'écriture retrouve exactement
+ * les enregistrements complets.
+ *
+ * Enregistrement (jamais à cheval sur deux secteurs):
+ *   magic(1) key_len(1) value_len(2) crc32(4) clé valeur
+ */
+
+#include "pico/stdlib.h"
+#include <vector>
+
+// Forward declaration
+class FAT32;
+
+namespace KV_Config {
+    static constexpr const char* DEFAULT_PATH = "/KVSTORE.DAT";
+    static constexpr uint16_t REGION_SECTORS = 32;         // 16 Ko par région (en-tête compris)
+    static constexpr uint32_t FILE_SECTORS = 2u * REGION_SECTORS;
+    static constexpr uint16_t INDEX_SLOTS = 128;           // puissance de 2
+    static constexpr uint16_t MAX_KEYS = INDEX_SLOTS * 3 / 4;
+    static constexpr uint8_t  MAX_KEY_LENGTH = 32;
+    static constexpr uint16_t MAX_VALUE_LENGTH = 256;
+
+    static constexpr uint32_t REGION_MAGIC = 0x3153564B;   // "KVS1"
+    static constexpr uint8_t  RECORD_MAGIC = 0x4B;
+    static constexpr uint16_t TOMBSTONE = 0xFFFF;          // value_len d'une suppression
+}
+
+struct KVStats {
+    uint32_t puts;
+    uint32_t gets;
+    uint32_t sector_reads;
+    uint32_t sector_writes;
+    uint32_t compactions;
+    uint32_t recovered;        // enregistrements relus au montage
+
+    KVStats() : puts(0), gets(0), sector_reads(0), sector_writes(0), compactions(0), recovered(0) {}
+};
+
+class KVStore {
+private:
+    struct RegionHeader {
+        uint32_t magic;
+        uint32_t generation;
+        uint32_t committed;    // 0 pendant un compactage, 1 une fois la copie écrite
+        uint32_t crc;
+    } __attribute__((packed));
+
+    struct RecordHeader {
+        uint8_t  magic;
+        uint8_t  key_len;
+        uint16_t value_len;
+        uint32_t crc;
+    } __attribute__((packed));
+
+    // location = secteur dans la région << 9 | décalage
+    struct Slot {
+        uint32_t hash;
+        uint16_t check;
+        uint16_t location;
+    };
+    static constexpr uint16_t SLOT_EMPTY = 0xFFFF;
+    static constexpr uint16_t SLOT_DELETED = 0xFFFE;
+
+    FAT32* fs;
+    std::vector<uint32_t> clusters;
+    bool mounted;
+
+    uint8_t  active_region;
+    uint32_t generation;
+    uint32_t max_generation;   // y compris les compactages interrompus
+    uint16_t tail_sector;      // secteur de queue, relatif à la région
+    uint16_t tail_offset;
+    uint8_t  tail[512];
+    uint8_t  sector[512];      // dernier secteur lu (hors queue)
+    int32_t  cached_sector;    // index absolu dans le fichier, -1 si aucun
+
+    Slot     index[KV_Config::INDEX_SLOTS];
+    uint16_t key_count;
+    KVStats  stats;
+
+    static void fingerprint(const char* key, uint8_t key_len, uint32_t& hash, uint16_t& check);
+    static uint32_t record_crc(uint32_t gen, const RecordHeader& header, const uint8_t* payload);
+    static uint16_t record_length(const RecordHeader& header);
+    bool valid_record(const uint8_t* data, uint16_t offset, uint32_t gen) const;
+    uint32_t region_base(uint8_t region) const { return region * KV_Config::REGION_SECTORS; }
+
+    const uint8_t* fetch_sector(uint32_t file_sector);
+    bool read_header(uint8_t region, RegionHeader& out);
+    bool write_header(uint8_t region, uint32_t gen, bool committed);
+    bool scan_region();
+
+    Slot* find_slot(uint32_t hash, uint16_t check, bool for_insert);
+    void index_clear();
+    bool apply_record(const uint8_t* record, uint16_t location);
+
+    bool append(const char* key, uint8_t key_len, const void* value, uint16_t value_len);
+    bool append_record(const uint8_t* record, uint16_t length, uint16_t& location);
+    bool reload_tail();
+
+public:
+    KVStore();
+
+    // Ouvre (ou crée et préalloue) le fichier du journal et reconstruit l'index
+    bool open(FAT32* filesystem, const char* path = KV_Config::DEFAULT_PATH);
+    bool is_open() const { return mounted; }
+
+    bool put(const char* key, const void* value, uint16_t length);
+    bool put_string(const char* key, const char* value);
+    // Retourne la taille de la valeur (copiée tronquée à max_length), -1 si absente
+    int32_t get(const char* key, void* out, uint16_t max_length);
+    bool remove(const char* key);
+    bool contains(const char* key);
+
+    // Recopie les enregistrements vivants dans l'autre région
+    bool compact();
+    // Écrit les secteurs en attente (la boucle principale le fait aux temps morts)
+    bool sync();
+
+    uint16_t count() const { return key_count; }
+    // Octets occupés dans la région active (en-tête exclu)
+    uint32_t used_bytes() const { return (uint32_t)(tail_sector - 1) * 512u + tail_offset; }
+    uint32_t get_generation() const { return generation; }
+    const KVStats& get_stats() const { return stats; }
+};
@@ -0,0 +1,146 @@
+#include "LineReader.h"
+#include <cstdio>
+#include <cstring>
+
+/*******************************************************
+ * Nom du fichier : LineReader.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : lecture ligne à ligne sans copie (FAT32)
+ *******************************************************/
+
+using namespace LineReader_Config;
+
+char LineReader::buffer[BUFFER_SECTORS * 512];
+char LineReader::carry[MAX_LINE];
+bool LineReader::busy = false;
+
+LineReader::LineReader(FAT32* filesystem)
+    : fs(filesystem), gzip(filesystem), opened(false), compressed(false), eof(true), complete(true),
+      position(0), length(0), carry_length(0), line_number(0) {}
+
+LineReader::~LineReader() {
+    close();
+}
+
+bool LineReader::open(const char* path) {
+    if (!fs || !fs->is_initialized() || !path || opened) return false;
+    if (busy) {
+        printf("LineReader: un autre fichier est en cours de lecture\n");
+        return false;
+    }
+    if (fs->file_open(path, READ) != FILE_FOUND) return false;
+
+    compressed = GzipReader::is_gz_name(path);
+    if (compressed && gzip.begin() != GZ_OK) {
+        gzip.end();
+        fs->file_close();
+        return false;
+    }
+    busy = true;
+    opened = true;
+    handler = ReadHandler();
+    eof = false;
+    complete = true;
+    position = length = carry_length = 0;
+    line_number = 0;
+    stats = LineReaderStats();
+    return true;
+}
+
+void LineReader::close() {
+    if (!opened) return;
+    if (compressed) gzip.end();
+    fs->file_close();
+    opened = false;
+    busy = false;
+}
+
+bool LineReader::refill() {
+    if (eof) return false;
+    uint32_t n;
+    if (compressed) {
+        n = gzip.read(reinterpret_cast<uint8_t*>(buffer), sizeof(buffer));
+    } else {
+        // Secteurs entiers en multi-blocs, la fin du fichier secteur par secteur
+        n = fs->file_read_blocks(reinterpret_cast<uint8_t*>(buffer), BUFFER_SECTORS, &handler);
+        if (n == 0) n = fs->file_read(reinterpret_cast<uint8_t*>(buffer), &handler);
+    }
+    position = 0;
+    length = (uint16_t)n;
+    if (n == 0) {
+        eof = true;
+        return false;
+    }
+    stats.bytes += n;
+    return true;
+}
+
+uint16_t LineReader::append_carry(const char* data, uint16_t count) {
+    const uint16_t room = MAX_LINE - carry_length;
+    const uint16_t n = (count < room) ? count : room;
+    memcpy(carry + carry_length, data, n);
+    carry_length += n;
+    return n;
+}
+
+std::string_view LineReader::strip_cr(const char* data, uint16_t count) {
+    if (count > 0 && data[count - 1] == '\r') count--;
+    return std::string_view(data, count);
+}
+
+bool LineReader::next(std::string_view& line) {
+    if (!opened) return false;
+
+    // Une ligne commence si la précédente était complète
+    const bool new_line = complete;
+    for (;;) {
+        if (position >= length) {
+            if (refill()) continue;
+            if (carry_length == 0) return false;
+            // Dernière ligne sans '\n'
+            line = strip_cr(carry, carry_length);
+            carry_length = 0;
+            complete = true;
+            stats.copied++;
+            break;
+        }
+
+        const char* start = buffer + position;
+        const uint16_t available = length - position;
+        const char* newline = static_cast<const char*>(memchr(start, '\n', available));
+        const uint16_t count = newline ? (uint16_t)(newline - start) : available;
+
+        if (newline && carry_length == 0) {
+            // Ligne entière dans le tampon: vue directe, sans copie
+            position += count + 1;
+            line = strip_cr(start, count);
+            complete = true;
+            break;
+        }
+
+        const uint16_t added = append_carry(start, count);
+        position += added;
+        if (added < count) {
+            // Plus longue que MAX_LINE: livrée par morceaux
+            line = std::string_view(carry, carry_length);
+            carry_length = 0;
+            complete = false;
+            stats.split++;
+            break;
+        }
+        if (newline) {
+            position++;
+            line = strip_cr(carry, carry_length);
+            carry_length = 0;
+            complete = true;
+            stats.copied++;
+            break;
+        }
+        // Pas de fin de ligne avant la fin du tampon: lecture suivante
+    }
+
+    if (new_line) line_number++;
+    stats.lines++;
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+/*
+ * LineReader - Lecture ligne à ligne d'un fichier texte
+ *
+ * Fichiers de configuration, listes de lecture, scripts: next() retourne
+ * chaque ligne sous forme de std::string_view pointant directement dans le
+ * tampon de secteurs, sans '\n' ni '\r' final (LF et CRLF). Seules les
+ * lignes à cheval sur deux lectures sont recopiées, dans un tampon de
+ * MAX_LINE octets; une ligne plus longue est livrée en plusieurs morceaux
+ * (last_complete() faux pour tous sauf le dernier). Aucune allocation: un
+ * journal de 1 Mo se parcourt avec les seuls tampons statiques.
+ *
+ * Un fichier .gz est décompressé à la volée (GzipReader). Les vues restent
+ * valides jusqu'à l'appel suivant de next(). FAT32 n'ayant qu'un fichier
+ * ouvert, un seul lecteur peut être ouvert à la fois.
+ */
+
+#include "pico/stdlib.h"
+#include "FAT32.h"
+#include "GzipReader.h"
+#include <string_view>
+
+namespace LineReader_Config {
+    static constexpr uint16_t BUFFER_SECTORS = 4;     // lecture multi-blocs
+    static constexpr uint16_t MAX_LINE = 256;         // ligne recopiée à cheval sur deux lectures
+}
+
+struct LineReaderStats {
+    uint32_t lines;            // lignes (ou morceaux) retournées
+    uint32_t copied;           // lignes recopiées (à cheval sur deux lectures)
+    uint32_t split;            // morceaux de lignes plus longues que MAX_LINE
+    uint32_t bytes;            // octets de texte lus
+
+    LineReaderStats() : lines(0), copied(0), split(0), bytes(0) {}
+};
+
+class LineReader {
+private:
+    FAT32* fs;
+    ReadHandler handler;
+    GzipReader gzip;
+    bool opened;
+    bool compressed;
+    bool eof;
+    bool complete;
+    uint16_t position;         // prochain octet à analyser dans buffer
+    uint16_t length;           // octets valides dans buffer
+    uint16_t carry_length;     // début de ligne recopié depuis la lecture précédente
+    uint32_t line_number;
+    LineReaderStats stats;
+
+    static char buffer[LineReader_Config::BUFFER_SECTORS * 512];
+    static char carry[LineReader_Config::MAX_LINE];
+    static bool busy;
+
+    bool refill();
+    // Ajoute à carry au plus ce qui y tient; retourne les octets ajoutés
+    uint16_t append_carry(const char* data, uint16_t count);
+    static std::string_view strip_cr(const char* data, uint16_t count);
+
+public:
+    explicit LineReader(FAT32* filesystem);
+    ~LineReader();
+
+    // Ouvre le fichier (FAT32::file_open en READ), .gz compris
+    bool open(const char* path);
+    // Ligne suivante; false en fin de fichier (ou erreur de décompression)
+    bool next(std::string_view& line);
+    // Faux si la dernière ligne retournée continue au prochain next()
+    bool last_complete() const { return complete; }
+    // Numéro (à partir de 1) de la dernière ligne retournée
+    uint32_t get_line_number() const { return line_number; }
+    void close();
+
+    bool is_open() const { return opened; }
+    const LineReaderStats& get_stats() const { return stats; }
+};
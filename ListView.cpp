@@ -0,0 +1,132 @@
+#include "ListView.h"
+
+/*******************************************************
+ * Nom du fichier : ListView.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : liste virtualisée, lignes à la demande
+ *******************************************************/
+
+using namespace ListView_Config;
+
+ListView::ListView(const Rect& area, ListSource data, void* data_context, uint32_t item_count,
+                   uint8_t line_height, uint16_t text_color, uint16_t highlight)
+    : Widget(area), source(data), context(data_context), count(data ? item_count : 0), first(0), selected(-1),
+      row_height(line_height ? line_height : 1), color(text_color), select_color(highlight) {
+    drop_cache();
+}
+
+void ListView::drop_cache() {
+    for (uint8_t i = 0; i < ROW_CACHE; ++i) cache[i].valid = false;
+}
+
+uint32_t ListView::max_first() const {
+    const uint16_t rows = visible_rows();
+    return (count > rows) ? count - rows : 0;
+}
+
+Rect ListView::row_rect(uint32_t index) const {
+    if (index < first || index >= first + visible_rows()) return Rect();
+    return Rect(bounds.x, bounds.y + (int)(index - first) * row_height, bounds.w, row_height);
+}
+
+const char* ListView::row_text(uint32_t index) {
+    Row& row = cache[index % ROW_CACHE];
+    if (row.valid && row.index == index) {
+        stats.hits++;
+        return row.text;
+    }
+    stats.fetches++;
+    row.index = index;
+    row.valid = source && source(index, row.text, ROW_TEXT, context);
+    if (!row.valid) row.text[0] = '\0';
+    row.text[ROW_TEXT - 1] = '\0';
+    return row.text;
+}
+
+void ListView::set_source(ListSource data, void* data_context, uint32_t item_count) {
+    source = data;
+    context = data_context;
+    count = data ? item_count : 0;
+    first = 0;
+    selected = -1;
+    drop_cache();
+    invalidate();
+}
+
+void ListView::refresh(uint32_t item_count) {
+    count = source ? item_count : 0;
+    if (first > max_first()) first = max_first();
+    if (selected >= (int32_t)count) selected = -1;
+    drop_cache();
+    invalidate();
+}
+
+void ListView::scroll_to(uint32_t index) {
+    const uint32_t target = (index < max_first()) ? index : max_first();
+    if (target == first) return;
+    const uint16_t rows = visible_rows();
+    const bool down = target > first;
+    const uint32_t delta = down ? target - first : first - target;
+    first = target;
+
+    if (delta < rows && tree) {
+        // Les lignes restées visibles glissent dans le framebuffer, seule
+        // la bande découverte est redessinée
+        const Rect area(bounds.x, bounds.y, bounds.w, rows * row_height);
+        const int shift = (int)delta * row_height;
+        if (tree->scroll(this, area, down ? -shift : shift)) {
+            stats.shifts++;
+            if (down) invalidate(Rect(area.x, area.y + area.h - shift, area.w, shift));
+            else invalidate(Rect(area.x, area.y, area.w, shift));
+            return;
+        }
+    }
+    invalidate();
+}
+
+void ListView::scroll(int32_t rows) {
+    if (rows < 0 && (uint32_t)(-rows) > first) {
+        scroll_to(0);
+        return;
+    }
+    scroll_to(first + rows);
+}
+
+void ListView::set_selected(int32_t index) {
+    if (index < -1 || index >= (int32_t)count) index = -1;
+    if (index == selected) return;
+    const int32_t previous = selected;
+    selected = index;
+    if (index >= 0) {
+        // Hors de la partie visible: défilement juste assez pour la montrer
+        const uint16_t rows = visible_rows();
+        if ((uint32_t)index < first) scroll_to((uint32_t)index);
+        else if (rows && (uint32_t)index >= first + rows) scroll_to((uint32_t)index - rows + 1);
+    }
+    if (previous >= 0) invalidate(row_rect((uint32_t)previous));
+    if (index >= 0) invalidate(row_rect((uint32_t)index));
+}
+
+void ListView::draw(TFT& tft, const Rect& clip) {
+    const Rect area = clip.intersect(bounds);
+    if (area.empty()) return;
+    const uint16_t rows = visible_rows();
+    const uint32_t r0 = (uint32_t)(area.y - bounds.y) / row_height;
+    uint32_t r1 = (uint32_t)(area.y + area.h - 1 - bounds.y) / row_height + 1;
+    if (r1 > rows) r1 = rows;
+
+    // Texte trop long: coupé au bord de la liste, pas de la zone redessinée
+    if (!tft.pushClip(area.x, area.y, area.w, area.h)) return;
+    const FontType previous = tft.getFont();
+    tft.setFont(FontType::FONT_STANDARD);
+    for (uint32_t r = r0; r < r1 && first + r < count; ++r) {
+        const uint32_t index = first + r;
+        const Rect row = row_rect(index);
+        if ((int32_t)index == selected) tft.fillRect(row.x, row.y, row.w, row.h, select_color);
+        tft.drawText(row.x + 2, row.y + (row.h - 12) / 2, row_text(index), color);
+        stats.rows_drawn++;
+    }
+    tft.setFont(previous);
+    tft.popClip();
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ * ListView - Liste virtualisée alimentée par une source de données
+ *
+ * Contrairement à ListWidget (tableau de lignes en mémoire), ListView ne
+ * connaît que le nombre d'éléments: le texte d'une ligne est demandé à la
+ * source (ListSource) au moment de la dessiner, par exemple un
+ * FAT32::DirIterator positionné par index. La mémoire est constante quel
+ * que soit le nombre d'éléments: ROW_CACHE lignes de ROW_TEXT octets.
+ *
+ * Cache: la ligne n est rangée dans l'emplacement n % ROW_CACHE. Tant que
+ * ROW_CACHE couvre les lignes visibles, défiler d'une ligne ne demande
+ * qu'une seule ligne à la source; les autres sont réutilisées.
+ *
+ * Défilement de moins d'un écran: les lignes restées visibles sont
+ * décalées dans le framebuffer (WidgetTree::scroll) et seule la bande
+ * découverte est redessinée. Si un autre widget recouvre la liste, toute
+ * la liste est invalidée.
+ */
+
+#include "pico/stdlib.h"
+#include "Widget.h"
+
+namespace ListView_Config {
+    static constexpr uint8_t ROW_CACHE = 24;           // >= lignes visibles (240 / 14 = 17)
+    static constexpr uint8_t ROW_TEXT = 40;            // texte d'une ligne, '\0' compris
+}
+
+// Texte de l'élément index (au plus size - 1 caractères); false si absent
+typedef bool (*ListSource)(uint32_t index, char* text, uint8_t size, void* context);
+
+struct ListViewStats {
+    uint32_t fetches;          // lignes demandées à la source
+    uint32_t hits;             // lignes trouvées dans le cache
+    uint32_t rows_drawn;
+    uint32_t shifts;           // défilements faits par décalage du framebuffer
+
+    ListViewStats() : fetches(0), hits(0), rows_drawn(0), shifts(0) {}
+};
+
+class ListView : public Widget {
+private:
+    struct Row {
+        uint32_t index;
+        bool valid;
+        char text[ListView_Config::ROW_TEXT];
+    };
+
+    ListSource source;
+    void* context;
+    uint32_t count;
+    uint32_t first;            // premier élément visible
+    int32_t  selected;         // -1: aucun
+    uint8_t  row_height;
+    uint16_t color, select_color;
+    Row cache[ListView_Config::ROW_CACHE];
+    ListViewStats stats;
+
+    uint16_t visible_rows() const { return (uint16_t)(bounds.h / row_height); }
+    uint32_t max_first() const;
+    Rect row_rect(uint32_t index) const;               // vide si l'élément n'est pas visible
+    const char* row_text(uint32_t index);              // cache, sinon source
+    void drop_cache();
+
+public:
+    ListView(const Rect& area, ListSource data, void* data_context, uint32_t item_count,
+             uint8_t line_height = 14, uint16_t text_color = COLOR_16BITS_WHITE,
+             uint16_t highlight = COLOR_16BITS_BLUE);
+
+    // Nouvelle source (ou nouveau contenu): retour en haut, cache vidé
+    void set_source(ListSource data, void* data_context, uint32_t item_count);
+    // Contenu modifié sans changer de source: cache vidé, position gardée
+    void refresh(uint32_t item_count);
+
+    // Premier élément visible (borné à la fin de la liste)
+    void scroll_to(uint32_t index);
+    void scroll(int32_t rows);
+    // Fait défiler si besoin pour rendre l'élément visible
+    void set_selected(int32_t index);
+
+    uint32_t get_count() const { return count; }
+    uint32_t get_first() const { return first; }
+    int32_t get_selected() const { return selected; }
+    const ListViewStats& get_stats() const { return stats; }
+    void reset_stats() { stats = ListViewStats(); }
+
+    // Ne dessine que les lignes qui touchent clip
+    void draw(TFT& tft, const Rect& clip) override;
+};
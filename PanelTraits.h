@@ -0,0 +1,161 @@
+#pragma once
+
+/*
+ * PanelTraits - Description des contrôleurs d'écran pris en charge
+ *
+ * Chaque structure décrit un contrôleur à la compilation: résolution
+ * native, forme (ronde ou rectangulaire), séquence d'initialisation,
+ * commandes de fenêtre, valeur de MADCTL et décalage en RAM pour chaque
+ * rotation. TFTRenderer<Panel> s'en sert comme paramètre de template:
+ * dimensions et tables sont des constantes, sans appel virtuel.
+ *
+ * Une séquence d'initialisation est une table de PanelCommand envoyées
+ * dans l'ordre après le reset matériel (TFTBus::init_panel).
+ */
+
+#include <cstdint>
+
+struct PanelCommand {
+    uint8_t cmd;
+    uint8_t len;               // octets de données (0: commande seule)
+    uint8_t data[15];
+    uint8_t delay_ms;          // attente après la commande
+};
+
+// GC9A01 240x240 rond (RGB565, ordre BGR)
+struct GC9A01Panel {
+    static constexpr const char* NAME = "GC9A01";
+    static constexpr int WIDTH = 240;
+    static constexpr int HEIGHT = 240;
+    static constexpr bool ROUND = true;
+
+    static constexpr uint8_t CASET = 0x2A;
+    static constexpr uint8_t RASET = 0x2B;
+    static constexpr uint8_t RAMWR = 0x2C;
+    static constexpr uint8_t MADCTL = 0x36;
+    // Index: Rotation (0°, 90°, 180°, 270°)
+    static constexpr uint8_t MADCTL_ROTATION[4] = {0x08, 0x68, 0xC8, 0xA8};
+    static constexpr uint16_t X_OFFSET[4] = {0, 0, 0, 0};
+    static constexpr uint16_t Y_OFFSET[4] = {0, 0, 0, 0};
+
+    static constexpr PanelCommand INIT[] = {
+        {0xEF, 0, {}, 0},
+        {0xEB, 2, {0xEB, 0x14}, 0},
+        {0xFE, 0, {}, 0},
+        {0xEF, 0, {}, 0},
+        {0xEB, 2, {0xEB, 0x14}, 0},
+        {0x84, 1, {0x40}, 0},
+        {0x85, 1, {0xFF}, 0},
+        {0x86, 1, {0xFF}, 0},
+        {0x87, 1, {0xFF}, 0},
+        {0x88, 1, {0x0A}, 0},
+        {0x89, 1, {0x21}, 0},
+        {0x8A, 1, {0x00}, 0},
+        {0x8B, 1, {0x80}, 0},
+        {0x8C, 1, {0x01}, 0},
+        {0x8D, 1, {0x01}, 0},
+        {0x8E, 1, {0xFF}, 0},
+        {0x8F, 1, {0xFF}, 0},
+        {0xB6, 2, {0x00, 0x20}, 0},
+        {0x36, 1, {0x08}, 0},
+        {0x3A, 1, {0x05}, 0},
+        {0x90, 4, {0x08, 0x08, 0x08, 0x08}, 0},
+        {0xBD, 1, {0x06}, 0},
+        {0xBC, 1, {0x00}, 0},
+        {0xFF, 3, {0x60, 0x01, 0x04}, 0},
+        {0xC3, 1, {0x13}, 0},
+        {0xC4, 1, {0x13}, 0},
+        {0xC9, 1, {0x22}, 0},
+        {0xBE, 1, {0x11}, 0},
+        {0xE1, 2, {0x10, 0x0E}, 0},
+        {0xDF, 3, {0x21, 0x0C, 0x02}, 0},
+        {0xF0, 6, {0x45, 0x09, 0x08, 0x08, 0x26, 0x2A}, 0},
+        {0xF1, 6, {0x43, 0x70, 0x72, 0x36, 0x37, 0x6F}, 0},
+        {0xF2, 6, {0x45, 0x09, 0x08, 0x08, 0x26, 0x2A}, 0},
+        {0xF3, 6, {0x43, 0x70, 0x72, 0x36, 0x37, 0x6F}, 0},
+        {0xED, 2, {0x1B, 0x0B}, 0},
+        {0xAE, 1, {0x77}, 0},
+        {0xCD, 1, {0x63}, 0},
+        {0x70, 9, {0x07, 0x07, 0x04, 0x0E, 0x0F, 0x09, 0x07, 0x08, 0x03}, 0},
+        {0xE8, 1, {0x34}, 0},
+        {0x62, 12, {0x18, 0x0D, 0x71, 0xED, 0x70, 0x70, 0x18, 0x0F, 0x71, 0xEF, 0x70, 0x70}, 0},
+        {0x63, 12, {0x18, 0x11, 0x71, 0xF1, 0x70, 0x70, 0x18, 0x13, 0x71, 0xF3, 0x70, 0x70}, 0},
+        {0x64, 7, {0x28, 0x29, 0xF1, 0x01, 0xF1, 0x00, 0x07}, 0},
+        {0x66, 10, {0x3C, 0x00, 0xCD, 0x67, 0x45, 0x45, 0x10, 0x00, 0x00, 0x00}, 0},
+        {0x67, 10, {0x00, 0x3C, 0x00, 0x00, 0x00, 0x01, 0x54, 0x10, 0x32, 0x98}, 0},
+        {0x74, 7, {0x10, 0x85, 0x80, 0x00, 0x00, 0x4E, 0x00}, 0},
+        {0x98, 2, {0x3E, 0x07}, 0},
+        {0x35, 0, {}, 0},
+        {0x21, 0, {}, 0},
+        {0x11, 0, {}, 120},    // Sleep Out
+        {0x29, 0, {}, 20},     // Display ON
+    };
+};
+
+// ST7789 240x240 (RAM 240x320: la zone visible est décalée de 80 lignes
+// ou colonnes après rotation de 180° ou 270°), ordre RGB
+struct ST7789Panel {
+    static constexpr const char* NAME = "ST7789";
+    static constexpr int WIDTH = 240;
+    static constexpr int HEIGHT = 240;
+    static constexpr bool ROUND = false;
+
+    static constexpr uint8_t CASET = 0x2A;
+    static constexpr uint8_t RASET = 0x2B;
+    static constexpr uint8_t RAMWR = 0x2C;
+    static constexpr uint8_t MADCTL = 0x36;
+    static constexpr uint8_t MADCTL_ROTATION[4] = {0x00, 0x60, 0xC0, 0xA0};
+    static constexpr uint16_t X_OFFSET[4] = {0, 0, 0, 80};
+    static constexpr uint16_t Y_OFFSET[4] = {0, 0, 80, 0};
+
+    static constexpr PanelCommand INIT[] = {
+        {0x01, 0, {}, 150},    // Software Reset
+        {0x11, 0, {}, 120},    // Sleep Out
+        {0x3A, 1, {0x55}, 10}, // 16 bits par pixel
+        {0x36, 1, {0x00}, 0},
+        {0x21, 0, {}, 10},     // Inversion (dalles IPS)
+        {0x13, 0, {}, 10},     // Normal Display
+        {0x29, 0, {}, 20},     // Display ON
+    };
+};
+
+// ILI9341 240x320 rectangulaire, ordre BGR
+struct ILI9341Panel {
+    static constexpr const char* NAME = "ILI9341";
+    static constexpr int WIDTH = 240;
+    static constexpr int HEIGHT = 320;
+    static constexpr bool ROUND = false;
+
+    static constexpr uint8_t CASET = 0x2A;
+    static constexpr uint8_t RASET = 0x2B;
+    static constexpr uint8_t RAMWR = 0x2C;
+    static constexpr uint8_t MADCTL = 0x36;
+    static constexpr uint8_t MADCTL_ROTATION[4] = {0x48, 0x28, 0x88, 0xE8};
+    static constexpr uint16_t X_OFFSET[4] = {0, 0, 0, 0};
+    static constexpr uint16_t Y_OFFSET[4] = {0, 0, 0, 0};
+
+    static constexpr PanelCommand INIT[] = {
+        {0xEF, 3, {0x03, 0x80, 0x02}, 0},
+        {0xCF, 3, {0x00, 0xC1, 0x30}, 0},
+        {0xED, 4, {0x64, 0x03, 0x12, 0x81}, 0},
+        {0xE8, 3, {0x85, 0x00, 0x78}, 0},
+        {0xCB, 5, {0x39, 0x2C, 0x00, 0x34, 0x02}, 0},
+        {0xF7, 1, {0x20}, 0},
+        {0xEA, 2, {0x00, 0x00}, 0},
+        {0xC0, 1, {0x23}, 0},  // Power Control 1
+        {0xC1, 1, {0x10}, 0},  // Power Control 2
+        {0xC5, 2, {0x3E, 0x28}, 0}, // VCOM 1
+        {0xC7, 1, {0x86}, 0},  // VCOM 2
+        {0x36, 1, {0x48}, 0},
+        {0x37, 1, {0x00}, 0},  // Vertical Scroll Start
+        {0x3A, 1, {0x55}, 0},  // 16 bits par pixel
+        {0xB1, 2, {0x00, 0x18}, 0},
+        {0xB6, 3, {0x08, 0x82, 0x27}, 0},
+        {0xF2, 1, {0x00}, 0},  // 3 gamma désactivé
+        {0x26, 1, {0x01}, 0},
+        {0xE0, 15, {0x0F, 0x31, 0x2B, 0x0C, 0x0E, 0x08, 0x4E, 0xF1, 0x37, 0x07, 0x10, 0x03, 0x0E, 0x09, 0x00}, 0},
+        {0xE1, 15, {0x00, 0x0E, 0x14, 0x03, 0x11, 0x07, 0x31, 0xC1, 0x48, 0x08, 0x0F, 0x0C, 0x31, 0x36, 0x0F}, 0},
+        {0x11, 0, {}, 150},    // Sleep Out
+        {0x29, 0, {}, 150},    // Display ON
+    };
+};
@@ -0,0 +1,529 @@
+#pragma once
+
+/*
+ * Raster - Primitives de dessin RGB565, templates sur la surface cible
+ *
+ * Segments, rectangles, cercles, images 1 bit, blocs de pixels, dégradés,
+ * motifs et texte sont écrits une fois pour toute surface: le framebuffer de l'écran
+ * (TFTRenderer) ou un Canvas hors écran. Chaque surface a son instance,
+ * sans appel virtuel ni indirection: dans le framebuffer, une primitive
+ * coûte ce qu'elle coûtait quand elle était écrite dans TFT.cpp.
+ *
+ * Une surface fournit:
+ *   bool clipBox(int x, int y, int w, int h, ClipRect& out) const;
+ *       boîte en coordonnées de dessin, ramenée à la surface et découpée
+ *   uint16_t* surfaceRow(int y);       début de la ligne y de la surface
+ *   int surfaceStride() const;         pixels d'une ligne à la suivante
+ *   int originX() const, originY() const;
+ *       décalage coordonnées de dessin -> surface (scroll de l'écran)
+ *   void setPixel(int x, int y, uint16_t color);  pixel seul, découpé
+ *
+ * Le découpage est fait une fois par primitive (par ligne pour les
+ * remplissages), jamais par pixel, sauf pour un segment ou un cercle
+ * coupé par le bord. Les pixels sont rangés gros-boutiens, comme le
+ * framebuffer envoyé tel quel en SPI.
+ *
+ * Remplissages: deux pixels par écriture de 32 bits (writeSpan); la
+ * couleur d'un dégradé vient d'une table de GRADIENT_STEPS + 1 teintes
+ * indexée en virgule fixe, sans calcul de couleur par pixel.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include "main.h"              // polices (font_mini.h, font_standard.h, arial_S32.h)
+
+/**
+ * @enum FontType
+ * @brief Types de polices disponibles
+ */
+enum class FontType {
+    FONT_MINI,      ///< Police 4x6 pixels - Compacte
+    FONT_STANDARD,  ///< Police 8x12 pixels - Standard
+    ARIAL_32        ///< Police Arial 32 pixels - Haute qualité
+};
+
+// Rectangle en coordonnées surface, x1 et y1 exclus
+struct ClipRect {
+    int x0, y0, x1, y1;
+};
+
+namespace Raster_Config {
+    static constexpr int GRADIENT_STEPS = 64;          // teintes d'un dégradé (vert: 64 niveaux)
+}
+
+namespace Raster {
+
+inline uint16_t to_be(uint16_t color) { return (uint16_t)((color >> 8) | (color << 8)); }
+
+// ===== ÉCRITURE PAR PAIRES =====
+// Deux pixels par mot de 32 bits (petit-boutien: pixel de gauche dans la
+// moitié basse). may_alias: le mot recouvre des uint16_t.
+typedef uint32_t __attribute__((__may_alias__)) PixelPair;
+
+// count pixels, next() donnant la couleur (gros-boutienne) de chacun
+template <class Next>
+inline void writeSpan(uint16_t* dst, int count, Next next) {
+    if (count <= 0) return;
+    if (reinterpret_cast<uintptr_t>(dst) & 2) {
+        *dst++ = next();
+        count--;
+    }
+    PixelPair* pairs = reinterpret_cast<PixelPair*>(dst);
+    for (int i = count >> 1; i > 0; i--) {
+        const uint32_t left = next();
+        *pairs++ = left | ((uint32_t)next() << 16);
+    }
+    if (count & 1) *reinterpret_cast<uint16_t*>(pairs) = next();
+}
+
+inline void fillSpan(uint16_t* dst, int count, uint16_t be_color) {
+    if (count <= 0) return;
+    if (reinterpret_cast<uintptr_t>(dst) & 2) {
+        *dst++ = be_color;
+        count--;
+    }
+    PixelPair* pairs = reinterpret_cast<PixelPair*>(dst);
+    const uint32_t pair = be_color | ((uint32_t)be_color << 16);
+    for (int i = count >> 1; i > 0; i--) *pairs++ = pair;
+    if (count & 1) *reinterpret_cast<uint16_t*>(pairs) = be_color;
+}
+
+// ===== POLICES =====
+inline const arial_S32_CharInfo& arial_info(char c) { return arial_S32_Info[(uint8_t)c]; }
+
+// Bitmap d'un caractère (une ligne par octet, sauf Arial32: bits contigus)
+inline const uint8_t* glyph(FontType font, char c) {
+    const uint8_t code = (uint8_t)c;
+    switch (font) {
+        case FontType::FONT_STANDARD: return &ufont_1[code * 12];
+        case FontType::ARIAL_32:      return &arial_S32_Bitmaps[arial_info(c).offset];
+        default:                      return &font_mini_4x6[code * 6];
+    }
+}
+
+inline int font_width(FontType font) {
+    switch (font) {
+        case FontType::FONT_STANDARD: return 8;
+        case FontType::ARIAL_32:      return arial_info(' ').w;
+        default:                      return 4;
+    }
+}
+
+inline int font_height(FontType font) {
+    switch (font) {
+        case FontType::FONT_STANDARD: return 12;
+        case FontType::ARIAL_32:      return arial_info('A').h;
+        default:                      return 6;
+    }
+}
+
+inline int char_width(FontType font, char c) {
+    return (font == FontType::ARIAL_32) ? arial_info(c).w : font_width(font);
+}
+
+// Largeur d'un texte, un pixel entre deux caractères
+inline int text_width(FontType font, const char* text) {
+    int total = 0;
+    for (int i = 0; text[i] != '\0'; i++) {
+        total += char_width(font, text[i]);
+        if (text[i + 1] != '\0') total += 1;
+    }
+    return total;
+}
+
+// ===== REMPLISSAGES =====
+template <class Surface>
+void fillRect(Surface& s, int x, int y, int w, int h, uint16_t color) {
+    ClipRect box;
+    if (!s.clipBox(x, y, w, h, box)) return;
+    const uint16_t be_color = to_be(color);
+    const int span = box.x1 - box.x0;
+    const int stride = s.surfaceStride();
+    uint16_t* dst = s.surfaceRow(box.y0) + box.x0;
+    for (int py = box.y0; py < box.y1; py++, dst += stride) fillSpan(dst, span, be_color);
+}
+
+template <class Surface>
+void drawLine(Surface& s, int x0, int y0, int x1, int y1, uint16_t color) {
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    // Horizontale ou verticale: un seul segment découpé
+    if (dy == 0) {
+        fillRect(s, (x0 < x1) ? x0 : x1, y0, dx + 1, 1, color);
+        return;
+    }
+    if (dx == 0) {
+        fillRect(s, x0, (y0 < y1) ? y0 : y1, 1, dy + 1, color);
+        return;
+    }
+
+    // Boîte englobante découpée une fois: entièrement visible, les pixels
+    // sont écrits sans test; sinon test par pixel (ligne coupée par le bord)
+    ClipRect box;
+    if (!s.clipBox((x0 < x1) ? x0 : x1, (y0 < y1) ? y0 : y1, dx + 1, dy + 1, box)) return;
+    const bool inside = (box.x1 - box.x0 == dx + 1) && (box.y1 - box.y0 == dy + 1);
+    const uint16_t be_color = to_be(color);
+    const int ox = s.originX();
+    const int oy = s.originY();
+
+    int sx = (x0 < x1) ? 1 : -1;
+    int sy = (y0 < y1) ? 1 : -1;
+    int err = dx - dy;
+    int x = x0, y = y0;
+
+    while (true) {
+        if (inside) s.surfaceRow(y - oy)[x - ox] = be_color;
+        else s.setPixel(x, y, color);
+        if (x == x1 && y == y1) break;
+
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+template <class Surface>
+void drawRect(Surface& s, int x, int y, int w, int h, uint16_t color) {
+    if (w <= 0 || h <= 0) return;
+    fillRect(s, x, y, w, 1, color);
+    if (h > 1) fillRect(s, x, y + h - 1, w, 1, color);
+    if (h > 2) {
+        fillRect(s, x, y + 1, 1, h - 2, color);
+        if (w > 1) fillRect(s, x + w - 1, y + 1, 1, h - 2, color);
+    }
+}
+
+// ===== CERCLES =====
+template <class Surface>
+void drawCircle(Surface& s, int xc, int yc, int r, uint16_t color) {
+    // Cercle entièrement visible: pixels écrits sans test
+    ClipRect box;
+    if (r < 0 || !s.clipBox(xc - r, yc - r, 2 * r + 1, 2 * r + 1, box)) return;
+    const bool inside = (box.x1 - box.x0 == 2 * r + 1) && (box.y1 - box.y0 == 2 * r + 1);
+    const uint16_t be_color = to_be(color);
+    const int ox = s.originX();
+    const int oy = s.originY();
+    auto plot = [&](int px, int py) {
+        if (inside) s.surfaceRow(py - oy)[px - ox] = be_color;
+        else s.setPixel(px, py, color);
+    };
+
+    int x = 0;
+    int y = r;
+    int d = 3 - 2 * r;
+
+    while (y >= x) {
+        plot(xc + x, yc + y);
+        plot(xc - x, yc + y);
+        plot(xc + x, yc - y);
+        plot(xc - x, yc - y);
+        plot(xc + y, yc + x);
+        plot(xc - y, yc + x);
+        plot(xc + y, yc - x);
+        plot(xc - y, yc - x);
+
+        x++;
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+}
+
+template <class Surface>
+void drawFillCircle(Surface& s, int xc, int yc, int r, uint16_t color) {
+    int x = 0;
+    int y = r;
+    int d = 3 - 2 * r;
+
+    while (y >= x) {
+        fillRect(s, xc - x, yc + y, 2 * x + 1, 1, color);
+        fillRect(s, xc - x, yc - y, 2 * x + 1, 1, color);
+        fillRect(s, xc - y, yc + x, 2 * y + 1, 1, color);
+        fillRect(s, xc - y, yc - x, 2 * y + 1, 1, color);
+        x++;
+
+        if (d > 0) {
+            y--;
+            d = d + 4 * (x - y) + 10;
+        } else {
+            d = d + 4 * x + 6;
+        }
+    }
+}
+
+// Disque plein (x² + y² <= r²), une ligne par rangée
+template <class Surface>
+void drawSmallCircle(Surface& s, int xc, int yc, int r, uint16_t color) {
+    ClipRect box;
+    if (!s.clipBox(xc - r, yc - r, 2 * r + 1, 2 * r + 1, box)) return;
+    const uint16_t be_color = to_be(color);
+    xc -= s.originX();
+    yc -= s.originY();
+
+    // Demi-largeur = plus grand h tel que h² + dy² <= r², suivie d'une
+    // rangée à l'autre sans racine carrée
+    int half = 0;
+    for (int py = box.y0; py < box.y1; ++py) {
+        int dy = py - yc;
+        int room = r * r - dy * dy;
+        while (half > 0 && half * half > room) --half;
+        while ((half + 1) * (half + 1) <= room) ++half;
+        int x0 = (xc - half > box.x0) ? xc - half : box.x0;
+        int x1 = (xc + half < box.x1 - 1) ? xc + half : box.x1 - 1;
+        uint16_t* dst = s.surfaceRow(py);
+        for (int px = x0; px <= x1; ++px) dst[px] = be_color;
+    }
+}
+
+// ===== IMAGES =====
+// Image 1 bit: lignes de (w + 7) / 8 octets, bit de poids fort à gauche
+template <class Surface>
+void drawBitmap(Surface& s, int x, int y, int w, int h, const uint8_t* bits, uint16_t color) {
+    ClipRect box;
+    if (!bits || !s.clipBox(x, y, w, h, box)) return;
+    const uint16_t be_color = to_be(color);
+    const int stride = (w + 7) / 8;
+    const int origin_x = x - s.originX();
+    const int origin_y = y - s.originY();
+    for (int py = box.y0; py < box.y1; py++) {
+        const uint8_t* line = bits + (py - origin_y) * stride;
+        uint16_t* dst = s.surfaceRow(py);
+        for (int px = box.x0; px < box.x1; px++) {
+            const int col = px - origin_x;
+            if (line[col >> 3] & (0x80 >> (col & 7))) dst[px] = be_color;
+        }
+    }
+}
+
+// Bloc w x h de pixels gros-boutiens
+template <class Surface>
+void blitRGB565(Surface& s, int x, int y, int w, int h, const uint16_t* pixels) {
+    ClipRect box;
+    if (!pixels || !s.clipBox(x, y, w, h, box)) return;
+    const int origin_x = x - s.originX();
+    const int origin_y = y - s.originY();
+    const size_t bytes = (size_t)(box.x1 - box.x0) * 2;
+    for (int py = box.y0; py < box.y1; py++) {
+        memcpy(s.surfaceRow(py) + box.x0, &pixels[(py - origin_y) * w + (box.x0 - origin_x)], bytes);
+    }
+}
+
+// Même chose, les pixels de couleur transparent (RGB565) ne sont pas copiés
+template <class Surface>
+void blitRGB565(Surface& s, int x, int y, int w, int h, const uint16_t* pixels, uint16_t transparent) {
+    ClipRect box;
+    if (!pixels || !s.clipBox(x, y, w, h, box)) return;
+    const uint16_t be_key = to_be(transparent);
+    const int origin_x = x - s.originX();
+    const int origin_y = y - s.originY();
+    const int count = box.x1 - box.x0;
+    for (int py = box.y0; py < box.y1; py++) {
+        // Depuis la première colonne visible: les deux pointeurs restent dans leur tableau
+        const uint16_t* src = &pixels[(py - origin_y) * w + (box.x0 - origin_x)];
+        uint16_t* dst = s.surfaceRow(py) + box.x0;
+        for (int i = 0; i < count; i++) {
+            if (src[i] != be_key) dst[i] = src[i];
+        }
+    }
+}
+
+// ===== DÉGRADÉS ET MOTIFS =====
+// Teintes de color0 (indice 0) à color1 (indice GRADIENT_STEPS), canaux
+// RGB565 avancés en virgule fixe 16.16, arrondis; rangées gros-boutiennes
+inline void buildRamp(uint16_t* ramp, uint16_t color0, uint16_t color1) {
+    const int steps = Raster_Config::GRADIENT_STEPS;
+    int32_t r = (int32_t)(color0 >> 11) << 16;
+    int32_t g = (int32_t)((color0 >> 5) & 0x3F) << 16;
+    int32_t b = (int32_t)(color0 & 0x1F) << 16;
+    const int32_t dr = (((int32_t)(color1 >> 11) << 16) - r) / steps;
+    const int32_t dg = (((int32_t)((color1 >> 5) & 0x3F) << 16) - g) / steps;
+    const int32_t db = (((int32_t)(color1 & 0x1F) << 16) - b) / steps;
+    for (int i = 0; i < steps; i++, r += dr, g += dg, b += db) {
+        ramp[i] = to_be((uint16_t)((((r + 0x8000) >> 16) << 11) | (((g + 0x8000) >> 16) << 5) | ((b + 0x8000) >> 16)));
+    }
+    ramp[steps] = to_be(color1);
+}
+
+// Rectangle rempli d'un dégradé le long de l'axe (x0, y0) -> (x1, y1):
+// color0 avant le premier point, color1 après le second. Position sur
+// l'axe suivie en virgule fixe, une addition par pixel; un axe vertical
+// donne des lignes d'une seule couleur.
+template <class Surface>
+void fillLinearGradient(Surface& s, int x, int y, int w, int h,
+                        int x0, int y0, uint16_t color0, int x1, int y1, uint16_t color1) {
+    ClipRect box;
+    if (!s.clipBox(x, y, w, h, box)) return;
+    const int steps = Raster_Config::GRADIENT_STEPS;
+    const int64_t ax = x1 - x0;
+    const int64_t ay = y1 - y0;
+    const int64_t length2 = ax * ax + ay * ay;
+    if (length2 == 0) {
+        fillRect(s, x, y, w, h, color1);
+        return;
+    }
+    uint16_t ramp[steps + 1];
+    buildRamp(ramp, color0, color1);
+
+    // Indice de teinte en 16.16: projection sur l'axe * steps / longueur²
+    const int64_t scale = (int64_t)steps << 16;
+    const int32_t step_x = (int32_t)((ax * scale + length2 / 2) / length2);
+    const int32_t step_y = (int32_t)((ay * scale + length2 / 2) / length2);
+    const int64_t px0 = box.x0 + s.originX() - x0;
+    const int64_t py0 = box.y0 + s.originY() - y0;
+    int64_t row_start = ((px0 * ax + py0 * ay) * scale) / length2 + 0x8000;   // arrondi compris
+    const int64_t last = (int64_t)steps << 16;
+    const int span = box.x1 - box.x0;
+    const int stride = s.surfaceStride();
+    uint16_t* dst = s.surfaceRow(box.y0) + box.x0;
+
+    for (int py = box.y0; py < box.y1; py++, dst += stride, row_start += step_y) {
+        const int64_t end = row_start + (int64_t)step_x * (span - 1);
+        if (step_x == 0) {
+            fillSpan(dst, span, ramp[(row_start < 0) ? 0 : (row_start >= last) ? steps : (int)(row_start >> 16)]);
+        } else if (row_start >= 0 && row_start < last + 0x10000 && end >= 0 && end < last + 0x10000) {
+            // Ligne entière dans le dégradé: ni borne à tester, ni débordement
+            int32_t t = (int32_t)row_start;
+            writeSpan(dst, span, [&]() { const uint16_t c = ramp[t >> 16]; t += step_x; return c; });
+        } else {
+            int64_t t = row_start;
+            writeSpan(dst, span, [&]() {
+                const uint16_t c = ramp[(t < 0) ? 0 : (t >= last) ? steps : (int)(t >> 16)];
+                t += step_x;
+                return c;
+            });
+        }
+    }
+}
+
+// Rectangle rempli d'un dégradé circulaire: inner au centre (xc, yc), outer
+// à partir du rayon r. Sans racine carrée: d² avance d'une addition par
+// pixel et l'indice de teinte suit les seuils de d² précalculés.
+template <class Surface>
+void fillRadialGradient(Surface& s, int x, int y, int w, int h,
+                        int xc, int yc, int r, uint16_t inner, uint16_t outer) {
+    ClipRect box;
+    if (!s.clipBox(x, y, w, h, box)) return;
+    const int steps = Raster_Config::GRADIENT_STEPS;
+    if (r <= 0) {
+        fillRect(s, x, y, w, h, outer);
+        return;
+    }
+    uint16_t ramp[steps + 1];
+    buildRamp(ramp, inner, outer);
+
+    // Indice k = round(steps * d / r): k > j dès que d² >= ((2j + 1) r)² / (4 steps²)
+    uint32_t limit[steps];
+    for (int j = 0; j < steps; j++) {
+        const uint64_t edge = (uint64_t)(2 * j + 1) * (uint64_t)r;
+        const uint64_t div = 4ull * steps * steps;
+        const uint64_t t = (edge * edge + div - 1) / div;
+        limit[j] = (t > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)t;
+    }
+
+    const int dx0 = box.x0 + s.originX() - xc;
+    const int span = box.x1 - box.x0;
+    const int stride = s.surfaceStride();
+    uint16_t* dst = s.surfaceRow(box.y0) + box.x0;
+    int k = 0;
+
+    for (int py = box.y0; py < box.y1; py++, dst += stride) {
+        const int dy = py + s.originY() - yc;
+        uint32_t d2 = (uint32_t)(dx0 * dx0) + (uint32_t)(dy * dy);
+        int dx = dx0;
+        writeSpan(dst, span, [&]() {
+            while (k < steps && d2 >= limit[k]) k++;
+            while (k > 0 && d2 < limit[k - 1]) k--;
+            const uint16_t c = ramp[k];
+            d2 += (uint32_t)(2 * dx + 1);               // (dx + 1)² - dx²
+            dx++;
+            return c;
+        });
+    }
+}
+
+// Rectangle rempli d'un motif 8x8 répété (un octet par ligne, bit de poids
+// fort à gauche): fg pour les bits à 1, bg pour les 0. Calé sur l'origine
+// des coordonnées, deux zones voisines se raccordent.
+template <class Surface>
+void fillPattern(Surface& s, int x, int y, int w, int h, const uint8_t* pattern, uint16_t fg, uint16_t bg) {
+    ClipRect box;
+    if (!pattern || !s.clipBox(x, y, w, h, box)) return;
+    const uint16_t be_fg = to_be(fg);
+    const uint16_t be_bg = to_be(bg);
+    const int col0 = (box.x0 + s.originX()) & 7;
+    const int span = box.x1 - box.x0;
+    const int stride = s.surfaceStride();
+    uint16_t* dst = s.surfaceRow(box.y0) + box.x0;
+
+    for (int py = box.y0; py < box.y1; py++, dst += stride) {
+        const uint8_t bits = pattern[(py + s.originY()) & 7];
+        if (bits == 0x00 || bits == 0xFF) {
+            fillSpan(dst, span, bits ? be_fg : be_bg);
+            continue;
+        }
+        uint16_t row[8];
+        for (int i = 0; i < 8; i++) row[i] = (bits & (0x80 >> i)) ? be_fg : be_bg;
+        int col = col0;
+        writeSpan(dst, span, [&]() { const uint16_t c = row[col]; col = (col + 1) & 7; return c; });
+    }
+}
+
+// ===== TEXTE =====
+template <class Surface>
+void drawChar(Surface& s, FontType font, int x, int y, char c, uint16_t color) {
+    if (font != FontType::ARIAL_32) {
+        // Un octet par ligne, bit de poids fort à gauche
+        drawBitmap(s, x, y, font_width(font), font_height(font), glyph(font, c), color);
+        return;
+    }
+
+    // Arial32: bits contigus (pas d'alignement par ligne), seule la partie
+    // visible est lue
+    const arial_S32_CharInfo& info = arial_info(c);
+    const uint8_t* bitmap = &arial_S32_Bitmaps[info.offset];
+    const int char_width = info.w;
+    ClipRect box;
+    if (!s.clipBox(x, y, char_width, info.h, box)) return;
+    const uint16_t be_color = to_be(color);
+    const int origin_x = x - s.originX();
+    const int origin_y = y - s.originY();
+
+    for (int py = box.y0; py < box.y1; py++) {
+        uint16_t* dst = s.surfaceRow(py);
+        int bit_index = (py - origin_y) * char_width + (box.x0 - origin_x);
+        for (int px = box.x0; px < box.x1; px++, bit_index++) {
+            if (bitmap[bit_index >> 3] & (0x80 >> (bit_index & 7))) dst[px] = be_color;
+        }
+    }
+}
+
+// Un pixel entre deux caractères
+template <class Surface>
+void drawText(Surface& s, FontType font, int x, int y, const char* text, uint16_t color) {
+    // Bande du texte découpée une fois: hors zone en hauteur, rien à faire;
+    // au-delà du bord droit, la suite est ignorée. En Arial32 la hauteur
+    // varie d'un caractère à l'autre: seul le bas de la zone compte.
+    const int band_height = (font == FontType::ARIAL_32) ? 0x4000 : font_height(font);
+    ClipRect band;
+    if (!s.clipBox(x, y, 0x7FFF, band_height, band)) return;
+    const int right = band.x1 + s.originX();
+    int char_x = x;
+
+    for (int i = 0; text[i] != '\0'; i++) {
+        if (char_x >= right) break;
+        drawChar(s, font, char_x, y, text[i], color);
+        char_x += char_width(font, text[i]) + 1;
+    }
+}
+
+} // namespace Raster
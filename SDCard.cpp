@@ -210,6 +210,7 @@ bool SDCard::write_block(uint32_t block_num, const uint8_t* buffer) {
     // Adresse selon le type de carte
     uint32_t address = (card_type == CARD_TYPE_SDHC) ? block_num : block_num * SDCardConfig::BLOCK_SIZE;
     
+    // CMD24 attend la fin de l'écriture précédente (send_command_core)
     uint8_t r1 = send_command_keep_cs(CMD24, address);
     if (r1 != 0x00) {
         last_status = SD_WRITE_COMMAND_FAILS;
@@ -229,28 +230,47 @@ bool SDCard::write_block(uint32_t block_num, const uint8_t* buffer) {
         last_status = SD_WRITE_DATA_FAILS;
         return false;
     }
-    // Attendre fin du busy
+    // La carte programme le bloc: libérer le bus sans attendre la fin du busy
+    spi_cs_deselect();
+    write_pending_ = true;
+    last_status = SD_OK;
+    return true;
+}
+
+// Fin d'une écriture différée: attente du busy puis vérification du status (CMD13)
+bool SDCard::finish_pending_write() {
+    if (!write_pending_) return true;
+    write_pending_ = false;   // avant CMD13: send_command_core ne doit pas y revenir
+
+    spi_cs_select();
     if (!wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS)) {
         spi_cs_deselect();
         last_status = SD_WRITE_TIMEOUT_BUSY;
+        write_error_ = true;
         return false;
     }
     spi_cs_deselect();
     // Vérifier le status avec CMD13 (R2)
     spi_write_read(0xFF);
-    spi_cs_select();
-    r1 = send_command_keep_cs(CMD13, 0);
+    uint8_t r1 = send_command_keep_cs(CMD13, 0);
     uint8_t r2 = spi_write_read(0xFF);
     spi_cs_deselect();
     spi_write_read(0xFF);
     if (r1 != 0x00 || r2 != 0x00) {
         last_status = SD_WRITE_STATUS_ERROR;
+        write_error_ = true;
         return false;
     }
-    last_status = SD_OK;
     return true;
 }
 
+bool SDCard::sync() {
+    finish_pending_write();
+    bool ok = !write_error_;
+    write_error_ = false;
+    return ok;
+}
+
 const char* SDCard::get_error_message(SDCard_Status status) {
     if (status >= 0 && status < sizeof(SD_ERROR_MESSAGES)/sizeof(SD_ERROR_MESSAGES[0])) {
         return SD_ERROR_MESSAGES[status];
@@ -391,6 +411,12 @@ uint8_t SDCard::send_command_r3(uint8_t cmd, uint32_t arg, uint8_t out[4]) {
 }
 
 uint8_t SDCard::send_command_core(uint8_t cmd, uint32_t arg, uint8_t* out, size_t out_len, bool keep_cs) {
+    // Toute commande commence par terminer l'écriture différée précédente
+    if (write_pending_) {
+        if (!finish_pending_write()) {
+            printf("SD  Écriture différée en échec (%s)\n", get_error_message(last_status));
+        }
+    }
     spi_cs_select();
     if (cmd != CMD0) {
         if (!wait_ready()) {
@@ -489,8 +515,56 @@ bool SDCard::read_start(uint32_t block) {
 
 bool SDCard::read_stop() {
     // Send CMD12 to stop transmission
-    uint8_t r1 = send_command(CMD12, 0);
-    (void)r1; // ignore errors for now
+    return stop_transmission();
+}
+
+bool SDCard::stop_transmission() {
+    // CS reste actif: send_command_core attendrait un 0xFF que la carte n'émet
+    // pas tant qu'elle transmet le bloc suivant. Le CMD12 est envoyé tel quel.
+    const uint8_t command[6] = {(uint8_t)(0x40 | CMD12), 0, 0, 0, 0, 0x01};
+    spi_write_blocking(command, 6);
+    spi_write_read(0xFF);   // octet de bourrage après CMD12
+    uint8_t r1 = 0xFF;
+    for (int i = 0; i < 20; i++) {
+        r1 = spi_write_read(0xFF);
+        if (!(r1 & 0x80)) break;
+    }
+    bool ok = wait_not_busy(SDCardConfig::READ_TIMEOUT_MS);
+    spi_cs_deselect();
+    spi_write_read(0xFF);
+    return ok && r1 == 0x00;
+}
+
+bool SDCard::read_blocks(uint32_t block, uint32_t count, uint8_t* buffer) {
+    if (count == 0) return true;
+    if (count == 1) return read_block(block, buffer);
+    if (!initialized) {
+        last_status = SD_INIT_FAILS;
+        return false;
+    }
+    uint32_t address = (card_type == CARD_TYPE_SDHC) ? block : block * SDCardConfig::BLOCK_SIZE;
+    uint8_t r1 = send_command_keep_cs(CMD18, address);
+    if (r1 != 0x00) {
+        last_status = SD_READ_COMMAND_FAILS;
+        spi_cs_deselect();
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t token = 0xFF;
+        if (!wait_start_token(DATA_TOKEN, SDCardConfig::READ_TIMEOUT_MS, token)) {
+            last_status = (token == 0xFF) ? SD_READ_TIMEOUT_TOKEN : SD_READ_BAD_TOKEN;
+            stop_transmission();
+            return false;
+        }
+        spi_read_blocking(buffer + i * SDCardConfig::BLOCK_SIZE, SDCardConfig::BLOCK_SIZE);
+        spi_write_read(0xFF);   // CRC
+        spi_write_read(0xFF);
+    }
+    if (!stop_transmission()) {
+        last_status = SD_READ_COMMAND_FAILS;
+        return false;
+    }
+    last_status = SD_OK;
     return true;
 }
 
@@ -516,16 +590,42 @@ bool SDCard::write_data(const uint8_t* src) {
     spi_write_read(0xFF); // CRC
     spi_write_read(0xFF);
     uint8_t resp = spi_write_read(0xFF);
-    if ((resp & 0x1F) != 0x05) { spi_cs_deselect(); return false; }
-    if (!wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS)) { spi_cs_deselect(); return false; }
+    if ((resp & 0x1F) != 0x05) {
+        last_status = SD_WRITE_DATA_FAILS;
+        write_abort();
+        return false;
+    }
+    if (!wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS)) {
+        last_status = SD_WRITE_TIMEOUT_BUSY;
+        write_abort();
+        return false;
+    }
     return true;
 }
 
+// La carte reste en réception CMD25 tant qu'elle n'a pas reçu le jeton Stop
+// Tran: sans lui la commande suivante serait lue comme un bloc de données
+void SDCard::write_abort() {
+    (void)wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS);
+    spi_write_read(STOP_TRAN_TOKEN);
+    spi_write_read(0xFF);
+    (void)wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS);
+    spi_cs_deselect();
+    spi_write_read(0xFF);
+    // CMD13 lit et efface le status d'erreur de la carte
+    (void)send_command_keep_cs(CMD13, 0);
+    spi_write_read(0xFF);
+    spi_cs_deselect();
+    spi_write_read(0xFF);
+}
+
 bool SDCard::write_stop() {
-    if (!wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS)) return false;
+    if (!wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS)) { spi_cs_deselect(); return false; }
     spi_write_read(STOP_TRAN_TOKEN);
-    if (!wait_not_busy(SDCardConfig::WRITE_TIMEOUT_MS)) return false;
+    spi_write_read(0xFF);   // un octet avant le début du busy
+    // Fin de programmation différée, comme pour write_block
     spi_cs_deselect();
+    write_pending_ = true;
     return true;
 }
 
@@ -566,11 +666,20 @@ bool SDCard::erase_single_block_enable() {
     // Not all cards expose this cleanly; attempt read CSD and check ERASE_BLK_EN bit
     uint8_t csd[16];
     if (!read_register(CMD9, csd)) return false;
-    // ERASE_BLK_EN is bit 46 in CSD v1; for simplicity, assume supported if bit set in csd[10] bit 0
-    bool enable = (csd[10] & 0x01) != 0;
+    // ERASE_BLK_EN is CSD bit 46 (same position in CSD v1 and v2): csd[10] bit 6
+    bool enable = (csd[10] & 0x40) != 0;
     return enable;
 }
 
+uint32_t SDCard::erase_sector_blocks() {
+    uint8_t csd[16];
+    if (!read_register(CMD9, csd)) return 0;
+    // SECTOR_SIZE: CSD bits 45..39 (taille d'un secteur d'effacement - 1, en blocs d'écriture).
+    // Fixé à 0x7F (64 Ko) sur les cartes SDHC/SDXC (CSD v2).
+    uint8_t sector_size = (uint8_t)(((csd[10] & 0x3F) << 1) | (csd[11] >> 7));
+    return (uint32_t)sector_size + 1;
+}
+
 bool SDCard::erase(uint32_t firstBlock, uint32_t lastBlock) {
     // Use byte addressing for SDSC
     if (card_type != CARD_TYPE_SDHC) {
@@ -585,7 +694,45 @@ bool SDCard::erase(uint32_t firstBlock, uint32_t lastBlock) {
     return true;
 }
 
+bool SDCard::read_sd_status(uint8_t out[64]) {
+    if (!initialized) return false;
+    uint8_t r1 = send_command(CMD55, 0);
+    if (r1 > 1) return false;
+    // ACMD13: réponse R2 (R1 + un octet de status) suivie d'un bloc de 64 octets
+    r1 = send_command_keep_cs(ACMD13, 0);
+    spi_write_read(0xFF);
+    if (r1 != 0x00) { spi_cs_deselect(); return false; }
+    uint8_t token;
+    if (!wait_start_token(DATA_TOKEN, SDCardConfig::READ_TIMEOUT_MS, token)) { spi_cs_deselect(); return false; }
+    for (uint16_t i = 0; i < 64; i++) { out[i] = spi_write_read(0xFF); }
+    spi_write_read(0xFF); spi_write_read(0xFF); // CRC
+    spi_cs_deselect();
+    spi_write_read(0xFF);
+    return true;
+}
+
+bool SDCard::allocation_unit_info(uint32_t& au_blocks, uint8_t& speed_class) {
+    uint8_t status[64];
+    if (!read_sd_status(status)) return false;
+    // SPEED_CLASS: bits 447..440 (octet 8), AU_SIZE: bits 431..428 (quartet haut de l'octet 10)
+    static const uint8_t classes[5] = {0, 2, 4, 6, 10};
+    speed_class = (status[8] < 5) ? classes[status[8]] : 0;
+    // AU_SIZE 1..9: 16 Ko << (n - 1); 0xA..0xF: 8, 12, 16, 24, 32, 64 Mo (0 = non défini)
+    static const uint16_t large_au_mb[6] = {8, 12, 16, 24, 32, 64};
+    uint8_t au_size = status[10] >> 4;
+    if (au_size == 0) {
+        au_blocks = 0;
+    } else if (au_size <= 9) {
+        au_blocks = 32u << (au_size - 1);
+    } else {
+        au_blocks = (uint32_t)large_au_mb[au_size - 10] * 2048u;
+    }
+    return true;
+}
+
 uint8_t SDCard::is_busy() {
+    // Sans écriture en cours, inutile d'occuper le bus partagé avec le TFT
+    if (!write_pending_) return 0;
     spi_cs_select();
     uint8_t b = spi_write_read(0xFF);
     spi_cs_deselect();
@@ -96,6 +96,7 @@ private:
     static constexpr uint8_t CMD38 = 38;
     static constexpr uint8_t CMD55 = 55;
     static constexpr uint8_t CMD58 = 58;
+    static constexpr uint8_t ACMD13 = 13;
     static constexpr uint8_t ACMD23 = 23;
     static constexpr uint8_t ACMD41 = 41;
 
@@ -129,7 +130,17 @@ private:
     bool wait_not_busy(uint32_t timeout_ms);
     bool wait_start_token(uint8_t expected_token, uint32_t timeout_ms, uint8_t &token_out);
     bool read_card_ocr(uint32_t &ocr);
+    // CMD12 pendant un transfert multi-blocs (CS déjà actif, la carte émet des données)
+    bool stop_transmission();
+    // Bloc refusé pendant un CMD25: jeton Stop Tran puis CMD13 (efface l'erreur)
+    void write_abort();
     
+    // Écriture différée: write_block rend la main après le jeton de réponse,
+    // l'attente de fin de programmation (busy) + CMD13 a lieu à la commande suivante
+    bool write_pending_ = false;
+    bool write_error_ = false;
+    bool finish_pending_write();
+
     // Partial read state
     bool in_block_ = false;
     uint32_t block_ = 0;
@@ -155,11 +166,18 @@ public:
     
     // Méthodes de base pour les blocs
     bool read_block(uint32_t block_num, uint8_t* buffer);
+    // Retourne dès que la carte a accepté les données: la programmation se poursuit
+    // en arrière-plan (voir is_busy). Une erreur de programmation est signalée par
+    // la commande suivante (last_status) et par sync().
     bool write_block(uint32_t block_num, const uint8_t* buffer);
+    // Attend la fin de l'écriture en cours; false si une écriture différée a échoué
+    bool sync();
     // Partial/slice read helpers
     bool read_data(uint32_t block, uint16_t offset, uint16_t count, uint8_t* dst);
     void read_end();
     void partial_block_read(uint8_t value) { read_end(); partial_block_read_ = (value != 0); }
+    // Lecture de 'count' blocs consécutifs en une commande (CMD18 + CMD12)
+    bool read_blocks(uint32_t block, uint32_t count, uint8_t* buffer);
     // Multi-block read/write
     bool read_start(uint32_t block);
     bool read_stop();
@@ -170,7 +188,17 @@ public:
     bool read_register(uint8_t cmd, void* buf16);
     uint32_t card_size();
     bool erase_single_block_enable();
+    // Granularité d'effacement (champ SECTOR_SIZE du CSD), en blocs de 512 octets. 0 si illisible.
+    uint32_t erase_sector_blocks();
     bool erase(uint32_t firstBlock, uint32_t lastBlock);
+    // Registre SD Status (ACMD13, 64 octets)
+    bool read_sd_status(uint8_t out[64]);
+    // Unité d'allocation (AU_SIZE, en blocs de 512 octets) et classe de vitesse
+    // (0, 2, 4, 6 ou 10) lues dans le SD Status. false si le registre est illisible.
+    bool allocation_unit_info(uint32_t& au_blocks, uint8_t& speed_class);
+    // Vrai tant que la carte programme la dernière écriture (le bus reste libre entre-temps).
+    // Un octet lu, sans commande ni attente: la boucle de main() s'en sert pour
+    // remettre flush/process_discards au tour suivant plutôt que de bloquer
     uint8_t is_busy();
     bool test_basic_read();
     
@@ -39,15 +39,16 @@ void ScrollableArea::draw(TFT& tft) {
     int first_line = scroll_position / line_height;
     int visible_lines = height / line_height;
     
-    for (int i = 0; i < visible_lines && (first_line + i) < (int)lines.size(); i++) {
+    // Lignes coupées par le bord comprises: le découpage les arrête au cadre
+    const bool clipped = tft.pushClip(x + 1, y + 1, width - 2, height - 2);
+    for (int i = 0; i <= visible_lines && (first_line + i) < (int)lines.size(); i++) {
         int line_index = first_line + i;
         int text_y = y + 2 + (i * line_height) - (scroll_position % line_height);
         
-        if (text_y >= y && text_y < y + height - line_height) {
-            tft.drawText(x + 2, text_y, lines[line_index].c_str(), 
-                        COLOR_16BITS_WHITE);
-        }
+        tft.drawText(x + 2, text_y, lines[line_index].c_str(), 
+                    COLOR_16BITS_WHITE);
     }
+    if (clipped) tft.popClip();
     
     // Barre de scroll (optionnel)
     drawScrollbar(tft);
@@ -2,8 +2,11 @@
 #include "Color.h"
 #include <vector>
 #include <string>
+#include "main.h"
 
-class TFT;
+// Forward declaration (TFT.h)
+template <class Panel> class TFTRenderer;
+using TFT = TFTRenderer<TFTConfig::Panel>;
 
 class ScrollableArea {
 public:
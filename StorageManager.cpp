@@ -1,6 +1,9 @@
 #include "StorageManager.h"
 #include "FAT32.h"
 #include "SDCard.h"
+#include "BufferedWriter.h"
+#include "GzipReader.h"
+#include "LineReader.h"
 #include <cstdio>
 #include <cstring>
 #include "lib_bmp.h"
@@ -70,6 +73,18 @@ bool StorageManager::mount_fat32() {
     if (fat32_fs->init()) {
         printf("Système FAT32 initialisé avec succès\n");
         fat32_mounted = true;
+        // Effacement différé des clusters libérés, à la granularité du CSD
+        if (!fat32_fs->is_exfat()) {
+            fat32_fs->set_discard(sd_card->erase_sector_blocks());
+            // Placement des gros fichiers sur les unités d'allocation de la carte
+            uint32_t au_blocks = 0;
+            uint8_t speed_class = 0;
+            if (sd_card->allocation_unit_info(au_blocks, speed_class)) {
+                printf("Carte SD: classe %u, unité d'allocation %lu Ko\n",
+                       (unsigned)speed_class, (unsigned long)(au_blocks / 2));
+                fat32_fs->set_allocation_unit(au_blocks);
+            }
+        }
         return true;
     }
     
@@ -105,27 +120,24 @@ SDCard_Status StorageManager::read_text_file(const char* filename) {
     current_command = SD_FILE_READING;
     printf("=== Lecture fichier avec FAT32 : %s ===\n", filename);
     
-    FAT_ErrorCode fat_result = fat32_fs->file_open(filename, READ);
-    if (fat_result != FILE_FOUND) {
-        printf("Fichier non trouvé: %s (Erreur FAT: %d)\n", filename, fat_result);
+    // Ligne à ligne, directement depuis les secteurs lus (.gz compris)
+    LineReader reader(fat32_fs);
+    if (!reader.open(filename)) {
+        printf("Fichier non trouvé: %s\n", filename);
         current_command = SD_INACTIVE;
         return SD_FILE_NOT_FOUND;
     }
-    
-    printf("Fichier trouvé - Taille: %lu bytes\n", fat32_fs->get_file_size(filename));
     printf("The content of file is:\n");
     
-    ReadHandler handler;
-    uint16_t bytes_read = fat32_fs->file_read(read_buffer, &handler);
-    
-    while (bytes_read > 0) {
-        read_buffer[bytes_read] = '\0';
-        printf("%s", read_buffer);
-        bytes_read = fat32_fs->file_read(read_buffer, &handler);
+    std::string_view line;
+    while (reader.next(line)) {
+        printf("%.*s%s", (int)line.size(), line.data(), reader.last_complete() ? "\n" : "");
     }
+    reader.close();
     
-    printf("\n<EOF>END OF FILE\n");
-    fat32_fs->file_close();
+    const LineReaderStats& stats = reader.get_stats();
+    printf("<EOF>END OF FILE (%lu lignes, %lu recopiées)\n",
+           (unsigned long)reader.get_line_number(), (unsigned long)stats.copied);
     
     current_command = SD_INACTIVE;
     buffer_index = 0;
@@ -141,15 +153,21 @@ SDCard_Status StorageManager::write_text_file(const char* filename, const uint8_
     printf("=== Écriture fichier avec FAT32 : %s (%d bytes) ===\n", filename, length);
     current_command = SD_FILE_WRITING;
     
-    FAT_ErrorCode fat_result = fat32_fs->file_open(filename, CREATE);
+    // Écriture groupée par cluster (taille annoncée pour le placement)
+    BufferedWriter writer(fat32_fs);
+    FAT_ErrorCode fat_result = writer.open(filename, CREATE, length);
     if (fat_result != FILE_CREATE_OK && fat_result != FILE_FOUND) {
         printf("Erreur création/ouverture fichier: %s (Erreur FAT: %d)\n", filename, fat_result);
         current_command = SD_INACTIVE;
         return SD_FILE_NOT_FOUND;
     }
     
-    fat32_fs->file_write(buffer, length);
-    fat32_fs->file_close();
+    bool written = writer.write(buffer, length);
+    if (!writer.close() || !written) {
+        printf("Erreur écriture fichier: %s\n", filename);
+        current_command = SD_INACTIVE;
+        return SD_WRITE_DATA_FAILS;
+    }
     
     printf("Fichier écrit avec succès: %s\n", filename);
     current_command = SD_INACTIVE;
@@ -178,13 +196,12 @@ bool StorageManager::file_exists(const char* filename) {
     }
     
     // Sauvegarder et changer de répertoire
-    if (!fat32_fs->change_directory(dir.c_str())) {
-        fat32_fs->change_directory("/");
+    if (!fat32_fs->push_directory(dir.c_str())) {
         return false;
     }
     
     bool exists = fat32_fs->file_exists(base.c_str());
-    fat32_fs->change_directory("/");
+    fat32_fs->pop_directory();
     
     return exists;
 }
@@ -207,11 +224,11 @@ uint32_t StorageManager::get_file_size(const char* filename) {
     }
     
     uint32_t size = 0;
-    if (fat32_fs->change_directory(dir.c_str())) {
+    if (fat32_fs->push_directory(dir.c_str())) {
         size = fat32_fs->get_file_size(base.c_str());
+        fat32_fs->pop_directory();
     }
     
-    fat32_fs->change_directory("/");
     return size;
 }
 
@@ -226,7 +243,7 @@ std::vector<FileInfo> StorageManager::list_directory(const char* path) {
     // Changer vers le répertoire demandé si nécessaire
     bool need_restore = false;
     if (path && std::strlen(path) > 0 && std::strcmp(path, "/") != 0) {
-        if (!fat32_fs->change_directory(path)) {
+        if (!fat32_fs->push_directory(path)) {
             printf("Impossible d'accéder au répertoire: %s\n", path);
             return result;
         }
@@ -240,7 +257,7 @@ std::vector<FileInfo> StorageManager::list_directory(const char* path) {
     if (error != ERROR_IDLE) {
         printf("Erreur listing FAT32 : %d\n", error);
         if (need_restore) {
-            fat32_fs->change_directory("/");
+            fat32_fs->pop_directory();
         }
         return result;
     }
@@ -266,9 +283,9 @@ std::vector<FileInfo> StorageManager::list_directory(const char* path) {
     
     printf("Listing FAT32 : %zu fichiers trouvés\n", result.size());
     
-    // Restaurer le répertoire racine
+    // Restaurer le répertoire de départ
     if (need_restore) {
-        fat32_fs->change_directory("/");
+        fat32_fs->pop_directory();
     }
     
     return result;
@@ -286,13 +303,14 @@ namespace {
         uint16_t position;
         FAT32* fs;
         ReadHandler* handler;
+        GzipReader* gz;        // fichier .gz: données décompressées
         
-        StagingBuffer(FAT32* filesystem, ReadHandler* h) 
-            : length(0), position(0), fs(filesystem), handler(h) {}
+        StagingBuffer(FAT32* filesystem, ReadHandler* h, GzipReader* gzip = nullptr) 
+            : length(0), position(0), fs(filesystem), handler(h), gz(gzip) {}
         
         bool refill() {
             if (position < length) return true;
-            length = fs->file_read(data, handler);
+            length = gz ? (uint16_t)gz->read(data, sizeof(data)) : fs->file_read(data, handler);
             position = 0;
             return length > 0;
         }
@@ -431,8 +449,17 @@ SDCard_Status StorageManager::read_bmp_file(
         return SD_FILE_NOT_FOUND;
     }
 
+    // Un .bmp.gz est décompressé au fil de la lecture
+    GzipReader gzip(fat32_fs);
+    const bool compressed = GzipReader::is_gz_name(filename);
+    if (compressed && gzip.begin() != GZ_OK) {
+        fat32_fs->file_close();
+        current_command = SD_INACTIVE;
+        return SD_UNSUPPORTED_COMPRESSION;
+    }
+
     ReadHandler handler;
-    StagingBuffer staging(fat32_fs, &handler);
+    StagingBuffer staging(fat32_fs, &handler, compressed ? &gzip : nullptr);
 
     // Lire header
     t_bmp_header header;
@@ -516,10 +543,11 @@ SDCard_Status StorageManager::read_bmp_file(
             }
         }
 
+        const bool intact = !compressed || gzip.finish() == GZ_END;
         fat32_fs->file_close();
         current_command = SD_INACTIVE;
         buffer_index = 0;
-        return SD_OK;
+        return intact ? SD_OK : SD_BAD_FILE_FORMAT;
     } else { // 16 bpp
         if (!validate_bmp_header(header, 16)) {
             fat32_fs->file_close();
@@ -596,10 +624,11 @@ SDCard_Status StorageManager::read_bmp_file(
             }
         }
 
+        const bool intact = !compressed || gzip.finish() == GZ_END;
         fat32_fs->file_close();
         current_command = SD_INACTIVE;
         buffer_index = 0;
-        return SD_OK;
+        return intact ? SD_OK : SD_BAD_FILE_FORMAT;
     }
 }
 
@@ -737,6 +766,13 @@ void StorageManager::display_fat32_system_info() {
     printf("Base Root:       secteur %lu\n", fat32_fs->get_root_base());
     printf("Base Data:       secteur %lu\n", fat32_fs->get_data_base());
     printf("Support LFN:     %s\n", fat32_fs->supports_lfn() ? "OUI" : "NON");
+    const BlockSchedulerStats& io = fat32_fs->get_io_stats();
+    printf("File E/S:        lectures %lu cmd / %lu secteurs (%lu en file), écritures %lu cmd / %lu secteurs (%lu fusionnées)\n",
+           (unsigned long)io.read_commands, (unsigned long)io.read_blocks, (unsigned long)io.read_hits,
+           (unsigned long)io.write_commands, (unsigned long)io.written_blocks, (unsigned long)io.coalesced);
+    if (fat32_fs->get_allocation_unit()) {
+        printf("Unité alloc.:    %lu secteurs (placement aligné)\n", (unsigned long)fat32_fs->get_allocation_unit());
+    }
 }
 
 void StorageManager::debug_sector_with_fat32(uint32_t sector_num) {
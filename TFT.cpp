@@ -1,45 +1,61 @@
 #include "TFT.h"
 #include "main.h"
+#include "ColorTransform.h"
+#include "TFTBus.h"
+#include "Canvas.h"
 #include <cstring>
 
 /*******************************************************
  * Nom du fichier : TFT.cpp
  * Auteur         : Guillaume Sahuc
  * Date           : 01 Decembre 2025
- * Description    : driver GC9A01 on spi0 RP2040
+ * Description    : driver GC9A01 / ST7789 / ILI9341 on spi0 RP2040
  *                : DMA removed 
  *******************************************************/
 
 
 // Framebuffer statique pour éviter l'allocation dynamique
 // Aligné sur 4 octets pour de meilleures performances SPI
-static uint8_t g_tft_framebuffer[TFTConfig::FB_SIZE_BYTES] __attribute__((aligned(4)));
+// (commun à tous les écrans d'un bus: dessiner puis envoyer un écran à la fois)
+template <class Panel>
+uint8_t TFTRenderer<Panel>::frame_storage[FB_SIZE_BYTES] __attribute__((aligned(4)));
+// Ligne transformée en attente d'envoi (transformation de couleur active)
+template <class Panel>
+uint16_t TFTRenderer<Panel>::row_storage[WIDTH > HEIGHT ? WIDTH : HEIGHT];
 
 // ===== CONSTRUCTEUR/DESTRUCTEUR =====
-TFT::TFT() : framebuffer(nullptr), 
-             fill_color(0x0000), scroll_x(0), scroll_y(0),
-             current_font(FontType::FONT_STANDARD), current_rotation(Rotation::PORTRAIT_0) {
+template <class Panel>
+TFTRenderer<Panel>::TFTRenderer() : TFTRenderer(&TFTBus::default_bus(), 0) {}
+
+template <class Panel>
+TFTRenderer<Panel>::TFTRenderer(TFTBus* panel_bus, uint8_t panel_index)
+           : framebuffer(nullptr), 
+             fill_color(0x0000), color_transform(nullptr), scroll_x(0), scroll_y(0),
+             render_scale(RenderScale::FULL), clip_depth(0),
+             current_font(FontType::FONT_STANDARD), current_rotation(Rotation::PORTRAIT_0),
+             bus(panel_bus), panel(panel_index) {
     updateScreenDimensions();
+    applyWindowFormat();
 }
 
-TFT::~TFT() {
+template <class Panel>
+TFTRenderer<Panel>::~TFTRenderer() {
     // Framebuffer statique: rien à libérer
 }
 
 // Taille du framebuffer (en octets)
-size_t TFT::getFramebufferSize() const {
-    return static_cast<size_t>(TFTConfig::FB_SIZE_BYTES);
+template <class Panel>
+size_t TFTRenderer<Panel>::getFramebufferSize() const {
+    return static_cast<size_t>(FB_SIZE_BYTES);
 }
 
 // ===== INITIALISATION =====
-void TFT::init() {
+template <class Panel>
+void TFTRenderer<Panel>::init() {
     // no DMA; no instance assigned
     
-    // Configuration GPIO
-    initGPIO();
-    
-    // Configuration SPI
-    initSPI();
+    // GPIO de l'écran, SPI et reset (via le bus partagé)
+    bus->init_panel(panel);
     
     // Allocation du framebuffer
     initFramebuffer();
@@ -48,509 +64,529 @@ void TFT::init() {
     initSequence();
 }
 
-void TFT::initGPIO() {
-    gpio_init(TFTConfig::PIN_DC); 
-    gpio_set_dir(TFTConfig::PIN_DC, GPIO_OUT);
-    gpio_init(TFTConfig::PIN_RST); 
-    gpio_set_dir(TFTConfig::PIN_RST, GPIO_OUT);
-    gpio_init(TFTConfig::PIN_CS); 
-    gpio_set_dir(TFTConfig::PIN_CS, GPIO_OUT);
-
-    gpio_put(TFTConfig::PIN_CS, 1);
-    gpio_put(TFTConfig::PIN_RST, 1);
-}
-
-void TFT::initSPI() {
-    spi_init(spi0, TFTConfig::SPI_BAUDRATE);
-    spi_set_format(spi0, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
-    gpio_set_function(TFTConfig::PIN_SCK, GPIO_FUNC_SPI);
-    gpio_set_function(TFTConfig::PIN_MOSI, GPIO_FUNC_SPI);
-}
-
-void TFT::initFramebuffer() {
-    framebuffer = g_tft_framebuffer;
+template <class Panel>
+void TFTRenderer<Panel>::initFramebuffer() {
+    framebuffer = frame_storage;
     // Clear initial
     // Prefer 16-bit writes for speed (RGB565 buffer)
     uint16_t* fb16 = reinterpret_cast<uint16_t*>(framebuffer);
-    size_t nb_words = TFTConfig::FB_SIZE_BYTES / 2;
+    size_t nb_words = FB_SIZE_BYTES / 2;
     for (size_t i = 0; i < nb_words; ++i) fb16[i] = 0;
 }
 
 // DMA removed. No initDMA implementation.
 
 // ===== COMMUNICATION SPI =====
-void TFT::writeCmd(const uint8_t* cmd, size_t len) {
-    // S'assurer que le bus SPI est à pleine vitesse pour l'écran
-    spi_set_baudrate(spi0, TFTConfig::SPI_BAUDRATE);
-    gpio_put(TFTConfig::PIN_DC, 0);
-    gpio_put(TFTConfig::PIN_CS, 0);
-    spi_write_blocking(spi0, cmd, len);
-    gpio_put(TFTConfig::PIN_CS, 1);
+template <class Panel>
+void TFTRenderer<Panel>::writeCmd(const uint8_t* cmd, size_t len) {
+    for (size_t i = 0; i < len; ++i) bus->command(panel, cmd[i]);
 }
 
-void TFT::writeData(const uint8_t* data, size_t len) {
-    // S'assurer que le bus SPI est à pleine vitesse pour l'écran
-    spi_set_baudrate(spi0, TFTConfig::SPI_BAUDRATE);
-    gpio_put(TFTConfig::PIN_DC, 1);
-    gpio_put(TFTConfig::PIN_CS, 0);
-    spi_write_blocking(spi0, data, len);
-    gpio_put(TFTConfig::PIN_CS, 1);
+template <class Panel>
+void TFTRenderer<Panel>::writeData(const uint8_t* data, size_t len) {
+    bus->data(panel, data, len);
 }
 
-void TFT::cmdWithData(const uint8_t cmd, const uint8_t* data, size_t datalen) {
+template <class Panel>
+void TFTRenderer<Panel>::cmdWithData(const uint8_t cmd, const uint8_t* data, size_t datalen) {
     writeCmd(&cmd, 1);
     if (datalen) writeData(data, datalen);
 }
 
-void TFT::setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
-    uint8_t buf[4];
-    
-    // Colonne
-    buf[0] = (x0 >> 8) & 0xFF; 
-    buf[1] = x0 & 0xFF;
-    buf[2] = (x1 >> 8) & 0xFF; 
-    buf[3] = x1 & 0xFF;
-    cmdWithData(0x2A, buf, 4);
-    
-    // Ligne
-    buf[0] = (y0 >> 8) & 0xFF; 
-    buf[1] = y0 & 0xFF;
-    buf[2] = (y1 >> 8) & 0xFF; 
-    buf[3] = y1 & 0xFF;
-    cmdWithData(0x2B, buf, 4);
+template <class Panel>
+void TFTRenderer<Panel>::setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    bus->set_window(panel, x0, y0, x1, y1);
 }
 
 // ===== TRANSPORT SPI =====
 
-void TFT::sendFrame() {
-    // S'assurer que le bus SPI est à pleine vitesse pour le transfert d'image
-    spi_set_baudrate(spi0, TFTConfig::SPI_BAUDRATE);
+template <class Panel>
+void TFTRenderer<Panel>::sendFrame() {
+    const int scale = static_cast<int>(render_scale);
+    setWindow(0, 0, screen_width * scale - 1, screen_height * scale - 1);
+    bus->begin_pixels(panel);
+    const uint16_t* fb16 = reinterpret_cast<const uint16_t*>(framebuffer);
+    if (render_scale == RenderScale::FULL) {
+        // Use blocking SPI transfer for the whole framebuffer instead of DMA
+        writePixels(fb16, FB_SIZE_BYTES / 2);
+    } else {
+        for (int row = 0; row < screen_height; ++row) {
+            writeScaledRow(fb16 + row * screen_width, screen_width);
+        }
+    }
+    bus->end_pixels(panel);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::writeScaledRow(const uint16_t* pixels, size_t count) {
+    const size_t scale = static_cast<size_t>(render_scale);
+    const size_t width = count * scale;
+    // La ligne réduite est d'abord placée (transformée) en fin de row_storage,
+    // puis étalée vers la gauche: l'écriture n°i (i*scale .. i*scale+scale-1)
+    // n'atteint jamais les pixels sources suivants (width-count+i+1 et au-delà)
+    uint16_t* src = row_storage + (width - count);
+    if (color_transform && !color_transform->is_identity()) {
+        color_transform->apply_be(pixels, src, count);
+    } else {
+        memcpy(src, pixels, count * 2);
+    }
+    uint16_t* dst = row_storage;
+    if (scale == 2) {
+        for (size_t i = 0; i < count; ++i, dst += 2) {
+            const uint16_t c = src[i];
+            dst[0] = c; dst[1] = c;
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i, dst += 3) {
+            const uint16_t c = src[i];
+            dst[0] = c; dst[1] = c; dst[2] = c;
+        }
+    }
+    // Même ligne écran répétée scale fois
+    for (size_t k = 0; k < scale; ++k) {
+        bus->write(panel, reinterpret_cast<const uint8_t*>(row_storage), width * 2);
+    }
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::writePixels(const uint16_t* pixels, size_t count) {
+    if (!color_transform || color_transform->is_identity()) {
+        bus->write(panel, reinterpret_cast<const uint8_t*>(pixels), count * 2);
+        return;
+    }
+    // Transformation ligne par ligne: le framebuffer reste intact
+    while (count > 0) {
+        const size_t n = (count < (size_t)WIDTH) ? count : (size_t)WIDTH;
+        color_transform->apply_be(pixels, row_storage, n);
+        bus->write(panel, reinterpret_cast<const uint8_t*>(row_storage), n * 2);
+        pixels += n;
+        count -= n;
+    }
+}
 
-    setWindow(0, 0, screen_width - 1, screen_height - 1);
-    uint8_t cmd = 0x2C;
-    writeCmd(&cmd, 1);
-    
-    gpio_put(TFTConfig::PIN_DC, 1);
-    gpio_put(TFTConfig::PIN_CS, 0);
-    // Use blocking SPI transfer for the whole framebuffer instead of DMA
-    spi_write_blocking(spi0, framebuffer, TFTConfig::FB_SIZE_BYTES);
-    gpio_put(TFTConfig::PIN_CS, 1);
+template <class Panel>
+void TFTRenderer<Panel>::setColorTransform(const ColorTransform* transform) {
+    color_transform = transform;
 }
 
-void TFT::sendRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+template <class Panel>
+void TFTRenderer<Panel>::sendRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Field field) {
     // Validate region
     if (w == 0 || h == 0) return;
     if (x >= (uint16_t)screen_width || y >= (uint16_t)screen_height) return;
     uint16_t x1 = (x + w > (uint16_t)screen_width) ? (screen_width - 1) : (x + w - 1);
     uint16_t y1 = (y + h > (uint16_t)screen_height) ? (screen_height - 1) : (y + h - 1);
 
-    // For each line we do a blocking SPI transfer of contiguous memory
-    // This avoids copying the whole framebuffer when only a small region changed
-    for (uint16_t row = y; row <= y1; ++row) {
-        setWindow(x, row, x1, row);
-        uint8_t cmd = 0x2C;
-        writeCmd(&cmd, 1);
-        gpio_put(TFTConfig::PIN_DC, 1);
-        gpio_put(TFTConfig::PIN_CS, 0);
-
-        // Calculate byte offset and bytes to transfer
-        uint16_t* fb16 = reinterpret_cast<uint16_t*>(framebuffer);
-        uint32_t offset = (static_cast<uint32_t>(row) * screen_width + x);
-        uint8_t* row_ptr = reinterpret_cast<uint8_t*>(&fb16[offset]);
-        size_t bytes = (x1 - x + 1) * 2;
-
-        // For small transfers we use blocking spi write
-        spi_write_blocking(spi0, row_ptr, bytes);
-        gpio_put(TFTConfig::PIN_CS, 1);
+    // Région entière: une seule fenêtre, les lignes s'y suivent; chaque
+    // ligne est un transfert bloquant de mémoire contiguë (pas de copie du
+    // framebuffer). En résolution réduite, scale lignes écran par ligne.
+    const uint16_t scale = static_cast<uint16_t>(render_scale);
+    const uint16_t cols = x1 - x + 1;
+    const uint16_t* fb16 = reinterpret_cast<const uint16_t*>(framebuffer);
+    if (field == Field::BOTH) {
+        setWindow(x * scale, y * scale, (x1 + 1) * scale - 1, (y1 + 1) * scale - 1);
+        bus->begin_pixels(panel);
+        for (uint16_t row = y; row <= y1; ++row) {
+            const uint16_t* line = &fb16[static_cast<uint32_t>(row) * screen_width + x];
+            if (scale == 1) writePixels(line, cols);
+            else writeScaledRow(line, cols);
+        }
+        bus->end_pixels(panel);
+        return;
+    }
+
+    // Entrelacé: une ligne sur deux. Le contrôleur n'a pas de pas de ligne,
+    // chaque ligne a donc sa plage: les colonnes sont envoyées une fois, puis
+    // RASET + RAMWR par ligne sous une seule sélection (TFTBus::begin_rows)
+    uint16_t first = y;
+    if ((first & 1) != (field == Field::ODD ? 1 : 0)) first++;
+    if (first > y1) return;
+    setWindow(x * scale, first * scale, (x1 + 1) * scale - 1, (first + 1) * scale - 1);
+    bus->begin_pixels(panel);
+    for (uint16_t row = first; row <= y1; row += 2) {
+        if (row != first) {
+            bus->end_pixels(panel);
+            bus->begin_rows(panel, row * scale, (row + 1) * scale - 1);
+        }
+        const uint16_t* line = &fb16[static_cast<uint32_t>(row) * screen_width + x];
+        if (scale == 1) writePixels(line, cols);
+        else writeScaledRow(line, cols);
     }
+    bus->end_pixels(panel);
 }
 
-void TFT::blitRGB565FullFrame(const uint8_t* src) {
+template <class Panel>
+void TFTRenderer<Panel>::blitRGB565FullFrame(const uint8_t* src) {
     if (!framebuffer || !src) return;
     // copy raw frame bytes as-is. Caller must provide data in the expected byte order
-    std::memcpy(framebuffer, src, TFTConfig::FB_SIZE_BYTES);
+    std::memcpy(framebuffer, src, static_cast<size_t>(screen_width) * screen_height * 2);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::setRenderScale(RenderScale scale) {
+    render_scale = scale;
+    updateScreenDimensions();
+    if (framebuffer) fill(COLOR_16BITS_BLACK);
+}
+
+template <class Panel>
+uint8_t* TFTRenderer<Panel>::getSpareBuffer(size_t& size) {
+    const size_t used = static_cast<size_t>(screen_width) * screen_height * 2;
+    size = (framebuffer && used < (size_t)FB_SIZE_BYTES) ? FB_SIZE_BYTES - used : 0;
+    return size ? framebuffer + used : nullptr;
 }
 
 // ===== GESTION DU FRAMEBUFFER =====
-void TFT::fill(uint16_t color) {
+template <class Panel>
+void TFTRenderer<Panel>::fill(uint16_t color) {
     fill_color = color;
     uint16_t* fb16 = reinterpret_cast<uint16_t*>(framebuffer);
-    size_t nb_words = TFTConfig::FB_SIZE_BYTES / 2;
+    // Seuls les pixels de la résolution courante (la zone libre reste intacte)
+    size_t nb_words = static_cast<size_t>(screen_width) * screen_height;
     // Store as big-endian 16-bit words in memory so the SPI transfer expects MSB first
     uint16_t be_color = (uint16_t)((color >> 8) | (color << 8));
     for (size_t i = 0; i < nb_words; ++i) fb16[i] = be_color;
 }
 
-void TFT::clear() {
+template <class Panel>
+void TFTRenderer<Panel>::clear() {
     // Efface en noir (RGB565)
     fill(COLOR_16BITS_BLACK);
     // Envoie immédiatement à l'écran
     sendFrame();
 }
 
-void TFT::setPixel(int x, int y, uint16_t color) {
+template <class Panel>
+void TFTRenderer<Panel>::setPixel(int x, int y, uint16_t color) {
    
     int screen_x = x - scroll_x;
     int screen_y = y - scroll_y;
     
-    // Vérifier les limites selon les dimensions logiques de l'écran
-    if (screen_x < 0 || screen_x >= screen_width || 
-        screen_y < 0 || screen_y >= screen_height) return;
+    // Vérifier les limites de la zone de dessin (l'écran par défaut)
+    if (screen_x < clip_x0 || screen_x >= clip_x1 || 
+        screen_y < clip_y0 || screen_y >= clip_y1) return;
     
     uint16_t* fb16 = reinterpret_cast<uint16_t*>(framebuffer);
     uint16_t be_color = (uint16_t)((color >> 8) | (color << 8));
     fb16[screen_y * screen_width + screen_x] = be_color;
 }
 
-void TFT::setFillColor(uint16_t color) {
+template <class Panel>
+void TFTRenderer<Panel>::setFillColor(uint16_t color) {
     fill_color = color;
 }
 
 // ===== PRIMITIVES DE DESSIN =====
-void TFT::drawLine(int x0, int y0, int x1, int y1, uint16_t color) {
-    int dx = abs(x1 - x0);
-    int dy = abs(y1 - y0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dx - dy;
-    int x = x0, y = y0;
-    
-    while (true) {
-        setPixel(x, y, color);
-        if (x == x1 && y == y1) break;
-        
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y += sy;
-        }
-    }
+template <class Panel>
+void TFTRenderer<Panel>::drawLine(int x0, int y0, int x1, int y1, uint16_t color) {
+    Raster::drawLine(*this, x0, y0, x1, y1, color);
 }
 
-void TFT::drawRect(int x, int y, int w, int h, uint16_t color) {
-    drawLine(x, y, x + w - 1, y, color);
-    drawLine(x, y + h - 1, x + w - 1, y + h - 1, color);
-    drawLine(x, y, x, y + h - 1, color);
-    drawLine(x + w - 1, y, x + w - 1, y + h - 1, color);
+template <class Panel>
+void TFTRenderer<Panel>::drawRect(int x, int y, int w, int h, uint16_t color) {
+    Raster::drawRect(*this, x, y, w, h, color);
 }
 
-void TFT::fillRect(int x, int y, int w, int h, uint16_t color) {
-    for (int py = y; py < y + h; py++) {
-        for (int px = x; px < x + w; px++) {
-            setPixel(px, py, color);
-        }
-    }
+template <class Panel>
+void TFTRenderer<Panel>::fillRect(int x, int y, int w, int h, uint16_t color) {
+    Raster::fillRect(*this, x, y, w, h, color);
 }
 
-void TFT::drawCircle(int xc, int yc, int r, uint16_t color) {
-    int x = 0;
-    int y = r;
-    int d = 3 - 2 * r;
-    
-    while (y >= x) {
-        setPixel(xc + x, yc + y, color);
-        setPixel(xc - x, yc + y, color);
-        setPixel(xc + x, yc - y, color);
-        setPixel(xc - x, yc - y, color);
-        setPixel(xc + y, yc + x, color);
-        setPixel(xc - y, yc + x, color);
-        setPixel(xc + y, yc - x, color);
-        setPixel(xc - y, yc - x, color);
-        
-        x++;
-        if (d > 0) {
-            y--;
-            d = d + 4 * (x - y) + 10;
-        } else {
-            d = d + 4 * x + 6;
-        }
-    }
+template <class Panel>
+void TFTRenderer<Panel>::drawHLine(int x, int y, int w, uint16_t color) {
+    Raster::fillRect(*this, x, y, w, 1, color);
 }
 
-void TFT::drawFillCircle(int xc, int yc, int r, uint16_t color) {
-    int x = 0;
-    int y = r;
-    int d = 3 - 2 * r;
-    
-    auto fillHorizontalLines = [&](int cx, int cy, int x, int y) {
-        drawLine(cx - x, cy + y, cx + x, cy + y, color);
-        drawLine(cx - x, cy - y, cx + x, cy - y, color);
-        drawLine(cx - y, cy + x, cx + y, cy + x, color);
-        drawLine(cx - y, cy - x, cx + y, cy - x, color);
-    };
-    
-    while (y >= x) {
-        fillHorizontalLines(xc, yc, x, y);
-        x++;
-        
-        if (d > 0) {
-            y--;
-            d = d + 4 * (x - y) + 10;
-        } else {
-            d = d + 4 * x + 6;
-        }
-    }
+template <class Panel>
+void TFTRenderer<Panel>::drawVLine(int x, int y, int h, uint16_t color) {
+    Raster::fillRect(*this, x, y, 1, h, color);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::drawBitmap(int x, int y, int w, int h, const uint8_t* bits, uint16_t color) {
+    Raster::drawBitmap(*this, x, y, w, h, bits, color);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::blitRGB565(int x, int y, int w, int h, const uint16_t* pixels) {
+    Raster::blitRGB565(*this, x, y, w, h, pixels);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::fillLinearGradient(int x, int y, int w, int h,
+                                            int x0, int y0, uint16_t color0, int x1, int y1, uint16_t color1) {
+    Raster::fillLinearGradient(*this, x, y, w, h, x0, y0, color0, x1, y1, color1);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::fillRadialGradient(int x, int y, int w, int h, int xc, int yc, int r,
+                                            uint16_t inner, uint16_t outer) {
+    Raster::fillRadialGradient(*this, x, y, w, h, xc, yc, r, inner, outer);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::fillPattern(int x, int y, int w, int h, const uint8_t* pattern, uint16_t fg, uint16_t bg) {
+    Raster::fillPattern(*this, x, y, w, h, pattern, fg, bg);
 }
 
-void TFT::drawSmallCircle(int xc, int yc, int r, uint16_t color) {
+template <class Panel>
+void TFTRenderer<Panel>::drawCanvas(const Canvas& canvas, int x, int y) {
+    Raster::blitRGB565(*this, x, y, canvas.getWidth(), canvas.getHeight(), canvas.getPixels());
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::drawCanvas(const Canvas& canvas, int x, int y, uint16_t transparent) {
+    Raster::blitRGB565(*this, x, y, canvas.getWidth(), canvas.getHeight(), canvas.getPixels(), transparent);
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::scrollRect(int x, int y, int w, int h, int dy) {
+    int x0 = (x > clip_x0) ? x : clip_x0;
+    int y0 = (y > clip_y0) ? y : clip_y0;
+    int x1 = (x + w < clip_x1) ? x + w : clip_x1;
+    int y1 = (y + h < clip_y1) ? y + h : clip_y1;
+    if (x1 <= x0 || y1 <= y0 || dy == 0 || dy >= y1 - y0 || -dy >= y1 - y0) return;
+
     uint16_t* fb16 = reinterpret_cast<uint16_t*>(framebuffer);
-    uint16_t be_color = (uint16_t)((color >> 8) | (color << 8));
-    int miny = yc - r;
-    int maxy = yc + r;
-    int minx = xc - r;
-    int maxx = xc + r;
-
-    // Clip to screen
-    if (minx < 0) minx = 0;
-    if (miny < 0) miny = 0;
-    if (maxx >= TFTConfig::WIDTH) maxx = TFTConfig::WIDTH - 1;
-    if (maxy >= TFTConfig::HEIGHT) maxy = TFTConfig::HEIGHT - 1;
-
-    for (int py = miny; py <= maxy; ++py) {
-        int dy = py - yc;
-        int dy2 = dy * dy;
-        for (int px = minx; px <= maxx; ++px) {
-            int dx = px - xc;
-            if ((dx*dx + dy2) <= r * r) {
-                fb16[py * TFTConfig::WIDTH + px] = be_color;
-            }
+    const size_t bytes = (size_t)(x1 - x0) * 2;
+    if (dy < 0) {
+        // Vers le haut: de la première ligne à la dernière
+        for (int row = y0; row < y1 + dy; row++) {
+            memcpy(&fb16[row * screen_width + x0], &fb16[(row - dy) * screen_width + x0], bytes);
+        }
+    } else {
+        for (int row = y1 - 1; row >= y0 + dy; row--) {
+            memcpy(&fb16[row * screen_width + x0], &fb16[(row - dy) * screen_width + x0], bytes);
         }
     }
 }
 
-// ===== GESTION DES POLICES =====
-void TFT::setFont(FontType font) {
-    current_font = font;
+template <class Panel>
+void TFTRenderer<Panel>::drawCircle(int xc, int yc, int r, uint16_t color) {
+    Raster::drawCircle(*this, xc, yc, r, color);
 }
 
-FontType TFT::getFont() const {
-    return current_font;
+template <class Panel>
+void TFTRenderer<Panel>::drawFillCircle(int xc, int yc, int r, uint16_t color) {
+    Raster::drawFillCircle(*this, xc, yc, r, color);
 }
 
-const uint8_t* TFT::getFontData(char c) {
-    uint8_t char_code = (uint8_t)c;
-    
-    switch (current_font) {
-        case FontType::FONT_MINI:
-            return &font_mini_4x6[char_code * 6];
-        case FontType::FONT_STANDARD:
-            return &ufont_1[char_code * 12];
-        case FontType::ARIAL_32: {
-            const arial_S32_CharInfo& info = getArialCharInfo(c);
-            return &arial_S32_Bitmaps[info.offset];
-        }
-        default:
-            return &font_mini_4x6[char_code * 6];
-    }
+template <class Panel>
+void TFTRenderer<Panel>::drawSmallCircle(int xc, int yc, int r, uint16_t color) {
+    // Coordonnées framebuffer: le scroll ne s'applique pas (balles)
+    Raster::drawSmallCircle(*this, xc + scroll_x, yc + scroll_y, r, color);
 }
 
-const arial_S32_CharInfo& TFT::getArialCharInfo(char c) {
-    return arial_S32_Info[(uint8_t)c];
+// ===== GESTION DES POLICES =====
+template <class Panel>
+void TFTRenderer<Panel>::setFont(FontType font) {
+    current_font = font;
 }
 
-int TFT::getFontWidth() {
-    switch (current_font) {
-        case FontType::FONT_MINI:
-            return 4;
-        case FontType::FONT_STANDARD:
-            return 8;
-        case FontType::ARIAL_32: {
-            const arial_S32_CharInfo& info = getArialCharInfo(' ');
-            return info.w;
-        }
-        default:
-            return 4;
-    }
+template <class Panel>
+FontType TFTRenderer<Panel>::getFont() const {
+    return current_font;
 }
 
-int TFT::getFontHeight() {
-    switch (current_font) {
-        case FontType::FONT_MINI:
-            return 6;
-        case FontType::FONT_STANDARD:
-            return 12;
-        case FontType::ARIAL_32: {
-            const arial_S32_CharInfo& info = getArialCharInfo('A');
-            return info.h;
-        }
-        default:
-            return 6;
-    }
+template <class Panel>
+const uint8_t* TFTRenderer<Panel>::getFontData(char c) {
+    return Raster::glyph(current_font, c);
 }
 
-int TFT::getCharWidth(char c) {
-    switch (current_font) {
-        case FontType::FONT_MINI:
-        case FontType::FONT_STANDARD:
-            return getFontWidth();
-        case FontType::ARIAL_32: {
-            const arial_S32_CharInfo& info = getArialCharInfo(c);
-            return info.w;
-        }
-        default:
-            return getFontWidth();
-    }
+template <class Panel>
+int TFTRenderer<Panel>::getFontWidth() {
+    return Raster::font_width(current_font);
 }
 
-int TFT::getTextWidth(const char* text) {
-    int total_width = 0;
-    int spacing = 1;
-    
-    for (int i = 0; text[i] != '\0'; i++) {
-        total_width += getCharWidth(text[i]);
-        if (text[i + 1] != '\0') {
-            total_width += spacing;
-        }
-    }
-    
-    return total_width;
+template <class Panel>
+int TFTRenderer<Panel>::getFontHeight() {
+    return Raster::font_height(current_font);
 }
 
-// ===== RENDU DE TEXTE =====
-void TFT::drawChar(int x, int y, char c, uint16_t color) {
-    if (current_font == FontType::ARIAL_32) {
-        drawArialChar(x, y, c, color);
-        return;
-    }
-    
-    const uint8_t* char_data = getFontData(c);
-    int font_width = getFontWidth();
-    int font_height = getFontHeight();
-    
-    for (int row = 0; row < font_height; row++) {
-        uint8_t line = char_data[row];
-        for (int col = 0; col < font_width; col++) {
-            if (line & (0x80 >> col)) {
-                setPixel(x + col, y + row, color);
-            }
-        }
-    }
+template <class Panel>
+int TFTRenderer<Panel>::getCharWidth(char c) {
+    return Raster::char_width(current_font, c);
 }
 
-void TFT::drawText(int x, int y, const char* text, uint16_t color) {
-    int char_x = x;
-    int spacing = 1;
-    
-    for (int i = 0; text[i] != '\0'; i++) {
-        drawChar(char_x, y, text[i], color);
-        int char_width = getCharWidth(text[i]);
-        char_x += char_width + spacing;
-    }
+template <class Panel>
+int TFTRenderer<Panel>::getTextWidth(const char* text) {
+    return Raster::text_width(current_font, text);
 }
 
+// ===== RENDU DE TEXTE =====
+template <class Panel>
+void TFTRenderer<Panel>::drawChar(int x, int y, char c, uint16_t color) {
+    Raster::drawChar(*this, current_font, x, y, c, color);
+}
 
-void TFT::drawArialChar(int x, int y, char c, uint16_t color) {
-    const arial_S32_CharInfo& charInfo = getArialCharInfo(c);
-    
-    uint32_t bitmap_offset = charInfo.offset;
-    const uint8_t* bitmap = &arial_S32_Bitmaps[bitmap_offset];
-    
-    int char_width = charInfo.w;
-    int char_height = charInfo.h;
-    
-    for (int row = 0; row < char_height; row++) {
-        for (int col = 0; col < char_width; col++) {
-            int bit_index = row * char_width + col;
-            int byte_index = bit_index / 8;
-            int bit_pos = 7 - (bit_index % 8);
-            
-            if (bitmap[byte_index] & (1 << bit_pos)) {
-                setPixel(x + col, y + row, color);
-            }
-        }
-    }
+template <class Panel>
+void TFTRenderer<Panel>::drawText(int x, int y, const char* text, uint16_t color) {
+    Raster::drawText(*this, current_font, x, y, text, color);
 }
 
+
 // ===== GESTION DU SCROLL =====
-void TFT::setScrollOffset(int x_offset, int y_offset) {
+template <class Panel>
+void TFTRenderer<Panel>::setScrollOffset(int x_offset, int y_offset) {
     scroll_x = x_offset;
     scroll_y = y_offset;
 }
 
-void TFT::scroll(int dx, int dy) {
+template <class Panel>
+void TFTRenderer<Panel>::scroll(int dx, int dy) {
     scroll_x += dx;
     scroll_y += dy;
 }
 
-void TFT::scrollUp(int lines) {
+template <class Panel>
+void TFTRenderer<Panel>::scrollUp(int lines) {
     int line_height = getFontHeight() + 1;
     scroll_y += lines * line_height;
 }
 
-void TFT::scrollDown(int lines) {
+template <class Panel>
+void TFTRenderer<Panel>::scrollDown(int lines) {
     int line_height = getFontHeight() + 1;
     scroll_y -= lines * line_height;
     if (scroll_y < 0) scroll_y = 0;
 }
 
-void TFT::scrollLeft(int pixels) {
+template <class Panel>
+void TFTRenderer<Panel>::scrollLeft(int pixels) {
     scroll_x += pixels;
 }
 
-void TFT::scrollRight(int pixels) {
+template <class Panel>
+void TFTRenderer<Panel>::scrollRight(int pixels) {
     scroll_x -= pixels;
     if (scroll_x < 0) scroll_x = 0;
 }
 
 // ===== GESTION DE LA ROTATION =====
-void TFT::setRotation(Rotation rotation) {
+template <class Panel>
+void TFTRenderer<Panel>::setRotation(Rotation rotation) {
     current_rotation = rotation;
     updateScreenDimensions();
     
-    uint8_t madctl_value;
-    switch (rotation) {
-        case Rotation::PORTRAIT_0:   madctl_value = 0x08; break;  // 0°
-        case Rotation::LANDSCAPE_90: madctl_value = 0x68; break;  // 90°
-        case Rotation::PORTRAIT_180: madctl_value = 0xC8; break;  // 180°
-        case Rotation::LANDSCAPE_270: madctl_value = 0xA8; break; // 270°
-        default: madctl_value = 0x08; break;
-    }
-    
-    cmdWithData(0x36, &madctl_value, 1);
+    uint8_t madctl_value = Panel::MADCTL_ROTATION[static_cast<int>(rotation) & 3];
+    cmdWithData(Panel::MADCTL, &madctl_value, 1);
+    applyWindowFormat();
     
     printf("TFT rotation set to %d° (%dx%d)\n", 
            (int)rotation * 90, screen_width, screen_height);
 }
 
-Rotation TFT::getRotation() const {
+template <class Panel>
+void TFTRenderer<Panel>::applyWindowFormat() {
+    // Décalage de la zone visible dans la RAM du contrôleur (ST7789 240x240)
+    const int r = static_cast<int>(current_rotation) & 3;
+    bus->set_window_format(panel, TFTWindow{Panel::CASET, Panel::RASET, Panel::RAMWR,
+                                            Panel::X_OFFSET[r], Panel::Y_OFFSET[r]});
+}
+
+template <class Panel>
+Rotation TFTRenderer<Panel>::getRotation() const {
     return current_rotation;
 }
 
-int TFT::getScreenWidth() const {
+template <class Panel>
+int TFTRenderer<Panel>::getScreenWidth() const {
     return screen_width;
 }
 
-int TFT::getScreenHeight() const {
+template <class Panel>
+int TFTRenderer<Panel>::getScreenHeight() const {
     return screen_height;
 }
 
-void TFT::updateScreenDimensions() {
+template <class Panel>
+void TFTRenderer<Panel>::updateScreenDimensions() {
     switch (current_rotation) {
         case Rotation::PORTRAIT_0:
         case Rotation::PORTRAIT_180:
-            screen_width = TFTConfig::WIDTH;
-            screen_height = TFTConfig::HEIGHT;
+            screen_width = WIDTH;
+            screen_height = HEIGHT;
             break;
         case Rotation::LANDSCAPE_90:
         case Rotation::LANDSCAPE_270:
-            screen_width = TFTConfig::HEIGHT;
-            screen_height = TFTConfig::WIDTH;
+            screen_width = HEIGHT;
+            screen_height = WIDTH;
             break;
     }
+    screen_width /= static_cast<int>(render_scale);
+    screen_height /= static_cast<int>(render_scale);
+    resetClipRect();
+}
+
+// ===== DÉCOUPAGE =====
+template <class Panel>
+void TFTRenderer<Panel>::setClipRect(int x, int y, int w, int h) {
+    clip_x0 = (x > 0) ? x : 0;
+    clip_y0 = (y > 0) ? y : 0;
+    clip_x1 = (x + w < screen_width) ? x + w : screen_width;
+    clip_y1 = (y + h < screen_height) ? y + h : screen_height;
+    // Rectangle vide: plus rien n'est dessiné
+    if (clip_x1 < clip_x0) clip_x1 = clip_x0;
+    if (clip_y1 < clip_y0) clip_y1 = clip_y0;
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::resetClipRect() {
+    clip_x0 = 0;
+    clip_y0 = 0;
+    clip_x1 = screen_width;
+    clip_y1 = screen_height;
+    clip_depth = 0;
+}
+
+template <class Panel>
+bool TFTRenderer<Panel>::pushClip(int x, int y, int w, int h) {
+    if (clip_depth >= CLIP_STACK_DEPTH) {
+        printf("TFT: pile de découpage pleine (%d)\n", CLIP_STACK_DEPTH);
+        return false;
+    }
+    clip_stack[clip_depth++] = ClipRect{clip_x0, clip_y0, clip_x1, clip_y1};
+    if (x > clip_x0) clip_x0 = x;
+    if (y > clip_y0) clip_y0 = y;
+    if (x + w < clip_x1) clip_x1 = x + w;
+    if (y + h < clip_y1) clip_y1 = y + h;
+    // Rectangle vide: plus rien n'est dessiné jusqu'au popClip()
+    if (clip_x1 < clip_x0) clip_x1 = clip_x0;
+    if (clip_y1 < clip_y0) clip_y1 = clip_y0;
+    return true;
+}
+
+template <class Panel>
+void TFTRenderer<Panel>::popClip() {
+    if (clip_depth == 0) return;
+    const ClipRect& saved = clip_stack[--clip_depth];
+    clip_x0 = saved.x0;
+    clip_y0 = saved.y0;
+    clip_x1 = saved.x1;
+    clip_y1 = saved.y1;
+}
+
+template <class Panel>
+bool TFTRenderer<Panel>::clipBox(int x, int y, int w, int h, ClipRect& out) const {
+    x -= scroll_x;
+    y -= scroll_y;
+    out.x0 = (x > clip_x0) ? x : clip_x0;
+    out.y0 = (y > clip_y0) ? y : clip_y0;
+    out.x1 = (x + w < clip_x1) ? x + w : clip_x1;
+    out.y1 = (y + h < clip_y1) ? y + h : clip_y1;
+    return out.x0 < out.x1 && out.y0 < out.y1;
 }
 
 // ===== FONCTIONS SPÉCIALISÉES =====
-void TFT::drawBalls(const std::vector<Ball>& balls) {
+template <class Panel>
+void TFTRenderer<Panel>::drawBalls(const std::vector<Ball>& balls) {
     for (const auto& ball : balls) {
         drawSmallCircle((int)ball.x, (int)ball.y, ball.radius, ball.color);
     }
 }
 
-void TFT::drawSecondsMarkers() {
+template <class Panel>
+void TFTRenderer<Panel>::drawSecondsMarkers() {
     // Utiliser les dimensions logiques de l'écran (déjà calculées selon rotation)
     int cx = screen_width / 2;
     int cy = screen_height / 2;
@@ -566,136 +602,14 @@ void TFT::drawSecondsMarkers() {
 }
 
 // ===== SÉQUENCE D'INITIALISATION LCD =====
-void TFT::initSequence() {
-    // Reset sequence
-    gpio_put(TFTConfig::PIN_RST, 0);
-    sleep_ms(20);
-    gpio_put(TFTConfig::PIN_RST, 1);
-    sleep_ms(20);
-
-    uint8_t data[12];
-
-    cmdWithData(0xEF, nullptr, 0);
-    data[0] = 0xEB; data[1] = 0x14; 
-    cmdWithData(0xEB, data, 2);
-
-    cmdWithData(0xFE, nullptr, 0);
-    cmdWithData(0xEF, nullptr, 0);
-
-    data[0] = 0xEB; data[1] = 0x14; 
-    cmdWithData(0xEB, data, 2);
-
-    data[0] = 0x40; cmdWithData(0x84, data, 1);
-    data[0] = 0xFF; cmdWithData(0x85, data, 1);
-    data[0] = 0xFF; cmdWithData(0x86, data, 1);
-    data[0] = 0xFF; cmdWithData(0x87, data, 1);
-    data[0] = 0x0A; cmdWithData(0x88, data, 1);
-    data[0] = 0x21; cmdWithData(0x89, data, 1);
-    data[0] = 0x00; cmdWithData(0x8A, data, 1);
-    data[0] = 0x80; cmdWithData(0x8B, data, 1);
-    data[0] = 0x01; cmdWithData(0x8C, data, 1);
-    data[0] = 0x01; cmdWithData(0x8D, data, 1);
-    data[0] = 0xFF; cmdWithData(0x8E, data, 1);
-    data[0] = 0xFF; cmdWithData(0x8F, data, 1);
-
-    data[0] = 0x00; data[1] = 0x20; 
-    cmdWithData(0xB6, data, 2);
-
-    uint8_t madctl = 0x08;
-    cmdWithData(0x36, &madctl, 1);
-
-    data[0] = 0x05; cmdWithData(0x3A, data, 1);
-
-    data[0] = 0x08; data[1] = 0x08; data[2] = 0x08; data[3] = 0x08; 
-    cmdWithData(0x90, data, 4);
-
-    data[0] = 0x06; cmdWithData(0xBD, data, 1);
-    data[0] = 0x00; cmdWithData(0xBC, data, 1);
-
-    data[0] = 0x60; data[1] = 0x01; data[2] = 0x04; 
-    cmdWithData(0xFF, data, 3);
-
-    data[0] = 0x13; cmdWithData(0xC3, data, 1);
-    data[0] = 0x13; cmdWithData(0xC4, data, 1);
-    data[0] = 0x22; cmdWithData(0xC9, data, 1);
-    data[0] = 0x11; cmdWithData(0xBE, data, 1);
-
-    data[0] = 0x10; data[1] = 0x0E; 
-    cmdWithData(0xE1, data, 2);
-
-    data[0] = 0x21; data[1] = 0x0C; data[2] = 0x02; 
-    cmdWithData(0xDF, data, 3);
-
-    data[0] = 0x45; data[1] = 0x09; data[2] = 0x08; 
-    data[3] = 0x08; data[4] = 0x26; data[5] = 0x2A; 
-    cmdWithData(0xF0, data, 6);
-
-    data[0] = 0x43; data[1] = 0x70; data[2] = 0x72; 
-    data[3] = 0x36; data[4] = 0x37; data[5] = 0x6F; 
-    cmdWithData(0xF1, data, 6);
-
-    data[0] = 0x45; data[1] = 0x09; data[2] = 0x08; 
-    data[3] = 0x08; data[4] = 0x26; data[5] = 0x2A; 
-    cmdWithData(0xF2, data, 6);
-
-    data[0] = 0x43; data[1] = 0x70; data[2] = 0x72; 
-    data[3] = 0x36; data[4] = 0x37; data[5] = 0x6F; 
-    cmdWithData(0xF3, data, 6);
-
-    data[0] = 0x1B; data[1] = 0x0B; 
-    cmdWithData(0xED, data, 2);
-
-    data[0] = 0x77; cmdWithData(0xAE, data, 1);
-    data[0] = 0x63; cmdWithData(0xCD, data, 1);
-
-    data[0] = 0x07; data[1] = 0x07; data[2] = 0x04; 
-    data[3] = 0x0E; data[4] = 0x0F; data[5] = 0x09;
-    data[6] = 0x07; data[7] = 0x08; data[8] = 0x03; 
-    cmdWithData(0x70, data, 9);
-
-    data[0] = 0x34; cmdWithData(0xE8, data, 1);
-
-    data[0] = 0x18; data[1] = 0x0D; data[2] = 0x71; 
-    data[3] = 0xED; data[4] = 0x70; data[5] = 0x70;
-    data[6] = 0x18; data[7] = 0x0F; data[8] = 0x71; 
-    data[9] = 0xEF; data[10] = 0x70; data[11] = 0x70;
-    cmdWithData(0x62, data, 12);
-
-    data[0] = 0x18; data[1] = 0x11; data[2] = 0x71; 
-    data[3] = 0xF1; data[4] = 0x70; data[5] = 0x70;
-    data[6] = 0x18; data[7] = 0x13; data[8] = 0x71; 
-    data[9] = 0xF3; data[10] = 0x70; data[11] = 0x70;
-    cmdWithData(0x63, data, 12);
-
-    data[0] = 0x28; data[1] = 0x29; data[2] = 0xF1; 
-    data[3] = 0x01; data[4] = 0xF1; data[5] = 0x00; data[6] = 0x07;
-    cmdWithData(0x64, data, 7);
-
-    data[0] = 0x3C; data[1] = 0x00; data[2] = 0xCD; 
-    data[3] = 0x67; data[4] = 0x45; data[5] = 0x45;
-    data[6] = 0x10; data[7] = 0x00; data[8] = 0x00; data[9] = 0x00;
-    cmdWithData(0x66, data, 10);
-
-    data[0] = 0x00; data[1] = 0x3C; data[2] = 0x00; 
-    data[3] = 0x00; data[4] = 0x00; data[5] = 0x01;
-    data[6] = 0x54; data[7] = 0x10; data[8] = 0x32; data[9] = 0x98;
-    cmdWithData(0x67, data, 10);
-
-    data[0] = 0x10; data[1] = 0x85; data[2] = 0x80; 
-    data[3] = 0x00; data[4] = 0x00; data[5] = 0x4E; data[6] = 0x00;
-    cmdWithData(0x74, data, 7);
-
-    data[0] = 0x3E; data[1] = 0x07; 
-    cmdWithData(0x98, data, 2);
-
-    cmdWithData(0x35, nullptr, 0);
-    cmdWithData(0x21, nullptr, 0);
-
-    // Sleep Out
-    cmdWithData(0x11, nullptr, 0);
-    sleep_ms(120);
+template <class Panel>
+void TFTRenderer<Panel>::initSequence() {
+    // Reset matériel déjà fait par TFTBus::init_panel
+    for (const PanelCommand& c : Panel::INIT) {
+        cmdWithData(c.cmd, c.data, c.len);
+        if (c.delay_ms) sleep_ms(c.delay_ms);
+    }
+}
 
-    // Display ON
-    cmdWithData(0x29, nullptr, 0);
-    sleep_ms(20);
-}
\ No newline at end of file
+// Seul le contrôleur monté est compilé (un framebuffer statique par instance)
+template class TFTRenderer<TFTConfig::Panel>;
@@ -6,13 +6,19 @@
  * @author Guillaume Sahuc
  * @date 2025
  * 
- * @class TFT
+ * @class TFTRenderer
  * @brief Gestionnaire d'écran TFT avec framebuffer et support multi-polices
  *
+ * Le contrôleur est un paramètre de template (PanelTraits.h): résolution,
+ * séquence d'initialisation, MADCTL et décalages sont des constantes de
+ * compilation. TFT désigne le renderer du contrôleur monté (TFTConfig::Panel);
+ * seul celui-ci est instancié (TFT.cpp).
+ *
  * Cette classe fournit une interface complète pour :
- * - Initialisation et communication SPI avec l'écran
+ * - Initialisation et communication SPI avec l'écran (GC9A01, ST7789, ILI9341)
  * - Gestion du framebuffer et transferts SPI (bloquant)
- * - Primitives de dessin (lignes, rectangles, cercles)
+ * - Primitives de dessin (lignes, rectangles, cercles), communes avec les
+ *   Canvas hors écran (Raster.h)
  * - Rendu de texte avec plusieurs polices (Mini, Standard, Arial32)
  * - Gestion de la rotation d'écran et du scroll
  * - Support des animations (balles, marqueurs horaires)
@@ -25,18 +31,14 @@
 #include "Color.h"
 #include "main.h"
 #include "arial_S32.h"
+#include "PanelTraits.h"
+#include "Raster.h"
 
-// ===== ÉNUMÉRATIONS =====
+class ColorTransform;
+class TFTBus;
+class Canvas;
 
-/**
- * @enum FontType
- * @brief Types de polices disponibles
- */
-enum class FontType {
-    FONT_MINI,      ///< Police 4x6 pixels - Compacte
-    FONT_STANDARD,  ///< Police 8x12 pixels - Standard
-    ARIAL_32        ///< Police Arial 32 pixels - Haute qualité
-};
+// ===== ÉNUMÉRATIONS =====
 
 /**
  * @enum Rotation
@@ -49,13 +51,51 @@ enum class Rotation {
     LANDSCAPE_270 = 3   ///< 270° - Paysage inversé (rotation anti-horaire)
 };
 
+/**
+ * @enum RenderScale
+ * @brief Résolution de dessin; chaque pixel est répété à l'envoi
+ */
+enum class RenderScale {
+    FULL = 1,           ///< 240x240 - un pixel par pixel écran
+    HALF = 2,           ///< 120x120 - pixels 2x2 (28,8 Ko)
+    THIRD = 3           ///< 80x80 - pixels 3x3 (12,8 Ko)
+};
+
+/**
+ * @enum Field
+ * @brief Lignes envoyées par sendRegion (affichage entrelacé)
+ */
+enum class Field {
+    BOTH,               ///< Toutes les lignes
+    EVEN,               ///< Lignes paires seulement
+    ODD                 ///< Lignes impaires seulement
+};
+
 // ===== CLASSE PRINCIPALE =====
 
-class TFT {
+template <class Panel>
+class TFTRenderer {
 public:
+    // Dimensions natives du contrôleur (portrait, pleine résolution)
+    static constexpr int WIDTH = Panel::WIDTH;
+    static constexpr int HEIGHT = Panel::HEIGHT;
+    static constexpr int FB_SIZE_BYTES = WIDTH * HEIGHT * 2;
+    static constexpr int CLIP_STACK_DEPTH = 8;  ///< pushClip() imbriqués au plus
+
     // ===== CONSTRUCTEUR/DESTRUCTEUR =====
-    TFT();
-    ~TFT();
+    /**
+     * @brief Écran principal (broches TFTConfig, bus par défaut)
+     */
+    TFTRenderer();
+    /**
+     * @brief Écran n° panel d'un bus partagé (TFTBus::add_panel)
+     * @note Tous les écrans partagent le framebuffer statique: dessiner puis
+     *       envoyer un écran à la fois, ou passer par TFTBus::render_strips.
+     */
+    TFTRenderer(TFTBus* bus, uint8_t panel);
+    TFTBus* getBus() const { return bus; }
+    uint8_t getPanel() const { return panel; }
+    ~TFTRenderer();
 
     // ===== INITIALISATION =====
     /**
@@ -63,6 +103,12 @@ public:
      */
     void init();
 
+    /**
+     * @brief Écran rond: les coins du framebuffer ne sont pas visibles
+     */
+    static constexpr bool isRound() { return Panel::ROUND; }
+    static constexpr const char* getPanelName() { return Panel::NAME; }
+
     // ===== GESTION DU FRAMEBUFFER =====
     /**
      * @brief Remplit tout l'écran avec une couleur
@@ -96,7 +142,7 @@ public:
 
     /**
      * @brief Copie une frame complète RGB565 dans le framebuffer interne.
-     * @param src Pointeur vers les données source (taille attendue: TFTConfig::FB_SIZE_BYTES)
+     * @param src Pointeur vers les données source (taille attendue: FB_SIZE_BYTES)
      * @note Cette fonction n'envoie pas l'image à l'écran; appelez sendFrame() après blit.
      */
     void blitRGB565FullFrame(const uint8_t* src);
@@ -108,6 +154,50 @@ public:
     // Taille du framebuffer (en octets)
     size_t getFramebufferSize() const;
 
+    // ===== DÉCOUPAGE =====
+    /**
+     * @brief Limite le dessin à un rectangle (coordonnées écran)
+     * @note Remplace le découpage courant, intersecté avec l'écran seulement.
+     *       Changer de rotation ou de résolution rend tout l'écran.
+     */
+    void setClipRect(int x, int y, int w, int h);
+    /**
+     * @brief Tout l'écran, pile de découpage vidée
+     */
+    void resetClipRect();
+
+    /**
+     * @brief Restreint le découpage courant à un rectangle (coordonnées écran)
+     * @return false si la pile est pleine: rien n'est empilé, ne pas appeler popClip()
+     * @note Intersecté avec le découpage courant: une zone imbriquée ne
+     *       déborde jamais de celle qui la contient. Chaque primitive
+     *       découpe ses lignes une fois, pas chaque pixel.
+     */
+    bool pushClip(int x, int y, int w, int h);
+    /**
+     * @brief Revient au découpage d'avant le dernier pushClip()
+     */
+    void popClip();
+    int getClipDepth() const { return clip_depth; }
+
+    // ===== RÉSOLUTION RÉDUITE =====
+    /**
+     * @brief Change la résolution de dessin et efface l'image
+     * @param scale FULL, HALF (120x120) ou THIRD (80x80)
+     * @note Les primitives dessinent en coordonnées réduites (getScreenWidth/Height);
+     *       sendFrame/sendRegion répètent chaque pixel 2x2 ou 3x3 vers l'écran.
+     */
+    void setRenderScale(RenderScale scale);
+    RenderScale getRenderScale() const { return render_scale; }
+
+    /**
+     * @brief Partie du framebuffer inutilisée par la résolution courante
+     * @param size Reçoit la taille en octets (0 en pleine résolution)
+     * @return Début de la zone (alignée sur 4 octets), nullptr si aucune
+     * @note Valide jusqu'au prochain setRenderScale(FULL).
+     */
+    uint8_t* getSpareBuffer(size_t& size);
+
     // ===== PRIMITIVES DE DESSIN =====
     /**
      * @brief Dessine une ligne entre deux points
@@ -123,6 +213,65 @@ public:
      * @brief Dessine un rectangle rempli
      */
     void fillRect(int x, int y, int w, int h, uint16_t color);
+
+    /**
+     * @brief Ligne horizontale (w pixels) ou verticale (h pixels)
+     */
+    void drawHLine(int x, int y, int w, uint16_t color);
+    void drawVLine(int x, int y, int h, uint16_t color);
+
+    /**
+     * @brief Image 1 bit, pixels à 1 dans la couleur donnée, 0 transparents
+     * @param bits Lignes de (w + 7) / 8 octets, bit de poids fort à gauche
+     */
+    void drawBitmap(int x, int y, int w, int h, const uint8_t* bits, uint16_t color);
+
+    /**
+     * @brief Copie un bloc de pixels dans le framebuffer
+     * @param pixels w x h pixels RGB565, octets dans l'ordre du framebuffer
+     */
+    void blitRGB565(int x, int y, int w, int h, const uint16_t* pixels);
+
+    /**
+     * @brief Rectangle rempli d'un dégradé le long de l'axe (x0, y0) -> (x1, y1)
+     * @note color0 avant le premier point, color1 après le second
+     *       (Raster_Config::GRADIENT_STEPS teintes).
+     */
+    void fillLinearGradient(int x, int y, int w, int h,
+                            int x0, int y0, uint16_t color0, int x1, int y1, uint16_t color1);
+
+    /**
+     * @brief Rectangle rempli d'un dégradé circulaire
+     * @param inner Couleur au centre (xc, yc)
+     * @param outer Couleur à partir du rayon r
+     */
+    void fillRadialGradient(int x, int y, int w, int h, int xc, int yc, int r, uint16_t inner, uint16_t outer);
+
+    /**
+     * @brief Rectangle rempli d'un motif 8x8 répété
+     * @param pattern 8 octets, un par ligne, bit de poids fort à gauche
+     * @note Calé sur l'origine: deux zones voisines se raccordent.
+     */
+    void fillPattern(int x, int y, int w, int h, const uint8_t* pattern, uint16_t fg, uint16_t bg);
+
+    /**
+     * @brief Copie un Canvas dans le framebuffer
+     * @note Découpé comme les autres primitives; rien n'est envoyé à l'écran.
+     */
+    void drawCanvas(const Canvas& canvas, int x, int y);
+    /**
+     * @brief Copie un Canvas sauf les pixels de la couleur transparent
+     */
+    void drawCanvas(const Canvas& canvas, int x, int y, uint16_t transparent);
+
+    /**
+     * @brief Décale verticalement le contenu d'un rectangle du framebuffer
+     * @param dy Lignes de décalage (négatif: vers le haut)
+     * @note Coordonnées écran, limitées au découpage courant. La bande
+     *       découverte garde son ancien contenu: à redessiner par l'appelant.
+     *       Rien n'est envoyé à l'écran.
+     */
+    void scrollRect(int x, int y, int w, int h, int dy);
     
     /**
      * @brief Dessine le contour d'un cercle
@@ -144,8 +293,20 @@ public:
      * @param y y de départ
      * @param w largeur
      * @param h hauteur
+     * @param field Toutes les lignes, ou une sur deux (paires/impaires de l'écran)
+     * @note Toutes les lignes: une seule fenêtre. Une trame: colonnes envoyées
+     *       une fois, puis RASET + RAMWR par ligne (le contrôleur n'a pas de pas
+     *       de ligne)
+     */
+    void sendRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h, Field field = Field::BOTH);
+
+    /**
+     * @brief Active une transformation de couleur appliquée à l'envoi (gamma, luminosité...)
+     * @param transform Tables à utiliser, nullptr pour envoyer le framebuffer tel quel
+     * @note Le framebuffer n'est pas modifié; renvoyer la frame pour voir l'effet.
      */
-    void sendRegion(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void setColorTransform(const ColorTransform* transform);
+    const ColorTransform* getColorTransform() const { return color_transform; }
 
     // ===== GESTION DES POLICES =====
     /**
@@ -191,6 +352,14 @@ public:
      * @return Largeur totale en pixels
      */
     int getTextWidth(const char* text);
+
+    // ===== SURFACE (Raster.h) =====
+    /// Boîte (coordonnées de dessin) décalée du scroll et découpée; false si vide
+    bool clipBox(int x, int y, int w, int h, ClipRect& out) const;
+    uint16_t* surfaceRow(int y) { return reinterpret_cast<uint16_t*>(framebuffer) + y * screen_width; }
+    int surfaceStride() const { return screen_width; }
+    int originX() const { return scroll_x; }
+    int originY() const { return scroll_y; }
     
        // ===== GESTION DE LA ROTATION =====
     /**
@@ -271,31 +440,45 @@ private:
     // Framebuffer et affichage
     uint8_t* framebuffer;           ///< Buffer d'image en mémoire
     uint16_t fill_color;            ///< Couleur de remplissage par défaut
+    const ColorTransform* color_transform; ///< Transformation à l'envoi (nullptr: aucune)
    
     // Scroll et transformation
     int scroll_x, scroll_y;         ///< Décalages de scroll actuels
+    RenderScale render_scale;       ///< Résolution de dessin (pixels répétés à l'envoi)
     Rotation current_rotation;      ///< Rotation courante de l'écran
     int screen_width, screen_height; ///< Dimensions actuelles de l'écran
+    int clip_x0, clip_y0, clip_x1, clip_y1; ///< Zone de dessin (x1, y1 exclus)
+    ClipRect clip_stack[CLIP_STACK_DEPTH]; ///< Découpages sauvegardés par pushClip()
+    int clip_depth;
     
     // Police courante
     FontType current_font;          ///< Type de police actuellement sélectionnée
+
+    // Transport
+    TFTBus* bus;                    ///< Bus SPI partagé (CS/DC de l'écran)
+    uint8_t panel;                  ///< Index de l'écran sur le bus
     
     // Singleton instance not required (no DMA callbacks)
+
+    // Framebuffer statique (un par contrôleur instancié) et ligne transformée
+    // en attente d'envoi (transformation de couleur, résolution réduite)
+    static uint8_t frame_storage[FB_SIZE_BYTES];
+    static uint16_t row_storage[WIDTH > HEIGHT ? WIDTH : HEIGHT];
     
     // ===== MÉTHODES PRIVÉES =====
     
     // Initialisation
-    void initGPIO();                ///< Configuration des GPIO
-    void initSPI();                 ///< Configuration du SPI
     void initFramebuffer();         ///< Allocation du framebuffer
     // DMA no longer used. Send frame implemented using blocking SPI.
-    void initSequence();            ///< Séquence d'initialisation LCD
+    void initSequence();            ///< Séquence d'initialisation LCD (Panel::INIT)
     
     // Communication SPI
     void writeCmd(const uint8_t* cmd, size_t len);
     void writeData(const uint8_t* data, size_t len);
     void cmdWithData(const uint8_t cmd, const uint8_t* data, size_t datalen);
     void setWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+    void writePixels(const uint16_t* pixels, size_t count); ///< Envoi (transformé si besoin)
+    void writeScaledRow(const uint16_t* pixels, size_t count); ///< Envoi d'une ligne réduite, répétée
     
     // (DMA removed) IRQ/Handler removed
     
@@ -304,16 +487,18 @@ private:
     int getFontWidth();             ///< Largeur de référence de la police
     int getFontHeight();            ///< Hauteur de la police courante
     
-    // Police Arial32 - Méthodes spécialisées
-    const arial_S32_CharInfo& getArialCharInfo(char c); ///< Info d'un caractère Arial32
-    void drawArialChar(int x, int y, char c, uint16_t color); ///< Rendu Arial32
-    
       
     // Rotation et transformation
     void updateScreenDimensions();  ///< Met à jour les dimensions après rotation
     void transformCoordinates(int& x, int& y) const; ///< Transforme les coordonnées selon rotation
+    void applyWindowFormat();       ///< Commandes de fenêtre et décalage de la rotation courante
 };
 
+/**
+ * @brief Renderer du contrôleur monté (TFTConfig::Panel)
+ */
+using TFT = TFTRenderer<TFTConfig::Panel>;
+
 // ===== CONSTANTES ET MACROS =====
 
 /**
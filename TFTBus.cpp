@@ -0,0 +1,182 @@
+#include "TFTBus.h"
+#include "main.h"
+#include "hardware/spi.h"
+#include "hardware/gpio.h"
+
+/*******************************************************
+ * Nom du fichier : TFTBus.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : plusieurs écrans sur spi0 (CS/DC séparés)
+ *******************************************************/
+
+using namespace TFTBus_Config;
+
+// Bande en cours d'envoi (render_strips)
+static uint16_t g_strip[TFTConfig::WIDTH * STRIP_ROWS];
+
+TFTBus::TFTBus() : panel_count(0), spi_ready(false), last_panel(-1) {
+    for (uint8_t i = 0; i < MAX_PANELS; ++i) reset_done[i] = false;
+}
+
+TFTBus& TFTBus::default_bus() {
+    static TFTBus bus;
+    if (bus.panel_count == 0) {
+        bus.add_panel(TFTPins{(uint8_t)TFTConfig::PIN_CS, (uint8_t)TFTConfig::PIN_DC, (uint8_t)TFTConfig::PIN_RST});
+    }
+    return bus;
+}
+
+int8_t TFTBus::add_panel(const TFTPins& panel_pins) {
+    if (panel_count >= MAX_PANELS) {
+        printf("TFTBus: %u écrans au plus\n", MAX_PANELS);
+        return -1;
+    }
+    pins[panel_count] = panel_pins;
+    windows[panel_count] = TFTWindow{0x2A, 0x2B, 0x2C, 0, 0};
+    reset_done[panel_count] = false;
+    return (int8_t)panel_count++;
+}
+
+void TFTBus::set_window_format(uint8_t panel, const TFTWindow& window) {
+    if (panel >= panel_count) return;
+    windows[panel] = window;
+}
+
+void TFTBus::init_panel(uint8_t panel) {
+    if (panel >= panel_count) return;
+    const TFTPins& p = pins[panel];
+    gpio_init(p.dc);
+    gpio_set_dir(p.dc, GPIO_OUT);
+    gpio_init(p.cs);
+    gpio_set_dir(p.cs, GPIO_OUT);
+    gpio_put(p.cs, 1);
+
+    if (!spi_ready) {
+        spi_init(spi0, TFTConfig::SPI_BAUDRATE);
+        spi_set_format(spi0, 8, SPI_CPOL_0, SPI_CPHA_0, SPI_MSB_FIRST);
+        gpio_set_function(TFTConfig::PIN_SCK, GPIO_FUNC_SPI);
+        gpio_set_function(TFTConfig::PIN_MOSI, GPIO_FUNC_SPI);
+        spi_ready = true;
+    }
+
+    if (reset_done[panel]) return;
+    // Reset sequence (une fois par broche RST)
+    gpio_init(p.rst);
+    gpio_set_dir(p.rst, GPIO_OUT);
+    gpio_put(p.rst, 0);
+    sleep_ms(20);
+    gpio_put(p.rst, 1);
+    sleep_ms(20);
+    for (uint8_t i = 0; i < panel_count; ++i) {
+        if (pins[i].rst == p.rst) reset_done[i] = true;
+    }
+}
+
+void TFTBus::select(uint8_t panel, bool data) {
+    // S'assurer que le bus SPI est à pleine vitesse pour l'écran (partagé avec la carte SD)
+    spi_set_baudrate(spi0, TFTConfig::SPI_BAUDRATE);
+    if (last_panel != (int8_t)panel) {
+        if (last_panel >= 0) stats.switches++;
+        last_panel = (int8_t)panel;
+    }
+    gpio_put(pins[panel].dc, data ? 1 : 0);
+    gpio_put(pins[panel].cs, 0);
+}
+
+void TFTBus::deselect(uint8_t panel) {
+    gpio_put(pins[panel].cs, 1);
+}
+
+void TFTBus::command(uint8_t panel, uint8_t cmd) {
+    if (panel >= panel_count) return;
+    select(panel, false);
+    spi_write_blocking(spi0, &cmd, 1);
+    deselect(panel);
+}
+
+void TFTBus::data(uint8_t panel, const uint8_t* bytes, size_t len) {
+    if (panel >= panel_count || len == 0) return;
+    select(panel, true);
+    spi_write_blocking(spi0, bytes, len);
+    deselect(panel);
+}
+
+void TFTBus::set_window(uint8_t panel, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    if (panel >= panel_count) return;
+    const TFTWindow& w = windows[panel];
+    x0 += w.x_offset; x1 += w.x_offset;
+    y0 += w.y_offset; y1 += w.y_offset;
+    uint8_t buf[4];
+
+    // Colonne
+    buf[0] = (x0 >> 8) & 0xFF;
+    buf[1] = x0 & 0xFF;
+    buf[2] = (x1 >> 8) & 0xFF;
+    buf[3] = x1 & 0xFF;
+    command(panel, w.caset);
+    data(panel, buf, 4);
+
+    // Ligne
+    buf[0] = (y0 >> 8) & 0xFF;
+    buf[1] = y0 & 0xFF;
+    buf[2] = (y1 >> 8) & 0xFF;
+    buf[3] = y1 & 0xFF;
+    command(panel, w.raset);
+    data(panel, buf, 4);
+}
+
+void TFTBus::begin_pixels(uint8_t panel) {
+    if (panel >= panel_count) return;
+    command(panel, windows[panel].ramwr);
+    select(panel, true);
+}
+
+void TFTBus::write(uint8_t panel, const uint8_t* bytes, size_t len) {
+    (void)panel;   // l'écran est déjà sélectionné par begin_pixels
+    spi_write_blocking(spi0, bytes, len);
+    stats.pixel_bytes += len;
+}
+
+void TFTBus::end_pixels(uint8_t panel) {
+    if (panel >= panel_count) return;
+    deselect(panel);
+}
+
+void TFTBus::begin_rows(uint8_t panel, uint16_t y0, uint16_t y1) {
+    if (panel >= panel_count) return;
+    const TFTWindow& w = windows[panel];
+    y0 += w.y_offset; y1 += w.y_offset;
+    const uint8_t rows[4] = {(uint8_t)(y0 >> 8), (uint8_t)y0, (uint8_t)(y1 >> 8), (uint8_t)y1};
+
+    // RASET, ses 4 octets et RAMWR sous le même CS: seule DC change
+    // (spi_write_blocking rend la main une fois les octets sortis)
+    select(panel, false);
+    spi_write_blocking(spi0, &w.raset, 1);
+    gpio_put(pins[panel].dc, 1);
+    spi_write_blocking(spi0, rows, 4);
+    gpio_put(pins[panel].dc, 0);
+    spi_write_blocking(spi0, &w.ramwr, 1);
+    gpio_put(pins[panel].dc, 1);
+}
+
+void TFTBus::render_strips(uint8_t panel_mask, uint16_t width, uint16_t height, StripFunction fn, void* context,
+                           uint16_t rows) {
+    if (!fn || width == 0 || width > TFTConfig::WIDTH || height == 0) return;
+    const uint16_t max_rows = (uint16_t)(sizeof(g_strip) / sizeof(g_strip[0]) / width);
+    if (rows == 0 || rows > max_rows) rows = max_rows;
+
+    // Bande y de chaque écran, puis bande suivante: les écrans avancent ensemble
+    for (uint16_t y = 0; y < height; y += rows) {
+        const uint16_t n = (height - y < rows) ? (uint16_t)(height - y) : rows;
+        for (uint8_t panel = 0; panel < panel_count; ++panel) {
+            if (!(panel_mask & (1u << panel))) continue;
+            fn(panel, y, n, g_strip, context);
+            set_window(panel, 0, y, width - 1, y + n - 1);
+            begin_pixels(panel);
+            write(panel, reinterpret_cast<const uint8_t*>(g_strip), (size_t)width * n * 2);
+            end_pixels(panel);
+            stats.strips++;
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+/*
+ * TFTBus - Transport SPI partagé par plusieurs écrans
+ *
+ * Tous les écrans sont sur spi0 (SCK/MOSI communs), chacun avec ses
+ * broches CS et DC; la broche RST peut être commune. Un seul CS est bas
+ * à la fois. Chaque TFT désigne son écran par un index sur le bus et
+ * n'envoie rien lui-même. Les commandes de fenêtre et le décalage en RAM
+ * de chaque écran (TFTWindow) sont fixés par son TFTRenderer d'après
+ * PanelTraits: des contrôleurs différents peuvent partager le bus.
+ *
+ * render_strips() met à jour plusieurs écrans à la fois sans framebuffer
+ * par écran: une fonction remplit une bande de lignes dans un tampon
+ * unique, envoyée aussitôt, en alternant les écrans bande par bande
+ * (écran 0 bande 0, écran 1 bande 0, écran 0 bande 1...). Aucun écran
+ * n'attend la fin de l'image de l'autre.
+ */
+
+#include "pico/stdlib.h"
+#include <cstddef>
+
+namespace TFTBus_Config {
+    static constexpr uint8_t MAX_PANELS = 2;
+    static constexpr uint16_t STRIP_ROWS = 8;          // tampon de bande: 240 x 8 pixels (3,75 Ko)
+}
+
+struct TFTPins {
+    uint8_t cs;
+    uint8_t dc;
+    uint8_t rst;
+};
+
+// Commandes de fenêtre et décalage de la zone visible en RAM (PanelTraits)
+struct TFTWindow {
+    uint8_t caset;
+    uint8_t raset;
+    uint8_t ramwr;
+    uint16_t x_offset;
+    uint16_t y_offset;
+};
+
+struct TFTBusStats {
+    uint32_t strips;           // bandes envoyées par render_strips
+    uint32_t switches;         // changements d'écran sélectionné
+    uint32_t pixel_bytes;      // octets de pixels envoyés
+
+    TFTBusStats() : strips(0), switches(0), pixel_bytes(0) {}
+};
+
+class TFTBus {
+public:
+    // Remplit rows lignes (à partir de y) de l'écran panel: rows * 240 pixels
+    // RGB565 gros-boutiens (format du framebuffer)
+    typedef void (*StripFunction)(uint8_t panel, uint16_t y, uint16_t rows, uint16_t* pixels, void* context);
+
+private:
+    TFTPins pins[TFTBus_Config::MAX_PANELS];
+    TFTWindow windows[TFTBus_Config::MAX_PANELS];
+    bool reset_done[TFTBus_Config::MAX_PANELS];
+    uint8_t panel_count;
+    bool spi_ready;
+    int8_t last_panel;         // dernier écran sélectionné (statistique)
+    TFTBusStats stats;
+
+    void select(uint8_t panel, bool data);
+    void deselect(uint8_t panel);
+
+public:
+    TFTBus();
+
+    // Ajoute un écran; retourne son index, -1 si le bus est plein
+    int8_t add_panel(const TFTPins& panel_pins);
+    uint8_t get_panel_count() const { return panel_count; }
+    // Commandes de fenêtre de l'écran (par défaut 0x2A/0x2B/0x2C, sans décalage)
+    void set_window_format(uint8_t panel, const TFTWindow& window);
+
+    // GPIO de l'écran (et SPI au premier appel), puis reset matériel; un RST
+    // commun n'est actionné qu'une fois pour tous les écrans qui le partagent
+    void init_panel(uint8_t panel);
+
+    // Commande seule (DC bas), données seules (DC haut)
+    void command(uint8_t panel, uint8_t cmd);
+    void data(uint8_t panel, const uint8_t* bytes, size_t len);
+    // Fenêtre en coordonnées visibles (le décalage en RAM est ajouté)
+    void set_window(uint8_t panel, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
+
+    // Écriture mémoire (RAMWR) dans la fenêtre courante: begin, write..., end
+    void begin_pixels(uint8_t panel);
+    void write(uint8_t panel, const uint8_t* bytes, size_t len);
+    void end_pixels(uint8_t panel);
+    // Nouvelle plage de lignes (colonnes de la fenêtre courante conservées)
+    // puis début d'écriture, sous une seule sélection: lignes non contiguës
+    // (trames entrelacées) sans renvoyer toute la fenêtre. Terminer par end_pixels
+    void begin_rows(uint8_t panel, uint16_t y0, uint16_t y1);
+
+    // Image entière (width x height) des écrans de panel_mask, bande par bande
+    // en alternant les écrans
+    void render_strips(uint8_t panel_mask, uint16_t width, uint16_t height, StripFunction fn, void* context,
+                       uint16_t rows = TFTBus_Config::STRIP_ROWS);
+
+    const TFTBusStats& get_stats() const { return stats; }
+    void reset_stats() { stats = TFTBusStats(); }
+
+    // Bus de l'écran principal (broches TFTConfig), utilisé par TFT()
+    static TFTBus& default_bus();
+};
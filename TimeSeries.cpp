@@ -0,0 +1,390 @@
+#include "TimeSeries.h"
+#include "FAT32.h"
+#include "BufferedWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+
+/*******************************************************
+ * Nom du fichier : TimeSeries.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : historique DHT11 par paliers (brut, minute, heure)
+ *******************************************************/
+
+using namespace TS_Config;
+
+static constexpr uint32_t MINUTE = 60;
+static constexpr uint32_t HOUR = 3600;
+
+// Moyenne arrondie au plus proche (sommes négatives comprises)
+static int32_t rounded_div(int32_t sum, uint32_t count) {
+    const int32_t c = (int32_t)count;
+    return (sum >= 0) ? (sum + c / 2) / c : -((-sum + c / 2) / c);
+}
+
+// ============================================================================
+// Agrégats
+// ============================================================================
+
+void TimeSeries::Accumulator::add(int16_t t, uint16_t h, uint32_t n) {
+    if (count == 0) {
+        t_min = t_max = t;
+        h_min = h_max = h;
+    } else {
+        if (t < t_min) t_min = t;
+        if (t > t_max) t_max = t;
+        if (h < h_min) h_min = h;
+        if (h > h_max) h_max = h;
+    }
+    t_sum += (int32_t)t * (int32_t)n;
+    h_sum += (int32_t)h * (int32_t)n;
+    count += n;
+}
+
+void TimeSeries::Accumulator::merge(const Accumulator& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        t_min = other.t_min; t_max = other.t_max;
+        h_min = other.h_min; h_max = other.h_max;
+    } else {
+        if (other.t_min < t_min) t_min = other.t_min;
+        if (other.t_max > t_max) t_max = other.t_max;
+        if (other.h_min < h_min) h_min = other.h_min;
+        if (other.h_max > h_max) h_max = other.h_max;
+    }
+    t_sum += other.t_sum;
+    h_sum += other.h_sum;
+    count += other.count;
+}
+
+void TimeSeries::Accumulator::to_record(TSAggregate& out) const {
+    out.start = bucket;
+    out.count = (uint16_t)(count > 0xFFFF ? 0xFFFF : count);
+    out.t_min = t_min;
+    out.t_max = t_max;
+    out.t_mean = (int16_t)rounded_div(t_sum, count);
+    // dixièmes -> demi-pourcents
+    out.h_min = (uint8_t)((h_min + 2) / 5);
+    out.h_max = (uint8_t)((h_max + 2) / 5);
+    out.h_mean = (uint8_t)rounded_div(h_sum, count * 5);
+    out.magic = AGGREGATE_MAGIC;
+}
+
+// ============================================================================
+// Anneaux
+// ============================================================================
+
+TimeSeries::TimeSeries()
+    : fs(nullptr), mounted(false), clock_base(1), clock_origin_ms(0), cached_sector(-1) {
+    const uint16_t first[3] = {0, RAW_SECTORS, RAW_SECTORS + MINUTE_SECTORS};
+    const uint16_t sectors[3] = {RAW_SECTORS, MINUTE_SECTORS, HOUR_SECTORS};
+    const uint8_t sizes[3] = {sizeof(TSSample), sizeof(TSAggregate), sizeof(TSAggregate)};
+    for (uint8_t i = 0; i < 3; ++i) {
+        rings[i].first_sector = first[i];
+        rings[i].sectors = sectors[i];
+        rings[i].record_size = sizes[i];
+        rings[i].head = rings[i].count = rings[i].last_time = 0;
+        rings[i].tail_sector = -1;
+    }
+    minute_acc.reset();
+    hour_acc.reset();
+}
+
+uint32_t TimeSeries::record_time(TS_Tier, const uint8_t* record) {
+    // time / start en tête des deux formats
+    uint32_t t;
+    memcpy(&t, record, sizeof(t));
+    return t;
+}
+
+bool TimeSeries::record_valid(TS_Tier tier, const uint8_t* record) {
+    if (tier == TS_RAW) {
+        const uint32_t t = record_time(tier, record);
+        return t != 0 && t != 0xFFFFFFFFu;
+    }
+    const TSAggregate* a = reinterpret_cast<const TSAggregate*>(record);
+    return a->magic == AGGREGATE_MAGIC && a->count > 0;
+}
+
+const uint8_t* TimeSeries::read_record(TS_Tier tier, uint32_t slot) {
+    Ring& r = rings[tier];
+    const uint32_t per_sector = 512u / r.record_size;
+    const int32_t s = (int32_t)(slot / per_sector);
+    const uint32_t offset = (slot % per_sector) * r.record_size;
+    if (s == r.tail_sector) return r.tail + offset;
+
+    const int32_t absolute = r.first_sector + s;
+    if (absolute != cached_sector) {
+        if (!fs->read_file_sector(clusters, (uint32_t)absolute, sector)) {
+            cached_sector = -1;
+            return nullptr;
+        }
+        cached_sector = absolute;
+        stats.sector_reads++;
+    }
+    return sector + offset;
+}
+
+bool TimeSeries::append(TS_Tier tier, const void* record) {
+    Ring& r = rings[tier];
+    const uint32_t per_sector = 512u / r.record_size;
+    const int32_t s = (int32_t)(r.head / per_sector);
+    const uint32_t offset = (r.head % per_sector) * r.record_size;
+    const uint32_t absolute = r.first_sector + (uint32_t)s;
+
+    if (s != r.tail_sector) {
+        // Secteur suivant de l'anneau: ses enregistrements les plus anciens
+        // restent lisibles jusqu'à être remplacés un à un
+        if (!fs->read_file_sector(clusters, absolute, r.tail)) return false;
+        stats.sector_reads++;
+        r.tail_sector = s;
+        if (cached_sector == (int32_t)absolute) cached_sector = -1;
+    }
+    memcpy(r.tail + offset, record, r.record_size);
+    if (!fs->write_file_sector(clusters, absolute, r.tail)) return false;
+    stats.sector_writes++;
+
+    r.head = (r.head + 1) % r.capacity();
+    if (r.count < r.capacity()) r.count++;
+    r.last_time = record_time(tier, static_cast<const uint8_t*>(record));
+    return true;
+}
+
+bool TimeSeries::scan(TS_Tier tier) {
+    Ring& r = rings[tier];
+    const uint32_t per_sector = 512u / r.record_size;
+    uint32_t newest_slot = 0;
+    bool found = false;
+    r.count = 0;
+    r.last_time = 0;
+    r.tail_sector = -1;
+
+    for (uint32_t s = 0; s < r.sectors; ++s) {
+        if (!fs->read_file_sector(clusters, r.first_sector + s, sector)) return false;
+        stats.sector_reads++;
+        for (uint32_t i = 0; i < per_sector; ++i) {
+            const uint8_t* record = sector + i * r.record_size;
+            if (!record_valid(tier, record)) continue;
+            r.count++;
+            const uint32_t t = record_time(tier, record);
+            if (!found || t > r.last_time) {
+                r.last_time = t;
+                newest_slot = s * per_sector + i;
+                found = true;
+            }
+        }
+    }
+    cached_sector = -1;
+    r.head = found ? (newest_slot + 1) % r.capacity() : 0;
+    return true;
+}
+
+uint32_t TimeSeries::locate(TS_Tier tier, uint32_t since) {
+    Ring& r = rings[tier];
+    const uint32_t cap = r.capacity();
+    uint32_t n = 0;
+    uint32_t previous = 0xFFFFFFFFu;
+    while (n < r.count) {
+        const uint8_t* record = read_record(tier, (r.head + cap - 1 - n) % cap);
+        if (!record || !record_valid(tier, record)) break;
+        const uint32_t t = record_time(tier, record);
+        // Horodatages décroissants à rebours: sinon fin de la partie valide
+        if (t < since || t >= previous) break;
+        previous = t;
+        n++;
+    }
+    return n;
+}
+
+uint16_t TimeSeries::collect(TS_Tier tier, uint32_t since, uint8_t* out, uint16_t max) {
+    if (!mounted || !out || max == 0) return 0;
+    Ring& r = rings[tier];
+    const uint32_t cap = r.capacity();
+    uint16_t n = 0;
+    uint32_t previous = 0xFFFFFFFFu;
+    // Du plus récent au plus ancien, rangés depuis la fin de out
+    while (n < max && n < r.count) {
+        const uint8_t* record = read_record(tier, (r.head + cap - 1 - n) % cap);
+        if (!record || !record_valid(tier, record)) break;
+        const uint32_t t = record_time(tier, record);
+        if (t < since || t >= previous) break;
+        previous = t;
+        memcpy(out + (uint32_t)(max - 1 - n) * r.record_size, record, r.record_size);
+        n++;
+    }
+    if (n < max) memmove(out, out + (uint32_t)(max - n) * r.record_size, (uint32_t)n * r.record_size);
+    return n;
+}
+
+// ============================================================================
+// Agrégation
+// ============================================================================
+
+void TimeSeries::aggregate(const TSSample& sample) {
+    const uint32_t minute = sample.time / MINUTE * MINUTE;
+    if (minute_acc.count && minute_acc.bucket != minute) close_minute();
+    if (hour_acc.count && hour_acc.bucket != sample.time / HOUR * HOUR) close_hour();
+    if (minute_acc.count == 0) minute_acc.bucket = minute;
+    minute_acc.add(sample.temperature, sample.humidity);
+}
+
+void TimeSeries::close_minute() {
+    TSAggregate record;
+    minute_acc.to_record(record);
+    if (append(TS_MINUTE, &record)) stats.minutes++;
+    feed_hour(minute_acc);
+    minute_acc.reset();
+}
+
+void TimeSeries::feed_hour(const Accumulator& minute) {
+    const uint32_t hour = minute.bucket / HOUR * HOUR;
+    if (hour_acc.count && hour_acc.bucket != hour) close_hour();
+    if (hour_acc.count == 0) hour_acc.bucket = hour;
+    hour_acc.merge(minute);
+}
+
+void TimeSeries::close_hour() {
+    TSAggregate record;
+    hour_acc.to_record(record);
+    if (append(TS_HOUR, &record)) stats.hours++;
+    hour_acc.reset();
+}
+
+bool TimeSeries::rebuild() {
+    minute_acc.reset();
+    hour_acc.reset();
+
+    // Minutes closes de l'heure en cours (sommes reconstituées depuis les
+    // moyennes: l'heure reprise après un redémarrage est arrondie)
+    const Ring& hours = rings[TS_HOUR];
+    uint32_t since = hours.count ? hours.last_time + HOUR : 0;
+    uint32_t n = locate(TS_MINUTE, since);
+    Ring& minutes = rings[TS_MINUTE];
+    for (uint32_t j = 0; j < n; ++j) {
+        const uint8_t* record = read_record(TS_MINUTE, (minutes.head + minutes.capacity() - n + j) % minutes.capacity());
+        if (!record) return false;
+        TSAggregate a;
+        memcpy(&a, record, sizeof(a));
+        Accumulator m;
+        m.reset();
+        m.bucket = a.start;
+        m.count = a.count;
+        m.t_sum = (int32_t)a.t_mean * a.count;
+        m.h_sum = (int32_t)a.h_mean * 5 * a.count;
+        m.t_min = a.t_min; m.t_max = a.t_max;
+        m.h_min = (uint16_t)(a.h_min * 5); m.h_max = (uint16_t)(a.h_max * 5);
+        feed_hour(m);
+    }
+
+    // Mesures pas encore agrégées: rejouées comme à leur arrivée
+    since = minutes.count ? minutes.last_time + MINUTE : 0;
+    Ring& raw = rings[TS_RAW];
+    n = locate(TS_RAW, since);
+    for (uint32_t j = 0; j < n; ++j) {
+        const uint8_t* record = read_record(TS_RAW, (raw.head + raw.capacity() - n + j) % raw.capacity());
+        if (!record) return false;
+        TSSample sample;
+        memcpy(&sample, record, sizeof(sample));
+        aggregate(sample);
+    }
+    return true;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+bool TimeSeries::open(FAT32* filesystem, const char* path) {
+    fs = filesystem;
+    mounted = false;
+    cached_sector = -1;
+    if (!fs || !fs->is_initialized() || fs->is_exfat() || !path) return false;
+
+    const uint32_t file_bytes = FILE_SECTORS * 512u;
+    uint32_t size = 0;
+    if (!fs->get_file_clusters(path, clusters, size) || size < file_bytes) {
+        // Création et préallocation: un fichier nul ne contient aucun enregistrement
+        BufferedWriter out(fs);
+        FAT_ErrorCode r = out.open(path, OVERWRITE, file_bytes);
+        if (r != FILE_CREATE_OK && r != FILE_FOUND) return false;
+        memset(sector, 0, sizeof(sector));
+        bool ok = true;
+        for (uint32_t i = 0; ok && i < FILE_SECTORS; ++i) ok = out.write(sector, sizeof(sector));
+        ok = out.close() && ok;
+        if (!ok || !fs->get_file_clusters(path, clusters, size)) {
+            printf("TimeSeries: impossible de préallouer %s\n", path);
+            return false;
+        }
+    }
+
+    for (uint8_t t = 0; t < 3; ++t) {
+        if (!scan(static_cast<TS_Tier>(t))) return false;
+    }
+    if (!rebuild()) return false;
+
+    // L'horloge reprend après la mesure la plus récente
+    clock_base = rings[TS_RAW].last_time + 1;
+    clock_origin_ms = to_ms_since_boot(get_absolute_time());
+    mounted = true;
+    printf("TimeSeries: %lu mesure(s), %lu minute(s), %lu heure(s)\n",
+           (unsigned long)rings[TS_RAW].count, (unsigned long)rings[TS_MINUTE].count,
+           (unsigned long)rings[TS_HOUR].count);
+    return true;
+}
+
+uint32_t TimeSeries::now() const {
+    return clock_base + (to_ms_since_boot(get_absolute_time()) - clock_origin_ms) / 1000u;
+}
+
+uint32_t TimeSeries::window_start(uint16_t hours) const {
+    const uint32_t hour = now() / 3600u;
+    const uint32_t back = hours ? hours - 1u : 0u;
+    return (hour > back ? hour - back : 0u) * 3600u;
+}
+
+bool TimeSeries::ingest(float temperature, float humidity) {
+    return ingest_at(now(), (int16_t)lroundf(temperature * 10.0f), (uint16_t)lroundf(humidity * 10.0f));
+}
+
+bool TimeSeries::ingest_at(uint32_t time, int16_t temperature, uint16_t humidity) {
+    if (!mounted) return false;
+    if (time == 0 || time == 0xFFFFFFFFu || (rings[TS_RAW].count && time <= rings[TS_RAW].last_time)) {
+        stats.rejected++;
+        return false;
+    }
+    TSSample sample;
+    sample.time = time;
+    sample.temperature = temperature;
+    sample.humidity = humidity;
+    if (!append(TS_RAW, &sample)) return false;
+    stats.samples++;
+    aggregate(sample);
+    return true;
+}
+
+uint16_t TimeSeries::query(TS_Tier tier, uint32_t since, TSAggregate* out, uint16_t max) {
+    if (tier == TS_RAW) return 0;
+    return collect(tier, since, reinterpret_cast<uint8_t*>(out), max);
+}
+
+uint16_t TimeSeries::query_raw(uint32_t since, TSSample* out, uint16_t max) {
+    return collect(TS_RAW, since, reinterpret_cast<uint8_t*>(out), max);
+}
+
+bool TimeSeries::current(TS_Tier tier, TSAggregate& out) const {
+    if (tier == TS_MINUTE) {
+        if (minute_acc.count == 0) return false;
+        minute_acc.to_record(out);
+        return true;
+    }
+    if (tier != TS_HOUR) return false;
+    Accumulator a = hour_acc;
+    if (minute_acc.count) {
+        if (a.count == 0) a.bucket = minute_acc.bucket / HOUR * HOUR;
+        a.merge(minute_acc);
+    }
+    if (a.count == 0) return false;
+    a.to_record(out);
+    return true;
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+/*
+ * TimeSeries - Historique des mesures du DHT11 sur la carte SD
+ *
+ * Trois paliers de taille fixe dans un seul fichier préalloué, chacun
+ * géré en anneau: mesures brutes, agrégats par minute et par heure
+ * (min/moyenne/max de la température et de l'humidité). L'agrégation est
+ * faite à l'arrivée de chaque mesure: une minute est close à la première
+ * mesure de la minute suivante, une heure de même. Une courbe sur 24 h ne
+ * lit que 24 agrégats horaires (384 octets), jamais les mesures brutes.
+ *
+ * Un palier est une suite d'enregistrements de taille puissance de 2 (ils
+ * ne chevauchent pas deux secteurs), horodatés en secondes et strictement
+ * croissants: au montage, la tête de chaque anneau est retrouvée par le
+ * plus grand horodatage, et les mesures pas encore agrégées sont rejouées.
+ *
+ * Sans horloge temps réel, le temps est compté en secondes depuis la
+ * première mesure enregistrée et continue après un redémarrage.
+ */
+
+#include "pico/stdlib.h"
+#include <vector>
+
+// Forward declaration
+class FAT32;
+
+namespace TS_Config {
+    static constexpr const char* DEFAULT_PATH = "/SENSORS.TS";
+    static constexpr uint16_t RAW_SECTORS = 32;        // 2048 mesures (~68 min à 2 s)
+    static constexpr uint16_t MINUTE_SECTORS = 48;     // 1536 minutes (25,6 h)
+    static constexpr uint16_t HOUR_SECTORS = 24;       // 768 heures (32 jours)
+    static constexpr uint32_t FILE_SECTORS = RAW_SECTORS + MINUTE_SECTORS + HOUR_SECTORS;
+    static constexpr uint32_t SAMPLE_PERIOD_MS = 10000; // échantillonnage en tâche de fond
+    static constexpr uint8_t  AGGREGATE_MAGIC = 0xA5;
+}
+
+// Mesure brute: température en dixièmes de °C, humidité en dixièmes de %
+struct TSSample {
+    uint32_t time;
+    int16_t  temperature;
+    uint16_t humidity;
+} __attribute__((packed));
+
+// Agrégat d'une minute ou d'une heure; humidité en demi-pourcents
+// (la résolution du DHT11 est de 1 %)
+struct TSAggregate {
+    uint32_t start;            // début de la période (secondes)
+    uint16_t count;            // mesures agrégées
+    int16_t  t_min;
+    int16_t  t_mean;
+    int16_t  t_max;
+    uint8_t  h_min;
+    uint8_t  h_mean;
+    uint8_t  h_max;
+    uint8_t  magic;
+} __attribute__((packed));
+
+enum TS_Tier {
+    TS_RAW = 0,
+    TS_MINUTE = 1,
+    TS_HOUR = 2
+};
+
+struct TSStats {
+    uint32_t samples;
+    uint32_t minutes;          // agrégats écrits
+    uint32_t hours;
+    uint32_t rejected;         // horodatage non croissant
+    uint32_t sector_reads;
+    uint32_t sector_writes;
+
+    TSStats() : samples(0), minutes(0), hours(0), rejected(0), sector_reads(0), sector_writes(0) {}
+};
+
+class TimeSeries {
+private:
+    struct Ring {
+        uint16_t first_sector; // dans le fichier
+        uint16_t sectors;
+        uint8_t  record_size;
+        uint32_t head;         // prochain emplacement écrit
+        uint32_t count;        // enregistrements valides
+        uint32_t last_time;    // horodatage du plus récent
+        int32_t  tail_sector;  // secteur (relatif) chargé dans tail, -1 si aucun
+        uint8_t  tail[512];
+
+        uint32_t capacity() const { return (uint32_t)sectors * (512u / record_size); }
+    };
+
+    // Agrégat en cours: sommes exactes en RAM
+    struct Accumulator {
+        uint32_t bucket;
+        uint32_t count;
+        int32_t  t_sum;
+        int32_t  h_sum;        // dixièmes de %
+        int16_t  t_min, t_max;
+        uint16_t h_min, h_max;
+
+        void reset() { bucket = 0; count = 0; t_sum = 0; h_sum = 0; t_min = t_max = 0; h_min = h_max = 0; }
+        void add(int16_t t, uint16_t h, uint32_t n = 1);
+        void merge(const Accumulator& other);
+        void to_record(TSAggregate& out) const;
+    };
+
+    FAT32* fs;
+    std::vector<uint32_t> clusters;
+    bool mounted;
+    Ring rings[3];
+    Accumulator minute_acc;
+    Accumulator hour_acc;
+    uint32_t clock_base;       // horodatage à clock_origin_ms
+    uint32_t clock_origin_ms;
+    uint8_t  sector[512];      // dernier secteur lu (hors queues)
+    int32_t  cached_sector;    // index absolu dans le fichier, -1 si aucun
+    TSStats  stats;
+
+    static uint32_t record_time(TS_Tier tier, const uint8_t* record);
+    static bool record_valid(TS_Tier tier, const uint8_t* record);
+
+    const uint8_t* read_record(TS_Tier tier, uint32_t slot);
+    bool append(TS_Tier tier, const void* record);
+    bool scan(TS_Tier tier);
+    // Nombre d'enregistrements les plus récents d'horodatage >= since
+    uint32_t locate(TS_Tier tier, uint32_t since);
+    // Copie les max plus récents (>= since) dans l'ordre chronologique,
+    // en une seule passe à rebours
+    uint16_t collect(TS_Tier tier, uint32_t since, uint8_t* out, uint16_t max);
+
+    void aggregate(const TSSample& sample);
+    void close_minute();
+    void feed_hour(const Accumulator& minute);
+    void close_hour();
+    bool rebuild();
+
+public:
+    TimeSeries();
+
+    // Ouvre (ou crée et préalloue) le fichier puis reprend les agrégats en cours
+    bool open(FAT32* filesystem, const char* path = TS_Config::DEFAULT_PATH);
+    bool is_open() const { return mounted; }
+
+    // Mesure horodatée par l'horloge interne
+    bool ingest(float temperature, float humidity);
+    // Mesure horodatée (secondes, strictement croissantes); valeurs en dixièmes
+    bool ingest_at(uint32_t time, int16_t temperature, uint16_t humidity);
+
+    // Au plus max agrégats clos les plus récents d'horodatage >= since,
+    // du plus ancien au plus récent. Retourne le nombre copié.
+    uint16_t query(TS_Tier tier, uint32_t since, TSAggregate* out, uint16_t max);
+    uint16_t query_raw(uint32_t since, TSSample* out, uint16_t max);
+    // Agrégat en cours (minute ou heure non close); false si vide
+    bool current(TS_Tier tier, TSAggregate& out) const;
+
+    uint32_t now() const;
+    // Début (s) de la fenêtre des 'hours' dernières heures, heure en cours
+    // comprise; 0 tant que l'horloge n'a pas atteint autant d'heures
+    uint32_t window_start(uint16_t hours) const;
+    uint32_t get_count(TS_Tier tier) const { return rings[tier].count; }
+    const TSStats& get_stats() const { return stats; }
+    void reset_stats() { stats = TSStats(); }
+};
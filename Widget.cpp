@@ -0,0 +1,355 @@
+#include "Widget.h"
+#include <cstdio>
+#include <cstring>
+
+/*******************************************************
+ * Nom du fichier : Widget.cpp
+ * Auteur         : Guillaume Sahuc
+ * Date           : 19 octobre 2026
+ * Description    : widgets retenus, redessin par zones
+ *******************************************************/
+
+using namespace Widget_Config;
+
+// ===== RECT =====
+bool Rect::intersects(const Rect& o) const {
+    return !empty() && !o.empty() && x < o.x + o.w && o.x < x + w && y < o.y + o.h && o.y < y + h;
+}
+
+bool Rect::contains(const Rect& o) const {
+    return !o.empty() && x <= o.x && y <= o.y && o.x + o.w <= x + w && o.y + o.h <= y + h;
+}
+
+Rect Rect::intersect(const Rect& o) const {
+    const int x0 = (x > o.x) ? x : o.x;
+    const int y0 = (y > o.y) ? y : o.y;
+    const int x1 = (x + w < o.x + o.w) ? x + w : o.x + o.w;
+    const int y1 = (y + h < o.y + o.h) ? y + h : o.y + o.h;
+    if (x1 <= x0 || y1 <= y0) return Rect();
+    return Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+Rect Rect::unite(const Rect& o) const {
+    if (empty()) return o;
+    if (o.empty()) return *this;
+    const int x0 = (x < o.x) ? x : o.x;
+    const int y0 = (y < o.y) ? y : o.y;
+    const int x1 = (x + w > o.x + o.w) ? x + w : o.x + o.w;
+    const int y1 = (y + h > o.y + o.h) ? y + h : o.y + o.h;
+    return Rect(x0, y0, x1 - x0, y1 - y0);
+}
+
+// ===== WIDGET =====
+Widget::Widget(const Rect& area) : bounds(area), tree(nullptr), visible(true), dirty(true) {}
+
+void Widget::invalidate() {
+    invalidate(bounds);
+}
+
+void Widget::invalidate(const Rect& area) {
+    dirty = true;
+    if (tree && visible) tree->invalidate(area.intersect(bounds));
+}
+
+void Widget::set_bounds(const Rect& area) {
+    if (area == bounds) return;
+    if (tree && visible) tree->invalidate(bounds);
+    bounds = area;
+    invalidate();
+}
+
+void Widget::set_visible(bool show) {
+    if (show == visible) return;
+    visible = show;
+    dirty = true;
+    if (tree) tree->invalidate(bounds);
+}
+
+// ===== LABEL =====
+Label::Label(const Rect& area, const char* initial, uint16_t text_color, FontType text_font, Align text_align)
+    : Widget(area), color(text_color), font(text_font), align(text_align) {
+    text[0] = '\0';
+    if (initial) {
+        strncpy(text, initial, LABEL_MAX - 1);
+        text[LABEL_MAX - 1] = '\0';
+    }
+}
+
+void Label::set_text(const char* value) {
+    if (!value) value = "";
+    if (strncmp(text, value, LABEL_MAX - 1) == 0) return;
+    strncpy(text, value, LABEL_MAX - 1);
+    text[LABEL_MAX - 1] = '\0';
+    invalidate();
+}
+
+void Label::set_color(uint16_t value) {
+    if (value == color) return;
+    color = value;
+    invalidate();
+}
+
+void Label::draw(TFT& tft, const Rect&) {
+    const FontType previous = tft.getFont();
+    tft.setFont(font);
+    int x = bounds.x;
+    if (align != LEFT) {
+        const int room = bounds.w - tft.getTextWidth(text);
+        x += (align == CENTER) ? room / 2 : room;
+    }
+    tft.drawText(x, bounds.y, text, color);
+    tft.setFont(previous);
+}
+
+// ===== GAUGE =====
+Gauge::Gauge(const Rect& area, int32_t minimum, int32_t maximum, uint16_t fill, uint16_t track, uint16_t border)
+    : Widget(area), min_value(minimum), max_value(maximum), value(minimum),
+      fill_color(fill), track_color(track), border_color(border) {}
+
+int Gauge::fill_width(int32_t v) const {
+    const int inner = bounds.w - 2;
+    if (inner <= 0 || max_value <= min_value || v <= min_value) return 0;
+    if (v >= max_value) return inner;
+    return (int)((int64_t)(v - min_value) * inner / (max_value - min_value));
+}
+
+void Gauge::set_value(int32_t v) {
+    const int before = fill_width(value);
+    const int after = fill_width(v);
+    value = v;
+    if (before == after) return;   // même pixel: rien à redessiner
+    const int lo = (before < after) ? before : after;
+    const int hi = (before < after) ? after : before;
+    invalidate(Rect(bounds.x + 1 + lo, bounds.y + 1, hi - lo, bounds.h - 2));
+}
+
+void Gauge::set_fill_color(uint16_t c) {
+    if (c == fill_color) return;
+    fill_color = c;
+    const int w = fill_width(value);
+    if (w > 0) invalidate(Rect(bounds.x + 1, bounds.y + 1, w, bounds.h - 2));
+}
+
+void Gauge::draw(TFT& tft, const Rect&) {
+    const int w = fill_width(value);
+    const int inner_w = bounds.w - 2;
+    const int inner_h = bounds.h - 2;
+    tft.drawRect(bounds.x, bounds.y, bounds.w, bounds.h, border_color);
+    if (w > 0) tft.fillRect(bounds.x + 1, bounds.y + 1, w, inner_h, fill_color);
+    if (w < inner_w) tft.fillRect(bounds.x + 1 + w, bounds.y + 1, inner_w - w, inner_h, track_color);
+}
+
+// ===== ICON =====
+Icon::Icon(const Rect& area, const uint8_t* bits, uint16_t icon_color)
+    : Widget(area), bitmap(bits), color(icon_color) {}
+
+void Icon::set_bitmap(const uint8_t* bits) {
+    if (bits == bitmap) return;
+    bitmap = bits;
+    invalidate();
+}
+
+void Icon::set_color(uint16_t c) {
+    if (c == color) return;
+    color = c;
+    invalidate();
+}
+
+void Icon::draw(TFT& tft, const Rect&) {
+    tft.drawBitmap(bounds.x, bounds.y, bounds.w, bounds.h, bitmap, color);
+}
+
+// ===== PICTURE =====
+Picture::Picture(const Rect& area, const Canvas* image)
+    : Widget(area), canvas(image), keyed(false), key(0) {}
+
+void Picture::set_canvas(const Canvas* image) {
+    if (image == canvas) return;
+    canvas = image;
+    invalidate();
+}
+
+void Picture::set_transparent(uint16_t color) {
+    if (keyed && color == key) return;
+    keyed = true;
+    key = color;
+    invalidate();
+}
+
+void Picture::draw(TFT& tft, const Rect&) {
+    if (!canvas) return;
+    // Canvas plus grand que le widget: coupé à ses bords
+    if (!tft.pushClip(bounds.x, bounds.y, bounds.w, bounds.h)) return;
+    if (keyed) tft.drawCanvas(*canvas, bounds.x, bounds.y, key);
+    else tft.drawCanvas(*canvas, bounds.x, bounds.y);
+    tft.popClip();
+}
+
+// ===== LIST =====
+ListWidget::ListWidget(const Rect& area, const char* const* lines, uint16_t line_count, uint8_t line_height,
+                       uint16_t text_color, uint16_t highlight)
+    : Widget(area), items(lines), count(lines ? line_count : 0), first(0), selected(-1),
+      row_height(line_height ? line_height : 1), color(text_color), select_color(highlight) {}
+
+Rect ListWidget::row_rect(uint16_t index) const {
+    if (index < first || index >= first + visible_rows()) return Rect();
+    return Rect(bounds.x, bounds.y + (index - first) * row_height, bounds.w, row_height);
+}
+
+void ListWidget::set_items(const char* const* lines, uint16_t line_count) {
+    items = lines;
+    count = lines ? line_count : 0;
+    first = 0;
+    selected = -1;
+    invalidate();
+}
+
+void ListWidget::set_selected(int16_t index) {
+    if (index < -1 || index >= (int16_t)count) index = -1;
+    if (index == selected) return;
+    const int16_t previous = selected;
+    selected = index;
+    if (index >= 0 && row_rect((uint16_t)index).empty()) {
+        // Hors de la partie visible: défilement, toute la liste change
+        const uint16_t rows = visible_rows();
+        first = ((uint16_t)index < first) ? (uint16_t)index : (uint16_t)(index - (rows ? rows - 1 : 0));
+        invalidate();
+        return;
+    }
+    if (previous >= 0) invalidate(row_rect((uint16_t)previous));
+    if (index >= 0) invalidate(row_rect((uint16_t)index));
+}
+
+void ListWidget::draw(TFT& tft, const Rect&) {
+    const FontType previous = tft.getFont();
+    tft.setFont(FontType::FONT_STANDARD);
+    const uint16_t rows = visible_rows();
+    for (uint16_t r = 0; r < rows && first + r < count; ++r) {
+        const uint16_t index = first + r;
+        const Rect row = row_rect(index);
+        if (index == selected) tft.fillRect(row.x, row.y, row.w, row.h, select_color);
+        tft.drawText(row.x + 2, row.y + (row.h - 12) / 2, items[index], color);
+    }
+    tft.setFont(previous);
+}
+
+// ===== WIDGET TREE =====
+WidgetTree::WidgetTree(TFT* display, uint16_t background_color)
+    : tft(display), widget_count(0), damage_count(0), background(background_color) {}
+
+bool WidgetTree::add(Widget* widget) {
+    if (!widget || widget->tree) return false;
+    if (widget_count >= MAX_WIDGETS) {
+        printf("WidgetTree: %u widgets au plus\n", MAX_WIDGETS);
+        return false;
+    }
+    widgets[widget_count++] = widget;
+    widget->tree = this;
+    widget->dirty = true;
+    if (widget->visible) invalidate(widget->bounds);
+    return true;
+}
+
+void WidgetTree::remove(Widget* widget) {
+    for (uint8_t i = 0; i < widget_count; ++i) {
+        if (widgets[i] != widget) continue;
+        for (uint8_t j = i + 1; j < widget_count; ++j) widgets[j - 1] = widgets[j];
+        widget_count--;
+        if (widget->visible) invalidate(widget->bounds);
+        widget->tree = nullptr;
+        return;
+    }
+}
+
+void WidgetTree::invalidate(const Rect& area) {
+    Rect r = area.intersect(Rect(0, 0, tft->getScreenWidth(), tft->getScreenHeight()));
+    if (r.empty()) return;
+
+    // Fusion tant que l'englobant ne coûte pas plus que les deux zones
+    for (uint8_t i = 0; i < damage_count;) {
+        const Rect u = damage[i].unite(r);
+        if (u.area() <= damage[i].area() + r.area()) {
+            r = u;
+            damage[i] = damage[--damage_count];
+            i = 0;                 // la zone agrandie peut en absorber d'autres
+        } else {
+            ++i;
+        }
+    }
+    if (damage_count < MAX_DAMAGE) {
+        damage[damage_count++] = r;
+        return;
+    }
+    // Plus de place: fusion avec la zone qui grossit le moins
+    uint8_t best = 0;
+    int32_t best_growth = INT32_MAX;
+    for (uint8_t i = 0; i < damage_count; ++i) {
+        const int32_t growth = damage[i].unite(r).area() - damage[i].area();
+        if (growth < best_growth) {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    damage[best] = damage[best].unite(r);
+}
+
+bool WidgetTree::can_move(const Widget* widget) const {
+    if (!widget || !widget->visible) return false;
+    for (uint8_t i = 0; i < damage_count; ++i) {
+        if (damage[i].intersects(widget->bounds)) return false;
+    }
+    for (uint8_t k = 0; k < widget_count; ++k) {
+        const Widget* w = widgets[k];
+        if (w != widget && w->visible && w->bounds.intersects(widget->bounds)) return false;
+    }
+    return true;
+}
+
+bool WidgetTree::scroll(const Widget* widget, const Rect& area, int dy) {
+    if (!can_move(widget)) return false;
+    const Rect r = area.intersect(widget->bounds).intersect(Rect(0, 0, tft->getScreenWidth(), tft->getScreenHeight()));
+    if (r.empty()) return true;
+    tft->scrollRect(r.x, r.y, r.w, r.h, dy);
+    moved = moved.unite(r);
+    return true;
+}
+
+void WidgetTree::invalidate_all() {
+    damage_count = 0;
+    moved = Rect();            // redessiné de toute façon
+    invalidate(Rect(0, 0, tft->getScreenWidth(), tft->getScreenHeight()));
+}
+
+uint8_t WidgetTree::render(bool send) {
+    if (damage_count == 0 && moved.empty()) return 0;
+    const uint8_t n = damage_count;
+
+    for (uint8_t i = 0; i < n; ++i) {
+        const Rect& d = damage[i];
+        if (!tft->pushClip(d.x, d.y, d.w, d.h)) break;
+        tft->fillRect(d.x, d.y, d.w, d.h, background);
+        for (uint8_t k = 0; k < widget_count; ++k) {
+            Widget* w = widgets[k];
+            if (!w->visible || !w->bounds.intersects(d)) continue;
+            w->draw(*tft, d);
+            stats.draws++;
+        }
+        stats.pixels += (uint32_t)d.area();
+        tft->popClip();
+    }
+    for (uint8_t k = 0; k < widget_count; ++k) widgets[k]->dirty = false;
+
+    if (send) {
+        if (!moved.empty()) tft->sendRegion((uint16_t)moved.x, (uint16_t)moved.y, (uint16_t)moved.w, (uint16_t)moved.h);
+        for (uint8_t i = 0; i < n; ++i) {
+            if (moved.contains(damage[i])) continue;   // déjà envoyée avec la zone déplacée
+            tft->sendRegion((uint16_t)damage[i].x, (uint16_t)damage[i].y, (uint16_t)damage[i].w, (uint16_t)damage[i].h);
+        }
+    }
+    stats.moved_pixels += (uint32_t)moved.area();
+    moved = Rect();
+    damage_count = 0;
+    stats.frames++;
+    stats.rects += n;
+    return n;
+}
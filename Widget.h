@@ -0,0 +1,230 @@
+#pragma once
+
+/*
+ * Widget - Interface graphique retenue, redessinée par zones invalidées
+ *
+ * Les widgets (texte, jauge, icône, image, liste) gardent leur rectangle et leur
+ * état; changer une propriété n'invalide que la zone réellement modifiée:
+ * tout le widget pour un texte, les seules colonnes entre l'ancien et le
+ * nouveau remplissage pour une jauge, deux lignes pour une sélection de
+ * liste. Une valeur inchangée n'invalide rien.
+ *
+ * WidgetTree::render() redessine chaque zone invalidée: fond, puis les
+ * widgets qui la touchent dans l'ordre d'ajout, découpés à la zone
+ * (TFT::pushClip), et n'envoie que ces zones à l'écran. Un tableau de
+ * bord immobile ne coûte rien; une valeur qui change coûte sa zone.
+ *
+ * Un widget peut aussi déplacer son propre contenu dans le framebuffer
+ * (défilement d'une ListView, WidgetTree::scroll) quand rien ne le
+ * recouvre: la zone déplacée est envoyée sans être redessinée, seule la
+ * bande découverte est invalidée.
+ *
+ * Les zones se chevauchant sont fusionnées quand le rectangle englobant
+ * n'est pas plus grand que les deux réunis; au-delà de MAX_DAMAGE zones,
+ * la nouvelle est fusionnée avec celle qui grossit le moins.
+ */
+
+#include "pico/stdlib.h"
+#include "TFT.h"
+#include "Canvas.h"
+
+namespace Widget_Config {
+    static constexpr uint8_t MAX_WIDGETS = 16;
+    static constexpr uint8_t MAX_DAMAGE = 8;           // zones distinctes par image
+    static constexpr uint8_t LABEL_MAX = 32;           // texte d'un Label, '\0' compris
+}
+
+// Rectangle en coordonnées écran (w ou h <= 0: vide)
+struct Rect {
+    int16_t x, y, w, h;
+
+    Rect() : x(0), y(0), w(0), h(0) {}
+    Rect(int x, int y, int w, int h) : x((int16_t)x), y((int16_t)y), w((int16_t)w), h((int16_t)h) {}
+
+    bool empty() const { return w <= 0 || h <= 0; }
+    int32_t area() const { return empty() ? 0 : (int32_t)w * h; }
+    bool intersects(const Rect& o) const;
+    bool contains(const Rect& o) const;
+    Rect intersect(const Rect& o) const;
+    Rect unite(const Rect& o) const;                   // rectangle englobant
+    bool operator==(const Rect& o) const { return x == o.x && y == o.y && w == o.w && h == o.h; }
+};
+
+struct WidgetStats {
+    uint32_t frames;           // render() ayant redessiné au moins une zone
+    uint32_t rects;            // zones redessinées
+    uint32_t pixels;           // pixels redessinés et envoyés
+    uint32_t draws;            // appels de Widget::draw
+    uint32_t moved_pixels;     // pixels déplacés dans le framebuffer, envoyés sans redessin
+
+    WidgetStats() : frames(0), rects(0), pixels(0), draws(0), moved_pixels(0) {}
+};
+
+class WidgetTree;
+
+class Widget {
+    friend class WidgetTree;
+
+protected:
+    Rect bounds;
+    WidgetTree* tree;
+    bool visible;
+    bool dirty;
+
+    // Invalide tout le widget, ou une partie seulement
+    void invalidate();
+    void invalidate(const Rect& area);
+
+public:
+    explicit Widget(const Rect& area);
+    virtual ~Widget() {}
+
+    // Dessine le widget; le découpage à clip (zone redessinée) est déjà
+    // actif, clip sert seulement à sauter ce qui est hors zone
+    virtual void draw(TFT& tft, const Rect& clip) = 0;
+
+    const Rect& get_bounds() const { return bounds; }
+    void set_bounds(const Rect& area);                 // ancienne et nouvelle zone
+    void set_visible(bool show);
+    bool is_visible() const { return visible; }
+    bool is_dirty() const { return dirty; }
+};
+
+// Texte d'une ligne
+class Label : public Widget {
+public:
+    enum Align { LEFT, CENTER, RIGHT };
+
+private:
+    char text[Widget_Config::LABEL_MAX];
+    uint16_t color;
+    FontType font;
+    Align align;
+
+public:
+    Label(const Rect& area, const char* initial = "", uint16_t text_color = COLOR_16BITS_WHITE,
+          FontType text_font = FontType::FONT_STANDARD, Align text_align = LEFT);
+
+    void set_text(const char* value);                  // tronqué à LABEL_MAX - 1
+    void set_color(uint16_t value);
+    const char* get_text() const { return text; }
+    void draw(TFT& tft, const Rect& clip) override;
+};
+
+// Barre horizontale: remplissage proportionnel à value dans [min, max]
+class Gauge : public Widget {
+private:
+    int32_t min_value, max_value, value;
+    uint16_t fill_color, track_color, border_color;
+
+    int fill_width(int32_t v) const;                   // colonnes remplies (intérieur)
+
+public:
+    Gauge(const Rect& area, int32_t minimum, int32_t maximum, uint16_t fill = COLOR_16BITS_GREEN,
+          uint16_t track = COLOR_16BITS_DARKGRAY, uint16_t border = COLOR_16BITS_WHITE);
+
+    // N'invalide que les colonnes entre l'ancien et le nouveau remplissage
+    void set_value(int32_t v);
+    int32_t get_value() const { return value; }
+    void set_fill_color(uint16_t c);
+    void draw(TFT& tft, const Rect& clip) override;
+};
+
+// Image 1 bit (lignes de (w + 7) / 8 octets, bit de poids fort à gauche)
+class Icon : public Widget {
+private:
+    const uint8_t* bitmap;
+    uint16_t color;
+
+public:
+    Icon(const Rect& area, const uint8_t* bits, uint16_t icon_color = COLOR_16BITS_WHITE);
+
+    void set_bitmap(const uint8_t* bits);
+    void set_color(uint16_t c);
+    void draw(TFT& tft, const Rect& clip) override;
+};
+
+// Image RGB565 préparée dans un Canvas (cadran, titre en Arial32...)
+class Picture : public Widget {
+private:
+    const Canvas* canvas;
+    bool keyed;
+    uint16_t key;
+
+public:
+    Picture(const Rect& area, const Canvas* image = nullptr);
+
+    void set_canvas(const Canvas* image);
+    // Les pixels de cette couleur laissent voir le fond
+    void set_transparent(uint16_t color);
+    // Contenu du Canvas redessiné: à signaler pour le renvoyer à l'écran
+    void changed() { invalidate(); }
+    void draw(TFT& tft, const Rect& clip) override;
+};
+
+// Liste de lignes de texte (tableau fourni par l'appelant), une sélectionnée
+class ListWidget : public Widget {
+private:
+    const char* const* items;
+    uint16_t count;
+    uint16_t first;            // première ligne visible
+    int16_t  selected;         // -1: aucune
+    uint8_t  row_height;
+    uint16_t color, select_color;
+
+    uint16_t visible_rows() const { return (uint16_t)(bounds.h / row_height); }
+    Rect row_rect(uint16_t index) const;               // vide si la ligne n'est pas visible
+
+public:
+    ListWidget(const Rect& area, const char* const* lines, uint16_t line_count, uint8_t line_height = 14,
+               uint16_t text_color = COLOR_16BITS_WHITE, uint16_t highlight = COLOR_16BITS_BLUE);
+
+    void set_items(const char* const* lines, uint16_t line_count);
+    // N'invalide que l'ancienne et la nouvelle ligne, sauf s'il faut faire défiler
+    void set_selected(int16_t index);
+    int16_t get_selected() const { return selected; }
+    void draw(TFT& tft, const Rect& clip) override;
+};
+
+class WidgetTree {
+private:
+    TFT* tft;
+    Widget* widgets[Widget_Config::MAX_WIDGETS];
+    uint8_t widget_count;
+    Rect damage[Widget_Config::MAX_DAMAGE];
+    uint8_t damage_count;
+    Rect moved;                // contenu déplacé à envoyer tel quel
+    uint16_t background;
+    WidgetStats stats;
+
+    // Vrai si le contenu du widget peut être déplacé dans le framebuffer:
+    // ni zone en attente ni autre widget visible ne le recouvre
+    bool can_move(const Widget* widget) const;
+
+public:
+    explicit WidgetTree(TFT* display, uint16_t background_color = COLOR_16BITS_BLACK);
+
+    // Ajoute au-dessus des widgets existants et invalide sa zone
+    bool add(Widget* widget);
+    void remove(Widget* widget);
+    uint8_t get_widget_count() const { return widget_count; }
+
+    // Zone à redessiner (découpée à l'écran)
+    void invalidate(const Rect& area);
+    void invalidate_all();
+
+    // Décale de dy lignes le contenu de area (dans le widget) directement
+    // dans le framebuffer; la zone est envoyée au prochain render() sans
+    // être redessinée, la bande découverte reste à invalider. false si le
+    // widget est recouvert: rien n'est déplacé, l'appelant invalide tout.
+    bool scroll(const Widget* widget, const Rect& area, int dy);
+
+    // Redessine les zones invalidées et les envoie (send faux: framebuffer
+    // seulement). Retourne le nombre de zones redessinées.
+    uint8_t render(bool send = true);
+
+    uint8_t get_damage_count() const { return damage_count; }
+    const Rect& get_damage(uint8_t i) const { return damage[i]; }
+    const WidgetStats& get_stats() const { return stats; }
+    void reset_stats() { stats = WidgetStats(); }
+};
@@ -3,11 +3,20 @@
 #include <cstdio>
 #include <vector>
 #include <cstring>
+#include <cmath>
 #include <string>
 
 #include "SDCard.h"
 #include "StorageManager.h"
+#include "ImageCache.h"
+#include "KVStore.h"
+#include "TimeSeries.h"
+#include "ColorTransform.h"
 #include "TFT.h"
+#include "TFTBus.h"
+#include "Widget.h"
+#include "Canvas.h"
+#include "ListView.h"
 #include "AnimationPlayer.h"
 #include "Ball.h"
 #include "rgb2.h"
@@ -29,9 +38,62 @@
 
 // Objets globaux
 TFT* tft = nullptr;
+TFT* tft2 = nullptr;       // second écran (TFT2Config::ENABLED)
 AnimationPlayer* anim_player = nullptr;
+ImageCache* image_cache = nullptr;
+static KVStore kv_store; // réglages et métadonnées (/KVSTORE.DAT)
+static TimeSeries time_series; // historique du DHT11 (/SENSORS.TS)
+DHT11* dht = nullptr;
+static ColorTransform color_transform; // gamma/luminosité appliqués à l'envoi SPI
 std::vector<Ball> balls;
 static RGB2 rgb; // LED RGB (R=17, G=16, B=25)
+static WidgetTree* dashboard = nullptr; // tableau de bord affiché (commande dash), nullptr: aucun
+static bool browsing = false; // liste de fichiers affichée (commande browse)
+
+// Tableau de bord du DHT11: seules les valeurs qui changent sont redessinées
+static Label dash_title(Rect(0, 40, 240, 12), "Capteurs", COLOR_16BITS_WHITE, FontType::FONT_STANDARD, Label::CENTER);
+static Label dash_temperature(Rect(40, 76, 160, 12), "--.- C", COLOR_16BITS_WHITE, FontType::FONT_STANDARD, Label::CENTER);
+static Gauge dash_temperature_gauge(Rect(40, 92, 160, 12), 0, 500, COLOR_16BITS_ORANGE);
+static Label dash_humidity(Rect(40, 126, 160, 12), "-- %", COLOR_16BITS_WHITE, FontType::FONT_STANDARD, Label::CENTER);
+static Gauge dash_humidity_gauge(Rect(40, 142, 160, 12), 0, 1000, COLOR_16BITS_CYAN);
+static Label dash_uptime(Rect(40, 180, 160, 12), "", COLOR_16BITS_GRAY, FontType::FONT_STANDARD, Label::CENTER);
+
+// Titre du tableau de bord en Arial32, dessiné une fois dans un Canvas puis
+// seulement recopié; nullptr si la réserve est pleine (titre en 8x12)
+static Canvas* dash_title_canvas() {
+    static Canvas* canvas = nullptr;
+    if (canvas) return canvas;
+    const char* text = "Capteurs";
+    int height = 0;
+    for (const char* c = text; *c; ++c) {
+        if (Raster::arial_info(*c).h > height) height = Raster::arial_info(*c).h;
+    }
+    canvas = Canvas::acquire(Raster::text_width(FontType::ARIAL_32, text), height);
+    if (!canvas) return nullptr;
+    canvas->fill(COLOR_16BITS_BLACK);
+    canvas->setFont(FontType::ARIAL_32);
+    canvas->drawText(0, 0, text, COLOR_16BITS_WHITE);
+    return canvas;
+}
+
+// Commandes qui dessinent: elles reprennent l'écran au tableau de bord
+static const char* const DRAWING_COMMANDS[] = {"bmp", "anim", "ball", "text", "clear", "scale", "dual", "browse", "gradient"};
+
+// Source de la liste browse: entrées du répertoire lues par index, sans
+// liste en mémoire
+struct BrowseSource {
+    FAT32* fs;
+    FAT32::DirIterator it;
+};
+
+static bool browse_row(uint32_t index, char* text, uint8_t size, void* context) {
+    BrowseSource* source = static_cast<BrowseSource*>(context);
+    FileListEntry entry;
+    if (!source->fs->dir_iterator_read(source->it, index, entry)) return false;
+    snprintf(text, size, "%s%s", entry.hasLongName ? entry.longFileName.c_str() : entry.dosFileName,
+             entry.type == _Directory ? "/" : "");
+    return true;
+}
 
 static void wait_for_usb(uint32_t timeout_ms = 4000) {
     stdio_init_all();
@@ -56,15 +118,28 @@ void print_help() {
     printf("\n=== COMMANDES DISPONIBLES ===\n");
     printf("  help              - Affiche ce menu\n");
     printf("  list [path]       - Liste les fichiers (défaut: racine)\n");
-    printf("  bmp <file>        - Affiche une image BMP\n");
+    printf("  bmp <file>        - Affiche une image BMP (ou .bmp.gz)\n");
+    printf("  cat <file>        - Affiche un fichier texte ligne à ligne (ou .gz)\n");
     printf("  fat32test         - Lance un test complet FAT32\n");
+    printf("  fsck              - Vérifie la cohérence FAT32 (lecture seule)\n");
+    printf("  rm [-r] <chemin>  - Supprime un fichier (-r: répertoire et contenu)\n");
+    printf("  discard [on|off]  - État / activation de l'effacement des clusters libérés\n");
+    printf("  kv [get|set|del|compact] <clé> [valeur] - Stockage clé/valeur sur la carte\n");
+    printf("  dht [min [n]|hour [n]|chart] - Mesure DHT11 / historique / courbe 24 h\n");
     printf("  format [label]    - Formate la carte en FAT32 (EFFACE TOUT!)\n");
-    printf("  anim <dir>        - Lance une animation depuis un répertoire\n");
+    printf("  anim <dir> [i]    - Lance une animation (FR_XXX.RAW ou FR_XXX.RAW.GZ), i: entrelacée\n");
+    printf("  fields <dir>      - Range les FR_XXX.RAW par lignes paires/impaires (pour anim i)\n");
     printf("  stop              - Arrête l'animation en cours\n");
     printf("  ball [n]          - Ajoute n balles animées (défaut: 1)\n");
     printf("  clearball         - Supprime toutes les balles\n");
     printf("  text <x> <y> <texte> - Affiche du texte à la position (x,y)\n");
     printf("  clear             - Efface l'écran\n");
+    printf("  gradient [linear|radial|pattern] - Fond en dégradé ou motif (temps de remplissage)\n");
+    printf("  scale [1|2|3]     - Résolution de dessin 240/120/80 (pixels répétés)\n");
+    printf("  dual              - Copie l'image sur les deux écrans (second en miroir)\n");
+    printf("  color [gamma|bright|warm|invert|night|off] - Réglage des couleurs à l'envoi\n");
+    printf("  dash [off]        - Tableau de bord DHT11 (redessin des seules valeurs modifiées)\n");
+    printf("  browse <dir>|up [n]|down [n] - Liste défilante d'un répertoire (lignes lues à la demande)\n");
     printf("  info              - Affiche les infos système\n");
     printf("  rgb <r> <g> <b>   - Pilote la LED RGB (0=OFF, 1=ON)\n");
     printf("=============================\n");
@@ -95,6 +170,63 @@ static std::string format_fat_datetime_from_fields(uint16_t date, uint16_t time)
 }
 
 // Fonction pour traiter les commandes
+// Courbe des 24 dernières heures: une barre min-max par heure, moyenne en blanc
+static void draw_dht_chart(const TSAggregate* hours, uint16_t count, uint32_t first_hour) {
+    tft->clear();
+    tft->drawText(70, 24, "Temperature 24 h", COLOR_16BITS_WHITE);
+    if (count == 0) {
+        tft->sendFrame();
+        return;
+    }
+    int16_t lo = hours[0].t_min, hi = hours[0].t_max;
+    for (uint16_t i = 1; i < count; ++i) {
+        if (hours[i].t_min < lo) lo = hours[i].t_min;
+        if (hours[i].t_max > hi) hi = hours[i].t_max;
+    }
+    if (hi - lo < 20) hi = lo + 20;   // échelle minimale de 2 °C
+
+    const int top = 50, bottom = 190, left = 12, step = 9;
+    auto y_of = [&](int16_t t) { return bottom - (int)((int32_t)(t - lo) * (bottom - top) / (hi - lo)); };
+    tft->drawRect(left - 2, top - 2, 24 * step + 3, bottom - top + 5, COLOR_16BITS_DARKGRAY);
+    for (uint16_t i = 0; i < count; ++i) {
+        const int x = left + (int)((hours[i].start - first_hour) / 3600u) * step;
+        const int y_max = y_of(hours[i].t_max);
+        tft->fillRect(x, y_max, step - 3, y_of(hours[i].t_min) - y_max + 1, COLOR_16BITS_ORANGE);
+        tft->fillRect(x, y_of(hours[i].t_mean), step - 3, 2, COLOR_16BITS_WHITE);
+    }
+    char label[32];
+    snprintf(label, sizeof(label), "%.1f .. %.1f C", lo / 10.0f, hi / 10.0f);
+    tft->drawText(70, 200, label, COLOR_16BITS_WHITE);
+    tft->sendFrame();
+}
+
+// Valeurs du tableau de bord (dixièmes de °C et de %)
+static void update_dashboard(const DHT11::Reading& r) {
+    char text[Widget_Config::LABEL_MAX];
+    snprintf(text, sizeof(text), "%.1f C", r.temperature);
+    dash_temperature.set_text(text);
+    dash_temperature_gauge.set_value((int32_t)lroundf(r.temperature * 10.0f));
+    snprintf(text, sizeof(text), "%.0f %%", r.humidity);
+    dash_humidity.set_text(text);
+    dash_humidity_gauge.set_value((int32_t)lroundf(r.humidity * 10.0f));
+}
+
+static void print_aggregate(const TSAggregate& a, const char* suffix) {
+    printf("  t=%-8lu T %5.1f/%5.1f/%5.1f C  H %4.1f/%4.1f/%4.1f %%  (%u mesures)%s\n",
+           (unsigned long)a.start, a.t_min / 10.0f, a.t_mean / 10.0f, a.t_max / 10.0f,
+           a.h_min / 2.0f, a.h_mean / 2.0f, a.h_max / 2.0f, a.count, suffix);
+}
+
+// Bandes du framebuffer pour render_strips: écran 0 tel quel, écran 1 en miroir
+static void mirror_strip(uint8_t panel, uint16_t y, uint16_t rows, uint16_t* pixels, void* context) {
+    const uint16_t* fb = static_cast<const uint16_t*>(context) + y * TFTConfig::WIDTH;
+    for (uint16_t i = 0; i < rows * TFTConfig::WIDTH; i += TFTConfig::WIDTH) {
+        for (uint16_t x = 0; x < TFTConfig::WIDTH; ++x) {
+            pixels[i + x] = fb[i + (panel == 0 ? x : TFTConfig::WIDTH - 1 - x)];
+        }
+    }
+}
+
 void process_command(const char* cmd, StorageManager* storage) {
     // Copie pour tokenisation
     std::string cmd_copy(cmd);
@@ -105,6 +237,12 @@ void process_command(const char* cmd, StorageManager* storage) {
     
     // Convertir en minuscules
     for (char* p = token; *p; ++p) *p = tolower(*p);
+
+    for (const char* name : DRAWING_COMMANDS) {
+        if (strcmp(token, name) != 0) continue;
+        dashboard = nullptr;
+        if (strcmp(token, "browse") != 0) browsing = false;
+    }
     
     // === HELP ===
     if (strcmp(token, "help") == 0) {
@@ -160,14 +298,14 @@ void process_command(const char* cmd, StorageManager* storage) {
         }
         
         printf("[INFO] Chargement de '%s'...\n", filename);
+        // Les images sont en 240x240: retour en pleine résolution
+        if (tft->getRenderScale() != RenderScale::FULL) tft->setRenderScale(RenderScale::FULL);
         
-        // Callback 16 bits pour afficher les pixels (le TFT attend du RGB565)
-        auto pixel_callback_565 = [](uint16_t x, uint16_t y, uint16_t color) {
-            if (tft) tft->setPixel(x, y, color);
-        };
-        
-        // Utiliser la lecture unifiée (gère BMP 16/24 bits automatiquement)
-        SDCard_Status status = storage->read_bmp_file(0, 0, filename, nullptr, pixel_callback_565);
+        // Premier affichage: décodage BMP puis copie au format de l'écran dans
+        // /IMGCACHE; ensuite, relecture directe dans le framebuffer
+        SDCard_Status status = image_cache
+            ? image_cache->display(filename, tft->getFramebuffer(), TFTConfig::WIDTH, TFTConfig::HEIGHT)
+            : SD_FILE_NOT_FOUND;
         
         if (status == SD_OK) {
             tft->sendFrame(); // Envoyer le framebuffer à l'écran
@@ -177,6 +315,19 @@ void process_command(const char* cmd, StorageManager* storage) {
         }
     }
 
+    // === CAT ===
+    else if (strcmp(token, "cat") == 0) {
+        const char* filename = strtok(nullptr, " ");
+        if (!filename) {
+            printf("[ERREUR] Usage: cat <fichier>\n");
+            return;
+        }
+        SDCard_Status status = storage->read_text_file(filename);
+        if (status != SD_OK) {
+            printf("[ERREUR] Lecture impossible (code: %d)\n", (int)status);
+        }
+    }
+
     // === FAT32 TEST ===
     else if (strcmp(token, "fat32test") == 0) {
         printf("[INFO] Lancement du test FAT32...\n");
@@ -188,6 +339,168 @@ void process_command(const char* cmd, StorageManager* storage) {
         }
     }
     
+    // === FSCK ===
+    else if (strcmp(token, "fsck") == 0) {
+        FAT32* fs = storage->get_fat32_fs();
+        if (!storage->is_fat32_mounted() || !fs) {
+            printf("[ERREUR] FAT32 non monté\n");
+            return;
+        }
+        if (!tft) {
+            printf("[ERREUR] Écran TFT non initialisé (framebuffer requis comme mémoire de travail)\n");
+            return;
+        }
+        // Le framebuffer sert de bitmap de propriété des clusters (115 Ko = 921600 clusters par passe)
+        if (anim_player) anim_player->stop();
+        FsckReport report;
+        bool ok = fs->check_filesystem(report, tft->getFramebuffer(), (uint32_t)tft->getFramebufferSize());
+        tft->clear();
+        if (!ok) {
+            printf("[ERREUR] Vérification interrompue\n");
+        } else if (report.error_count() == 0) {
+            printf("[OK] Système de fichiers cohérent\n");
+        } else {
+            printf("[ATTENTION] %lu anomalie(s) détectée(s)\n", (unsigned long)report.error_count());
+        }
+    }
+    
+    // === RM ===
+    else if (strcmp(token, "rm") == 0) {
+        const char* arg = strtok(nullptr, " ");
+        bool recursive = false;
+        if (arg && strcmp(arg, "-r") == 0) {
+            recursive = true;
+            arg = strtok(nullptr, " ");
+        }
+        if (!arg) {
+            printf("Usage: rm [-r] <chemin>\n");
+            return;
+        }
+        FAT32* fs = storage->get_fat32_fs();
+        if (!storage->is_fat32_mounted() || !fs) {
+            printf("[ERREUR] FAT32 non monté\n");
+            return;
+        }
+        // Une animation en cours lit peut-être dans le répertoire supprimé
+        if (recursive && anim_player) anim_player->stop();
+        bool ok = recursive ? fs->remove_tree(arg) : fs->delete_file(arg);
+        if (ok) {
+            printf("[OK] %s supprimé\n", arg);
+        } else {
+            printf("[ERREUR] Impossible de supprimer %s%s\n", arg, recursive ? "" : " (répertoire ? utiliser rm -r)");
+        }
+    }
+    
+    // === DISCARD ===
+    else if (strcmp(token, "discard") == 0) {
+        FAT32* fs = storage->get_fat32_fs();
+        if (!storage->is_fat32_mounted() || !fs || fs->is_exfat()) {
+            printf("[ERREUR] FAT32 non monté\n");
+            return;
+        }
+        const char* arg = strtok(nullptr, " ");
+        if (arg && strcmp(arg, "on") == 0) {
+            fs->set_discard(storage->get_sd_card()->erase_sector_blocks());
+        } else if (arg && strcmp(arg, "off") == 0) {
+            fs->set_discard(0);
+        }
+        if (fs->get_discard_erase_blocks() == 0) {
+            printf("[INFO] Discard désactivé\n");
+        } else {
+            printf("[INFO] Discard actif: blocs de %lu secteurs, %u séquence(s) en attente, %lu secteurs effacés\n",
+                   (unsigned long)fs->get_discard_erase_blocks(), (unsigned)fs->get_discard_pending(),
+                   (unsigned long)fs->get_discarded_blocks());
+        }
+    }
+    
+    // === KV ===
+    else if (strcmp(token, "kv") == 0) {
+        if (!kv_store.is_open()) {
+            printf("[ERREUR] Stockage clé/valeur non ouvert\n");
+            return;
+        }
+        const char* action = strtok(nullptr, " ");
+        const char* key = action ? strtok(nullptr, " ") : nullptr;
+        if (!action) {
+            const KVStats& st = kv_store.get_stats();
+            printf("[INFO] %u clé(s), génération %lu, %lu octets utilisés\n", kv_store.count(),
+                   (unsigned long)kv_store.get_generation(), (unsigned long)kv_store.used_bytes());
+            printf("[INFO] %lu écriture(s), %lu lecture(s), %lu secteur(s) écrits, %lu lus, %lu compactage(s)\n",
+                   (unsigned long)st.puts, (unsigned long)st.gets, (unsigned long)st.sector_writes,
+                   (unsigned long)st.sector_reads, (unsigned long)st.compactions);
+        } else if (strcmp(action, "compact") == 0) {
+            printf(kv_store.compact() ? "[OK] Journal compacté\n" : "[ERREUR] Échec du compactage\n");
+        } else if (!key) {
+            printf("[ERREUR] Usage: kv get|del <clé>, kv set <clé> <valeur>\n");
+        } else if (strcmp(action, "get") == 0) {
+            char value[KV_Config::MAX_VALUE_LENGTH + 1];
+            int32_t n = kv_store.get(key, value, KV_Config::MAX_VALUE_LENGTH);
+            if (n < 0) {
+                printf("[INFO] '%s' absente\n", key);
+            } else {
+                value[n] = '\0';
+                printf("%s = %s\n", key, value);
+            }
+        } else if (strcmp(action, "set") == 0) {
+            const char* value = strtok(nullptr, "");
+            printf(kv_store.put_string(key, value ? value : "") ? "[OK] '%s' enregistrée\n" : "[ERREUR] Écriture de '%s' impossible\n", key);
+        } else if (strcmp(action, "del") == 0) {
+            printf(kv_store.remove(key) ? "[OK] '%s' supprimée\n" : "[INFO] '%s' absente\n", key);
+        } else {
+            printf("[ERREUR] Action inconnue: %s\n", action);
+        }
+    }
+
+    // === DHT ===
+    else if (strcmp(token, "dht") == 0) {
+        const char* action = strtok(nullptr, " ");
+        if (!action) {
+            DHT11::Reading r = dht ? dht->read() : DHT11::Reading{0.0f, 0.0f, false};
+            if (!r.valid) {
+                printf("[ERREUR] Lecture DHT11 impossible\n");
+                return;
+            }
+            if (time_series.is_open() && time_series.ingest(r.temperature, r.humidity)) {
+                printf("[OK] Mesure enregistrée (t=%lu)\n", (unsigned long)time_series.now());
+            }
+            return;
+        }
+        if (!time_series.is_open()) {
+            printf("[ERREUR] Historique non ouvert\n");
+            return;
+        }
+        static TSAggregate rows[48];
+        if (strcmp(action, "min") == 0 || strcmp(action, "hour") == 0) {
+            const TS_Tier tier = (action[0] == 'm') ? TS_MINUTE : TS_HOUR;
+            const char* n_str = strtok(nullptr, " ");
+            int n = n_str ? atoi(n_str) : (tier == TS_MINUTE ? 10 : 24);
+            if (n < 1) n = 1;
+            if (n > 48) n = 48;
+            const uint32_t reads = time_series.get_stats().sector_reads;
+            uint16_t got = time_series.query(tier, 0, rows, (uint16_t)n);
+            for (uint16_t i = 0; i < got; ++i) print_aggregate(rows[i], "");
+            TSAggregate partial;
+            if (time_series.current(tier, partial)) print_aggregate(partial, " en cours");
+            printf("[INFO] %u agrégat(s), %lu secteur(s) lu(s)\n", got,
+                   (unsigned long)(time_series.get_stats().sector_reads - reads));
+        } else if (strcmp(action, "chart") == 0) {
+            if (!tft) {
+                printf("[ERREUR] Écran TFT non initialisé\n");
+                return;
+            }
+            dashboard = nullptr;
+            browsing = false;
+            // 23 heures closes + l'heure en cours (moins juste après le démarrage)
+            const uint32_t first_hour = time_series.window_start(24);
+            uint16_t got = time_series.query(TS_HOUR, first_hour, rows, 23);
+            if (time_series.current(TS_HOUR, rows[got])) got++;
+            draw_dht_chart(rows, got, first_hour);
+            printf("[OK] Courbe affichée (%u heure(s), %u octets lus)\n", got, (unsigned)(got * sizeof(TSAggregate)));
+        } else {
+            printf("[ERREUR] Usage: dht [min [n]|hour [n]|chart]\n");
+        }
+    }
+
     // === FORMAT ===
     else if (strcmp(token, "format") == 0) {
         const char* label = strtok(nullptr, " ");
@@ -240,6 +553,9 @@ void process_command(const char* cmd, StorageManager* storage) {
             return;
         }
         
+        // Les écritures encore en file ne doivent pas passer après le formatage
+        if (storage->get_fat32_fs()) storage->get_fat32_fs()->flush();
+        
         // Formatage
         bool success = sd->format_fat32(label);
         
@@ -264,8 +580,12 @@ void process_command(const char* cmd, StorageManager* storage) {
             printf("[ERREUR] AnimationPlayer non initialisé\n");
             return;
         }
+        const char* mode = strtok(nullptr, " ");
+        anim_player->set_interlaced(mode && strcmp(mode, "i") == 0);
         
         printf("[INFO] Chargement de l'animation '%s'...\n", dirname);
+        // Trames en 240x240: retour en pleine résolution
+        if (tft && tft->getRenderScale() != RenderScale::FULL) tft->setRenderScale(RenderScale::FULL);
         
         // Charger l'animation en mode auto-détection
         bool success = anim_player->load_animation_auto_detect(dirname, dirname);
@@ -278,6 +598,19 @@ void process_command(const char* cmd, StorageManager* storage) {
         }
     }
     
+    // === FIELDS ===
+    else if (strcmp(token, "fields") == 0) {
+        const char* dirname = strtok(nullptr, " ");
+        if (!dirname || !anim_player) {
+            printf("[ERREUR] Usage: fields <répertoire>\n");
+            return;
+        }
+        anim_player->stop();
+        size_t n = anim_player->convert_to_fields(dirname);
+        if (tft) tft->sendFrame();
+        printf("[OK] %zu trame(s) rangée(s) par lignes paires/impaires\n", n);
+    }
+
     // === STOP ===
     else if (strcmp(token, "stop") == 0) {
         if (anim_player) {
@@ -304,7 +637,7 @@ void process_command(const char* cmd, StorageManager* storage) {
         }
         
         for (int i = 0; i < count; i++) {
-            balls.emplace_back(TFTConfig::WIDTH, TFTConfig::HEIGHT);
+            balls.emplace_back(tft->getScreenWidth(), tft->getScreenHeight());
         }
         
         printf("[INFO] %d balle(s) ajoutée(s) (total: %zu)\n", count, balls.size());
@@ -354,6 +687,223 @@ void process_command(const char* cmd, StorageManager* storage) {
         }
     }
     
+    // === GRADIENT ===
+    else if (strcmp(token, "gradient") == 0) {
+        if (!tft) {
+            printf("[ERREUR] Écran TFT non initialisé\n");
+            return;
+        }
+        static const uint8_t HATCH[8] = {0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81};
+        const char* kind = strtok(nullptr, " ");
+        if (!kind) kind = "linear";
+        const int w = tft->getScreenWidth();
+        const int h = tft->getScreenHeight();
+        const uint64_t start = time_us_64();
+        if (strcmp(kind, "linear") == 0) {
+            tft->fillLinearGradient(0, 0, w, h, 0, 0, COLOR_16BITS_NAVY, w - 1, h - 1, COLOR_16BITS_ORANGE);
+        } else if (strcmp(kind, "radial") == 0) {
+            tft->fillRadialGradient(0, 0, w, h, w / 2, h / 2, ((w < h) ? w : h) / 2, COLOR_16BITS_WHITE, COLOR_16BITS_NAVY);
+        } else if (strcmp(kind, "pattern") == 0) {
+            tft->fillPattern(0, 0, w, h, HATCH, COLOR_16BITS_CYAN, COLOR_16BITS_BLACK);
+        } else {
+            printf("[ERREUR] Usage: gradient [linear|radial|pattern]\n");
+            return;
+        }
+        const uint32_t elapsed = (uint32_t)(time_us_64() - start);
+        balls.clear();
+        tft->sendFrame();
+        printf("[INFO] Remplissage %s %dx%d: %lu us\n", kind, w, h, (unsigned long)elapsed);
+    }
+
+    // === SCALE ===
+    else if (strcmp(token, "scale") == 0) {
+        if (!tft) {
+            printf("[ERREUR] Écran TFT non initialisé\n");
+            return;
+        }
+        const char* n_str = strtok(nullptr, " ");
+        if (n_str) {
+            const int n = atoi(n_str);
+            if (n < 1 || n > 3) {
+                printf("[ERREUR] Usage: scale [1|2|3]\n");
+                return;
+            }
+            tft->setRenderScale(static_cast<RenderScale>(n));
+            balls.clear(); // positions en coordonnées de l'ancienne résolution
+            tft->sendFrame();
+        }
+        size_t spare = 0;
+        tft->getSpareBuffer(spare);
+        printf("[INFO] Résolution %dx%d (pixels %dx%d), %u octets libres dans le framebuffer\n",
+               tft->getScreenWidth(), tft->getScreenHeight(), (int)tft->getRenderScale(),
+               (int)tft->getRenderScale(), (unsigned)spare);
+    }
+
+    // === DUAL ===
+    else if (strcmp(token, "dual") == 0) {
+        if (!tft || !tft2) {
+            printf("[ERREUR] Second écran non configuré (TFT2Config::ENABLED)\n");
+            return;
+        }
+        if (tft->getRenderScale() != RenderScale::FULL) tft->setRenderScale(RenderScale::FULL);
+        TFTBus* bus = tft->getBus();
+        bus->reset_stats();
+        const uint32_t start = to_ms_since_boot(get_absolute_time());
+        bus->render_strips(0x03, TFTConfig::WIDTH, TFTConfig::HEIGHT, mirror_strip, tft->getFramebuffer16());
+        const TFTBusStats& bs = bus->get_stats();
+        printf("[OK] Image envoyée aux 2 écrans (miroir) en %lu ms: %lu bandes, %lu octets\n",
+               (unsigned long)(to_ms_since_boot(get_absolute_time()) - start),
+               (unsigned long)bs.strips, (unsigned long)bs.pixel_bytes);
+    }
+
+    // === COLOR ===
+    else if (strcmp(token, "color") == 0) {
+        if (!tft) {
+            printf("[ERREUR] Écran TFT non initialisé\n");
+            return;
+        }
+        ColorSettings cs = color_transform.get();
+        const char* action = strtok(nullptr, " ");
+        const char* value = strtok(nullptr, " ");
+        if (!action) {
+            // état courant seulement
+        } else if (strcmp(action, "gamma") == 0 && value) {
+            cs.gamma = (float)atof(value);
+        } else if (strcmp(action, "bright") == 0 && value) {
+            cs.brightness = atoi(value) / 100.0f;
+        } else if (strcmp(action, "warm") == 0 && value) {
+            cs.warmth = atoi(value) / 100.0f;
+        } else if (strcmp(action, "invert") == 0) {
+            cs.invert = !cs.invert;
+        } else if (strcmp(action, "night") == 0) {
+            cs.brightness = ColorTransform_Config::NIGHT_BRIGHTNESS;
+            cs.warmth = ColorTransform_Config::NIGHT_WARMTH;
+        } else if (strcmp(action, "off") == 0) {
+            cs = ColorSettings();
+        } else {
+            printf("[ERREUR] Usage: color [gamma <g>|bright <0-100>|warm <-100..100>|invert|night|off]\n");
+            return;
+        }
+        if (action) {
+            color_transform.set(cs);
+            tft->sendFrame();
+        }
+        cs = color_transform.get();
+        printf("[INFO] Couleur: gamma %.2f, luminosité %d%%, température %+d, inversion %s%s\n",
+               cs.gamma, (int)lroundf(cs.brightness * 100.0f), (int)lroundf(cs.warmth * 100.0f),
+               cs.invert ? "oui" : "non", color_transform.is_identity() ? " (neutre)" : "");
+    }
+
+    // === DASH ===
+    else if (strcmp(token, "dash") == 0) {
+        if (!tft) {
+            printf("[ERREUR] Écran TFT non initialisé\n");
+            return;
+        }
+        const char* action = strtok(nullptr, " ");
+        if (action && strcmp(action, "off") == 0) {
+            dashboard = nullptr;
+            printf("[INFO] Tableau de bord arrêté\n");
+            return;
+        }
+        static WidgetTree tree(tft);
+        if (tree.get_widget_count() == 0) {
+            if (const Canvas* title = dash_title_canvas()) {
+                static Picture dash_picture(Rect((240 - title->getWidth()) / 2, 36, title->getWidth(),
+                                                 title->getHeight()), title);
+                dash_picture.set_transparent(COLOR_16BITS_BLACK);
+                tree.add(&dash_picture);
+            } else {
+                tree.add(&dash_title);
+            }
+            tree.add(&dash_temperature);
+            tree.add(&dash_temperature_gauge);
+            tree.add(&dash_humidity);
+            tree.add(&dash_humidity_gauge);
+            tree.add(&dash_uptime);
+        }
+        if (!dashboard) {
+            // Dessin complet une fois, ensuite seulement les zones modifiées
+            if (tft->getRenderScale() != RenderScale::FULL) tft->setRenderScale(RenderScale::FULL);
+            balls.clear();
+            tree.invalidate_all();
+            tree.reset_stats();
+            dashboard = &tree;
+            browsing = false;
+        }
+        const WidgetStats& ws = tree.get_stats();
+        printf("[INFO] Tableau de bord: %lu image(s), %lu zone(s), %lu pixels redessinés, %lu dessin(s) de widget\n",
+               (unsigned long)ws.frames, (unsigned long)ws.rects, (unsigned long)ws.pixels, (unsigned long)ws.draws);
+    }
+
+    // === BROWSE ===
+    else if (strcmp(token, "browse") == 0) {
+        FAT32* fs = storage->get_fat32_fs();
+        if (!storage->is_fat32_mounted() || !fs || fs->is_exfat()) {
+            printf("[ERREUR] FAT32 non monté\n");
+            return;
+        }
+        if (!tft) {
+            printf("[ERREUR] Écran TFT non initialisé\n");
+            return;
+        }
+        static BrowseSource source;
+        // 11 lignes de 14 pixels, coins dans le cercle de l'écran rond
+        static Label title(Rect(40, 26, 160, 12), "", COLOR_16BITS_YELLOW, FontType::FONT_STANDARD, Label::CENTER);
+        static ListView view(Rect(40, 44, 160, 154), browse_row, &source, 0);
+        static WidgetTree tree(tft);
+        if (tree.get_widget_count() == 0) {
+            tree.add(&title);
+            tree.add(&view);
+        }
+
+        const char* arg = strtok(nullptr, " ");
+        if (!arg) {
+            printf("[ERREUR] Usage: browse <dir> | browse up [n] | browse down [n]\n");
+            return;
+        }
+        if (strcmp(arg, "up") == 0 || strcmp(arg, "down") == 0) {
+            if (!browsing) {
+                printf("[ERREUR] Aucune liste affichée (browse <dir>)\n");
+                return;
+            }
+            const char* n_str = strtok(nullptr, " ");
+            const int32_t n = n_str ? atoi(n_str) : 1;
+            view.scroll(strcmp(arg, "up") == 0 ? -n : n);
+        } else {
+            if (!fs->push_directory(arg)) {
+                printf("[ERREUR] Répertoire introuvable: %s\n", arg);
+                return;
+            }
+            source.fs = fs;
+            const bool opened = fs->dir_iterator_open(source.it);
+            fs->pop_directory();
+            if (!opened) {
+                printf("[ERREUR] Parcours impossible: %s\n", arg);
+                return;
+            }
+            // Un seul passage jusqu'au bout: nombre d'entrées et points de reprise
+            const uint32_t count = fs->dir_iterator_count(source.it);
+            view.set_source(browse_row, &source, count);
+            title.set_text(arg);
+            if (!browsing) {
+                if (tft->getRenderScale() != RenderScale::FULL) tft->setRenderScale(RenderScale::FULL);
+                balls.clear();
+                tree.invalidate_all();
+                browsing = true;
+            }
+        }
+        view.reset_stats();
+        tree.reset_stats();
+        tree.render();
+        const ListViewStats& ls = view.get_stats();
+        const WidgetStats& ws = tree.get_stats();
+        printf("[INFO] Première entrée %lu / %lu: %lu lue(s), %lu en cache, %lu ligne(s) dessinée(s), %lu pixels redessinés, %lu déplacés\n",
+               (unsigned long)view.get_first(), (unsigned long)view.get_count(),
+               (unsigned long)ls.fetches, (unsigned long)ls.hits, (unsigned long)ls.rows_drawn,
+               (unsigned long)ws.pixels, (unsigned long)ws.moved_pixels);
+    }
+
     // === INFO ===
     else if (strcmp(token, "info") == 0) {
         printf("\n=== INFORMATIONS SYSTÈME ===\n");
@@ -364,10 +914,16 @@ void process_command(const char* cmd, StorageManager* storage) {
             printf("  Carte SD: Non montée\n");
         }
         if (tft) {
-            printf("  Écran TFT: Initialisé (%dx%d)\n", TFTConfig::WIDTH, TFTConfig::HEIGHT);
+            printf("  Écran TFT: Initialisé (%dx%d)\n", tft->getScreenWidth(), tft->getScreenHeight());
         } else {
             printf("  Écran TFT: Non initialisé\n");
         }
+        if (image_cache) {
+            const ImageCacheStats& cs = image_cache->get_stats();
+            printf("  Cache images: %lu succès, %lu défauts, %lu invalidées, %lu évincées\n",
+                   (unsigned long)cs.hits, (unsigned long)cs.misses,
+                   (unsigned long)cs.invalidations, (unsigned long)cs.evictions);
+        }
         printf("===========================\n");
     }
 
@@ -449,14 +1005,38 @@ int main() {
     // Initialiser l'écran TFT (utilise la configuration dans main.h)
     tft = new TFT();
     tft->init();
+    tft->setColorTransform(&color_transform);
+    if (TFT2Config::ENABLED) {
+        TFTBus& bus = TFTBus::default_bus();
+        int8_t second = bus.add_panel(TFTPins{(uint8_t)TFT2Config::PIN_CS, (uint8_t)TFT2Config::PIN_DC,
+                                              (uint8_t)TFT2Config::PIN_RST});
+        if (second >= 0) {
+            tft2 = new TFT(&bus, (uint8_t)second);
+            tft2->init();
+            printf("[OK] Second écran initialisé (CS=%d, DC=%d)\n", TFT2Config::PIN_CS, TFT2Config::PIN_DC);
+        }
+    }
     tft->clear();
-    printf("[OK] TFT initialisé (%dx%d)\n", TFTConfig::WIDTH, TFTConfig::HEIGHT);
+    printf("[OK] TFT %s initialisé (%dx%d)\n", TFT::getPanelName(), TFTConfig::WIDTH, TFTConfig::HEIGHT);
 
     
     // Initialiser l'AnimationPlayer
     anim_player = new AnimationPlayer(&storage, tft);
     printf("[OK] AnimationPlayer initialisé\n");
 
+    image_cache = new ImageCache(&storage);
+
+    if (!storage.get_fat32_fs()->is_exfat() && kv_store.open(storage.get_fat32_fs())) {
+        printf("[OK] Stockage clé/valeur ouvert\n");
+    }
+
+    dht = new DHT11(DHT11Config::PIN_DATA);
+    if (!storage.get_fat32_fs()->is_exfat() && time_series.open(storage.get_fat32_fs())) {
+        printf("[OK] Historique DHT11 ouvert\n");
+    }
+    uint32_t last_sample_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t last_dashboard_s = 0;
+
     printf("\n> "); // Premier prompt
     // Boucle principale
     cmd_buffer.reserve(128);
@@ -471,7 +1051,7 @@ int main() {
                 tft->drawFillCircle((int)ball.x, (int)ball.y, ball.radius, COLOR_16BITS_BLACK);
 
                 // Mettre à jour la position
-                ball.update(TFTConfig::WIDTH, TFTConfig::HEIGHT);
+                ball.update(tft->getScreenWidth(), tft->getScreenHeight());
 
                 // Dessiner à la nouvelle position
                 tft->drawFillCircle((int)ball.x, (int)ball.y, ball.radius, ball.color);
@@ -486,6 +1066,35 @@ int main() {
             anim_player->update();
         }
         
+        // Temps mort (ni animation ni balles): vider la file d'écriture puis
+        // effacer les clusters libérés en attente
+        if (balls.empty() && (!anim_player || !anim_player->is_playing())) {
+            // Échantillonnage périodique du DHT11 (~25 ms bloquantes)
+            const uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+            if ((time_series.is_open() || dashboard) && now_ms - last_sample_ms >= TS_Config::SAMPLE_PERIOD_MS) {
+                last_sample_ms = now_ms;
+                DHT11::Reading r = dht->read(false);
+                if (r.valid && time_series.is_open()) time_series.ingest(r.temperature, r.humidity);
+                if (r.valid && dashboard) update_dashboard(r);
+            }
+            if (dashboard) {
+                // Une seule zone par seconde (le compteur), rien sinon
+                if (now_ms / 1000u != last_dashboard_s) {
+                    last_dashboard_s = now_ms / 1000u;
+                    char text[Widget_Config::LABEL_MAX];
+                    snprintf(text, sizeof(text), "%lu s", (unsigned long)last_dashboard_s);
+                    dash_uptime.set_text(text);
+                }
+                dashboard->render();
+            }
+            // Carte encore en programmation (écriture différée): revenir au
+            // tour suivant plutôt que d'attendre le busy dans flush/discard
+            if (!storage.get_sd_card()->is_busy()) {
+                storage.get_fat32_fs()->flush();
+                storage.get_fat32_fs()->process_discards();
+            }
+        }
+        
         sleep_ms(1); // Petite pause pour ne pas saturer le CPU
     }
     
@@ -14,7 +14,7 @@
 #include "hardware/structs/scb.h"
 #include "hardware/regs/m0plus.h"
 #include "Color.h" // couleurs RGB565 prédéfinies   
-#include "ScrollableArea.h"
+#include "PanelTraits.h"
 #include "DHT11.h"
 #include "font_mini.h"
 #include "font_standard.h"
@@ -30,13 +30,26 @@ struct TFTConfig {
     static constexpr int PIN_RST          = 7;
     // static constexpr int PIN_BL        = 14; // Uncomment if needed
 
-    static constexpr int WIDTH            = 240;
-    static constexpr int HEIGHT           = 240;
+    // Contrôleur monté (PanelTraits.h): GC9A01Panel, ST7789Panel, ILI9341Panel
+    using Panel = GC9A01Panel;
+    static constexpr int WIDTH            = Panel::WIDTH;
+    static constexpr int HEIGHT           = Panel::HEIGHT;
     static constexpr int BYTES_PER_PIXEL  = 2;
     static constexpr int FB_SIZE_BYTES    = WIDTH * HEIGHT * BYTES_PER_PIXEL;
     static constexpr int SPI_BAUDRATE     = 62000000; // 62 MHz
 };
 
+// Second écran (même contrôleur) optionnel sur spi0 (yeux, tableau de bord)
+struct TFT2Config {
+    static constexpr bool ENABLED         = false;
+    static constexpr int PIN_CS           = 8;
+    static constexpr int PIN_DC           = 9;
+    static constexpr int PIN_RST          = TFTConfig::PIN_RST; // reset commun
+};
+
 struct DHT11Config {
     static constexpr int PIN_DATA = 4;  // GPIO4 pour DHT11
-};
\ No newline at end of file
+};
+
+// Après TFTConfig: ScrollableArea désigne TFT par TFTConfig::Panel
+#include "ScrollableArea.h"
@@ -0,0 +1,26 @@
+#pragma once
+
+/*
+ * Pico SDK des tests hôte - SPI. spi0/spi1 sont des pointeurs définis par
+ * le test qui simule le bus (écran ou carte SD).
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct spi_inst spi_inst_t;
+extern spi_inst_t *spi0_p, *spi1_p;
+#define spi0 spi0_p
+#define spi1 spi1_p
+
+typedef unsigned int uint;
+#define SPI_MSB_FIRST 1
+#define SPI_CPOL_0 0
+#define SPI_CPHA_0 0
+
+uint spi_init(spi_inst_t*, uint);
+uint spi_set_baudrate(spi_inst_t*, uint);
+void spi_set_format(spi_inst_t*, uint, int, int, int);
+int spi_write_blocking(spi_inst_t*, const uint8_t*, size_t);
+int spi_read_blocking(spi_inst_t*, uint8_t, uint8_t*, size_t);
+int spi_write_read_blocking(spi_inst_t*, const uint8_t*, uint8_t*, size_t);
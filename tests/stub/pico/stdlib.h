@@ -0,0 +1,40 @@
+#pragma once
+
+/*
+ * Pico SDK des tests hôte - déclarations utilisées par les sources du
+ * projet. Les définitions viennent des tests (horloge, GPIO, SPI simulés).
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+typedef uint64_t absolute_time_t;
+typedef unsigned int uint;
+
+absolute_time_t get_absolute_time(void);
+uint32_t to_ms_since_boot(absolute_time_t);
+int64_t absolute_time_diff_us(absolute_time_t, absolute_time_t);
+absolute_time_t make_timeout_time_ms(uint32_t);
+void sleep_ms(uint32_t);
+void sleep_us(uint64_t);
+uint32_t time_us_32(void);
+uint64_t time_us_64(void);
+static inline void tight_loop_contents(void) {}
+
+void stdio_init_all(void);
+int getchar_timeout_us(uint32_t);
+#define PICO_ERROR_TIMEOUT (-1)
+
+#define GPIO_OUT 1
+#define GPIO_IN 0
+#define GPIO_FUNC_SPI 1
+void gpio_init(uint);
+void gpio_put(uint, bool);
+bool gpio_get(uint);
+void gpio_set_dir(uint, bool);
+void gpio_set_function(uint, int);
+void gpio_pull_up(uint);
+
+#include "hardware/spi.h"
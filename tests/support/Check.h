@@ -0,0 +1,21 @@
+#pragma once
+
+/*
+ * Check - vérifications des tests hôte: une ligne par vérification,
+ * code de sortie non nul si l'une d'elles échoue.
+ */
+
+#include <cstdio>
+
+inline int check_failures = 0;
+
+inline void check(bool ok, const char* what) {
+    printf("%-60s %s\n", what, ok ? "ok" : "FAIL");
+    if (!ok) check_failures++;
+}
+
+// Bilan en fin de main(): return check_report();
+inline int check_report() {
+    printf(check_failures ? "%d FAILURE(S)\n" : "ALL OK\n", check_failures);
+    return check_failures != 0;
+}
@@ -0,0 +1,25 @@
+/*
+Nom du fichier : HostClock.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Horloge du Pico pour les tests hôte: temps réel de l'hôte depuis le lancement,
+              plus l'avance demandée par le test (HostClock::advance_ms)
+*/
+
+#include "HostClock.h"
+#include "pico/stdlib.h"
+#include <chrono>
+
+namespace HostClock {
+    static uint64_t offset_us = 0;
+
+    void advance_ms(uint32_t ms) { offset_us += (uint64_t)ms * 1000; }
+}
+
+absolute_time_t get_absolute_time() {
+    static const auto t0 = std::chrono::steady_clock::now();
+    return (absolute_time_t)(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count() +
+                             HostClock::offset_us);
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
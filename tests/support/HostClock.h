@@ -0,0 +1,13 @@
+#pragma once
+
+/*
+ * HostClock - horloge du Pico pour les tests hôte: temps réel de l'hôte
+ * depuis le lancement, plus une avance réglée par le test (délais des
+ * boucles d'affichage sans attendre).
+ */
+
+#include <cstdint>
+
+namespace HostClock {
+    void advance_ms(uint32_t ms);
+}
@@ -0,0 +1,106 @@
+/*
+Nom du fichier : ImageCard.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Carte SD des tests hôte, adossée à un fichier image
+*/
+
+#include "SDCard.h"
+#include "ImageCard.h"
+
+namespace ImageCard {
+    FILE* image = nullptr;
+    unsigned long reads = 0, writes = 0, commands = 0, cost_us = 0;
+    unsigned long write_budget = ~0UL;
+    long write_fail = -1;
+    long read_blocks_fail = -1;
+    uint32_t au_blocks = 0;
+    std::vector<std::pair<uint32_t, uint32_t>> erases;
+
+    bool open(const char* path) {
+        image = path ? fopen(path, "r+b") : nullptr;
+        if (!image) printf("ImageCard: image %s introuvable\n", path ? path : "(aucune)");
+        return image != nullptr;
+    }
+
+    bool create(uint32_t blocks) {
+        image = tmpfile();
+        if (!image) return false;
+        static const uint8_t zero[512] = {};
+        for (uint32_t b = 0; b < blocks; b++) fwrite(zero, 1, 512, image);
+        return fflush(image) == 0;
+    }
+
+    uint32_t fat_entry(uint32_t fat_base, uint32_t cluster) {
+        uint8_t entry[4];
+        fseek(image, (long)(fat_base + cluster / 128) * 512 + (cluster % 128) * 4, SEEK_SET);
+        if (fread(entry, 1, 4, image) != 4) return ~0u;
+        return ((uint32_t)entry[0] | entry[1] << 8 | entry[2] << 16 | (uint32_t)entry[3] << 24) & 0x0FFFFFFF;
+    }
+
+    static bool write_allowed() {
+        if (write_budget == 0) return false;
+        if (write_budget != ~0UL) write_budget--;
+        return true;
+    }
+
+    static bool put(uint32_t block, const uint8_t* src) {
+        if (write_fail >= 0 && write_fail-- == 0) return false;
+        if (!write_allowed()) return true;      // perdue, mais la carte a répondu
+        fseek(image, (long)block * 512, SEEK_SET);
+        return fwrite(src, 1, 512, image) == 512;
+    }
+
+    static uint32_t write_cursor = 0;
+}
+
+using namespace ImageCard;
+
+SDCard::SDCard() { initialized = true; }
+SDCard::~SDCard() {}
+
+bool SDCard::read_block(uint32_t block, uint8_t* buffer) {
+    commands++; cost_us += 100 + 350; reads++;
+    fseek(image, (long)block * 512, SEEK_SET);
+    return fread(buffer, 1, 512, image) == 512;
+}
+
+bool SDCard::read_blocks(uint32_t block, uint32_t count, uint8_t* buffer) {
+    if (read_blocks_fail >= 0 && read_blocks_fail-- == 0) return false;
+    commands++; cost_us += 150 + 350 * count; reads += count;
+    fseek(image, (long)block * 512, SEEK_SET);
+    return fread(buffer, 1, 512 * count, image) == 512 * count;
+}
+
+bool SDCard::write_block(uint32_t block, const uint8_t* buffer) {
+    commands++; cost_us += 100 + 350 + 1200; writes++;
+    return put(block, buffer);
+}
+
+bool SDCard::write_start(uint32_t block, uint32_t) {
+    commands++; cost_us += 150;
+    write_cursor = block;
+    return true;
+}
+
+bool SDCard::write_data(const uint8_t* src) {
+    writes++; cost_us += 350 + 150;
+    return put(write_cursor++, src);
+}
+
+bool SDCard::write_stop() { cost_us += 1200; return true; }
+bool SDCard::sync() { return true; }
+
+bool SDCard::erase(uint32_t firstBlock, uint32_t lastBlock) {
+    erases.push_back({firstBlock, lastBlock});
+    return true;
+}
+
+uint32_t SDCard::erase_sector_blocks() { return 0; }
+
+bool SDCard::allocation_unit_info(uint32_t& au, uint8_t& speed_class) {
+    au = au_blocks; speed_class = au_blocks ? 10 : 0;
+    return au_blocks != 0;
+}
+
+void SD_print_buffer_hex(const uint8_t*, size_t, size_t) {}
@@ -0,0 +1,38 @@
+#pragma once
+
+/*
+ * ImageCard - carte SD des tests hôte: les blocs sont lus et écrits dans un
+ * fichier image (tools/mk*.py) à la place du bus SPI. SDCard.cpp n'est pas
+ * compilé avec ImageCard.cpp; les compteurs et les pannes simulées sont ici.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace ImageCard {
+    // Ouvre l'image en lecture/écriture; false si le fichier est absent
+    bool open(const char* path);
+    // Image anonyme de 'blocks' blocs à zéro (supprimée à la sortie)
+    bool create(uint32_t blocks);
+    // Entrée de la première FAT lue directement dans l'image (sans le cache du pilote)
+    uint32_t fat_entry(uint32_t fat_base, uint32_t cluster);
+
+    extern FILE* image;
+    extern unsigned long reads;         // blocs lus
+    extern unsigned long writes;        // blocs écrits
+    extern unsigned long commands;      // commandes SD (une par bloc isolé, une par suite multi-blocs)
+    // Temps modélisé (µs): commande + accès, transfert de 512 o à 12 MHz, programmation
+    extern unsigned long cost_us;
+    // Coupure d'alimentation simulée: écritures ignorées une fois le budget épuisé (~0: illimité)
+    extern unsigned long write_budget;
+    // Panne d'écriture simulée: le write_fail-ième bloc écrit est refusé (-1: jamais)
+    extern long write_fail;
+    // Panne de lecture simulée: la read_blocks_fail-ième commande multi-blocs échoue (-1: jamais)
+    extern long read_blocks_fail;
+    // Unité d'allocation annoncée par allocation_unit_info, en blocs (0: registre illisible)
+    extern uint32_t au_blocks;
+    // Effacements demandés (premier bloc, dernier bloc)
+    extern std::vector<std::pair<uint32_t, uint32_t>> erases;
+}
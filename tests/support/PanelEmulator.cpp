@@ -0,0 +1,150 @@
+/*
+Nom du fichier : PanelEmulator.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Bus SPI des écrans pour les tests hôte (voir PanelEmulator.h)
+*/
+
+#include "PanelEmulator.h"
+#include "main.h"
+
+spi_inst_t* spi0_p = nullptr;
+spi_inst_t* spi1_p = nullptr;
+
+namespace PanelEmulator {
+    std::vector<Panel> panels;
+    unsigned long writes = 0, orphans = 0, overlaps = 0, reset_pulses = 0;
+    std::vector<int> pixel_runs;
+    std::vector<unsigned long> run_bytes;
+    bool record = false;
+    std::vector<std::string> events;
+
+    int attach(int cs, int dc, int width, int height) {
+        Panel p;
+        p.cs = cs;
+        p.dc = dc;
+        p.width = width;
+        p.height = height;
+        p.x1 = width - 1;
+        p.y1 = height - 1;
+        p.mem.assign((size_t)width * height, 0xDEAD);
+        panels.push_back(p);
+        return (int)panels.size() - 1;
+    }
+
+    void clear() {
+        for (auto& p : panels) {
+            p.mem.assign(p.mem.size(), 0xDEAD);
+            p.bytes = p.commands = p.pixels = p.selects = 0;
+        }
+        writes = 0;
+        pixel_runs.clear();
+        run_bytes.clear();
+        events.clear();
+    }
+
+    static void log(const char* format, unsigned long value) {
+        if (!record) return;
+        char b[32];
+        snprintf(b, sizeof b, format, value);
+        events.push_back(b);
+    }
+
+    static void receive(Panel& p, uint8_t b) {
+        if (!p.data) {
+            p.command = b;
+            p.args.clear();
+            p.commands++;
+            if (b == 0x2C) {
+                p.cx = p.x0;
+                p.cy = p.y0;
+                p.high = true;
+            }
+            return;
+        }
+        p.bytes++;
+        if (p.command == 0x2A || p.command == 0x2B) {
+            p.args.push_back(b);
+            if (p.args.size() == 4) {
+                const int a = p.args[0] << 8 | p.args[1], e = p.args[2] << 8 | p.args[3];
+                if (p.command == 0x2A) { p.x0 = a; p.x1 = e; }
+                else { p.y0 = a; p.y1 = e; }
+            }
+            return;
+        }
+        if (p.command != 0x2C) return;
+        if (p.high) {
+            p.first = b;
+            p.high = false;
+            return;
+        }
+        p.high = true;
+        p.pixels++;
+        if (p.cx < p.width && p.cy < p.height) p.mem[p.cy * p.width + p.cx] = (uint16_t)(p.first | b << 8);
+        if (++p.cx > p.x1) {
+            p.cx = p.x0;
+            if (++p.cy > p.y1) p.cy = p.y0;
+        }
+    }
+}
+
+using namespace PanelEmulator;
+
+uint spi_init(spi_inst_t*, uint baudrate) { return baudrate; }
+uint spi_set_baudrate(spi_inst_t*, uint baudrate) { return baudrate; }
+void spi_set_format(spi_inst_t*, uint, int, int, int) {}
+
+int spi_write_blocking(spi_inst_t*, const uint8_t* src, size_t len) {
+    writes++;
+    int id = -1;
+    for (size_t i = 0; i < panels.size(); i++)
+        if (panels[i].selected) id = (int)i;
+    if (id < 0) {
+        orphans++;
+        if (record) events.push_back("ORPHAN");
+        return (int)len;
+    }
+    Panel& p = panels[id];
+    if (record) {
+        if (p.data && len > 16) log("px %lu", len);
+        else
+            for (size_t i = 0; i < len; i++) {
+                char b[16];
+                snprintf(b, sizeof b, "%c %02X", p.data ? 'D' : 'C', src[i]);
+                events.push_back(b);
+            }
+    }
+    for (size_t i = 0; i < len; i++) receive(p, src[i]);
+    if (p.data && p.command == 0x2C) {
+        if (pixel_runs.empty() || pixel_runs.back() != id) {
+            pixel_runs.push_back(id);
+            run_bytes.push_back(0);
+        }
+        run_bytes.back() += len;
+    }
+    return (int)len;
+}
+
+void gpio_init(uint) {}
+void gpio_set_dir(uint, bool) {}
+void gpio_set_function(uint, int) {}
+
+void gpio_put(uint pin, bool value) {
+    if ((int)pin == TFTConfig::PIN_RST) {
+        if (!value) reset_pulses++;
+        log("rst %lu", value);
+    }
+    int low = 0;
+    for (auto& p : panels) {
+        if ((int)pin == p.cs) {
+            if (!value && !p.selected) p.selects++;
+            p.selected = !value;
+        }
+        if ((int)pin == p.dc) p.data = value;
+        low += p.selected;
+    }
+    if (low > 1) overlaps++;
+}
+
+void sleep_ms(uint32_t ms) { log("delay %lu", ms); }
+void sleep_us(uint64_t) {}
@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ * PanelEmulator - écrans SPI des tests hôte: spi_write_blocking et gpio_put
+ * sont définis ici. Chaque écran attaché (broches CS et DC) interprète
+ * CASET/RASET/RAMWR et range les pixels reçus dans sa mémoire, octets dans
+ * l'ordre du framebuffer. Le flux peut aussi être enregistré tel quel.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace PanelEmulator {
+    struct Panel {
+        int cs, dc;
+        int width, height;
+        std::vector<uint16_t> mem;          // 0xDEAD: jamais écrit
+        bool selected = false;
+        bool data = false;
+        int command = -1;
+        std::vector<uint8_t> args;
+        int x0 = 0, x1 = 0, y0 = 0, y1 = 0, cx = 0, cy = 0;
+        bool high = true;
+        uint8_t first = 0;
+        unsigned long bytes = 0;            // octets de données (paramètres et pixels)
+        unsigned long commands = 0;
+        unsigned long pixels = 0;
+        unsigned long selects = 0;          // fronts descendants de CS
+    };
+
+    // Ajoute un écran; retourne son indice
+    int attach(int cs, int dc, int width = 240, int height = 240);
+    // Mémoires remises à 0xDEAD, compteurs des écrans à zéro (writes aussi);
+    // orphans, overlaps et reset_pulses couvrent tout le test
+    void clear();
+
+    extern std::vector<Panel> panels;
+    extern unsigned long writes;            // appels à spi_write_blocking
+    extern unsigned long orphans;           // écritures sans écran sélectionné
+    extern unsigned long overlaps;          // plusieurs CS bas à la fois
+    extern unsigned long reset_pulses;      // RST (TFTConfig::PIN_RST) mis à 0
+    // Écrans successivement alimentés en pixels, et octets de chaque série
+    extern std::vector<int> pixel_runs;
+    extern std::vector<unsigned long> run_bytes;
+    // Enregistrement: "C 2A", "D 00", "px n" (données de plus de 16 octets),
+    // "delay n", "rst n", "ORPHAN"
+    extern bool record;
+    extern std::vector<std::string> events;
+}
@@ -0,0 +1,151 @@
+/*
+Nom du fichier : SpiCard.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Carte SD simulée au niveau SPI (et horloge virtuelle) pour les tests de SDCard.cpp
+*/
+
+#include "pico/stdlib.h"
+#include "SDCard.h"
+#include "SpiCard.h"
+#include <deque>
+#include <map>
+
+namespace SpiCard {
+    uint64_t now_us = 0;
+    uint64_t program_us = 1500;
+    uint32_t violations = 0;
+    long reject_block = -1;
+    std::vector<std::string> log;
+
+    static std::map<uint32_t, std::vector<uint8_t>> blocks;
+    static std::deque<uint8_t> out;          // octets que la carte va émettre
+    static bool cs_low = false;
+    static bool idle = true;                 // avant ACMD41
+    static uint64_t busy_until = 0;
+    static uint8_t cmd[6];
+    static int cmd_len = 0;
+    enum State { IDLE, WAIT_TOKEN, DATA };
+    static State state = IDLE;
+    static bool multi = false;
+    static uint32_t write_at = 0;
+    static std::vector<uint8_t> incoming;
+
+    std::vector<uint8_t> block(uint32_t number) {
+        auto it = blocks.find(number);
+        return it != blocks.end() ? it->second : std::vector<uint8_t>(512, (uint8_t)number);
+    }
+
+    static void send_block(uint32_t number) {
+        out.push_back(0xFF);
+        out.push_back(0xFE);
+        for (uint8_t b : block(number)) out.push_back(b);
+        out.push_back(0); out.push_back(0);
+    }
+
+    static void command(uint8_t c, uint32_t arg) {
+        log.push_back("CMD" + std::to_string(c));
+        const uint8_t r1 = idle ? 0x01 : 0x00;
+        out.push_back(0xFF);
+        switch (c) {
+            case 0: idle = true; out.push_back(0x01); break;
+            case 8: out.push_back(0x01); out.push_back(0); out.push_back(0); out.push_back(0x01); out.push_back(0xAA); break;
+            case 41: idle = false; out.push_back(0x00); break;
+            case 58: out.push_back(r1); out.push_back(0xC0); out.push_back(0xFF); out.push_back(0x80); out.push_back(0x00); break;
+            case 12: out.clear(); out.push_back(0xFF); out.push_back(0x00); break;
+            case 13: out.push_back(0x00); out.push_back(0x00); break;
+            case 17: out.push_back(0x00); send_block(arg); break;
+            case 18: out.push_back(0x00); for (uint32_t b = 0; b < 64; b++) send_block(arg + b); break;
+            case 24: case 25:
+                out.push_back(0x00);
+                state = WAIT_TOKEN; multi = c == 25; write_at = arg;
+                break;
+            case 16: case 23: case 55: out.push_back(r1); break;
+            default: out.push_back(0x04); break;      // commande illégale
+        }
+    }
+
+    static uint8_t exchange(uint8_t in) {
+        now_us += 1;
+        if (!cs_low) return 0xFF;
+        const bool busy = now_us < busy_until;
+        uint8_t r = busy ? 0x00 : 0xFF;
+        if (!out.empty()) { r = out.front(); out.pop_front(); }
+
+        if (state == DATA) {
+            incoming.push_back(in);
+            if (incoming.size() < 514) return r;
+            state = multi ? WAIT_TOKEN : IDLE;
+            busy_until = now_us + 2 + program_us;
+            if (reject_block >= 0 && reject_block-- == 0) {
+                out.push_back(0x0B);                  // bloc refusé (CRC)
+                log.push_back("REJECT");
+            } else {
+                out.push_back(0xE5);                  // bloc accepté
+                incoming.resize(512);
+                blocks[write_at++] = incoming;
+                log.push_back("DATA");
+            }
+            return r;
+        }
+        if (state == WAIT_TOKEN && cmd_len == 0) {
+            if ((in == 0xFE && !multi) || (in == 0xFC && multi)) { state = DATA; incoming.clear(); return r; }
+            if (in == 0xFD && multi) {
+                state = IDLE;
+                out.push_back(0xFF);
+                busy_until = now_us + 3 + program_us;
+                log.push_back("STOP_TRAN");
+                return r;
+            }
+            if ((in & 0xC0) != 0x40) return r;
+            violations++;                             // commande lue comme des données
+            log.push_back("IN_WRITE");
+            state = IDLE;
+        }
+        if (cmd_len == 0 && (in & 0xC0) != 0x40) return r;
+        if (cmd_len == 0 && busy) { violations++; log.push_back("BUSY"); }
+        cmd[cmd_len++] = in;
+        if (cmd_len == 6) {
+            cmd_len = 0;
+            command(cmd[0] & 0x3F, (uint32_t)cmd[1] << 24 | cmd[2] << 16 | cmd[3] << 8 | cmd[4]);
+        }
+        return r;
+    }
+}
+
+using namespace SpiCard;
+
+spi_inst_t* spi0_p = nullptr;
+spi_inst_t* spi1_p = nullptr;
+
+absolute_time_t get_absolute_time() { return now_us; }
+uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+absolute_time_t make_timeout_time_ms(uint32_t ms) { return now_us + ms * 1000ull; }
+void sleep_ms(uint32_t ms) { now_us += ms * 1000ull; }
+void sleep_us(uint64_t us) { now_us += us; }
+uint32_t time_us_32() { return (uint32_t)now_us; }
+uint64_t time_us_64() { return now_us; }
+
+void gpio_init(uint) {}
+void gpio_set_dir(uint, bool) {}
+void gpio_set_function(uint, int) {}
+void gpio_pull_up(uint) {}
+bool gpio_get(uint) { return true; }
+void gpio_put(uint pin, bool value) { if (pin == (uint)SDCardConfig::PIN_CS) cs_low = !value; }
+
+uint spi_init(spi_inst_t*, uint baud) { return baud; }
+uint spi_set_baudrate(spi_inst_t*, uint baud) { return baud; }
+void spi_set_format(spi_inst_t*, uint, int, int, int) {}
+int spi_write_read_blocking(spi_inst_t*, const uint8_t* src, uint8_t* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = exchange(src[i]);
+    return (int)n;
+}
+int spi_write_blocking(spi_inst_t*, const uint8_t* src, size_t n) {
+    for (size_t i = 0; i < n; i++) exchange(src[i]);
+    return (int)n;
+}
+int spi_read_blocking(spi_inst_t*, uint8_t tx, uint8_t* dst, size_t n) {
+    for (size_t i = 0; i < n; i++) dst[i] = exchange(tx);
+    return (int)n;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+/*
+ * SpiCard - carte SD SDHC simulée au niveau du bus SPI, pour tester
+ * SDCard.cpp sur l'hôte. Temps virtuel: chaque octet échangé dure 1 µs,
+ * sleep_ms/sleep_us l'avancent. Après un bloc écrit la carte reste occupée
+ * program_us (MISO à 0); une commande envoyée pendant ce temps, ou pendant
+ * qu'un CMD24/CMD25 attend ses données, est comptée dans violations.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SpiCard {
+    extern uint64_t now_us;                 // temps virtuel
+    extern uint64_t program_us;             // programmation d'un bloc
+    extern uint32_t violations;
+    extern long reject_block;               // n-ième bloc de données refusé (-1: jamais)
+    extern std::vector<std::string> log;    // "CMD24", "DATA", "REJECT", "STOP_TRAN"...
+
+    // Contenu d'un bloc: écrit, sinon rempli de (uint8_t)block
+    std::vector<uint8_t> block(uint32_t number);
+}
@@ -0,0 +1,97 @@
+/*
+Nom du fichier : test_au.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Placement des gros fichiers sur des unités d'allocation (AU)
+              libres (tools/mktree.py, clusters de 4 KB, une trame sur trois
+              effacée, AU simulée de 64 KB). Usage: test_au <image>
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstring>
+
+static const uint32_t AU = 128;            // blocs de 512 o
+static uint8_t scratch[8192];
+
+struct Placement {
+    unsigned clusters = 0;
+    unsigned runs = 0;            // séquences de clusters contigus
+    unsigned unaligned = 0;       // entrées dans une AU ailleurs qu'au début
+    unsigned partial = 0;         // AU entamées mais pas remplies (hors dernière)
+};
+
+static Placement analyse(FAT32& fs, const char* name) {
+    Placement p;
+    std::vector<FileListEntry> l;
+    fs.change_directory("/");
+    fs.list_directory(l);
+    uint32_t first = 0;
+    for (auto& e : l) if (!strcmp(e.dosFileName, name)) first = e.firstCluster;
+    std::vector<uint32_t> chain;
+    for (uint32_t c = first; c >= 2 && c < 0x0FFFFFF8 && chain.size() < 100000; c = ImageCard::fat_entry(fs.get_fat_base(), c))
+        chain.push_back(c);
+    const uint32_t cs = fs.get_cluster_size();
+    auto lba = [&](uint32_t c) { return fs.get_data_base() + (c - 2) * cs; };
+    p.clusters = chain.size();
+    std::vector<std::pair<uint32_t, unsigned>> aus;     // AU, clusters dedans
+    for (size_t i = 0; i < chain.size(); i++) {
+        if (i == 0 || chain[i] != chain[i - 1] + 1) p.runs++;
+        const uint32_t au = lba(chain[i]) / AU;
+        if (aus.empty() || aus.back().first != au) {
+            if (lba(chain[i]) % AU >= cs) p.unaligned++;
+            aus.push_back({au, 0});
+        }
+        aus.back().second++;
+    }
+    for (size_t i = 0; i + 1 < aus.size(); i++)
+        if (aus[i].second * cs < AU - cs) p.partial++;
+    return p;
+}
+
+static void write_file(FAT32& fs, const char* name, uint32_t size) {
+    static uint8_t blk[512];
+    memset(blk, 0x5A, sizeof blk);
+    fs.set_expected_size(size);
+    fs.file_open(name, CREATE);
+    for (uint32_t o = 0; o < size; o += 512) fs.file_write(blk, 512);
+    fs.file_close();
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+    printf("data area at LBA %u, %u sectors per cluster, AU %u sectors\n", fs.get_data_base(), fs.get_cluster_size(), AU);
+
+    // Clusters libres fragmentés: une trame sur trois effacée
+    char p[32];
+    for (int i = 0; i < 161; i += 3) { snprintf(p, sizeof p, "/OLDANIM/FR_%03d.RAW", i); fs.delete_file(p); }
+
+    fs.set_allocation_unit(AU);
+    write_file(fs, "/SMALL.TXT", 4096);
+    write_file(fs, "/BIGAU.BIN", 400 * 1024);
+    fs.set_allocation_unit(0);
+    write_file(fs, "/BIGOLD.BIN", 400 * 1024);
+
+    const Placement small = analyse(fs, "SMALL.TXT"), au = analyse(fs, "BIGAU.BIN"), old = analyse(fs, "BIGOLD.BIN");
+    printf("BIGAU.BIN:  %u clusters, %u runs, %u unaligned AU entries, %u partly used AUs\n", au.clusters, au.runs, au.unaligned, au.partial);
+    printf("BIGOLD.BIN: %u clusters, %u runs, %u unaligned AU entries, %u partly used AUs\n", old.clusters, old.runs, old.unaligned, old.partial);
+    check(small.clusters == 1, "a file under one AU keeps the first-fit placement");
+    check(au.clusters == 100 && au.unaligned == 0 && au.partial == 0, "a 400 KB file fills whole, aligned AUs");
+    check(old.runs > au.runs, "  fewer runs than the first-fit placement");
+
+    // Plus d'AU libre de cette taille: repli sur le placement linéaire
+    fs.set_allocation_unit(1u << 20);
+    write_file(fs, "/NOAU.BIN", 8192);
+    check(analyse(fs, "NOAU.BIN").clusters == 2, "no free AU: falls back to first fit");
+    fs.set_allocation_unit(0);
+
+    FsckReport r;
+    fs.check_filesystem(r, scratch, sizeof scratch);
+    check(r.error_count() == 0, "fsck clean");
+    return check_report();
+}
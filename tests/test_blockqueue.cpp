@@ -0,0 +1,72 @@
+/*
+Nom du fichier : test_blockqueue.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : BlockScheduler face à une carte qui refuse un bloc: la séquence
+              refusée reste en file (flush() relançable, secteurs toujours
+              servis par read()), une file pleine refuse le secteur suivant
+              sans rien écraser.
+*/
+
+#include "SDCard.h"
+#include "BlockScheduler.h"
+#include "Check.h"
+#include "ImageCard.h"
+
+static void fill(uint8_t* b, uint32_t lba, int generation) { memset(b, (uint8_t)(lba * 7 + generation), 512); }
+
+static bool on_card(uint32_t lba, int generation) {
+    uint8_t want[512], got[512];
+    fill(want, lba, generation);
+    fseek(ImageCard::image, (long)lba * 512, SEEK_SET);
+    return fread(got, 1, 512, ImageCard::image) == 512 && memcmp(want, got, 512) == 0;
+}
+
+int main() {
+    if (!ImageCard::create(256)) return 2;
+    SDCard sd;
+    BlockScheduler io(&sd);
+    uint8_t b[512];
+
+    // Deux séquences, 10..13 et 40..43; le 2e bloc de la seconde est refusé
+    const uint32_t lbas[] = {42, 10, 41, 12, 40, 11, 43, 13};
+    for (uint32_t l : lbas) { fill(b, l, 1); io.write(l, b); }
+    ImageCard::write_fail = 5;
+    check(!io.flush(), "flush reports the failure");
+    check(on_card(10, 1) && on_card(13, 1), "run before the failure written");
+    check(io.pending() == 4, "failed run kept in the queue");
+    bool served = true;
+    for (uint32_t l = 40; l <= 43; l++) {
+        uint8_t r[512];
+        fill(b, l, 1);
+        served &= io.read(l, r) && memcmp(r, b, 512) == 0;
+    }
+    check(served, "kept sectors still served by read()");
+    ImageCard::write_fail = -1;
+    check(io.flush() && io.pending() == 0, "retry writes them");
+    bool all = true;
+    for (uint32_t l : lbas) all &= on_card(l, 1);
+    check(all, "every sector on the card after the retry");
+
+    // File pleine, carte en échec: write() refuse sans écraser ni déborder
+    for (uint32_t l = 100; l < 108; l++) { fill(b, l, 2); io.write(l, b); }
+    ImageCard::write_fail = 0;
+    fill(b, 200, 2);
+    check(!io.write(200, b) && io.pending() == 8, "full queue + failing card: write refused, 8 kept");
+    ImageCard::write_fail = -1;
+    check(io.write(200, b) && io.flush(), "accepted once the card answers");
+    all = on_card(200, 2);
+    for (uint32_t l = 100; l < 108; l++) all &= on_card(l, 2);
+    check(all, "nothing lost");
+
+    // Une séquence de secteurs consécutifs part en une commande, une réécriture est absorbée
+    io.reset_stats();
+    for (uint32_t l = 20; l < 26; l++) { fill(b, l, 3); io.write(l, b); }
+    fill(b, 22, 4);
+    io.write(22, b);
+    check(io.flush(), "flush");
+    const BlockSchedulerStats& st = io.get_stats();
+    check(st.write_commands == 1 && st.written_blocks == 6 && st.coalesced == 1, "6 sectors in one command, 1 rewrite absorbed");
+    check(on_card(22, 4), "latest copy written");
+    return check_report();
+}
@@ -0,0 +1,80 @@
+/*
+Nom du fichier : test_bufwriter.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : file_write par petits morceaux (1, 37 et 512 o) et BufferedWriter
+              sur une image à clusters de 4 Ko (tools/mktree.py, SPC=8):
+              contenu relu, fsck propre, secteurs écrits et lus par FAT32.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "BufferedWriter.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <algorithm>
+
+static const uint32_t TOTAL = 16384;     // 4 clusters tout juste: pas de cluster en trop
+static uint8_t scratch[8192];
+
+static uint8_t expected(uint32_t i) { return (uint8_t)('A' + (i * 7) % 26); }
+
+// Écrit TOTAL octets par morceaux de 'piece'; retourne les secteurs écrits demandés par FAT32
+static unsigned long write_file(FAT32& fs, const char* name, uint32_t piece, bool buffered) {
+    static uint8_t src[TOTAL];
+    for (uint32_t i = 0; i < TOTAL; i++) src[i] = expected(i);
+    fs.reset_io_stats();
+    if (buffered) {
+        BufferedWriter bw(&fs);
+        bw.open(name, CREATE);
+        for (uint32_t o = 0; o < TOTAL; o += piece) bw.write(src + o, std::min(piece, TOTAL - o));
+        bw.close();
+    } else {
+        fs.file_open(name, CREATE);
+        for (uint32_t o = 0; o < TOTAL; o += piece) fs.file_write(src + o, std::min(piece, TOTAL - o));
+        fs.file_close();
+    }
+    const BlockSchedulerStats& s = fs.get_io_stats();
+    return s.written_blocks + s.coalesced;
+}
+
+static bool read_back(FAT32& fs, const char* name) {
+    fs.file_open(name, READ);
+    ReadHandler h;
+    uint8_t t[512];
+    uint32_t n = 0, good = 0, k;
+    while ((k = fs.file_read(t, &h)) > 0)
+        for (uint32_t i = 0; i < k; i++, n++) if (n < TOTAL && t[i] == expected(n)) good++;
+    fs.file_close();
+    return n == TOTAL && good == TOTAL;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+
+    const uint32_t pieces[] = {1, 37, 512};
+    for (int buffered = 0; buffered < 2; buffered++) {
+        for (uint32_t piece : pieces) {
+            char name[16], what[80];
+            snprintf(name, sizeof name, "/W%d_%u.BIN", buffered, piece);
+            const unsigned long sectors = write_file(fs, name, piece, buffered);
+            snprintf(what, sizeof what, "%s, %u-byte pieces: %lu sector writes, content intact",
+                     buffered ? "BufferedWriter" : "file_write", piece, sectors);
+            check(read_back(fs, name), what);
+            // 32 secteurs de données + répertoire et FAT
+            if (buffered || piece == 512) check(sectors < 100, "  under 100 sector writes");
+        }
+    }
+
+    BufferedWriter bw(&fs);
+    check(bw.open("/TEXT.TXT", CREATE) == FILE_CREATE_OK && bw.print("line 1\n") && bw.print("line 2\n"), "print");
+    check(bw.get_size() == 14 && bw.close() && fs.get_file_size("/TEXT.TXT") == 14, "  size after close");
+
+    FsckReport r;
+    fs.check_filesystem(r, scratch, sizeof scratch);
+    check(r.error_count() == 0, "fsck clean (no extra cluster on a 16 KB file)");
+    return check_report();
+}
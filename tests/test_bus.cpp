@@ -0,0 +1,85 @@
+/*
+Nom du fichier : test_bus.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Deux écrans sur le même bus SPI (TFTBus) émulés: jamais deux
+              CS bas, chaque TFT n'écrit que sur son écran, render_strips
+              alterne les écrans bande par bande, RST commun actionné une fois.
+*/
+
+#include "TFT.h"
+#include "TFTBus.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using PanelEmulator::panels;
+
+// Second écran en miroir horizontal
+static void mirror(uint8_t panel, uint16_t y, uint16_t rows, uint16_t* px, void* ctx) {
+    const uint16_t* fb = (const uint16_t*)ctx + y * 240;
+    for (int r = 0; r < rows; r++)
+        for (int x = 0; x < 240; x++) px[r * 240 + x] = fb[r * 240 + (panel ? 239 - x : x)];
+}
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    PanelEmulator::attach(TFT2Config::PIN_CS, TFT2Config::PIN_DC);
+    TFTBus& bus = TFTBus::default_bus();
+    const int8_t second = bus.add_panel(TFTPins{(uint8_t)TFT2Config::PIN_CS, (uint8_t)TFT2Config::PIN_DC, (uint8_t)TFT2Config::PIN_RST});
+    const int8_t third = bus.add_panel(TFTPins{20, 21, 22});
+    TFT a;
+    a.init();
+    TFT b(&bus, second);
+    b.init();
+    check(second == 1 && third == -1, "second panel added, third refused");
+    check(PanelEmulator::reset_pulses == 1, "shared RST pulsed once");
+    check(panels[0].commands == panels[1].commands && panels[0].commands > 0, "both panels initialized alike");
+
+    // Chaque TFT n'écrit que sur son écran
+    uint16_t* fb = a.getFramebuffer16();
+    for (int i = 0; i < 240 * 240; i++) fb[i] = (uint16_t)(i * 2654435761u >> 16);
+    PanelEmulator::clear();
+    a.sendFrame();
+    check(memcmp(panels[0].mem.data(), fb, 240 * 240 * 2) == 0, "TFT a.sendFrame fills panel 0");
+    check(std::count(panels[1].mem.begin(), panels[1].mem.end(), 0xDEAD) == 240 * 240, "  panel 1 untouched");
+    uint16_t* fb2 = b.getFramebuffer16();
+    b.fillRect(10, 20, 30, 40, 0xF800);
+    const std::vector<uint16_t> before = panels[0].mem;
+    b.sendRegion(10, 20, 30, 40);
+    bool region = true;
+    for (int y = 20; y < 60; y++)
+        for (int x = 10; x < 40; x++) region &= panels[1].mem[y * 240 + x] == fb2[y * 240 + x];
+    check(region, "TFT b.sendRegion fills panel 1");
+    check(panels[0].mem == before, "  panel 0 untouched");
+
+    // render_strips: bandes alternées, chaque écran avec son image
+    PanelEmulator::clear();
+    bus.reset_stats();
+    bus.render_strips(0x03, 240, 240, mirror, fb);
+    const std::vector<int>& runs = PanelEmulator::pixel_runs;
+    bool alternate = true;
+    for (size_t i = 1; i < runs.size(); i++) alternate &= runs[i] != runs[i - 1];
+    const unsigned long longest = *std::max_element(PanelEmulator::run_bytes.begin(), PanelEmulator::run_bytes.end());
+    int bad0 = 0, bad1 = 0;
+    for (int y = 0; y < 240; y++)
+        for (int x = 0; x < 240; x++) {
+            bad0 += panels[0].mem[y * 240 + x] != fb[y * 240 + x];
+            bad1 += panels[1].mem[y * 240 + x] != fb[y * 240 + 239 - x];
+        }
+    const TFTBusStats& st = bus.get_stats();
+    printf("render_strips: %zu pixel runs, longest %lu B, %lu strips, %lu switches\n", runs.size(), longest,
+           (unsigned long)st.strips, (unsigned long)st.switches);
+    check(alternate && runs.size() == 2 * 240 / TFTBus_Config::STRIP_ROWS, "render_strips alternates panels strip by strip");
+    check(longest <= 240u * TFTBus_Config::STRIP_ROWS * 2 + 1, "  no run longer than a strip");
+    check(bad0 == 0 && bad1 == 0, "  both panels hold their image");
+    PanelEmulator::clear();
+    bus.render_strips(0x02, 240, 100, mirror, fb);
+    check(runs.size() == 1 && runs[0] == 1, "mask 0x02 draws panel 1 only");
+
+    printf("%lu CS overlaps, %lu writes without CS\n", PanelEmulator::overlaps, PanelEmulator::orphans);
+    check(PanelEmulator::overlaps == 0 && PanelEmulator::orphans == 0, "never two CS low, no byte without CS");
+    return check_report();
+}
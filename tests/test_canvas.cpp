@@ -0,0 +1,169 @@
+/*
+Nom du fichier : test_canvas.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Canvas (Canvas.h) contre le framebuffer, pixel pour pixel: les
+              mêmes opérations aléatoires dessinées dans un Canvas et dans le
+              framebuffer (décalé, découpé au rectangle du Canvas par
+              pushClip, avec défilement), puis drawCanvas opaque et avec
+              couleur transparente, puis la réserve d'emplacements.
+*/
+
+#include "TFT.h"
+#include "Canvas.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+static const uint8_t bits[] = {0x18, 0x3C, 0x7E, 0xFF, 0xFF, 0x7E, 0x3C, 0x18, 0xA5, 0x5A};
+static const char* texts[] = {"Hello", "0123456789", "Capteurs 21.5 C", "gjpqy|", "ABC xyz"};
+
+static uint16_t rnd16() { return (uint16_t)(rand() & 0xFFFF); }
+static int rnd(int a, int b) { return a + rand() % (b - a + 1); }
+
+// Framebuffer == fond 0xF00F, sauf là où le Canvas posé en (x, y) est visible
+// (dans le découpage, et hors couleur transparente si key >= 0)
+static bool drawn_as_expected(const uint16_t* fb, const Canvas& c, int x, int y, int key,
+                              int cx0 = 0, int cy0 = 0, int cx1 = 240, int cy1 = 240) {
+    const int w = c.getWidth(), h = c.getHeight();
+    for (int py = 0; py < 240; py++) for (int px = 0; px < 240; px++) {
+        const int cx = px - x, cy = py - y;
+        uint16_t want = Raster::to_be(0xF00F);
+        if (px >= cx0 && px < cx1 && py >= cy0 && py < cy1 && cx >= 0 && cx < w && cy >= 0 && cy < h) {
+            const uint16_t v = c.getPixels()[cy * w + cx];
+            if (key < 0 || v != Raster::to_be((uint16_t)key)) want = v;
+        }
+        if (fb[py * 240 + px] != want) return false;
+    }
+    return true;
+}
+
+int main() {
+    using namespace Canvas_Config;
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    const uint16_t* fb = (const uint16_t*)tft.getFramebuffer();
+    printf("pool: %u slots of %u pixels\n", (unsigned)SLOTS, (unsigned)SLOT_PIXELS);
+
+    // Opérations aléatoires: Canvas (cx, cy) <-> écran (cx + ox + sx, cy + oy + sy)
+    srand(1234);
+    long ops = 0, compared = 0, mismatches = 0;
+    bool acquired = true;
+    for (int round = 0; round < 400 && acquired; round++) {
+        const int w = rnd(1, 120), h = rnd(1, std::min<int>(100, SLOTS * SLOT_PIXELS / w));
+        Canvas* c = Canvas::acquire(w, h);
+        acquired = c != nullptr;
+        if (!c) break;
+        const int ox = rnd(0, 240 - w), oy = rnd(0, 240 - h);
+        const int sx = (round & 1) ? rnd(-20, 20) : 0, sy = (round & 2) ? rnd(-20, 20) : 0;
+        const uint16_t bg = rnd16();
+        c->fill(bg);
+        tft.resetClipRect();
+        tft.setScrollOffset(0, 0);
+        tft.fillRect(ox, oy, w, h, bg);
+        tft.setScrollOffset(sx, sy);
+        tft.pushClip(ox, oy, w, h);
+        const int dx = ox + sx, dy = oy + sy;
+        for (int k = 0; k < 60; k++, ops++) {
+            const uint16_t col = rnd16();
+            const int a = rnd(-30, w + 30), b = rnd(-30, h + 30), e = rnd(-30, w + 30), f = rnd(-30, h + 30), r = rnd(0, 40);
+            switch (rnd(0, 9)) {
+                case 0: c->fillRect(a, b, e - a, f - b, col); tft.fillRect(a + dx, b + dy, e - a, f - b, col); break;
+                case 1: c->drawRect(a, b, e - a, f - b, col); tft.drawRect(a + dx, b + dy, e - a, f - b, col); break;
+                case 2: c->drawLine(a, b, e, f, col); tft.drawLine(a + dx, b + dy, e + dx, f + dy, col); break;
+                case 3: c->drawCircle(a, b, r, col); tft.drawCircle(a + dx, b + dy, r, col); break;
+                case 4: c->drawFillCircle(a, b, r, col); tft.drawFillCircle(a + dx, b + dy, r, col); break;
+                // drawSmallCircle de l'écran ignore le défilement
+                case 5: c->drawSmallCircle(a, b, r % 12, col); tft.drawSmallCircle(a + ox, b + oy, r % 12, col); break;
+                case 6: c->drawBitmap(a, b, 8, 10, bits, col); tft.drawBitmap(a + dx, b + dy, 8, 10, bits, col); break;
+                case 7: {
+                    std::vector<uint16_t> px((size_t)(r + 1) * (r / 2 + 1));
+                    for (auto& p : px) p = rnd16();
+                    c->blitRGB565(a, b, r + 1, r / 2 + 1, px.data());
+                    tft.blitRGB565(a + dx, b + dy, r + 1, r / 2 + 1, px.data());
+                    break;
+                }
+                default: {
+                    const FontType fonts[] = {FontType::FONT_MINI, FontType::FONT_STANDARD, FontType::ARIAL_32};
+                    const FontType font = fonts[rnd(0, 2)];
+                    const char* t = texts[rnd(0, 4)];
+                    c->setFont(font);
+                    tft.setFont(font);
+                    c->drawText(a, b, t, col);
+                    tft.drawText(a + dx, b + dy, t, col);
+                    break;
+                }
+            }
+        }
+        tft.popClip();
+        tft.setScrollOffset(0, 0);
+        for (int y = 0; y < h; y++) for (int x = 0; x < w; x++) {
+            compared++;
+            mismatches += c->getPixels()[y * w + x] != fb[(oy + y) * 240 + ox + x];
+        }
+        c->release();
+    }
+    printf("%ld random operations on 400 canvases, %ld pixels compared: %ld mismatching\n", ops, compared, mismatches);
+    check(acquired, "every canvas of the run acquired");
+    check(mismatches == 0, "canvas == framebuffer");
+
+    // drawCanvas opaque, avec couleur transparente, découpé de tous les côtés
+    Canvas* c = Canvas::acquire(50, 30);
+    for (int y = 0; y < 30; y++) for (int x = 0; x < 50; x++)
+        c->setPixel(x, y, ((x * 37 + y * 11) & 1) ? 0x1234 : COLOR_16BITS_BLACK);
+    tft.resetClipRect();
+    tft.fillRect(0, 0, 240, 240, 0xF00F);
+    tft.drawCanvas(*c, 210, -5);
+    check(drawn_as_expected(fb, *c, 210, -5, -1), "drawCanvas opaque, clipped at the screen edge");
+    tft.fillRect(0, 0, 240, 240, 0xF00F);
+    tft.drawCanvas(*c, 20, 30, COLOR_16BITS_BLACK);
+    check(drawn_as_expected(fb, *c, 20, 30, COLOR_16BITS_BLACK), "drawCanvas keyed (black transparent)");
+    bool keyed = true;
+    const int spots[][2] = {{-30, -10}, {-49, 100}, {200, 225}, {220, -29}, {-10, 230}, {100, 100}};
+    for (auto& p : spots) for (int clip = 0; clip < 2; clip++) {
+        tft.resetClipRect();
+        tft.fillRect(0, 0, 240, 240, 0xF00F);
+        if (clip) tft.pushClip(p[0] + 7, p[1] + 3, 30, 20);
+        tft.drawCanvas(*c, p[0], p[1], COLOR_16BITS_BLACK);
+        if (clip) tft.popClip();
+        keyed &= clip ? drawn_as_expected(fb, *c, p[0], p[1], COLOR_16BITS_BLACK, p[0] + 7, p[1] + 3, p[0] + 37, p[1] + 23)
+                      : drawn_as_expected(fb, *c, p[0], p[1], COLOR_16BITS_BLACK);
+    }
+    check(keyed, "drawCanvas keyed, clipped on every side and by pushClip");
+    c->release();
+
+    // Réserve: premier emplacement libre assez long, rendu par release()
+    const int slots = SLOTS;
+    check(Canvas::free_slots() == slots, "pool empty after releases");
+    Canvas* a = Canvas::acquire(32, 32);
+    Canvas* b = Canvas::acquire(50, 30);             // 1500 px: 2 emplacements
+    Canvas* d = Canvas::acquire(10, 10);
+    Canvas* e = Canvas::acquire(32, 32 * (slots - 4));
+    check(a && b && d && e && Canvas::free_slots() == 0, "1 + 2 + 1 + rest slots");
+    check(Canvas::acquire(1, 1) == nullptr, "pool full -> nullptr");
+    a->release();
+    d->release();
+    check(Canvas::free_slots() == 2, "release returns slots");
+    check(Canvas::acquire(32, 64) == nullptr, "2 free but not contiguous -> nullptr");
+    b->release();
+    e->release();
+    Canvas* big = Canvas::acquire(32, 32 * slots);
+    check(big && Canvas::free_slots() == 0, "whole pool in one canvas");
+    check(Canvas::acquire(0, 5) == nullptr && Canvas::acquire(32, 32 * slots + 1) == nullptr, "bad sizes rejected");
+    big->release();
+    check(Canvas::free_slots() == slots, "pool empty at the end");
+
+    // Titre du tableau de bord (main.cpp): "Capteurs" en Arial32
+    int th = 0;
+    for (const char* ch = "Capteurs"; *ch; ++ch) th = std::max<int>(th, Raster::arial_info(*ch).h);
+    const int tw = Raster::text_width(FontType::ARIAL_32, "Capteurs");
+    Canvas* title = Canvas::acquire(tw, th);
+    const int used = slots - Canvas::free_slots();
+    printf("dashboard title %dx%d: %d of %d slots\n", tw, th, used, slots);
+    check(title && used == (int)((tw * th + SLOT_PIXELS - 1) / SLOT_PIXELS), "dashboard title fits the pool, rounded up to slots");
+    if (title) title->release();
+    return check_report();
+}
@@ -0,0 +1,238 @@
+/*
+Nom du fichier : test_clip.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Découpage des primitives de TFT (pile pushClip/popClip,
+              décalage de défilement) comparé, après chaque opération, à un
+              rastériseur de référence qui reprend les algorithmes d'origine
+              et teste chaque pixel contre sa propre pile de découpage.
+              Affiche ensuite quelques temps de tracé sur l'hôte.
+*/
+
+#include "TFT.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const int W = 240, H = 240;
+
+// Référence: un pixel à la fois, découpage testé sur chaque pixel
+struct Ref {
+    struct Box { int x0, y0, x1, y1; };
+    uint16_t fb[W * H];
+    int sx = 0, sy = 0;
+    Box clip{0, 0, W, H};
+    std::vector<Box> stack;
+    TFT* t = nullptr;
+
+    void px(int x, int y, uint16_t c) {
+        x -= sx; y -= sy;
+        if (x < clip.x0 || x >= clip.x1 || y < clip.y0 || y >= clip.y1) return;
+        fb[y * W + x] = Raster::to_be(c);
+    }
+    void push(int x, int y, int w, int h) {
+        stack.push_back(clip);
+        clip.x0 = std::max(clip.x0, x); clip.y0 = std::max(clip.y0, y);
+        clip.x1 = std::min(clip.x1, x + w); clip.y1 = std::min(clip.y1, y + h);
+        clip.x1 = std::max(clip.x1, clip.x0); clip.y1 = std::max(clip.y1, clip.y0);
+    }
+    void pop() {
+        if (stack.empty()) return;
+        clip = stack.back();
+        stack.pop_back();
+    }
+    void reset() { clip = {0, 0, W, H}; stack.clear(); }
+    void line(int x0, int y0, int x1, int y1, uint16_t c) {
+        const int dx = abs(x1 - x0), dy = abs(y1 - y0), stx = x0 < x1 ? 1 : -1, sty = y0 < y1 ? 1 : -1;
+        int err = dx - dy, x = x0, y = y0;
+        while (true) {
+            px(x, y, c);
+            if (x == x1 && y == y1) break;
+            const int e2 = 2 * err;
+            if (e2 > -dy) { err -= dy; x += stx; }
+            if (e2 < dx) { err += dx; y += sty; }
+        }
+    }
+    void rect(int x, int y, int w, int h, uint16_t c) {
+        if (w <= 0 || h <= 0) return;
+        line(x, y, x + w - 1, y, c); line(x, y + h - 1, x + w - 1, y + h - 1, c);
+        line(x, y, x, y + h - 1, c); line(x + w - 1, y, x + w - 1, y + h - 1, c);
+    }
+    void fill(int x, int y, int w, int h, uint16_t c) {
+        for (int py = y; py < y + h; py++) for (int q = x; q < x + w; q++) px(q, py, c);
+    }
+    void circle(int xc, int yc, int r, uint16_t c) {
+        int x = 0, y = r, d = 3 - 2 * r;
+        while (y >= x) {
+            px(xc + x, yc + y, c); px(xc - x, yc + y, c); px(xc + x, yc - y, c); px(xc - x, yc - y, c);
+            px(xc + y, yc + x, c); px(xc - y, yc + x, c); px(xc + y, yc - x, c); px(xc - y, yc - x, c);
+            x++;
+            if (d > 0) { y--; d += 4 * (x - y) + 10; } else d += 4 * x + 6;
+        }
+    }
+    void fcircle(int xc, int yc, int r, uint16_t c) {
+        int x = 0, y = r, d = 3 - 2 * r;
+        while (y >= x) {
+            line(xc - x, yc + y, xc + x, yc + y, c); line(xc - x, yc - y, xc + x, yc - y, c);
+            line(xc - y, yc + x, xc + y, yc + x, c); line(xc - y, yc - x, xc + y, yc - x, c);
+            x++;
+            if (d > 0) { y--; d += 4 * (x - y) + 10; } else d += 4 * x + 6;
+        }
+    }
+    // drawSmallCircle ignore le décalage de défilement
+    void small(int xc, int yc, int r, uint16_t c) {
+        for (int y = yc - r; y <= yc + r; y++) for (int x = xc - r; x <= xc + r; x++)
+            if (x >= clip.x0 && x < clip.x1 && y >= clip.y0 && y < clip.y1 && (x - xc) * (x - xc) + (y - yc) * (y - yc) <= r * r)
+                fb[y * W + x] = Raster::to_be(c);
+    }
+    void glyph(int x, int y, char ch, uint16_t c) {
+        const FontType font = t->getFont();
+        if (font == FontType::ARIAL_32) {
+            const arial_S32_CharInfo& ci = Raster::arial_info(ch);
+            const uint8_t* b = &arial_S32_Bitmaps[ci.offset];
+            for (int r = 0; r < ci.h; r++) for (int q = 0; q < ci.w; q++) {
+                const int bi = r * ci.w + q;
+                if (b[bi / 8] & (1 << (7 - bi % 8))) px(x + q, y + r, c);
+            }
+            return;
+        }
+        const uint8_t* d = Raster::glyph(font, ch);
+        const int fw = Raster::font_width(font), fh = Raster::font_height(font);
+        for (int r = 0; r < fh; r++) for (int q = 0; q < fw; q++) if (d[r] & (0x80 >> q)) px(x + q, y + r, c);
+    }
+    void text(int x, int y, const char* s, uint16_t c) {
+        for (int i = 0; s[i]; i++) {
+            glyph(x, y, s[i], c);
+            x += t->getCharWidth(s[i]) + 1;
+        }
+    }
+    void bitmap(int x, int y, int w, int h, const uint8_t* b, uint16_t c) {
+        const int stride = (w + 7) / 8;
+        for (int r = 0; r < h; r++) for (int q = 0; q < w; q++)
+            if (b[r * stride + (q >> 3)] & (0x80 >> (q & 7))) px(x + q, y + r, c);
+    }
+    void blit(int x, int y, int w, int h, const uint16_t* p) {
+        for (int r = 0; r < h; r++) for (int q = 0; q < w; q++) px(x + q, y + r, Raster::to_be(p[r * w + q]));
+    }
+};
+
+static Ref ref;
+static uint8_t bits[32 * 40];
+static uint16_t pix[48 * 48];
+
+static int rnd(int a, int b) { return a + rand() % (b - a + 1); }
+
+template <class F> static double micros(F f, int n) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) f(i);
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    tft.fill(0);
+    ref.t = &tft;
+    memset(ref.fb, 0, sizeof ref.fb);
+    for (auto& b : bits) b = (uint8_t)rand();
+    for (auto& p : pix) p = (uint16_t)rand();
+    const char* texts[] = {"Hello", "Clip 0123456789", "WWWWWWWWWWWWWWWWWWWWWWWWWWWWWW", "a", "longer line of text that runs off"};
+
+    srand(1234);
+    int mismatches = 0, depth_errors = 0, first_bad = -1, max_depth = 0;
+    const int steps = 200000;
+    for (int step = 0; step < steps; step++) {
+        const uint16_t c = (uint16_t)rand();
+        const int k = rand() % 16;
+        if (k == 0) {
+            const int x = rnd(-60, 250), y = rnd(-60, 250), w = rnd(-10, 200), h = rnd(-10, 200);
+            if (tft.pushClip(x, y, w, h)) ref.push(x, y, w, h);
+            else depth_errors += (int)ref.stack.size() != TFT::CLIP_STACK_DEPTH;
+        } else if (k == 1) {
+            tft.popClip(); ref.pop();
+        } else if (k == 2 && rand() % 8 == 0) {
+            ref.sx = rnd(-20, 20); ref.sy = rnd(-20, 20);
+            tft.setScrollOffset(ref.sx, ref.sy);
+        } else if (k == 3) {
+            const int x = rnd(-50, 250), y = rnd(-50, 250), w = rnd(-5, 120), h = rnd(-5, 120);
+            tft.fillRect(x, y, w, h, c); ref.fill(x, y, w, h, c);
+        } else if (k == 4) {
+            const int x = rnd(-50, 250), y = rnd(-50, 250), w = rnd(-5, 120), h = rnd(-5, 120);
+            tft.drawRect(x, y, w, h, c); ref.rect(x, y, w, h, c);
+        } else if (k == 5 || k == 6) {
+            int x0 = rnd(-80, 320), y0 = rnd(-80, 320), x1 = rnd(-80, 320), y1 = rnd(-80, 320);
+            if (rand() % 3 == 0) y1 = y0;
+            else if (rand() % 3 == 0) x1 = x0;
+            tft.drawLine(x0, y0, x1, y1, c); ref.line(x0, y0, x1, y1, c);
+        } else if (k == 7) {
+            const int x = rnd(-40, 280), y = rnd(-40, 280), r = rnd(-2, 90);
+            tft.drawCircle(x, y, r, c); ref.circle(x, y, r, c);
+        } else if (k == 8) {
+            const int x = rnd(-40, 280), y = rnd(-40, 280), r = rnd(-2, 60);
+            tft.drawFillCircle(x, y, r, c); ref.fcircle(x, y, r, c);
+        } else if (k == 9) {
+            const int x = rnd(-20, 260), y = rnd(-20, 260), r = rnd(0, 25);
+            tft.drawSmallCircle(x, y, r, c); ref.small(x, y, r, c);
+        } else if (k == 10 || k == 11) {
+            tft.setFont((FontType)(rand() % 3));
+            const int x = rnd(-100, 250), y = rnd(-40, 250);
+            const char* s = texts[rand() % 5];
+            tft.drawText(x, y, s, c); ref.text(x, y, s, c);
+        } else if (k == 12) {
+            const int x = rnd(-40, 250), y = rnd(-40, 250), w = rnd(1, 32), h = rnd(1, 40);
+            tft.drawBitmap(x, y, w, h, bits, c); ref.bitmap(x, y, w, h, bits, c);
+        } else if (k == 13) {
+            const int x = rnd(-50, 250), y = rnd(-50, 250), w = rnd(1, 48), h = rnd(1, 48);
+            tft.blitRGB565(x, y, w, h, pix); ref.blit(x, y, w, h, pix);
+        } else if (k == 14) {
+            const int x = rnd(-5, 245), y = rnd(-5, 245);
+            tft.setPixel(x, y, c); ref.px(x, y, c);
+        } else {
+            tft.resetClipRect(); ref.reset();
+        }
+        if (memcmp(ref.fb, tft.getFramebuffer(), sizeof ref.fb) != 0) {
+            if (first_bad < 0) {
+                first_bad = step;
+                printf("  first mismatch at step %d, operation %d\n", step, k);
+            }
+            mismatches++;
+            memcpy(ref.fb, tft.getFramebuffer(), sizeof ref.fb);
+        }
+        depth_errors += tft.getClipDepth() != (int)ref.stack.size();
+        max_depth = std::max(max_depth, tft.getClipDepth());
+    }
+    printf("%d random operations, clips nested up to %d: %d mismatching\n", steps, max_depth, mismatches);
+    check(mismatches == 0, "every primitive == per-pixel reference");
+    check(depth_errors == 0, "clip stack depth follows push/pop");
+
+    // Pile pleine: le niveau de trop est refusé sans toucher au découpage
+    tft.resetClipRect();
+    tft.setScrollOffset(0, 0);
+    bool pushed = true;
+    for (int i = 0; i < TFT::CLIP_STACK_DEPTH; i++) pushed &= tft.pushClip(i, i, 200, 200);
+    check(pushed && !tft.pushClip(100, 100, 10, 10) && tft.getClipDepth() == TFT::CLIP_STACK_DEPTH,
+          "full stack refuses one more pushClip");
+    tft.fill(0);
+    tft.fillRect(0, 0, 240, 240, 0xFFFF);
+    int inside = 0;
+    for (int y = 0; y < H; y++) for (int x = 0; x < W; x++) inside += ((const uint16_t*)tft.getFramebuffer())[y * W + x] != 0;
+    check(inside == 193 * 193, "clip after the refused push is unchanged");
+    for (int i = 0; i < TFT::CLIP_STACK_DEPTH; i++) tft.popClip();
+    tft.popClip();
+    check(tft.getClipDepth() == 0, "extra popClip on an empty stack is harmless");
+
+    // Temps sur l'hôte, à titre indicatif (non vérifiés)
+    tft.setClipRect(60, 60, 120, 120);
+    const double fill = micros([&](int i) { tft.fillRect(20 + (i & 7), 20, 200, 200, (uint16_t)i); }, 2000);
+    tft.setFont(FontType::FONT_STANDARD);
+    const double text = micros([&](int i) { for (int y = 0; y < 240; y += 13) tft.drawText(0, y, "The quick brown fox jumps", (uint16_t)i); }, 2000);
+    const double circle = micros([&](int i) { tft.drawFillCircle(120, 120, 100, (uint16_t)i); }, 2000);
+    printf("host timing, clip 120x120: fillRect 200x200 %.1f us, 19 text lines %.1f us, drawFillCircle r=100 %.1f us\n",
+           fill, text, circle);
+    return check_report();
+}
@@ -0,0 +1,72 @@
+/*
+Nom du fichier : test_colortransform.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Transformation de couleur (ColorTransform): les 65536 pixels
+              RGB565 sous plusieurs réglages, comparés à une référence
+              flottante indépendante calculée pixel par pixel.
+*/
+
+#include "ColorTransform.h"
+#include "Check.h"
+#include <cmath>
+#include <vector>
+
+// Référence: même formule que la documentation, sans les tables
+static uint16_t reference(uint16_t p, float gamma, float bright, float warm, bool inv) {
+    const int ch[3] = {p >> 11, (p >> 5) & 63, p & 31}, mx[3] = {31, 63, 31};
+    int out[3];
+    const float w = warm > 1 ? 1 : (warm < -1 ? -1 : warm);
+    const float gw[3] = {1.0f, 1.0f - 0.35f * w, 1.0f - 0.75f * w};
+    const float gc[3] = {1.0f + 0.5f * w, 1.0f + 0.2f * w, 1.0f};
+    for (int c = 0; c < 3; c++) {
+        float v = (float)ch[c] / (float)mx[c];
+        if (inv) v = 1.0f - v;
+        if (v > 0.0f && gamma != 1.0f) v = powf(v, gamma);
+        v *= bright * (w >= 0 ? gw[c] : gc[c]);
+        const int o = (int)(v * (float)mx[c] + 0.5f);
+        out[c] = o < 0 ? 0 : (o > mx[c] ? mx[c] : o);
+    }
+    return (uint16_t)(out[0] << 11 | out[1] << 5 | out[2]);
+}
+
+static uint16_t swap(uint16_t v) { return (uint16_t)((v >> 8) | (v << 8)); }
+
+int main() {
+    struct Case { float gamma, bright, warm; bool inv; } cases[] = {
+        {1, 1, 0, false}, {2.2f, 1, 0, false}, {0.45f, 1, 0, false}, {1, 0.4f, 0.8f, false}, {1, 1, -1, false},
+        {1, 1, 0, true}, {1.8f, 0.7f, 0.3f, true}, {1, 0, 0, false}, {3, 0.25f, -0.5f, false}};
+    std::vector<uint16_t> src(65536), dst(65536);
+    for (auto& k : cases) {
+        ColorTransform t;
+        ColorSettings s;
+        s.gamma = k.gamma;
+        s.brightness = k.bright;
+        s.warmth = k.warm;
+        s.invert = k.inv;
+        t.set(s);
+        for (int p = 0; p < 65536; p++) src[p] = swap((uint16_t)p);     // framebuffer gros-boutien
+        t.apply_be(src.data(), dst.data(), 65536);
+        int mismatches = 0;
+        bool untouched = true;
+        for (int p = 0; p < 65536; p++) {
+            const uint16_t r = reference((uint16_t)p, k.gamma, k.bright, k.warm, k.inv);
+            mismatches += swap(dst[p]) != r || t.apply((uint16_t)p) != r;
+            untouched &= src[p] == swap((uint16_t)p);
+        }
+        char what[96];
+        snprintf(what, sizeof what, "gamma %.2f bright %.2f warm %+.2f inv %d: bit-exact", k.gamma, k.bright, k.warm, k.inv);
+        check(mismatches == 0 && untouched, what);
+        if (mismatches) printf("  %d/65536 pixels differ\n", mismatches);
+    }
+
+    ColorTransform t;
+    check(t.is_identity(), "default transform is the identity");
+    ColorSettings s;
+    s.brightness = 0.4f;
+    t.set(s);
+    check(!t.is_identity(), "  dimmed is not");
+    t.set(ColorSettings());
+    check(t.is_identity(), "  back to identity after reset");
+    return check_report();
+}
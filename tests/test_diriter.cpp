@@ -0,0 +1,98 @@
+/*
+Nom du fichier : test_diriter.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : FAT32::DirIterator sur un grand répertoire (noms longs et 8.3,
+              trous laissés par des effacements): lectures en avant, en
+              arrière et au hasard identiques à list_directory, et coût
+              d'une ligne de plus dans une fenêtre qui défile.
+              Arguments: image, nombre de fichiers créés.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static std::string name_of(const FileListEntry& e) {
+    return e.hasLongName ? e.longFileName : std::string(e.dosFileName);
+}
+
+static void file_name(char* n, size_t size, int i) {
+    if (i % 3) snprintf(n, size, "F%05d.TXT", i);
+    else snprintf(n, size, "A long file name number %05d.data", i);
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    const int n = argc > 2 ? atoi(argv[2]) : 3000;
+    SDCard sd;
+    FAT32 fs(&sd);
+    if (!fs.init()) return 2;
+
+    // Un fichier sur trois avec un nom long, un sur 37 effacé, puis un sous-répertoire
+    fs.create_directory("BIG");
+    fs.change_directory("BIG");
+    char nm[64];
+    bool created = true;
+    for (int i = 0; i < n; i++) {
+        file_name(nm, sizeof nm, i);
+        created &= fs.file_open(nm, CREATE) == FILE_CREATE_OK;
+        fs.file_close();
+    }
+    for (int i = 5; i < n; i += 37) {
+        file_name(nm, sizeof nm, i);
+        created &= fs.delete_file(nm);
+    }
+    created &= fs.create_directory("Sub directory");
+    check(created, "directory built");
+
+    std::vector<FileListEntry> list;
+    fs.list_directory(list);
+    static FAT32::DirIterator it;
+    fs.dir_iterator_open(it);
+    const uint32_t count = fs.dir_iterator_count(it);
+    printf("entries: list_directory %u, iterator %u, %u checkpoints every %u, sizeof(DirIterator) %u\n",
+           (unsigned)list.size(), (unsigned)count, it.checkpoint_count, it.step, (unsigned)sizeof it);
+    check(count == list.size() && count > 0, "count == list_directory size");
+    if (count != list.size() || count == 0) return check_report();
+
+    FileListEntry e;
+    int bad = 0;
+    for (uint32_t i = 0; i < count; i++)
+        bad += !fs.dir_iterator_read(it, i, e) || name_of(e) != name_of(list[i]) ||
+               e.type != list[i].type || e.firstCluster != list[i].firstCluster;
+    check(bad == 0, "forward reads == list_directory");
+
+    bad = 0;
+    unsigned long r0 = ImageCard::reads;
+    for (int32_t i = count - 1; i >= 0; i--) bad += !fs.dir_iterator_read(it, i, e) || name_of(e) != name_of(list[i]);
+    printf("%u backward reads: %lu sectors\n", (unsigned)count, (unsigned long)(ImageCard::reads - r0));
+    check(bad == 0, "backward reads == list_directory");
+
+    bad = 0;
+    srand(3);
+    r0 = ImageCard::reads;
+    for (int k = 0; k < 2000; k++) {
+        const uint32_t i = rand() % count;
+        bad += !fs.dir_iterator_read(it, i, e) || name_of(e) != name_of(list[i]);
+    }
+    printf("2000 random reads: %lu sectors (%.1f per read)\n", (unsigned long)(ImageCard::reads - r0),
+           (double)(ImageCard::reads - r0) / 2000);
+    check(bad == 0, "random reads == list_directory");
+
+    // Fenêtre de 14 lignes qui descend d'une ligne
+    const uint32_t first = count / 2;
+    for (uint32_t k = 0; k < 14; k++) fs.dir_iterator_read(it, first + k, e);
+    r0 = ImageCard::reads;
+    fs.dir_iterator_read(it, first + 14, e);
+    printf("next row after a 14-row window: %lu sector(s)\n", (unsigned long)(ImageCard::reads - r0));
+    check(ImageCard::reads - r0 <= 1, "next row costs at most 1 sector read");
+
+    check(!fs.dir_iterator_read(it, count, e), "read past the last entry fails");
+    check(fs.dir_iterator_read(it, 0, e) && name_of(e) == name_of(list[0]), "back to entry 0");
+    return check_report();
+}
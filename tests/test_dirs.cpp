@@ -0,0 +1,81 @@
+/*
+Nom du fichier : test_dirs.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Pile de répertoires, chemins relatifs et cache des résolutions
+              (tools/mkfat.py): 60 trames ouvertes dans /ANIMS/SEQ01 par
+              push/pop, '.', '..', noms longs de répertoires, pile pleine.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+
+    // 40 fichiers dans /, 20 dans /ANIMS, 60 trames dans /ANIMS/SEQ01
+    char n[32];
+    for (int i = 0; i < 40; i++) { snprintf(n, sizeof n, "F%03d.TXT", i); fs.file_open(n, CREATE); fs.file_close(); }
+    fs.change_directory("ANIMS");
+    for (int i = 0; i < 20; i++) { snprintf(n, sizeof n, "X%03d.TXT", i); fs.file_open(n, CREATE); fs.file_close(); }
+    fs.create_directory("SEQ01");
+    fs.change_directory("SEQ01");
+    const uint8_t frame[4] = {1, 0, 1, 0};
+    for (int i = 0; i < 60; i++) {
+        snprintf(n, sizeof n, "FR_%03d.RAW", i);
+        fs.file_open(n, CREATE);
+        fs.file_write(frame, sizeof frame);
+        fs.file_close();
+    }
+    fs.change_directory("/");
+
+    fs.reset_dir_stats();
+    const unsigned long r0 = ImageCard::reads;
+    int opened = 0;
+    uint8_t buf[512];
+    for (int i = 0; i < 60; i++) {
+        snprintf(n, sizeof n, "FR_%03d.RAW", i);
+        if (!fs.push_directory("/ANIMS/SEQ01")) continue;
+        if (fs.file_open(n, READ) == FILE_FOUND) {
+            ReadHandler h;
+            if (fs.file_read(buf, &h) == 4 && buf[0] == 1) opened++;
+            fs.file_close();
+        }
+        fs.pop_directory();
+    }
+    const DirStats& st = fs.get_dir_stats();
+    printf("60 frames: %lu SD reads, %lu directory sector reads, %lu/%lu components cached\n",
+           ImageCard::reads - r0, (unsigned long)st.dir_sector_reads, (unsigned long)st.cache_hits, (unsigned long)st.path_lookups);
+    check(opened == 60, "every frame opened through push/pop");
+    check(st.cache_hits >= 118, "the parent path is served by the cache");
+    check(ImageCard::reads - r0 < 300, "under 300 SD reads (398 with change_directory)");
+    check(fs.get_current_dir_cluster() == fs.get_root_dir_cluster(), "pop restores the root");
+
+    // Chemins relatifs, '.' et '..'
+    check(fs.change_directory("/ANIMS") && fs.change_directory("SEQ01") && fs.change_directory(".."), "cd /ANIMS, SEQ01, ..");
+    check(fs.change_directory("../ANIMS/./SEQ01"), "cd ../ANIMS/./SEQ01");
+    check(fs.change_directory("../../..") && fs.get_current_dir_cluster() == fs.get_root_dir_cluster(), "cd past the root stays at the root");
+    check(fs.file_open("ANIMS/SEQ01/FR_010.RAW", READ) == FILE_FOUND, "open with a relative path");
+    fs.file_close();
+    fs.change_directory("ANIMS");
+    check(fs.file_open("../F001.TXT", READ) == FILE_FOUND, "open ../F001.TXT from /ANIMS");
+    fs.file_close();
+    fs.change_directory("/");
+    check(fs.create_directory("A much longer directory"), "mkdir with a long name");
+    check(fs.change_directory("/a much longer DIRECTORY"), "cd matches the long name in any case");
+    check(fs.change_directory("..") && fs.get_current_dir_cluster() == fs.get_root_dir_cluster(), "cd .. back to the root");
+
+    // Pile bornée
+    int depth = 0;
+    while (fs.push_directory(".")) depth++;
+    check(depth == FAT_Config::DIR_STACK_DEPTH, "push stops at DIR_STACK_DEPTH");
+    while (fs.pop_directory()) depth--;
+    check(depth == 0 && !fs.pop_directory(), "pop empties the stack");
+    check(fs.push_directory("/NOPE") == false && !fs.pop_directory(), "failed push leaves nothing on the stack");
+    return check_report();
+}
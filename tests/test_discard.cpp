@@ -0,0 +1,105 @@
+/*
+Nom du fichier : test_discard.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : File d'effacements (discard) des clusters libérés.
+              test_discard <image> queue   (tools/mktree.py, clusters de 4 KB):
+                les séquences libérées fusionnent, chaque effacement est aligné
+                sur l'unité d'effacement et ne couvre que des clusters libres.
+              test_discard <image> handler (tools/mkfat.py): rename_file et
+                create_file ne laissent pas de handler d'écriture qui
+                bloquerait les effacements, une écriture ouverte les bloque.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstring>
+
+static uint8_t scratch[8192];
+
+static void drain(FAT32& fs) {
+    for (int k = 0; k < 1000 && fs.process_discards(); k++) {}
+}
+
+static void queue(FAT32& fs) {
+    const uint32_t E = 128;
+    fs.set_discard(E);
+    // Une trame sur deux, puis un fichier qui reprend des clusters libérés, puis le reste
+    char n[32];
+    for (int i = 0; i < 161; i += 2) { snprintf(n, sizeof n, "/OLDANIM/FR_%03d.RAW", i); fs.delete_file(n); }
+    printf("pending after every other frame: %u\n", fs.get_discard_pending());
+    static uint8_t d[512 * 200];
+    memset(d, 0x5A, sizeof d);
+    fs.file_open("/NEW.BIN", CREATE);
+    fs.file_write(d, sizeof d);
+    fs.file_close();
+    check(fs.remove_tree("/OLDANIM"), "rm -r /OLDANIM");
+    printf("pending after rm -r: %u\n", fs.get_discard_pending());
+    check(fs.get_discard_pending() <= 2, "freed runs merged in the queue");
+    drain(fs);
+
+    uint32_t total = 0;
+    bool aligned = true, free_only = true;
+    for (auto& r : ImageCard::erases) {
+        aligned &= r.first % E == 0 && (r.second + 1) % E == 0;
+        total += r.second - r.first + 1;
+        for (uint32_t lba = r.first; lba <= r.second; lba += fs.get_cluster_size())
+            free_only &= ImageCard::fat_entry(fs.get_fat_base(), 2 + (lba - fs.get_data_base()) / fs.get_cluster_size()) == 0;
+    }
+    printf("%zu erase commands, %u blocks\n", ImageCard::erases.size(), total);
+    check(!ImageCard::erases.empty() && fs.get_discard_pending() == 0, "queue drained");
+    check(aligned, "every erase aligned on the erase unit");
+    check(free_only, "every erase covers free clusters only");
+    check(fs.get_discarded_blocks() == total, "discarded block counter");
+    FsckReport rep;
+    fs.check_filesystem(rep, scratch, sizeof scratch);
+    check(rep.error_count() == 0, "fsck clean");
+
+    ReadHandler h;
+    uint8_t b[512];
+    uint32_t got = 0;
+    bool same = true;
+    uint16_t k;
+    fs.file_open("/NEW.BIN", READ);
+    while ((k = fs.file_read(b, &h))) { for (int i = 0; i < k; i++) same &= b[i] == 0x5A; got += k; }
+    fs.file_close();
+    check(got == sizeof d && same, "file written on reused clusters intact");
+}
+
+static void handler(FAT32& fs) {
+    fs.set_discard(1);
+    fs.delete_file("/A.TXT");
+    check(fs.get_discard_pending() > 0, "delete queues a discard");
+    check(fs.rename_file("/ANIMS/FR_001.RAW", "FR_002.RAW"), "rename");
+    check(fs.create_file("/EMPTY.TXT"), "create_file");
+    drain(fs);
+    check(!ImageCard::erases.empty() && fs.get_discard_pending() == 0, "discards run after rename and create_file");
+
+    // Écriture ouverte: le renommage ne la perd pas et les effacements attendent
+    ImageCard::erases.clear();
+    static uint8_t d[1500];
+    memset(d, 0x33, sizeof d);
+    fs.file_open("/W.BIN", CREATE);
+    fs.file_write(d, 700);
+    fs.delete_file("/EMPTY.TXT");
+    fs.delete_file("/ANIMS/FR_002.RAW");
+    fs.rename_file("/W.BIN", "W2.BIN");
+    check(fs.process_discards() && ImageCard::erases.empty(), "an open write holds the discards");
+    fs.file_write(d + 700, 800);
+    fs.file_close();
+    check(fs.get_file_size("/W2.BIN") == 1500, "write continued after the rename");
+    drain(fs);
+    check(!ImageCard::erases.empty(), "discards run after close");
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+    if (argc > 2 && strcmp(argv[2], "handler") == 0) handler(fs);
+    else queue(fs);
+    return check_report();
+}
@@ -0,0 +1,169 @@
+/*
+Nom du fichier : test_exfat.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Lecture d'un volume exFAT (tools/mkexfat.py): listage, noms longs,
+              fichier fragmenté, fichier contigu NoFatChain. Avec SHIFT=16 BIG=1,
+              un fichier plus grand qu'un cluster de 65536 secteurs se lit sans
+              reboucler dans le premier cluster. Puis le même volume par FAT32
+              (file_read_blocks, file_skip_sectors): données et commandes SD,
+              une par suite de clusters contigus.
+              Usage: test_exfat <image> [play]; avec play (image FRAMES=8),
+              lecture de /Play par AnimationPlayer sur l'écran émulé:
+              trames affichées et commandes SD par pas.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "ExFAT.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include "StorageManager.h"
+#include "AnimationPlayer.h"
+#include "TFT.h"
+#include "HostClock.h"
+#include "PanelEmulator.h"
+#include <algorithm>
+#include <cstring>
+
+// Trame k de tools/mkexfat.py (FRAMES): pixel x*7 + y*13 + k*101 gros-boutien
+static bool frame_shown(int k) {
+    const std::vector<uint16_t>& mem = PanelEmulator::panels[0].mem;
+    for (int y = 0; y < 240; y++) for (int x = 0; x < 240; x++) {
+        const uint16_t c = (uint16_t)(x * 7 + y * 13 + k * 101);
+        if (mem[y * 240 + x] != (uint16_t)(c >> 8 | c << 8)) return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    const bool play = argc > 2 && strcmp(argv[2], "play") == 0;
+    SDCard sd;
+    ExFAT fs(&sd);
+    check(fs.mount(0), "mount");
+    printf("sectors per cluster %lu\n", (unsigned long)fs.get_sectors_per_cluster());
+
+    std::vector<FileListEntry> l;
+    fs.list_directory(l);
+    bool hello = false, anims = false, frames = false;
+    for (auto& e : l) {
+        printf("  %s %u\n", e.longFileName.c_str(), e.size);
+        hello |= e.longFileName == "Hello World Long Name.txt" && e.size == 5000;
+        anims |= e.longFileName == "Anims";
+        frames |= e.longFileName == "Play";
+    }
+    check(l.size() == (play ? 3u : 2u) && hello && anims && frames == play, "root lists Anims and the long name");
+
+    // Fichier fragmenté (chaîne FAT), ouvert sans tenir compte de la casse
+    ReadHandler h;
+    uint8_t buf[512];
+    uint16_t n;
+    check(fs.file_open("hello world long name.TXT", READ, h) == FILE_FOUND, "open is case-insensitive");
+    uint32_t total = 0, bad = 0;
+    while ((n = fs.file_read(buf, &h)))
+        for (uint16_t i = 0; i < n; i++, total++) if (buf[i] != (uint8_t)(total * 3)) bad++;
+    check(total == 5000 && bad == 0, "fragmented file reads back intact");
+
+    // Fichier contigu: pas de chaîne FAT
+    check(fs.change_directory("/Anims"), "cd /Anims");
+    h = ReadHandler();
+    check(fs.file_open("FR_001.RAW", READ, h) == FILE_FOUND && h.NoFatChain, "FR_001.RAW is NoFatChain");
+    const uint32_t size = h.File_Size;
+    total = 0; bad = 0;
+    if (size == 8000) {
+        while ((n = fs.file_read(buf, &h)))
+            for (uint16_t i = 0; i < n; i++, total++) if (buf[i] != (uint8_t)(total * 7)) bad++;
+        check(total == 8000 && bad == 0, "contiguous file reads back intact");
+    } else {
+        // Image BIG: chaque secteur commence par son numéro
+        while (fs.file_read(buf, &h) == 512) {
+            uint32_t tag;
+            memcpy(&tag, buf, 4);
+            if (tag != total && bad++ < 3) printf("  sector %u holds %u\n", total, tag);
+            total++;
+        }
+        printf("%u sectors read, %u misplaced\n", total, bad);
+        check(total * 512 == size && bad == 0, "file past a 65536-sector cluster reads in order");
+    }
+    check(fs.file_open("/nope.txt", READ, h) != FILE_FOUND, "missing file not found");
+
+    // Par FAT32 (chemin de AnimationPlayer): plages lues par l'ordonnanceur
+    FAT32 vol(&sd);
+    check(vol.init(), "FAT32::init delegates to exFAT");
+    const uint32_t spc = fs.get_sectors_per_cluster();
+    const bool two_extents = spc < 10;   // 10 secteurs: clusters 6 puis 8 si plus petits
+    static uint8_t run[32 * 512];
+    h = ReadHandler();
+    check(vol.file_open("/Hello World Long Name.txt", READ) == FILE_FOUND, "open through FAT32");
+    unsigned long c0 = ImageCard::commands;
+    uint32_t got = vol.file_read_blocks(run, 32, &h);
+    const unsigned long blocks_cmds = ImageCard::commands - c0;
+    total = got; bad = 0;
+    for (uint32_t i = 0; i < got; i++) bad += run[i] != (uint8_t)(i * 3);
+    while ((n = vol.file_read(buf, &h)))
+        for (uint16_t i = 0; i < n; i++, total++) bad += buf[i] != (uint8_t)(total * 3);
+    printf("file_read_blocks, fragmented: %u bytes in %lu SD commands\n", got, blocks_cmds);
+    check(got == 9 * 512 && total == 5000 && bad == 0, "  full sectors by file_read_blocks, tail by file_read");
+    // Une commande par extent (secteur de FAT déjà en cache après le parcours de la racine)
+    check(blocks_cmds == (two_extents ? 2u : 1u), "  one command per contiguous extent");
+
+    h = ReadHandler();
+    vol.file_open("/Hello World Long Name.txt", READ);
+    c0 = ImageCard::commands;
+    const uint32_t skipped = vol.file_skip_sectors(8, &h);
+    const unsigned long skip_cmds = ImageCard::commands - c0;
+    got = vol.file_read_blocks(run, 1, &h);
+    bad = 0;
+    for (uint32_t i = 0; i < got; i++) bad += run[i] != (uint8_t)((8 * 512 + i) * 3);
+    check(skipped == 8 && skip_cmds == 0 && got == 512 && bad == 0, "  file_skip_sectors: no data read, next sector in place");
+
+    // Fichier contigu: une seule commande, même à cheval sur deux clusters
+    h = ReadHandler();
+    check(vol.file_open("/Anims/FR_001.RAW", READ) == FILE_FOUND, "open NoFatChain file through FAT32");
+    const uint32_t first = size == 8000 ? 0 : spc - 6;
+    c0 = ImageCard::commands;
+    check(vol.file_skip_sectors(first, &h) == first && ImageCard::commands == c0, "  skip: LBA arithmetic only");
+    got = vol.file_read_blocks(run, size == 8000 ? 32 : 14, &h);
+    const unsigned long contiguous_cmds = ImageCard::commands - c0;
+    bad = 0;
+    for (uint32_t i = 0; i < got; i++) {
+        if (size == 8000) { bad += run[i] != (uint8_t)(i * 7); continue; }
+        uint32_t tag;
+        memcpy(&tag, run + (i & ~511u), 4);
+        bad += (i & 511) == 0 && tag != first + i / 512;
+    }
+    printf("file_read_blocks, contiguous: %u sectors from sector %u in %lu SD commands\n", got / 512, first, contiguous_cmds);
+    check(got == (size == 8000 ? 15u : 14u) * 512 && bad == 0, "  sectors across the cluster boundary in order");
+    check(contiguous_cmds == 1, "  one SD command");
+    if (!play) return check_report();
+
+    // Lecture par AnimationPlayer: trames paires contiguës, impaires en deux
+    // morceaux; 228 secteurs par pas (répertoire, premier secteur, suite, fin)
+    // en quelques commandes, et non une par secteur
+    StorageManager sm(&sd);
+    check(sm.mount_fat32() && sm.get_fat32_fs()->is_exfat(), "StorageManager mounts exFAT");
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    AnimationPlayer ap(&sm, &tft);
+    const int N = 8;
+    ap.load_animation_generated("/Play", "play", N, ".RAW");
+    ap.play_animation("play");
+    int shown = 0;
+    unsigned long worst = 0, sectors = 0;
+    for (int i = 0; i < N; i++) {
+        PanelEmulator::clear();
+        const unsigned long c1 = ImageCard::commands, r1 = ImageCard::reads;
+        HostClock::advance_ms(100);
+        ap.update();
+        const unsigned long cmds = ImageCard::commands - c1;
+        shown += frame_shown(i);
+        worst = std::max(worst, cmds);
+        sectors = std::max(sectors, ImageCard::reads - r1);
+        printf("  step %d: %lu SD commands, %lu sectors\n", i, cmds, ImageCard::reads - r1);
+    }
+    check(shown == N, "  every frame shown intact");
+    check(sectors >= 225 && worst <= 8, "  at most 8 SD commands per frame, split frames included");
+    return check_report();
+}
@@ -0,0 +1,47 @@
+/*
+Nom du fichier : test_fsck.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : FAT32::check_filesystem sur une image saine et sur une image
+              corrompue (tools/mkfat.py, MODE=corrupt), avec une mémoire de
+              travail entière puis fenêtrée en plusieurs passes.
+              Usage: test_fsck <image> clean|corrupt
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstring>
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    const bool corrupt = argc > 2 && strcmp(argv[2], "corrupt") == 0;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+
+    static uint8_t scratch[115200];
+    const uint32_t sizes[] = {sizeof scratch, 256, 64};
+    for (uint32_t size : sizes) {
+        FsckReport r;
+        char what[80];
+        snprintf(what, sizeof what, "fsck with %u bytes of scratch", (unsigned)size);
+        check(fs.check_filesystem(r, scratch, size), what);
+        printf("  passes %u, errors %u\n", r.passes, r.error_count());
+        check(size == sizeof scratch ? r.passes == 1 : r.passes > 1, "  windowed when the bitmap does not fit");
+        check(r.directories == 1 && r.files == (corrupt ? 3u : 2u), "  tree walked");
+        if (!corrupt) {
+            check(r.error_count() == 0, "  clean image: no error");
+        } else {
+            check(r.cross_links == 1, "  cross-linked chain");
+            check(r.lost_clusters == 1, "  lost cluster");
+            check(r.size_mismatches == 1, "  size/chain mismatch");
+            check(r.broken_chains == 1, "  broken chain");
+            check(r.fat_mirror_mismatches == 1, "  FAT1/FAT2 mismatch");
+        }
+    }
+    FsckReport r;
+    check(!fs.check_filesystem(r, scratch, 8), "scratch too small refused");
+    return check_report();
+}
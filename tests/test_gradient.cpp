@@ -0,0 +1,175 @@
+/*
+Nom du fichier : test_gradient.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Dégradés linéaires et radiaux, motifs 8x8 (Raster.h) contre une
+              référence naïve (flottants, setPixel pixel par pixel): écart de
+              couleur, rien d'écrit hors du rectangle ou du découpage, même
+              résultat dans un Canvas et dans le framebuffer. Affiche les
+              temps plein écran contre la référence.
+*/
+
+#include "TFT.h"
+#include "Canvas.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static int rnd(int a, int b) { return a + rand() % (b - a + 1); }
+
+static uint16_t lerp565(uint16_t c0, uint16_t c1, double t) {
+    t = std::min(1.0, std::max(0.0, t));
+    const int r = (int)lround((c0 >> 11) + ((int)(c1 >> 11) - (int)(c0 >> 11)) * t);
+    const int g = (int)lround(((c0 >> 5) & 63) + ((int)((c1 >> 5) & 63) - (int)((c0 >> 5) & 63)) * t);
+    const int b = (int)lround((c0 & 31) + ((int)(c1 & 31) - (int)(c0 & 31)) * t);
+    return (uint16_t)(r << 11 | g << 5 | b);
+}
+
+// Référence: ce que faisait l'appelant avant, un setPixel et un calcul par pixel
+static void ref_linear(TFT& t, int x, int y, int w, int h, int x0, int y0, uint16_t c0, int x1, int y1, uint16_t c1) {
+    const double ax = x1 - x0, ay = y1 - y0, l2 = ax * ax + ay * ay;
+    for (int py = y; py < y + h; py++) for (int px = x; px < x + w; px++)
+        t.setPixel(px, py, l2 == 0 ? c1 : lerp565(c0, c1, ((px - x0) * ax + (py - y0) * ay) / l2));
+}
+
+static void ref_radial(TFT& t, int x, int y, int w, int h, int xc, int yc, int r, uint16_t in, uint16_t out) {
+    for (int py = y; py < y + h; py++) for (int px = x; px < x + w; px++)
+        t.setPixel(px, py, r <= 0 ? out : lerp565(in, out, sqrt((double)(px - xc) * (px - xc) + (double)(py - yc) * (py - yc)) / r));
+}
+
+static void ref_pattern(TFT& t, int x, int y, int w, int h, const uint8_t* p, uint16_t fg, uint16_t bg) {
+    for (int py = y; py < y + h; py++) for (int px = x; px < x + w; px++)
+        t.setPixel(px, py, (p[py & 7] & (0x80 >> (px & 7))) ? fg : bg);
+}
+
+// Plus grand écart entre canaux, en niveaux RGB565 (pixels gros-boutiens)
+static int channel_error(uint16_t a_be, uint16_t b_be) {
+    const uint16_t a = Raster::to_be(a_be), b = Raster::to_be(b_be);
+    int e = abs((a >> 11) - (b >> 11));
+    e = std::max(e, abs(((a >> 5) & 63) - ((b >> 5) & 63)));
+    return std::max(e, abs((a & 31) - (b & 31)));
+}
+
+template <class F> static double micros(F f, int n) {
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) f(i);
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+static const uint8_t hatch[8] = {0x81, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x81};
+static const uint8_t checker[8] = {0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55};
+static uint16_t ref[240 * 240];
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    uint16_t* fb = tft.getFramebuffer16();
+
+    // Remplissages aléatoires: référence puis primitive sur le même fond
+    srand(42);
+    int max_linear = 0, max_radial = 0, outside = 0, pattern_diff = 0;
+    long hist[4] = {0, 0, 0, 0}, pixels = 0;
+    for (int k = 0; k < 3000; k++) {
+        const int kind = k % 3;
+        const int x = rnd(-40, 230), y = rnd(-40, 230), w = rnd(0, 200), h = rnd(0, 120);
+        const uint16_t c0 = (uint16_t)rand(), c1 = (uint16_t)rand();
+        const bool clip = rand() & 1;
+        const int sx = (k & 4) ? rnd(-10, 10) : 0, sy = (k & 8) ? rnd(-10, 10) : 0;
+        const int cx = rnd(0, 200), cy = rnd(0, 200), cw = rnd(10, 120), ch = rnd(10, 120);
+        int a0 = rnd(-60, 300), b0 = rnd(-60, 300), a1 = rnd(-60, 300), b1 = rnd(-60, 300);
+        const int r = rnd(0, 200);
+        if (k % 50 == 0) { a1 = a0; b1 = b0 + rnd(1, 200); }      // axe vertical: lignes unies
+        if (k % 97 == 0) { a1 = a0 + 1; b1 = b0; }                // axe d'un pixel
+        const uint8_t* pat = (k & 1) ? hatch : checker;
+        for (int pass = 0; pass < 2; pass++) {
+            tft.setScrollOffset(0, 0);
+            tft.resetClipRect();
+            for (int i = 0; i < 240 * 240; i++) fb[i] = 0x5A5A;
+            tft.setScrollOffset(sx, sy);
+            if (clip) tft.pushClip(cx, cy, cw, ch);
+            if (pass == 0) {
+                if (kind == 0) ref_linear(tft, x, y, w, h, a0, b0, c0, a1, b1, c1);
+                else if (kind == 1) ref_radial(tft, x, y, w, h, a0, b0, r, c0, c1);
+                else ref_pattern(tft, x, y, w, h, pat, c0, c1);
+                memcpy(ref, fb, sizeof ref);
+            } else {
+                if (kind == 0) tft.fillLinearGradient(x, y, w, h, a0, b0, c0, a1, b1, c1);
+                else if (kind == 1) tft.fillRadialGradient(x, y, w, h, a0, b0, r, c0, c1);
+                else tft.fillPattern(x, y, w, h, pat, c0, c1);
+            }
+            if (clip) tft.popClip();
+        }
+        for (int i = 0; i < 240 * 240; i++) {
+            const bool ref_bg = ref[i] == 0x5A5A, new_bg = fb[i] == 0x5A5A;
+            // Une couleur du dégradé peut tomber à 1 niveau du fond
+            if (ref_bg != new_bg && channel_error(ref[i], fb[i]) > 1) { outside++; continue; }
+            if (ref_bg && new_bg) continue;
+            const int e = channel_error(ref[i], fb[i]);
+            pixels++;
+            hist[std::min(e, 3)]++;
+            if (kind == 0) max_linear = std::max(max_linear, e);
+            else if (kind == 1) max_radial = std::max(max_radial, e);
+            else pattern_diff += e != 0;
+        }
+    }
+    tft.setScrollOffset(0, 0);
+    tft.resetClipRect();
+    printf("3000 random fills, %ld pixels: error 0:%ld 1:%ld 2:%ld >2:%ld\n", pixels, hist[0], hist[1], hist[2], hist[3]);
+    printf("max channel error (RGB565 levels): linear %d, radial %d\n", max_linear, max_radial);
+    check(max_linear <= 1 && max_radial <= 1, "gradients within 1 level of the float reference");
+    check(pattern_diff == 0, "pattern identical to the reference");
+    check(outside == 0, "nothing written outside the rect / clip");
+
+    // Canvas == framebuffer: même primitive sur l'autre surface
+    Canvas* c = Canvas::acquire(97, 61);
+    long diff = 0;
+    for (int k = 0; c && k < 300; k++) {
+        int ox = rnd(0, 140), oy = rnd(0, 170);
+        const int x = rnd(-20, 90), y = rnd(-20, 60), w = rnd(0, 110), h = rnd(0, 80);
+        const int a0 = rnd(-50, 150), b0 = rnd(-50, 150), a1 = rnd(-50, 150), b1 = rnd(-50, 150), r = rnd(0, 90);
+        const uint16_t c0 = (uint16_t)rand(), c1 = (uint16_t)rand();
+        // Motif calé sur l'origine: décalage multiple de 8
+        if (k % 3 == 2) { ox &= ~7; oy &= ~7; }
+        c->fill(0x1234);
+        tft.fillRect(ox, oy, 97, 61, 0x1234);
+        tft.pushClip(ox, oy, 97, 61);
+        switch (k % 3) {
+            case 0:
+                c->fillLinearGradient(x, y, w, h, a0, b0, c0, a1, b1, c1);
+                tft.fillLinearGradient(x + ox, y + oy, w, h, a0 + ox, b0 + oy, c0, a1 + ox, b1 + oy, c1);
+                break;
+            case 1:
+                c->fillRadialGradient(x, y, w, h, a0, b0, r, c0, c1);
+                tft.fillRadialGradient(x + ox, y + oy, w, h, a0 + ox, b0 + oy, r, c0, c1);
+                break;
+            case 2:
+                c->fillPattern(x, y, w, h, hatch, c0, c1);
+                tft.fillPattern(x + ox, y + oy, w, h, hatch, c0, c1);
+                break;
+        }
+        tft.popClip();
+        for (int py = 0; py < 61; py++) for (int px = 0; px < 97; px++)
+            diff += c->getPixels()[py * 97 + px] != fb[(py + oy) * 240 + px + ox];
+    }
+    printf("canvas vs framebuffer, 300 fills: %ld mismatching pixels\n", diff);
+    check(c && diff == 0, "canvas == framebuffer");
+    if (c) c->release();
+
+    // Temps plein écran sur l'hôte, à titre indicatif (non vérifiés)
+    const double l_ref = micros([&](int i) { ref_linear(tft, 0, 0, 240, 240, 0, 0, 0x001F, 239, 239, (uint16_t)(0xF800 | i)); }, 20);
+    const double l_new = micros([&](int i) { tft.fillLinearGradient(0, 0, 240, 240, 0, 0, 0x001F, 239, 239, (uint16_t)(0xF800 | i)); }, 200);
+    const double v_ref = micros([&](int i) { ref_linear(tft, 0, 0, 240, 240, 0, 0, 0x0010, 0, 239, (uint16_t)(0x07E0 | i)); }, 20);
+    const double v_new = micros([&](int i) { tft.fillLinearGradient(0, 0, 240, 240, 0, 0, 0x0010, 0, 239, (uint16_t)(0x07E0 | i)); }, 200);
+    const double r_ref = micros([&](int i) { ref_radial(tft, 0, 0, 240, 240, 120, 120, 120, 0xFFFF, (uint16_t)i); }, 20);
+    const double r_new = micros([&](int i) { tft.fillRadialGradient(0, 0, 240, 240, 120, 120, 120, 0xFFFF, (uint16_t)i); }, 200);
+    const double p_ref = micros([&](int i) { ref_pattern(tft, 0, 0, 240, 240, hatch, 0xFFFF, (uint16_t)i); }, 20);
+    const double p_new = micros([&](int i) { tft.fillPattern(0, 0, 240, 240, hatch, 0xFFFF, (uint16_t)i); }, 200);
+    printf("240x240 host timing, reference -> primitive: diagonal %.0f -> %.0f us, vertical %.0f -> %.0f us, "
+           "radial %.0f -> %.0f us, pattern %.0f -> %.0f us\n", l_ref, l_new, v_ref, v_new, r_ref, r_new, p_ref, p_new);
+    return check_report();
+}
@@ -0,0 +1,156 @@
+/*
+Nom du fichier : test_gzip.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Décompression gzip en flux (GzipReader) sur le corpus de
+              tools/mkgz.py copié dans l'image: niveaux, stratégies, fenêtres,
+              tailles de lecture, erreurs, BMP compressé.
+              Usage: test_gzip <image> <répertoire du corpus>
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "StorageManager.h"
+#include "GzipReader.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::string corpus;
+
+static std::vector<uint8_t> load(const std::string& name) {
+    std::vector<uint8_t> v;
+    FILE* f = fopen((corpus + "/" + name).c_str(), "rb");
+    if (!f) return v;
+    fseek(f, 0, SEEK_END);
+    v.resize(ftell(f));
+    fseek(f, 0, SEEK_SET);
+    if (!v.empty() && fread(v.data(), 1, v.size(), f) != v.size()) v.clear();
+    fclose(f);
+    return v;
+}
+
+static void put(FAT32& fs, const std::string& path, const std::vector<uint8_t>& data) {
+    fs.file_open(path.c_str(), OVERWRITE);
+    if (!data.empty()) fs.file_write(data.data(), data.size());
+    fs.file_close();
+}
+
+// Décompresse le fichier en entier par lectures de 'chunk' octets
+static Gzip_Status gunzip(FAT32& fs, const char* path, std::vector<uint8_t>& out, uint32_t chunk) {
+    out.clear();
+    if (fs.file_open(path, READ) != FILE_FOUND) return GZ_BAD_HEADER;
+    GzipReader gz(&fs);
+    Gzip_Status st = gz.begin();
+    std::vector<uint8_t> buf(chunk);
+    while (st == GZ_OK) {
+        const uint32_t n = gz.read(buf.data(), chunk);
+        out.insert(out.end(), buf.begin(), buf.begin() + n);
+        st = gz.status();
+        if (n == 0 && st == GZ_OK) st = GZ_BAD_DATA;
+    }
+    gz.end();
+    fs.file_close();
+    return st;
+}
+
+static uint16_t* pixels;
+static void pixel(uint16_t x, uint16_t y, uint16_t color) {
+    if (x < 240 && y < 240) pixels[y * 240 + x] = color;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr) || argc < 3) return 2;
+    corpus = argv[2];
+    SDCard sd;
+    StorageManager sm(&sd);
+    check(sm.mount_fat32(), "mount");
+    FAT32& fs = *sm.get_fat32_fs();
+    fs.create_directory("C");
+
+    // Corpus: contenus x niveaux x stratégies x fenêtres, lectures de 1 o à tout le fichier
+    std::vector<std::string> names;
+    for (int p = 0; p < 6; p++)
+        for (int level : {0, 1, 6, 9})
+            for (int s = 0; s < 5; s++)
+                for (int w : {9, 13}) {
+                    if (level == 0 && s) continue;
+                    char n[32];
+                    snprintf(n, sizeof n, "%d_%d_%d_%d", p, level, s, w);
+                    names.push_back(n);
+                }
+    names.push_back("HDR");
+    for (auto& n : names) put(fs, "/C/" + n + ".GZ", load(n + ".GZ"));
+    int good = 0, bad = 0;
+    for (auto& n : names) {
+        const std::vector<uint8_t> ref = load(n + ".RAW");
+        std::vector<uint8_t> got;
+        for (uint32_t chunk : {1u, 7u, 512u, 100000u}) {
+            const Gzip_Status st = gunzip(fs, ("/C/" + n + ".GZ").c_str(), got, chunk);
+            if (st == GZ_END && got == ref && !ref.empty()) good++;
+            else {
+                bad++;
+                printf("  %s chunk %u: %s, %zu/%zu bytes\n", n.c_str(), chunk, GzipReader::status_name(st), got.size(), ref.size());
+            }
+        }
+    }
+    printf("corpus: %d decodes matched zlib, %d failed\n", good, bad);
+    check(bad == 0 && good > 0, "corpus decodes byte for byte");
+
+    // skip() puis read(), et finish() vérifie le trailer sans rien produire
+    {
+        const std::vector<uint8_t> ref = load("0_9_0_13.RAW");
+        fs.file_open("/C/0_9_0_13.GZ", READ);
+        GzipReader gz(&fs);
+        uint8_t b[100];
+        const bool ok = gz.begin() == GZ_OK && gz.skip(10000) && gz.read(b, sizeof b) == sizeof b;
+        check(ok && memcmp(b, &ref[10000], sizeof b) == 0, "skip then read");
+        check(gz.finish() == GZ_END && gz.total_out() == ref.size(), "finish checks the trailer");
+        gz.end();
+        fs.file_close();
+    }
+
+    // Erreurs
+    std::vector<uint8_t> got;
+    put(fs, "/E32.GZ", load("E32.GZ"));
+    check(gunzip(fs, "/E32.GZ", got, 4096) == GZ_WINDOW_TOO_SMALL, "32 KB window rejected");
+    const std::vector<uint8_t> g = load("3_9_0_13.GZ");
+    std::vector<uint8_t> crc = g;
+    crc[crc.size() - 6] ^= 1;
+    put(fs, "/CRC.GZ", crc);
+    put(fs, "/TRUNC.GZ", std::vector<uint8_t>(g.begin(), g.begin() + g.size() / 2));
+    put(fs, "/NOT.GZ", load("EARTH.BMP"));
+    check(gunzip(fs, "/CRC.GZ", got, 512) == GZ_CRC_ERROR, "flipped CRC byte");
+    check(gunzip(fs, "/TRUNC.GZ", got, 512) == GZ_TRUNCATED, "truncated file");
+    check(gunzip(fs, "/NOT.GZ", got, 512) == GZ_BAD_HEADER, "not gzip");
+    {
+        // Tampons statiques: un seul lecteur à la fois
+        GzipReader a(&fs), b(&fs);
+        fs.file_open("/C/HDR.GZ", READ);
+        const Gzip_Status sa = a.begin(), sb = b.begin();
+        check(sa == GZ_OK && sb == GZ_BUSY, "second reader is busy");
+        a.end();
+        check(b.begin() == GZ_OK, "  free again after end()");
+        b.end();
+        fs.file_close();
+    }
+
+    // BMP brut et compressé: mêmes pixels, moins de commandes SD
+    static uint16_t raw_px[240 * 240], gz_px[240 * 240];
+    put(fs, "/EARTH.BMP", load("EARTH.BMP"));
+    put(fs, "/EARTH.GZ", load("EARTH.BMP.GZ"));
+    pixels = raw_px;
+    unsigned long c0 = ImageCard::commands;
+    const SDCard_Status ra = sm.read_bmp_file(0, 0, "/EARTH.BMP", nullptr, pixel);
+    const unsigned long raw_cmds = ImageCard::commands - c0;
+    pixels = gz_px;
+    c0 = ImageCard::commands;
+    const SDCard_Status rg = sm.read_bmp_file(0, 0, "/EARTH.GZ", nullptr, pixel);
+    const unsigned long gz_cmds = ImageCard::commands - c0;
+    printf("240x240 BMP: %lu card commands raw, %lu gzip\n", raw_cmds, gz_cmds);
+    check(ra == SD_OK && rg == SD_OK && memcmp(raw_px, gz_px, sizeof raw_px) == 0, "gzip BMP gives the same pixels");
+    check(gz_cmds < raw_cmds, "  with fewer card commands");
+    return check_report();
+}
@@ -0,0 +1,130 @@
+/*
+Nom du fichier : test_imgcache.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Cache des images BMP converties en RGB565 (tools/mkfat.py, SPF=1024):
+              succès et échecs, invalidation quand la source change (taille,
+              ou même taille réécrite), éviction sous le budget, clear().
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "StorageManager.h"
+#include "ImageCache.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstring>
+#include <vector>
+
+static uint8_t scratch[8192];
+static uint8_t fb[240 * 240 * 2];
+static uint8_t ref[240 * 240 * 2];
+
+// BMP 24 bits de bas en haut, pixel = f(x, y, seed)
+static void make_bmp(FAT32& fs, const char* name, int w, int h, int seed) {
+    const int row = (w * 3 + 3) & ~3;
+    const uint32_t size = 54 + row * h, offset = 54, header = 40;
+    const uint16_t planes = 1, bpp = 24;
+    std::vector<uint8_t> b(size, 0);
+    b[0] = 'B'; b[1] = 'M';
+    memcpy(&b[2], &size, 4); memcpy(&b[10], &offset, 4); memcpy(&b[14], &header, 4);
+    memcpy(&b[18], &w, 4); memcpy(&b[22], &h, 4); memcpy(&b[26], &planes, 2); memcpy(&b[28], &bpp, 2);
+    for (int y = 0; y < h; y++) for (int x = 0; x < w; x++) {
+        uint8_t* p = &b[54 + (h - 1 - y) * row + x * 3];
+        p[0] = (uint8_t)(x * 5 + seed); p[1] = (uint8_t)(y * 3 + seed * 7); p[2] = (uint8_t)(x + y + seed * 13);
+    }
+    fs.file_open(name, OVERWRITE);
+    fs.file_write(b.data(), size);
+    fs.file_close();
+}
+
+// Affiche l'image; retourne les secteurs lus sur la carte
+static unsigned long view(ImageCache& cache, const char* name) {
+    memset(fb, 0, sizeof fb);
+    const unsigned long r0 = ImageCard::reads;
+    const SDCard_Status st = cache.display(name, fb, 240, 240);
+    if (st != SD_OK) printf("  display(%s) -> %d\n", name, st);
+    return ImageCard::reads - r0;
+}
+
+static uint32_t cache_bytes(FAT32& fs, int& entries) {
+    std::vector<FileListEntry> v;
+    uint32_t total = 0;
+    entries = 0;
+    if (!fs.push_directory("/IMGCACHE")) return 0;
+    fs.list_directory(v);
+    fs.pop_directory();
+    for (auto& e : v) if (e.type == _File) { total += e.size; entries++; }
+    return total;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    StorageManager sm(&sd);
+    check(sm.mount_fat32(), "mount");
+    FAT32& fs = *sm.get_fat32_fs();
+    ImageCache cache(&sm);
+    const ImageCacheStats& s = cache.get_stats();
+
+    make_bmp(fs, "/A.BMP", 240, 240, 1);
+    make_bmp(fs, "/SMALL.BMP", 100, 50, 2);
+    const unsigned long first = view(cache, "/A.BMP");
+    memcpy(ref, fb, sizeof fb);
+    const unsigned long second = view(cache, "/A.BMP");
+    printf("240x240 BMP: %lu sectors read on a miss, %lu on a hit\n", first, second);
+    check(s.misses == 1 && s.hits == 1 && memcmp(ref, fb, sizeof fb) == 0, "second display is a hit, same pixels");
+    check(second < first, "  a hit reads fewer sectors than the BMP");
+    view(cache, "/SMALL.BMP");
+    memcpy(ref, fb, sizeof fb);
+    view(cache, "/SMALL.BMP");
+    check(s.hits == 2 && memcmp(ref, fb, sizeof fb) == 0, "smaller image: hit, same pixels");
+
+    // Source modifiée, autre taille
+    make_bmp(fs, "/A.BMP", 200, 240, 3);
+    view(cache, "/A.BMP");
+    memcpy(ref, fb, sizeof fb);
+    check(s.misses == 3, "resized source misses");
+    view(cache, "/A.BMP");
+    check(s.hits == 3 && memcmp(ref, fb, sizeof fb) == 0, "  then hits");
+    // Même taille, même premier cluster, autres pixels: la date de modification change la clé
+    make_bmp(fs, "/A.BMP", 200, 240, 9);
+    view(cache, "/A.BMP");
+    check(s.misses == 4 && memcmp(ref, fb, sizeof fb) != 0, "same-size rewrite misses and shows the new pixels");
+    memcpy(ref, fb, sizeof fb);
+    view(cache, "/A.BMP");
+    check(s.hits == 4 && memcmp(ref, fb, sizeof fb) == 0, "  then hits");
+    check(s.invalidations >= 2, "  old versions removed");
+
+    // Budget de deux images plein écran
+    int entries;
+    cache.set_max_bytes(2 * (512 + 240 * 240 * 2) + 1000);
+    make_bmp(fs, "/B.BMP", 240, 240, 4);
+    make_bmp(fs, "/C.BMP", 240, 240, 5);
+    view(cache, "/B.BMP");
+    view(cache, "/C.BMP");
+    check(s.evictions > 0 && cache_bytes(fs, entries) <= cache.get_max_bytes(), "eviction keeps the cache under budget");
+
+    // Plus d'entrées que EVICTION_CANDIDATES: le budget reste tenu
+    cache.set_max_bytes(40 * (512 + 32 * 32 * 2));
+    char nm[32];
+    for (int i = 0; i < 100; i++) {
+        snprintf(nm, sizeof nm, "/T%02d.BMP", i);
+        make_bmp(fs, nm, 32, 32, i);
+        view(cache, nm);
+    }
+    const uint32_t bytes = cache_bytes(fs, entries);
+    printf("100 small images: %d entries, %u bytes, budget %u\n", entries, bytes, cache.get_max_bytes());
+    check(bytes <= cache.get_max_bytes(), "budget held with many small entries");
+    const uint32_t hits = s.hits;
+    view(cache, "/T99.BMP");
+    check(s.hits == hits + 1, "  newest entry kept");
+
+    FsckReport r;
+    fs.check_filesystem(r, scratch, sizeof scratch);
+    check(r.error_count() == 0, "fsck clean");
+    check(cache.clear() && cache_bytes(fs, entries) == 0 && entries == 0, "clear empties the cache");
+    fs.check_filesystem(r, scratch, sizeof scratch);
+    check(r.error_count() == 0, "fsck clean after clear");
+    return check_report();
+}
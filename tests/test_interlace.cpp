@@ -0,0 +1,177 @@
+/*
+Nom du fichier : test_interlace.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Affichage entrelacé des animations (AnimationPlayer) sur
+              l'image de tools/mkfat.py et l'écran émulé: conversion sur
+              place en rangement par trame, puis à chaque pas les lignes
+              envoyées (toutes, ou une parité sur deux) comparées à l'image
+              d'origine, et octets lus sur la carte par pas.
+              Usage: test_interlace <image> <répertoire de tools/mkframes.py>
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "StorageManager.h"
+#include "AnimationPlayer.h"
+#include "TFT.h"
+#include "Check.h"
+#include "HostClock.h"
+#include "ImageCard.h"
+#include "PanelEmulator.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+static const int N = 8;
+static std::string dir;
+
+static std::vector<uint8_t> load(const std::string& name) {
+    std::vector<uint8_t> v;
+    FILE* f = fopen((dir + "/" + name).c_str(), "rb");
+    if (!f) return v;
+    fseek(f, 0, SEEK_END);
+    v.resize(ftell(f));
+    fseek(f, 0, SEEK_SET);
+    if (fread(v.data(), 1, v.size(), f) != v.size()) v.clear();
+    fclose(f);
+    return v;
+}
+
+static void put(FAT32& fs, const char* path, const std::vector<uint8_t>& data) {
+    fs.file_open(path, OVERWRITE);
+    fs.file_write(data.data(), data.size());
+    fs.file_close();
+}
+
+static std::vector<uint8_t> get(FAT32& fs, const char* path) {
+    std::vector<uint8_t> v;
+    if (fs.file_open(path, READ) != FILE_FOUND) return v;
+    ReadHandler h;
+    uint8_t b[512];
+    uint16_t n;
+    while ((n = fs.file_read(b, &h)) > 0) v.insert(v.end(), b, b + n);
+    fs.file_close();
+    return v;
+}
+
+// Rangement par trame: lignes paires puis impaires, bit 15 de la hauteur
+static std::vector<uint8_t> to_fields(const std::vector<uint8_t>& f) {
+    const int w = f[0] | f[1] << 8, h = f[2] | f[3] << 8, rb = w * 2;
+    std::vector<uint8_t> o(f.size());
+    memcpy(o.data(), f.data(), 4);
+    o[3] |= 0x80;
+    int r = 0;
+    for (int p = 0; p < 2; p++)
+        for (int y = p; y < h; y += 2, r++) memcpy(&o[4 + r * rb], &f[4 + y * rb], rb);
+    return o;
+}
+
+// Lignes de l'image (centrée) reçues par l'écran depuis clear(): -1 toutes,
+// 0 ou 1 une seule parité; -2 si une ligne est fausse ou partielle
+static int rows_shown(const std::vector<uint8_t>& f) {
+    const int w = f[0] | f[1] << 8, h = f[2] | f[3] << 8, ox = (240 - w) / 2, oy = (240 - h) / 2;
+    const std::vector<uint16_t>& mem = PanelEmulator::panels[0].mem;
+    bool sent[2] = {false, false}, skipped[2] = {false, false};
+    for (int y = 0; y < h; y++) {
+        int good = 0, untouched = 0;
+        for (int x = 0; x < w; x++) {
+            const uint16_t v = mem[(oy + y) * 240 + ox + x];
+            good += v == (uint16_t)(f[4 + (y * w + x) * 2] | f[5 + (y * w + x) * 2] << 8);
+            untouched += v == 0xDEAD;
+        }
+        if (good == w) sent[y & 1] = true;
+        else if (untouched == w) skipped[y & 1] = true;
+        else return -2;
+    }
+    if (sent[0] && sent[1] && !skipped[0] && !skipped[1]) return -1;
+    if (sent[0] != sent[1] && skipped[0] != skipped[1]) return sent[1] ? 1 : 0;
+    return -2;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr) || argc < 3) return 2;
+    dir = argv[2];
+    SDCard sd;
+    StorageManager sm(&sd);
+    check(sm.mount_fat32(), "mount");
+    FAT32& fs = *sm.get_fat32_fs();
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    AnimationPlayer ap(&sm, &tft);
+
+    std::vector<uint8_t> r240[N], r200[N], g240[N];
+    for (const char* d : {"P240", "F240", "F200", "G240"}) fs.create_directory(d);
+    char p[64];
+    for (int i = 0; i < N; i++) {
+        r240[i] = load("R240_" + std::to_string(i) + ".RAW");
+        r200[i] = load("R200_" + std::to_string(i) + ".RAW");
+        g240[i] = load("G240_" + std::to_string(i) + ".RAW");
+        snprintf(p, sizeof p, "/P240/FR_%03d.RAW", i);
+        put(fs, p, r240[i]);
+        snprintf(p, sizeof p, "/F240/FR_%03d.RAW", i);
+        put(fs, p, r240[i]);
+        snprintf(p, sizeof p, "/F200/FR_%03d.RAW", i);
+        put(fs, p, r200[i]);
+        snprintf(p, sizeof p, "/G240/FR_%03d.RAW.GZ", i);
+        put(fs, p, load("G240_" + std::to_string(i) + ".GZ"));
+    }
+    fs.flush();
+
+    // Conversion sur place
+    for (auto set : {std::make_pair("/F240", r240), std::make_pair("/F200", r200)}) {
+        const size_t n = ap.convert_to_fields(set.first), again = ap.convert_to_fields(set.first);
+        int same = 0;
+        for (int i = 0; i < N; i++) {
+            snprintf(p, sizeof p, "%s/FR_%03d.RAW", set.first, i);
+            same += get(fs, p) == to_fields(set.second[i]);
+        }
+        printf("convert %s: %zu converted, %zu on the second pass\n", set.first, n, again);
+        check(n == N && again == 0 && same == N, "  field-major files byte-identical to the reference");
+    }
+
+    // Lecture pas à pas: progressive = image entière à chaque pas; entrelacée =
+    // première image entière, puis une parité sur deux en alternance
+    struct Run { const char* dir; const char* ext; bool interlaced; std::vector<uint8_t>* ref; bool fields; } runs[] = {
+        {"/P240", ".RAW", false, r240, false}, {"/F240", ".RAW", false, r240, true}, {"/F240", ".RAW", true, r240, true},
+        {"/F200", ".RAW", false, r200, true}, {"/F200", ".RAW", true, r200, true},
+        {"/G240", ".RAW.GZ", false, g240, true}, {"/G240", ".RAW.GZ", true, g240, true},
+        {"/P240", ".RAW", true, r240, false}};
+    unsigned long progressive_bytes = 0;
+    for (auto& r : runs) {
+        char name[32];
+        snprintf(name, sizeof name, "%s%s%d", r.dir, r.ext, r.interlaced);
+        ap.load_animation_generated(r.dir, name, N, r.ext);
+        ap.play_animation(name);
+        ap.set_interlaced(r.interlaced);
+        bool ok = true;
+        unsigned long card = 0, panel = 0;
+        for (int i = 0; i < N; i++) {
+            PanelEmulator::clear();
+            const unsigned long r0 = ImageCard::reads;
+            HostClock::advance_ms(100);
+            ap.update();
+            const int shown = rows_shown(r.ref[i]);
+            const int want = (!r.interlaced || !r.fields || i == 0) ? -1 : (i - 1) & 1;
+            if (shown != want) {
+                printf("  step %d: rows %d, expected %d\n", i, shown, want);
+                ok = false;
+            }
+            if (i > 0) {
+                card += (ImageCard::reads - r0) * 512;
+                panel += PanelEmulator::panels[0].bytes;
+            }
+        }
+        printf("%-6s %-7s %-11s %7lu card B/step, %7lu panel B/step\n", r.dir, r.ext, r.interlaced ? "interlaced" : "progressive",
+               card / (N - 1), panel / (N - 1));
+        if (!r.interlaced && r.fields && r.ref == r240) progressive_bytes = card / (N - 1);
+        char what[64];
+        snprintf(what, sizeof what, "  %s", !r.fields ? "row-major frames play whole" :
+                 r.interlaced ? "one field per step, rows match" : "whole frames match");
+        check(ok, what);
+        if (r.interlaced && r.fields && r.ref == r240 && r.ext[4] == 0)
+            check(card / (N - 1) * 10 < progressive_bytes * 6, "  about half the card reads");
+    }
+    return check_report();
+}
@@ -0,0 +1,107 @@
+/*
+Nom du fichier : test_iosched.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : File de requêtes bloc sous FAT32 (tools/mktree.py, FILL=1):
+              60 trames de 115 Ko lues comme AnimationPlayer, chacune suivie
+              d'un enregistrement de 512 o dans un journal; commandes SD et
+              temps modélisé. Puis file_read_blocks relancé après une lecture
+              multi-blocs en échec.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstring>
+
+static uint8_t fb[115200];
+static uint8_t scratch[8192];
+
+// Lecture d'une trame comme AnimationPlayer::read_frame_from_file (copie directe);
+// le journal reste ouvert en écriture pendant la lecture
+static bool play_frame(FAT32& fs, int i) {
+    char p[32];
+    snprintf(p, sizeof p, "/OLDANIM/FR_%03d.RAW", i);
+    if (fs.file_open(p, READ) != FILE_FOUND) return false;
+    ReadHandler h;
+    uint8_t tmp[512];
+    uint32_t chunk = fs.file_read(tmp, &h);
+    uint32_t copied = chunk - 4;
+    memcpy(fb, tmp + 4, copied);
+    while (copied < sizeof fb) {
+        const uint32_t sectors = (sizeof fb - copied) / 512;
+        if (sectors > 0) {
+            const uint32_t n = fs.file_read_blocks(fb + copied, sectors, &h);
+            if (n) { copied += n; continue; }
+        }
+        chunk = fs.file_read(tmp, &h);
+        if (!chunk) break;
+        const uint32_t take = chunk > sizeof fb - copied ? sizeof fb - copied : chunk;
+        memcpy(fb + copied, tmp, take);
+        copied += take;
+    }
+    return copied == sizeof fb && fb[1000] == (uint8_t)i;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+
+    const int frames = 60;
+    int played = 0;
+    static uint8_t rec[512];
+    const unsigned long c0 = ImageCard::cost_us, k0 = ImageCard::commands;
+    fs.file_open("/LOG.TXT", CREATE);
+    for (int i = 0; i < frames; i++) {
+        played += play_frame(fs, i);
+        memset(rec, 'a' + i % 26, sizeof rec);
+        fs.file_write(rec, sizeof rec);
+    }
+    fs.file_close();
+    const BlockSchedulerStats& s = fs.get_io_stats();
+    printf("%lu SD commands, %.1f ms modelled; writes: %lu commands, %lu blocks, %lu rewrites absorbed\n",
+           ImageCard::commands - k0, (ImageCard::cost_us - c0) / 1000.0,
+           (unsigned long)s.write_commands, (unsigned long)s.written_blocks, (unsigned long)s.coalesced);
+    check(played == frames, "every frame read intact");
+    check(ImageCard::commands - k0 < 1000, "under 1000 SD commands (13972 sector by sector)");
+    check(s.coalesced > 0 && s.write_commands < s.written_blocks, "writes coalesced and merged");
+    FsckReport r;
+    fs.check_filesystem(r, scratch, sizeof scratch);
+    check(r.error_count() == 0, "fsck clean");
+    fs.file_open("/LOG.TXT", READ);
+    ReadHandler h;
+    uint8_t t[512];
+    int good = 0;
+    for (int i = 0; i < frames; i++) if (fs.file_read(t, &h) == 512 && t[0] == 'a' + i % 26 && t[511] == t[0]) good++;
+    fs.file_close();
+    check(good == frames, "log reads back");
+
+    // Lecture multi-blocs en échec: le handler n'avance pas, la relance reprend au bon secteur
+    std::vector<uint8_t> ref(300 * 512);
+    for (size_t i = 0; i < ref.size(); i++) ref[i] = (uint8_t)(i * 7 + i / 512);
+    fs.file_open("/BIG.BIN", CREATE);
+    fs.file_write(ref.data(), ref.size());
+    fs.file_close();
+    for (int fail_at = 0; fail_at < 4; fail_at++) {
+        std::vector<uint8_t> got(ref.size());
+        fs.file_open("/BIG.BIN", READ);
+        ReadHandler rh;
+        uint32_t pos = 0;
+        int errors = 0;
+        ImageCard::read_blocks_fail = fail_at;
+        while (pos < got.size()) {
+            const uint32_t n = fs.file_read_blocks(got.data() + pos, 37, &rh);
+            if (n == 0) { if (++errors > 3) break; continue; }
+            pos += n;
+        }
+        ImageCard::read_blocks_fail = -1;
+        fs.file_close();
+        char what[80];
+        snprintf(what, sizeof what, "read failure on command %d: retry resumes, data identical", fail_at);
+        check(pos == got.size() && got == ref && errors == 1, what);
+    }
+    return check_report();
+}
@@ -0,0 +1,263 @@
+/*
+Nom du fichier : test_kv.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Journal clé/valeur (KVStore) sur l'image de tools/mkfat.py: coût
+              en secteurs par opération, reprise après troncature du journal à
+              chaque octet, et après coupure d'alimentation à chaque bloc écrit.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "KVStore.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+typedef std::map<std::string, std::string> State;
+
+struct Op {
+    std::string key, value;
+    bool del;
+};
+
+static const int KEYS = 20;
+static std::vector<uint32_t> lbas;      // secteurs du fichier, dans l'ordre
+
+// Les montages répétés sont bavards: sortie standard coupée pendant les boucles
+static int saved_fd = -1;
+static void quiet() {
+    fflush(stdout);
+    saved_fd = dup(1);
+    const int f = open("/dev/null", O_WRONLY);
+    dup2(f, 1);
+    close(f);
+}
+static void loud() {
+    fflush(stdout);
+    dup2(saved_fd, 1);
+    close(saved_fd);
+}
+
+static uint32_t rng = 12345;
+static uint32_t rnd() {
+    rng = rng * 1103515245u + 12345u;
+    return rng >> 8;
+}
+
+static std::vector<Op> make_ops(int n) {
+    std::vector<Op> ops;
+    for (int i = 0; i < n; i++) {
+        Op o;
+        char k[8];
+        snprintf(k, sizeof k, "k%02u", rnd() % KEYS);
+        o.key = k;
+        o.del = rnd() % 10 == 0;
+        const int len = rnd() % 40;
+        for (int j = 0; j < len; j++) o.value += (char)('a' + rnd() % 26);
+        ops.push_back(o);
+    }
+    return ops;
+}
+
+static void apply(State& s, const Op& o) {
+    if (o.del) s.erase(o.key);
+    else s[o.key] = o.value;
+}
+
+static void run(KVStore& kv, const Op& o) {
+    if (o.del) kv.remove(o.key.c_str());
+    else kv.put_string(o.key.c_str(), o.value.c_str());
+}
+
+static bool matches(KVStore& kv, const State& s) {
+    for (int i = 0; i < KEYS; i++) {
+        char k[8], v[300];
+        snprintf(k, sizeof k, "k%02d", i);
+        const int32_t n = kv.get(k, v, 299);
+        auto it = s.find(k);
+        if (it == s.end()) {
+            if (n >= 0) return false;
+            continue;
+        }
+        if (n < 0 || std::string(v, n) != it->second) return false;
+    }
+    return kv.count() == s.size();
+}
+
+static void snap(std::vector<uint8_t>& out) {
+    out.resize(lbas.size() * 512);
+    for (size_t i = 0; i < lbas.size(); i++) {
+        fseek(ImageCard::image, (long)lbas[i] * 512, SEEK_SET);
+        if (fread(&out[i * 512], 1, 512, ImageCard::image) != 512) return;
+    }
+}
+
+static void restore(const std::vector<uint8_t>& in) {
+    for (size_t i = 0; i < lbas.size(); i++) {
+        fseek(ImageCard::image, (long)lbas[i] * 512, SEEK_SET);
+        fwrite(&in[i * 512], 1, 512, ImageCard::image);
+    }
+    fflush(ImageCard::image);
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    std::vector<uint8_t> base, full, trial;
+
+    // Coût par opération
+    {
+        SDCard sd;
+        FAT32 fs(&sd);
+        check(fs.init(), "mount");
+        KVStore kv;
+        check(kv.open(&fs), "open creates the store");
+        fs.flush();
+        std::vector<uint32_t> cl;
+        uint32_t size;
+        fs.get_file_clusters(KV_Config::DEFAULT_PATH, cl, size);
+        for (uint32_t c : cl)
+            for (uint32_t s = 0; s < fs.get_cluster_size(); s++)
+                lbas.push_back(fs.get_data_base() + (c - 2) * fs.get_cluster_size() + s);
+        check(size == KV_Config::FILE_SECTORS * 512 && lbas.size() == KV_Config::FILE_SECTORS, "  preallocated file");
+        snap(base);
+
+        KVStats s0 = kv.get_stats();
+        kv.put_string("volume", "7");
+        kv.put_string("last_anim", "/ANIM/SPACE");
+        char v[64];
+        int32_t n = kv.get("volume", v, sizeof v);
+        KVStats s1 = kv.get_stats();
+        printf("2 puts + 1 get: %lu sector writes, %lu reads\n",
+               (unsigned long)(s1.sector_writes - s0.sector_writes), (unsigned long)(s1.sector_reads - s0.sector_reads));
+        check(n == 1 && v[0] == '7', "get returns the value");
+        check(s1.sector_writes - s0.sector_writes <= 2 && s1.sector_reads == s0.sector_reads, "  one sector write per put, no read");
+        for (int i = 0; i < 30; i++) kv.put_string("filler", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx");
+        s0 = kv.get_stats();
+        n = kv.get("last_anim", v, sizeof v);
+        s1 = kv.get_stats();
+        check(n == 11 && memcmp(v, "/ANIM/SPACE", 11) == 0, "get outside the tail sector");
+        check(s1.sector_reads - s0.sector_reads == 1, "  one sector read");
+        const unsigned long w0 = ImageCard::writes;
+        fs.flush();
+        printf("32 puts: %lu card writes after flush\n", ImageCard::writes - w0);
+    }
+
+    // Troncature du journal à chaque octet (sans compactage)
+    restore(base);
+    const std::vector<Op> ops = make_ops(300);
+    std::vector<uint32_t> ends;
+    std::vector<State> states(1);
+    {
+        SDCard sd;
+        FAT32 fs(&sd);
+        fs.init();
+        KVStore kv;
+        kv.open(&fs);
+        for (auto& o : ops) {
+            run(kv, o);
+            State st = states.back();
+            apply(st, o);
+            states.push_back(st);
+            ends.push_back(512 + kv.used_bytes());
+        }
+        kv.sync();
+        check(kv.get_stats().compactions == 0, "truncation log fits one region");
+    }
+    snap(full);
+    const uint32_t region_bytes = KV_Config::REGION_SECTORS * 512;
+    uint32_t bad = 0, tested = 0;
+    quiet();
+    for (uint32_t t = 0; t <= ends.back() + 1; t++) {
+        trial = full;
+        memset(&trial[t], 0, region_bytes - t);
+        restore(trial);
+        SDCard sd;
+        FAT32 fs(&sd);
+        fs.init();
+        KVStore kv;
+        const bool ok = kv.open(&fs);
+        size_t j = 0;
+        while (j < ends.size() && ends[j] <= t) j++;
+        if (!ok || !matches(kv, states[j])) bad++;
+        tested++;
+    }
+    loud();
+    printf("truncation: %u offsets, %u mismatches\n", tested, bad);
+    check(bad == 0, "truncated log recovers the complete records");
+
+    // Coupure d'alimentation après N blocs écrits, compactages compris
+    restore(base);
+    const std::vector<Op> ops2 = make_ops(1500);
+    std::vector<State> st2(1);
+    for (auto& o : ops2) {
+        State s = st2.back();
+        apply(s, o);
+        st2.push_back(s);
+    }
+    unsigned long total_writes = 0;
+    quiet();
+    {
+        SDCard sd;
+        FAT32 fs(&sd);
+        fs.init();
+        KVStore kv;
+        kv.open(&fs);
+        const unsigned long w0 = ImageCard::writes;
+        int i = 0;
+        for (auto& o : ops2) {
+            run(kv, o);
+            if (++i % 10 == 0) kv.sync();
+        }
+        kv.sync();
+        total_writes = ImageCard::writes - w0;
+        loud();
+        check(kv.get_stats().compactions > 0 && matches(kv, st2.back()), "power-cut run compacts and ends in the final state");
+        quiet();
+    }
+    uint32_t inconsistent = 0, regress = 0;
+    size_t last = 0;
+    for (unsigned long budget = 0; budget <= total_writes; budget++) {
+        restore(base);
+        {
+            SDCard sd;
+            FAT32 fs(&sd);
+            fs.init();
+            KVStore kv;
+            kv.open(&fs);
+            ImageCard::write_budget = budget;
+            int i = 0;
+            for (auto& o : ops2) {
+                run(kv, o);
+                if (++i % 10 == 0) kv.sync();
+            }
+            kv.sync();
+            ImageCard::write_budget = ~0UL;
+        }
+        SDCard sd;
+        FAT32 fs(&sd);
+        fs.init();
+        KVStore kv;
+        kv.open(&fs);
+        // État relu = un état intermédiaire, jamais antérieur au précédent
+        size_t found = SIZE_MAX;
+        for (size_t j = last; j < st2.size() && found == SIZE_MAX; j++)
+            if (matches(kv, st2[j])) found = j;
+        for (size_t j = 0; j < last && found == SIZE_MAX; j++)
+            if (matches(kv, st2[j])) { found = j; regress++; }
+        if (found == SIZE_MAX) inconsistent++;
+        else last = found;
+    }
+    loud();
+    printf("power cut: %lu budgets, %u inconsistent, %u regressions, final state %zu/%zu\n",
+           total_writes + 1, inconsistent, regress, last, st2.size() - 1);
+    check(inconsistent == 0 && regress == 0, "every power cut recovers an intermediate state");
+    check(last == st2.size() - 1, "  full budget keeps the final state");
+    return check_report();
+}
@@ -0,0 +1,209 @@
+/*
+Nom du fichier : test_lfn.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Noms longs et création de fichiers (tools/mkfat.py, SPF=1024):
+              - suite aléatoire de créations (8.3, noms longs, casse variable,
+                doublons), effacements, renommages, mkdir et rm -r comparée à
+                un modèle: chaque répertoire contient exactement les noms du
+                modèle, fsck propre;
+              - rotation effacer le plus ancien / créer le suivant sans que le
+                répertoire grandisse;
+              - lectures SD et temps par création dans une série de 10000 noms
+                longs (index de la dernière passe).
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <string>
+
+static std::string upper(std::string s) {
+    for (auto& c : s) c = (char)toupper((unsigned char)c);
+    return s;
+}
+
+static int rnd(int a, int b) { return a + rand() % (b - a + 1); }
+
+static std::string random_name() {
+    static const char* words[] = {"log", "Frame", "capture", "A", "data", "IMG", "sensor", "x"};
+    char b[64];
+    switch (rand() % 4) {
+        case 0: snprintf(b, sizeof b, "F%05d.TXT", rnd(0, 3000)); break;
+        case 1: snprintf(b, sizeof b, "%s %d.raw", words[rand() % 8], rnd(0, 3000)); break;
+        case 2: snprintf(b, sizeof b, "%s_%s_%d.dat", words[rand() % 8], words[rand() % 8], rnd(0, 300)); break;
+        default: snprintf(b, sizeof b, "%s%d", words[rand() % 8], rnd(0, 999)); break;
+    }
+    std::string s(b);
+    if (rand() % 5 == 0) for (auto& c : s) c = (char)(rand() & 1 ? toupper(c) : tolower(c));
+    return s;
+}
+
+static bool fixed_entry(const std::string& k) {
+    return k == "D1" || k == "D2" || k == "ANIMS" || k == "SUB DIR" || k.rfind("DIR", 0) == 0;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+    srand(7);
+
+    // Modèle: répertoire -> nom en majuscules -> nom tel que créé
+    const char* dirs[] = {"/", "/D1", "/D1/Sub dir", "/D2"};
+    std::map<std::string, std::map<std::string, std::string>> model;
+    fs.create_directory("D1");
+    fs.create_directory("D2");
+    fs.change_directory("/D1");
+    fs.create_directory("Sub dir");
+    fs.change_directory("/");
+    model["/"] = {{"D1", "D1"}, {"D2", "D2"}, {"A.TXT", "A.TXT"}, {"ANIMS", "ANIMS"}};
+    model["/D1"] = {{"SUB DIR", "Sub dir"}};
+    model["/D1/Sub dir"];
+    model["/D2"];
+    int creates = 0, refused = 0;
+    for (int step = 0; step < 6000; step++) {
+        const char* d = dirs[(step / 400) % 4];
+        if (rand() % 7 == 0) d = dirs[rand() % 4];
+        fs.change_directory(d);
+        auto& m = model[d];
+        const int op = rnd(0, 99);
+        if (op < 70) {
+            const std::string n = random_name();
+            const FAT_ErrorCode r = fs.file_open(n.c_str(), CREATE);
+            if (r == FILE_CREATE_OK || r == FILE_FOUND) { m.emplace(upper(n), n); creates++; }
+            else refused++;
+            fs.file_close();
+        } else if (op < 85 && !m.empty()) {
+            auto it = m.begin();
+            std::advance(it, rand() % m.size());
+            const std::string n = it->second;
+            if (fixed_entry(it->first)) continue;
+            if (fs.delete_file(n.c_str())) m.erase(upper(n));
+        } else if (op < 93 && !m.empty()) {
+            // Renommage 8.3 -> 8.3 (seul cas pris en charge)
+            auto it = m.begin();
+            std::advance(it, rand() % m.size());
+            const std::string n = it->second;
+            if (n.size() > 12 || n.find(' ') != std::string::npos || n.find('.') == std::string::npos) continue;
+            char nn[16];
+            snprintf(nn, sizeof nn, "R%05d.TXT", rnd(0, 3000));
+            if (m.count(nn)) continue;
+            if (fs.rename_file(n.c_str(), nn)) { m.erase(upper(n)); m.emplace(nn, nn); }
+        } else if (op < 96) {
+            char dn[16];
+            snprintf(dn, sizeof dn, "DIR%d", rnd(0, 40));
+            if (!m.count(dn) && fs.create_directory(dn)) m.emplace(dn, dn);
+        } else {
+            for (auto [k, n] : m) if (k.rfind("DIR", 0) == 0) { if (fs.remove_tree(n.c_str())) m.erase(k); break; }
+        }
+    }
+    printf("%d creates, %d refused\n", creates, refused);
+    check(refused == 0, "no create refused");
+    bool same = true;
+    for (auto& [d, m] : model) {
+        fs.change_directory(d.c_str());
+        std::vector<FileListEntry> l;
+        fs.list_directory(l);
+        size_t listed = 0, missing = 0;
+        for (auto& e : l) if (e.dosFileName[0] != '.' && !(e.attributes & 0x08)) listed++;
+        for (auto& [k, n] : m) if (!fixed_entry(k) && !fs.file_exists(n.c_str())) missing++;
+        if (listed != m.size() || missing) {
+            same = false;
+            printf("  %s: %zu listed, %zu expected, %zu missing\n", d.c_str(), listed, m.size(), missing);
+        }
+    }
+    check(same, "directories match the model");
+    fs.change_directory("/");
+    static uint8_t scratch[115200];
+    FsckReport rep;
+    fs.check_filesystem(rep, scratch, sizeof scratch);
+    check(rep.error_count() == 0, "fsck clean");
+
+    // Noms longs: liste, taille, effacement, recréation, doublon
+    check(fs.create_directory("Recorded Frames") && fs.change_directory("/Recorded Frames"), "mkdir + cd with a long name");
+    char nm[64];
+    bool made = true;
+    for (int i = 0; i < 300; i++) {
+        snprintf(nm, sizeof nm, "capture frame %05d.raw", i);
+        made &= fs.file_open(nm, CREATE) == FILE_CREATE_OK;
+        fs.file_close();
+    }
+    check(made, "300 long names created");
+    std::vector<FileListEntry> l;
+    fs.list_directory(l);
+    int lfn = 0;
+    for (auto& e : l) if (e.hasLongName && e.longFileName.rfind("capture frame", 0) == 0) lfn++;
+    check(lfn == 300, "every long name listed");
+    check(fs.delete_file("capture frame 00042.raw") && !fs.file_exists("capture frame 00042.raw"), "long name deleted");
+    check(fs.file_open("capture frame 00042.raw", CREATE) == FILE_CREATE_OK, "long name created again");
+    fs.file_close();
+    // CREATE sur un nom existant (autre casse): le fichier est tronqué, pas dupliqué
+    check(fs.file_open("CAPTURE FRAME 00043.RAW", CREATE) == FILE_CREATE_OK, "create on an existing name (other case)");
+    fs.file_close();
+    l.clear();
+    fs.list_directory(l);
+    check(l.size() == 302, "  no duplicate entry");
+    fs.change_directory("/");
+
+    // Rotation: le trou laissé par l'effacement est repris
+    fs.create_directory("Rotate");
+    fs.change_directory("/Rotate");
+    for (int i = 0; i < 200; i++) {
+        snprintf(nm, sizeof nm, "sensor log %06d.csv", i);
+        fs.file_open(nm, CREATE);
+        fs.file_close();
+    }
+    const uint32_t free0 = fs.count_free_clusters();
+    unsigned long r0 = ImageCard::reads;
+    bool rot = true;
+    for (int i = 200; i < 2200; i++) {
+        snprintf(nm, sizeof nm, "sensor log %06d.csv", i - 200);
+        rot &= fs.delete_file(nm);
+        snprintf(nm, sizeof nm, "sensor log %06d.csv", i);
+        rot &= fs.file_open(nm, CREATE) == FILE_CREATE_OK;
+        fs.file_close();
+    }
+    l.clear();
+    fs.list_directory(l);
+    printf("rotation: %.1f SD reads per delete + create\n", (double)(ImageCard::reads - r0) / 2000);
+    check(rot && l.size() == 202 && free0 == fs.count_free_clusters(), "rotation reuses the erased slots");
+    check((ImageCard::reads - r0) / 2000 < 40, "rotation under 40 reads per pair");
+    fs.change_directory("/");
+
+    // Série: sans collision possible, une création ne relit pas le répertoire,
+    // quelle que soit sa taille (10000 noms longs, 30000 entrées)
+    fs.create_directory("Series");
+    fs.change_directory("/Series");
+    r0 = ImageCard::reads;
+    unsigned long r_last = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    bool created = true;
+    for (int i = 0; i < 10000; i++) {
+        if (i == 9000) r_last = ImageCard::reads;
+        snprintf(nm, sizeof nm, "capture frame %05d.raw", i);
+        created &= fs.file_open(nm, CREATE) == FILE_CREATE_OK;
+        fs.file_close();
+    }
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    const double per_create = (double)(ImageCard::reads - r0) / 10000, per_last = (double)(ImageCard::reads - r_last) / 1000;
+    printf("series: 10000 creates in %.0f ms (host), %.2f SD reads per create, %.2f over the last 1000\n", ms, per_create, per_last);
+    check(created, "10000 long names created");
+    check(per_create < 2 && per_last < 2, "under 2 reads per create, flat up to 10000 names");
+    // CREATE sur un nom existant (autre casse) tronque sans dupliquer
+    check(fs.file_open("CAPTURE FRAME 09999.RAW", CREATE) == FILE_CREATE_OK, "  create on an existing name (other case)");
+    fs.file_close();
+    l.clear();
+    fs.list_directory(l);
+    check(l.size() == 10002, "  no duplicate entry among 10000");
+    fs.change_directory("/");
+    fs.check_filesystem(rep, scratch, sizeof scratch);
+    check(rep.error_count() == 0, "fsck clean at the end");
+    return check_report();
+}
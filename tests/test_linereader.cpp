@@ -0,0 +1,120 @@
+/*
+Nom du fichier : test_linereader.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Lecture ligne à ligne (LineReader) des fichiers de
+              tools/mklines.py copiés dans l'image, bruts et .gz: lignes
+              identiques (LF, CRLF, CR en fin de lecture, lignes longues en
+              morceaux), aucune allocation pendant l'analyse.
+              Usage: test_linereader <image> <répertoire des fichiers>
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "LineReader.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocations comptées pendant la lecture
+static unsigned long allocations = 0;
+void* operator new(size_t n) {
+    allocations++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+static std::string dir;
+
+static bool load(const std::string& name, std::string& out) {
+    out.clear();
+    FILE* f = fopen((dir + "/" + name).c_str(), "rb");
+    if (!f) return false;
+    char b[4096];
+    size_t n;
+    while ((n = fread(b, 1, sizeof b, f)) > 0) out.append(b, n);
+    fclose(f);
+    return true;
+}
+
+// Lignes attendues: coupées sur '\n', un '\r' final retiré
+static std::vector<std::string> expected(const std::string& t) {
+    std::vector<std::string> v;
+    size_t a = 0;
+    while (a < t.size()) {
+        size_t e = t.find('\n', a);
+        if (e == std::string::npos) e = t.size();
+        std::string l = t.substr(a, e - a);
+        if (!l.empty() && l.back() == '\r') l.pop_back();
+        v.push_back(l);
+        a = e + 1;
+    }
+    return v;
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr) || argc < 3) return 2;
+    dir = argv[2];
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+    const char* names[] = {"LOG.TXT", "SPLIT.TXT", "MIX.TXT", "EMPTY.TXT", "ONE.TXT", "NL.TXT", "CRLF.TXT"};
+    std::string data;
+    for (auto n : names)
+        for (std::string s : {std::string(n), std::string(n) + ".GZ"}) {
+            if (!load(s, data)) continue;
+            fs.file_open(("/" + s).c_str(), OVERWRITE);
+            if (!data.empty()) fs.file_write((const uint8_t*)data.data(), data.size());
+            fs.file_close();
+        }
+
+    for (auto n : names) {
+        load(n, data);
+        const std::vector<std::string> exp = expected(data);
+        for (std::string s : {std::string(n), std::string(n) + ".GZ"}) {
+            LineReader r(&fs);
+            const unsigned long c0 = ImageCard::commands;
+            if (!r.open(("/" + s).c_str())) {
+                check(false, ("open " + s).c_str());
+                continue;
+            }
+            // Comparaison morceau par morceau, sans allocation dans la boucle
+            const unsigned long a0 = allocations;
+            std::string_view line;
+            size_t idx = 0, off = 0;
+            bool ok = true;
+            while (ok && r.next(line)) {
+                if (idx >= exp.size() || exp[idx].compare(off, line.size(), line.data(), line.size()) != 0) ok = false;
+                off += line.size();
+                if (!ok || !r.last_complete()) continue;
+                if (off != exp[idx].size() || r.get_line_number() != idx + 1) ok = false;
+                idx++;
+                off = 0;
+            }
+            const unsigned long allocs = allocations - a0;
+            r.close();
+            const LineReaderStats& st = r.get_stats();
+            char what[96];
+            printf("%-12s %6zu lines, %lu copied, %lu split, %lu card commands\n", s.c_str(), exp.size(),
+                   (unsigned long)st.copied, (unsigned long)st.split, ImageCard::commands - c0);
+            snprintf(what, sizeof what, "%s: every line matches", s.c_str());
+            check(ok && idx == exp.size(), what);
+            check(allocs == 0, "  no allocation while parsing");
+        }
+    }
+
+    // Tampons statiques: un seul lecteur à la fois
+    LineReader a(&fs), b(&fs);
+    const bool oa = a.open("/ONE.TXT"), ob = b.open("/NL.TXT");
+    a.close();
+    check(oa && !ob, "second reader refused");
+    check(b.open("/NL.TXT"), "  free again after close()");
+    b.close();
+    return check_report();
+}
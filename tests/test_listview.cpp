@@ -0,0 +1,148 @@
+/*
+Nom du fichier : test_listview.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : ListView (ListView.h) sur l'écran émulé avec une source
+              synthétique de 100000 éléments: lignes demandées et dessinées
+              par défilement, bande invalidée, pas d'allocation, rendu
+              partiel identique au rendu complet, repli sur l'invalidation
+              complète quand un widget recouvre la liste.
+*/
+
+#include "TFT.h"
+#include "Widget.h"
+#include "ListView.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// Compteur d'allocations: le défilement ne doit pas toucher au tas
+static unsigned long news = 0;
+void* operator new(size_t n) {
+    news++;
+    if (void* p = malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+struct Synth {
+    uint32_t n;
+    unsigned long calls;
+};
+
+static bool synth(uint32_t index, char* text, uint8_t size, void* ctx) {
+    Synth* s = (Synth*)ctx;
+    s->calls++;
+    if (index >= s->n) return false;
+    snprintf(text, size, "item %06u %s", (unsigned)index, (index % 7 == 0) ? "- a rather long line that overflows" : "");
+    return true;
+}
+
+static uint16_t ref[240 * 240];
+
+// Rendu partiel déjà fait: écran == framebuffer, puis rendu complet == partiel
+static bool same_as_full(TFT& tft, WidgetTree& tree) {
+    const uint16_t* fb = (const uint16_t*)tft.getFramebuffer();
+    int panel_vs_fb = 0, partial_vs_full = 0;
+    for (int i = 0; i < 240 * 240; i++) panel_vs_fb += PanelEmulator::panels[0].mem[i] != fb[i];
+    memcpy(ref, fb, sizeof ref);
+    tree.invalidate_all();
+    tree.render(false);
+    for (int i = 0; i < 240 * 240; i++) partial_vs_full += ref[i] != fb[i];
+    if (panel_vs_fb || partial_vs_full) printf("  panel != fb: %d px, partial != full: %d px\n", panel_vs_fb, partial_vs_full);
+    return panel_vs_fb == 0 && partial_vs_full == 0;
+}
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    WidgetTree tree(&tft, COLOR_16BITS_NAVY);
+    Synth src{100000, 0};
+    Label title(Rect(0, 2, 240, 14), "100000 items", COLOR_16BITS_WHITE, FontType::FONT_STANDARD, Label::CENTER);
+    ListView view(Rect(10, 20, 220, 196), synth, &src, src.n, 14);     // 14 lignes visibles
+    tree.add(&title);
+    tree.add(&view);
+    tree.invalidate_all();
+    tree.render();
+    printf("sizeof(ListView) = %u bytes for any item count\n", (unsigned)sizeof(ListView));
+    check(src.calls == 14, "first render fetches only the 14 visible rows");
+
+    // Défilement ligne à ligne: 1 ligne demandée, 1 ligne dessinée, 1 bande invalidée
+    // En remontant, les lignes encore dans le cache ne sont pas redemandées
+    int bad_fetch = 0, bad_draw = 0, bad_damage = 0, bad_px = 0, cached = 0;
+    const unsigned long news0 = news;
+    for (int i = 0; i < 2000; i++) {
+        const bool down = i < 1500;
+        const unsigned long c0 = src.calls;
+        view.reset_stats();
+        tree.reset_stats();
+        view.scroll(down ? 1 : -1);
+        const Rect band = down ? Rect(10, 20 + 13 * 14, 220, 14) : Rect(10, 20, 220, 14);
+        bad_damage += !(tree.get_damage_count() == 1 && tree.get_damage(0) == band);
+        tree.render();
+        bad_fetch += down ? src.calls - c0 != 1 : src.calls - c0 > 1;
+        cached += src.calls == c0;
+        bad_draw += view.get_stats().rows_drawn != 1;
+        bad_px += tree.get_stats().pixels != 220u * 14;
+    }
+    printf("500 scrolls up: %d served from the row cache\n", cached);
+    check(bad_fetch == 0, "scroll by 1 (x2000): 1 source call down, at most 1 up");
+    check(bad_draw == 0, "scroll by 1: 1 row drawn");
+    check(bad_damage == 0, "scroll by 1: only the exposed band damaged");
+    check(bad_px == 0, "scroll by 1: 3080 px redrawn instead of 43120");
+    check(news == news0, "no heap allocation while scrolling");
+    check(same_as_full(tft, tree), "after 1500 down / 500 up: partial == full");
+
+    // Sauts, défilements et sélection aléatoires
+    srand(11);
+    int mismatches = 0;
+    unsigned long calls = 0, shifts = 0;
+    const unsigned steps = 3000;
+    for (unsigned s = 0; s < steps; s++) {
+        const unsigned long c0 = src.calls;
+        view.reset_stats();
+        switch (rand() % 5) {
+            case 0: view.scroll(rand() % 41 - 20); break;
+            case 1: view.scroll_to((uint32_t)rand() % 100100); break;
+            case 2: view.set_selected((int32_t)view.get_first() + rand() % 30 - 8); break;
+            case 3: view.set_selected(rand() % 100000); break;
+            case 4: view.scroll(rand() % 3 - 1); view.scroll(rand() % 3 - 1); break;
+        }
+        tree.render();
+        calls += src.calls - c0;
+        shifts += view.get_stats().shifts;
+        mismatches += !same_as_full(tft, tree);
+    }
+    printf("%u random steps: %lu source calls (%.1f per step), %lu framebuffer shifts\n",
+           steps, calls, (double)calls / steps, shifts);
+    check(mismatches == 0, "random jumps/scrolls/selection: partial == full");
+    view.scroll_to(200000);
+    tree.render();
+    check(view.get_first() == 100000 - 14, "scroll past the end clamps to the last page");
+
+    // Widget superposé: pas de décalage, toute la liste est redessinée
+    static const uint8_t bits[] = {0xFF, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0xFF};
+    Icon badge(Rect(200, 100, 8, 8), bits, COLOR_16BITS_YELLOW);
+    tree.add(&badge);
+    tree.render();
+    view.reset_stats();
+    view.scroll(-1);
+    check(view.get_stats().shifts == 0 && tree.get_damage_count() == 1 && tree.get_damage(0) == Rect(10, 20, 220, 196),
+          "overlapped list: whole list invalidated, no shift");
+    tree.render();
+    check(same_as_full(tft, tree), "overlapped list: partial == full");
+
+    // Liste plus courte que la fenêtre
+    Synth few{5, 0};
+    view.set_source(synth, &few, few.n);
+    tree.render();
+    view.scroll(3);
+    view.set_selected(4);
+    tree.render();
+    check(view.get_first() == 0 && same_as_full(tft, tree), "short list does not scroll");
+    return check_report();
+}
@@ -0,0 +1,112 @@
+/*
+Nom du fichier : test_panels.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Contrôleurs d'écran (PanelTraits.h) sur le bus SPI émulé:
+              flux GC9A01 (init, rotations, trame) identique à celui du
+              pilote d'avant TFTRenderer (data/gc9a01_stream.txt),
+              séquences d'init ST7789 et ILI9341
+              conformes à leurs tables, fenêtres après rotation.
+              Usage: test_panels <data/gc9a01_stream.txt>
+*/
+
+// TFT.cpp n'instancie que le contrôleur monté: les deux autres le sont ici
+#include "TFT.cpp"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <fstream>
+#include <string>
+#include <vector>
+
+template class TFTRenderer<ST7789Panel>;
+template class TFTRenderer<ILI9341Panel>;
+
+using PanelEmulator::events;
+
+// Flux complet: init, quatre rotations, trame entière
+template <class P> static std::vector<std::string> record(TFTBus& bus) {
+    events.clear();
+    TFTRenderer<P> t(&bus, 0);
+    t.init();
+    for (int r = 0; r < 4; r++) t.setRotation((Rotation)r);
+    t.setRotation(Rotation::PORTRAIT_0);
+    t.sendFrame();
+    return events;
+}
+
+// Séquence d'init attendue d'après la table du contrôleur
+template <class P> static std::vector<std::string> init_table() {
+    std::vector<std::string> v;
+    char b[16];
+    for (const PanelCommand& c : P::INIT) {
+        snprintf(b, sizeof b, "C %02X", c.cmd);
+        v.push_back(b);
+        for (int i = 0; i < c.len; i++) {
+            snprintf(b, sizeof b, "D %02X", c.data[i]);
+            v.push_back(b);
+        }
+        if (c.delay_ms) {
+            snprintf(b, sizeof b, "delay %u", (unsigned)c.delay_ms);
+            v.push_back(b);
+        }
+    }
+    return v;
+}
+
+template <class P> static void check_panel(size_t fb_bytes) {
+    TFTBus bus;
+    bus.add_panel(TFTPins{(uint8_t)TFTConfig::PIN_CS, (uint8_t)TFTConfig::PIN_DC, (uint8_t)TFTConfig::PIN_RST});
+    const std::vector<std::string> got = record<P>(bus), want = init_table<P>();
+    // Reset matériel (rst 0, delay, rst 1, delay) puis la table
+    const bool init = got.size() >= 4 + want.size() && std::equal(want.begin(), want.end(), got.begin() + 4);
+    char what[64];
+    snprintf(what, sizeof what, "%s init stream follows its table", P::NAME);
+    check(init, what);
+    TFTRenderer<P> t(&bus, 0);
+    snprintf(what, sizeof what, "  framebuffer %zu bytes", fb_bytes);
+    check(t.getFramebufferSize() == fb_bytes, what);
+}
+
+// Fenêtre reçue par l'écran pour une trame entière après rotation
+template <class P> static bool window(TFTRenderer<P>& t, Rotation r, int x0, int y0, int x1, int y1) {
+    t.setRotation(r);
+    t.sendRegion(0, 0, t.getScreenWidth(), t.getScreenHeight());
+    const PanelEmulator::Panel& p = PanelEmulator::panels[0];
+    if (p.x0 == x0 && p.y0 == y0 && p.x1 == x1 && p.y1 == y1) return true;
+    printf("  %s rotation %d: window %d,%d-%d,%d\n", P::NAME, (int)r * 90, p.x0, p.y0, p.x1, p.y1);
+    return false;
+}
+
+int main(int argc, char** argv) {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC, 320, 320);
+    PanelEmulator::record = true;
+
+    std::vector<std::string> ref;
+    std::ifstream f(argc > 1 ? argv[1] : "");
+    for (std::string l; std::getline(f, l);) ref.push_back(l);
+    const std::vector<std::string> gc = record<GC9A01Panel>(TFTBus::default_bus());
+    size_t i = 0;
+    while (i < gc.size() && i < ref.size() && gc[i] == ref[i]) i++;
+    printf("GC9A01: %zu events, reference %zu\n", gc.size(), ref.size());
+    if (i < gc.size() || i < ref.size())
+        printf("  first difference at %zu: %s / %s\n", i, i < gc.size() ? gc[i].c_str() : "-", i < ref.size() ? ref[i].c_str() : "-");
+    check(!ref.empty() && i == gc.size() && i == ref.size(), "GC9A01 stream identical to the previous driver");
+
+    check_panel<ST7789Panel>(240 * 240 * 2);
+    check_panel<ILI9341Panel>(240 * 320 * 2);
+
+    PanelEmulator::record = false;
+    TFTBus bus;
+    bus.add_panel(TFTPins{(uint8_t)TFTConfig::PIN_CS, (uint8_t)TFTConfig::PIN_DC, (uint8_t)TFTConfig::PIN_RST});
+    TFTRenderer<ST7789Panel> st(&bus, 0);
+    st.init();
+    check(window(st, Rotation::PORTRAIT_0, 0, 0, 239, 239) && window(st, Rotation::LANDSCAPE_90, 0, 0, 239, 239) &&
+          window(st, Rotation::PORTRAIT_180, 0, 80, 239, 319) && window(st, Rotation::LANDSCAPE_270, 80, 0, 319, 239),
+          "ST7789 windows offset by 80 at 180/270");
+    TFTRenderer<ILI9341Panel> il(&bus, 0);
+    il.init();
+    check(window(il, Rotation::PORTRAIT_0, 0, 0, 239, 319) && window(il, Rotation::LANDSCAPE_90, 0, 0, 319, 239) &&
+          window(il, Rotation::PORTRAIT_180, 0, 0, 239, 319) && window(il, Rotation::LANDSCAPE_270, 0, 0, 319, 239),
+          "ILI9341 320x240 in landscape");
+    return check_report();
+}
@@ -0,0 +1,59 @@
+/*
+Nom du fichier : test_region.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : TFT::sendRegion sur l'écran émulé: régions aléatoires aux
+              trois échelles, image entière ou une parité de lignes; l'écran
+              reçoit exactement les lignes demandées, rien d'autre.
+*/
+
+#include "TFT.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <cstdlib>
+#include <vector>
+
+static int rr(int a, int b) { return a + rand() % (b - a + 1); }
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    srand(3);
+    long bad = 0, regions = 0;
+    std::vector<uint16_t>& mem = PanelEmulator::panels[0].mem;
+    for (int k = 0; k < 3000; k++) {
+        const RenderScale sc = (RenderScale)(1 + k % 3);
+        if (tft.getRenderScale() != sc) tft.setRenderScale(sc);
+        const int s = (int)sc, W = 240 / s;
+        uint16_t* fb = tft.getFramebuffer16();
+        for (int i = 0; i < W * W; i++) fb[i] = (uint16_t)rand();
+        PanelEmulator::clear();
+        // Régions débordantes ou vides comprises
+        const int x = rr(0, W + 5), y = rr(0, W + 5), w = rr(0, W), h = rr(0, W);
+        const Field f = (Field)(k / 3 % 3);
+        tft.sendRegion(x, y, w, h, f);
+        regions++;
+        for (int py = 0; py < 240; py++)
+            for (int px = 0; px < 240; px++) {
+                const int fx = px / s, fy = py / s;
+                const bool in = fx >= x && fx < x + w && fy >= y && fy < y + h && fx < W && fy < W &&
+                                (f == Field::BOTH || (fy & 1) == (f == Field::ODD));
+                bad += mem[py * 240 + px] != (in ? fb[fy * W + fx] : 0xDEAD);
+            }
+    }
+    printf("%ld random regions (scales 1/2/3, both/even/odd): %ld wrong pixels\n", regions, bad);
+    check(bad == 0, "panel holds exactly the requested rows");
+
+    // Une trame coûte la moitié des octets de l'image entière
+    tft.setRenderScale(RenderScale::FULL);
+    PanelEmulator::clear();
+    tft.sendRegion(0, 0, 240, 240, Field::BOTH);
+    const unsigned long both = PanelEmulator::panels[0].bytes;
+    PanelEmulator::clear();
+    tft.sendRegion(0, 0, 240, 240, Field::EVEN);
+    const unsigned long even = PanelEmulator::panels[0].bytes;
+    printf("240x240: %lu bytes whole, %lu for one field (%lu CS selects)\n", both, even, PanelEmulator::panels[0].selects);
+    check(even * 2 < both + 120 * 16, "  a field sends half the pixels");
+    return check_report();
+}
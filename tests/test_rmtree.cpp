@@ -0,0 +1,71 @@
+/*
+Nom du fichier : test_rmtree.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : rm -r (FAT32::remove_tree) sur l'animation de tools/mktree.py
+              (/OLDANIM: 161 trames + SUB/), puis compactage d'un répertoire
+              (cleanup_deleted_files). Usage: test_rmtree <image> <écritures max>
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include <cstdlib>
+#include <cstring>
+
+static uint8_t scratch[8192];
+
+static uint32_t fsck_errors(FAT32& fs) {
+    FsckReport r;
+    fs.check_filesystem(r, scratch, sizeof scratch);
+    return r.error_count();
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    const unsigned long max_writes = argc > 2 ? strtoul(argv[2], nullptr, 10) : 20;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+    check(fsck_errors(fs) == 0, "fsck clean before");
+
+    // Suppression depuis l'intérieur de l'arbre: le répertoire courant revient à la racine
+    const uint32_t free0 = fs.count_free_clusters();
+    fs.push_directory("/OLDANIM/SUB");
+    const unsigned long w0 = ImageCard::writes;
+    check(fs.remove_tree("/OLDANIM"), "rm -r /OLDANIM");
+    printf("  %lu sector writes (at most %lu)\n", ImageCard::writes - w0, max_writes);
+    check(ImageCard::writes - w0 <= max_writes, "  FAT updated a sector at a time, not per cluster");
+    check(fs.get_current_dir_cluster() == fs.get_root_dir_cluster(), "  cwd inside the tree reset to the root");
+    fs.pop_directory();
+    const uint32_t freed = fs.count_free_clusters() - free0;
+    printf("  %lu clusters freed\n", (unsigned long)freed);
+    check(freed > 161, "  every frame and SUB freed");
+    check(fs.file_exists("/KEEP.TXT") && !fs.change_directory("/OLDANIM"), "  KEEP.TXT stays, /OLDANIM is gone");
+    check(fsck_errors(fs) == 0, "  fsck clean after");
+    check(!fs.remove_tree("/OLDANIM"), "rm -r on a missing path fails");
+
+    // Compactage: un fichier sur trois effacé, aucune entrée dupliquée ensuite
+    char n[16];
+    for (int i = 0; i < 40; i++) { snprintf(n, sizeof n, "F%03d.TXT", i); fs.file_open(n, CREATE); fs.file_close(); }
+    for (int i = 0; i < 40; i += 3) { snprintf(n, sizeof n, "/F%03d.TXT", i); fs.delete_file(n); }
+    fs.cleanup_deleted_files();
+    std::vector<FileListEntry> l;
+    fs.change_directory("/");
+    fs.list_directory(l);
+    int files = 0, dups = 0;
+    for (auto& e : l) {
+        if (strncmp(e.dosFileName, "F0", 2) == 0) files++;
+        for (auto& f : l) if (&e != &f && e.dosFileName[0] && !strcmp(e.dosFileName, f.dosFileName)) dups++;
+    }
+    check(files == 26 && dups == 0, "cleanup keeps 26 files, no duplicate slot");
+    bool all = true;
+    for (int i = 0; i < 40; i++) {
+        snprintf(n, sizeof n, "/F%03d.TXT", i);
+        all &= fs.file_exists(n) == (i % 3 != 0);
+    }
+    check(all, "  the right files remain");
+    check(fsck_errors(fs) == 0, "  fsck clean");
+    return check_report();
+}
@@ -0,0 +1,85 @@
+/*
+Nom du fichier : test_scale.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Rendu à échelle réduite (TFT::setRenderScale) sur l'écran
+              émulé: trame entière et sendRegion identiques à un
+              agrandissement naïf du framebuffer réduit, avec et sans
+              ColorTransform; réserve du framebuffer préservée.
+*/
+
+#include "TFT.h"
+#include "ColorTransform.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <cstring>
+#include <vector>
+
+static uint32_t rng = 99;
+static uint16_t rnd() {
+    rng = rng * 1103515245u + 12345u;
+    return (uint16_t)(rng >> 12);
+}
+
+// Pixels de l'écran différents de l'agrandissement du framebuffer réduit
+static int mismatches(TFT& t, int s, const ColorTransform* ct) {
+    const uint16_t* fb = t.getFramebuffer16();
+    const int w = t.getScreenWidth(), h = t.getScreenHeight();
+    const std::vector<uint16_t>& mem = PanelEmulator::panels[0].mem;
+    int bad = 0;
+    for (int y = 0; y < h * s; y++)
+        for (int x = 0; x < w * s; x++) {
+            uint16_t v = fb[(y / s) * w + x / s];
+            if (ct) ct->apply_be(&v, &v, 1);
+            bad += mem[y * 240 + x] != v;
+        }
+    return bad;
+}
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT t;
+    t.init();
+    ColorTransform ct;
+    ColorSettings cs;
+    cs.gamma = 2.2f;
+    cs.warmth = 0.5f;
+    ct.set(cs);
+    char what[96];
+    for (int s = 1; s <= 3; s++)
+        for (int use_ct = 0; use_ct < 2; use_ct++) {
+            t.setRenderScale((RenderScale)s);
+            t.setColorTransform(use_ct ? &ct : nullptr);
+            const int w = t.getScreenWidth(), h = t.getScreenHeight();
+            size_t spare = 0;
+            uint8_t* sp = t.getSpareBuffer(spare);
+            if (sp) memset(sp, 0x5A, spare);
+            for (int i = 0; i < w * h; i++) t.setPixel(i % w, i / w, rnd());
+            PanelEmulator::clear();
+            t.sendFrame();
+            printf("scale %d, LUT %d: %dx%d, spare %zu B, %lu data bytes\n", s, use_ct, w, h, spare,
+                   PanelEmulator::panels[0].bytes);
+            snprintf(what, sizeof what, "scale %d LUT %d: frame is the exact upscale", s, use_ct);
+            check(mismatches(t, s, use_ct ? &ct : nullptr) == 0 && PanelEmulator::panels[0].bytes == 240 * 240 * 2 + 8, what);
+
+            // Rectangle redessiné puis envoyé seul
+            const int rx = w / 5, ry = h / 3, rw = w / 4, rh = h / 6;
+            t.fillRect(rx, ry, rw, rh, 0xF81F);
+            t.drawLine(rx, ry, rx + rw - 1, ry + rh - 1, 0x07E0);
+            const std::vector<uint16_t> before = PanelEmulator::panels[0].mem;
+            t.sendRegion(rx, ry, rw, rh);
+            int outside = 0;
+            for (int y = 0; y < 240; y++)
+                for (int x = 0; x < 240; x++)
+                    if ((x < rx * s || x >= (rx + rw) * s || y < ry * s || y >= (ry + rh) * s) &&
+                        PanelEmulator::panels[0].mem[y * 240 + x] != before[y * 240 + x]) outside++;
+            check(mismatches(t, s, use_ct ? &ct : nullptr) == 0 && outside == 0, "  region upscaled, nothing written outside");
+
+            bool intact = true;
+            for (size_t i = 0; i < spare; i++) intact &= sp[i] == 0x5A;
+            t.fill(0x1234);
+            for (size_t i = 0; i < spare; i++) intact &= sp[i] == 0x5A;
+            check(intact && (s == 1 || spare > 0), "  spare area survives drawing and fill()");
+        }
+    return check_report();
+}
@@ -0,0 +1,93 @@
+/*
+Nom du fichier : test_sdcard.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : SDCard.cpp face à une carte simulée au niveau SPI (support/SpiCard):
+              initialisation, écriture différée (l'attente de fin de
+              programmation et le CMD13 ont lieu à la commande suivante),
+              lectures et écritures multi-blocs.
+*/
+
+#include "SDCard.h"
+#include "Check.h"
+#include "SpiCard.h"
+#include <cstring>
+
+using SpiCard::log;
+
+static std::string trace() {
+    std::string s;
+    for (auto& e : log) s += (s.empty() ? "" : " ") + e;
+    return s;
+}
+
+int main() {
+    SDCard sd;
+    check(sd.init() && sd.is_initialized(), "init (CMD0, CMD8, ACMD41, CMD58)");
+
+    // Écriture différée: write_block rend la main avant la fin de la programmation
+    uint8_t blk[512], back[512];
+    for (int i = 0; i < 512; i++) blk[i] = (uint8_t)(i * 7);
+    log.clear();
+    const uint64_t t0 = SpiCard::now_us;
+    check(sd.write_block(100, blk), "write_block");
+    const uint64_t spent = SpiCard::now_us - t0;
+    printf("  write_block returned after %llu us (programming %llu us)\n", (unsigned long long)spent, (unsigned long long)SpiCard::program_us);
+    check(spent < SpiCard::program_us, "  returns before the card has programmed");
+    check(sd.is_busy() == 1, "  card busy afterwards");
+    check(sd.write_block(101, blk) && sd.read_block(100, back), "write, write, read");
+    printf("  %s\n", trace().c_str());
+    check(trace() == "CMD24 DATA CMD13 CMD24 DATA CMD13 CMD17", "  busy wait + CMD13 before the next command");
+    check(memcmp(blk, back, 512) == 0, "  data read back");
+    check(sd.sync() && !sd.is_busy(), "sync");
+    check(SpiCard::violations == 0, "no command sent while busy");
+
+    // Scrutation de la boucle principale: un octet lu, ni commande ni attente;
+    // la fin d'écriture (CMD13) reste à la commande suivante
+    check(sd.write_block(102, blk), "write_block before polling");
+    log.clear();
+    const uint64_t t = SpiCard::now_us;
+    const bool busy = sd.is_busy();
+    const uint64_t poll_us = SpiCard::now_us - t;
+    check(busy && poll_us < SpiCard::program_us / 4 && log.empty(), "  is_busy while programming: no wait, no command");
+    sleep_us(SpiCard::program_us);
+    check(!sd.is_busy() && log.empty(), "  is_busy once programmed: 0, still no command");
+    check(sd.read_block(102, back) && memcmp(blk, back, 512) == 0, "  next command reads the block back");
+    printf("  %s (polled in %llu us)\n", trace().c_str(), (unsigned long long)poll_us);
+    check(trace() == "CMD13 CMD17", "  CMD13 still sent before the next command");
+    check(sd.sync() && SpiCard::violations == 0, "  no violation");
+
+    // Multi-blocs
+    static uint8_t big[4 * 512];
+    check(sd.read_blocks(10, 4, big) && big[0] == 10 && big[512] == 11 && big[3 * 512 + 511] == 13, "read_blocks: CMD18 + CMD12");
+    log.clear();
+    bool ok = sd.write_start(50, 3);
+    for (int b = 0; b < 3; b++) { memset(blk, 0x50 + b, 512); ok = ok && sd.write_data(blk); }
+    ok = ok && sd.write_stop() && sd.read_block(51, back);
+    printf("  %s\n", trace().c_str());
+    check(ok && back[0] == 0x51 && SpiCard::block(52)[511] == 0x52, "write_start/write_data/write_stop");
+    check(trace() == "CMD55 CMD23 CMD25 DATA DATA DATA STOP_TRAN CMD13 CMD17", "  ACMD23, stop token, CMD13 deferred to the next command");
+    check(sd.sync() && SpiCard::violations == 0, "  no violation");
+
+    // Bloc refusé pendant un CMD25: jeton Stop Tran, la commande suivante est comprise
+    SpiCard::reject_block = 1;
+    log.clear();
+    ok = sd.write_start(60, 3) && sd.write_data(blk);
+    check(ok && !sd.write_data(blk), "rejected block reported by write_data");
+    check(sd.write_block(70, blk) && sd.sync() && SpiCard::block(70)[0] == blk[0], "next write understood");
+    printf("  %s\n", trace().c_str());
+    check(trace().find("REJECT STOP_TRAN") != std::string::npos && SpiCard::violations == 0, "  stop token closes the CMD25");
+
+    // Boucle de rendu de 2 ms entre deux écritures: la programmation se fait pendant le rendu
+    const uint64_t s = SpiCard::now_us;
+    for (int i = 0; i < 100; i++) {
+        sd.write_block(200 + i, blk);
+        sleep_us(2000);
+    }
+    sd.sync();
+    const uint64_t total = SpiCard::now_us - s;
+    printf("100 x (write_block + 2 ms render): %llu us\n", (unsigned long long)total);
+    check(total < 100 * (2000 + SpiCard::program_us), "programming overlaps the render");
+    check(SpiCard::violations == 0, "no command sent while busy");
+    return check_report();
+}
@@ -0,0 +1,174 @@
+/*
+Nom du fichier : test_timeseries.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Historique des mesures (TimeSeries) sur l'image de
+              tools/mkfat.py: flux synthétiques (2 s sur 3 jours, 60 s sur
+              40 jours, trou de 6 h, réouverture régulière) comparés aux
+              agrégats exacts calculés ici, coût d'une courbe sur 24 h, et
+              courbe demandée moins de 23 h après le démarrage.
+*/
+
+#include "SDCard.h"
+#include "FAT32.h"
+#include "TimeSeries.h"
+#include "Check.h"
+#include "ImageCard.h"
+#include "HostClock.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+// Agrégat exact d'une période
+struct Truth {
+    uint32_t n = 0;
+    int64_t t_sum = 0, h_sum = 0;
+    int t_min = 99999, t_max = -99999, h_min = 99999, h_max = -1;
+};
+
+static std::map<uint32_t, Truth> minutes, hours;
+
+static const uint32_t RAW_CAPACITY = TS_Config::RAW_SECTORS * (512 / sizeof(TSSample));
+static const uint32_t MINUTE_CAPACITY = TS_Config::MINUTE_SECTORS * (512 / 16);
+static const uint32_t HOUR_CAPACITY = TS_Config::HOUR_SECTORS * (512 / 16);
+
+static void feed(uint32_t t, int16_t T, uint16_t H) {
+    for (auto* m : {&minutes, &hours}) {
+        Truth& x = (*m)[m == &minutes ? t / 60 * 60 : t / 3600 * 3600];
+        x.n++;
+        x.t_sum += T;
+        x.h_sum += H;
+        x.t_min = std::min<int>(x.t_min, T);
+        x.t_max = std::max<int>(x.t_max, T);
+        x.h_min = std::min<int>(x.h_min, H);
+        x.h_max = std::max<int>(x.h_max, H);
+    }
+}
+
+static uint32_t rng = 7;
+static int rnd(int n) {
+    rng = rng * 1103515245u + 12345u;
+    return (rng >> 8) % n;
+}
+
+// Température en dixièmes, sous zéro une heure par jour
+static int16_t T_at(uint32_t t) {
+    return (int16_t)(215 + 60 * sin(t / 43200.0 * M_PI) + rnd(7) - 3 - (t % 86400 < 3600 ? 250 : 0));
+}
+static uint16_t H_at(uint32_t t) { return (uint16_t)(450 + 150 * cos(t / 30000.0) + rnd(11)); }
+
+// Agrégats relus contre la vérité; tol: écart de moyenne toléré en plus de l'arrondi
+static int compare(TimeSeries& ts, TS_Tier tier, std::map<uint32_t, Truth>& truth, double tol, int& rows_checked) {
+    static TSAggregate rows[2000];
+    const uint16_t n = ts.query(tier, 0, rows, 2000);
+    int bad = 0;
+    rows_checked = n;
+    for (uint16_t i = 0; i < n; i++) {
+        const TSAggregate& a = rows[i];
+        if (i && a.start <= rows[i - 1].start) bad++;
+        auto it = truth.find(a.start);
+        if (it == truth.end()) {
+            bad++;
+            continue;
+        }
+        const Truth& x = it->second;
+        const double tm = (double)x.t_sum / x.n, hm = (double)x.h_sum / x.n / 5.0;
+        if (a.count != x.n || a.t_min != x.t_min || a.t_max != x.t_max ||
+            a.h_min != (x.h_min + 2) / 5 || a.h_max != (x.h_max + 2) / 5 ||
+            fabs(a.t_mean - tm) > 0.5 + tol || fabs(a.h_mean - hm) > 0.5 + tol) {
+            if (bad < 3) printf("  start %u: count %u/%u, T %d/%d/%d vs %d/%.2f/%d\n", a.start, a.count, x.n,
+                                a.t_min, a.t_mean, a.t_max, x.t_min, tm, x.t_max);
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static void run(FAT32& fs, const char* path, const char* name, uint32_t period, uint32_t duration,
+                uint32_t reopen_every, uint32_t gap_at, uint32_t gap_len) {
+    minutes.clear();
+    hours.clear();
+    printf("%s\n", name);
+    TimeSeries* ts = new TimeSeries();
+    check(ts->open(&fs, path), "  open");
+    uint32_t accepted = 0, last = 0;
+    bool ingested = true;
+    for (uint32_t t = 1000; t < 1000 + duration && ingested; t += period) {
+        if (gap_len && t >= gap_at && t < gap_at + gap_len) continue;
+        const int16_t T = T_at(t);
+        const uint16_t H = H_at(t);
+        ingested = ts->ingest_at(t, T, H);
+        feed(t, T, H);
+        accepted++;
+        last = t;
+        if (reopen_every && accepted % reopen_every == 0) {
+            fs.flush();
+            delete ts;
+            ts = new TimeSeries();
+            ingested = ts->open(&fs, path);
+        }
+    }
+    check(ingested, "  every sample stored");
+    check(!ts->ingest_at(last, 200, 500) && !ts->ingest_at(last - 5, 200, 500) && ts->get_stats().rejected >= 2,
+          "  non-increasing timestamps rejected");
+
+    // Minute: moyenne arrondie exacte; heure: à un dixième près après une reprise
+    int rows = 0;
+    check(compare(*ts, TS_MINUTE, minutes, 0, rows) == 0 && rows > 0, "  minute aggregates match");
+    if (minutes.size() > MINUTE_CAPACITY) check(rows == (int)MINUTE_CAPACITY, "    ring wrapped, full");
+    check(compare(*ts, TS_HOUR, hours, reopen_every ? 1 : 0, rows) == 0 && rows > 0, "  hour aggregates match");
+    if (hours.size() > HOUR_CAPACITY) check(rows == (int)HOUR_CAPACITY, "    ring wrapped, full");
+
+    // Palier brut: les plus récentes, dans l'ordre
+    static TSSample raw[3000];
+    const uint16_t nr = ts->query_raw(0, raw, 3000);
+    bool raw_ok = nr == std::min(accepted, RAW_CAPACITY) && raw[nr - 1].time == last;
+    for (uint16_t i = 1; i < nr; i++) raw_ok &= raw[i].time > raw[i - 1].time;
+    check(raw_ok, "  raw tier keeps the newest samples in order");
+
+    // Courbe 24 h après remontage (cache froid): palier horaire seulement
+    fs.flush();
+    delete ts;
+    ts = new TimeSeries();
+    ts->open(&fs, path);
+    ts->reset_stats();
+    static TSAggregate day[24];
+    const uint16_t nd = ts->query(TS_HOUR, (last / 3600 - 23) * 3600, day, 24);
+    printf("  24 h chart: %u rows, %u sector reads\n", nd, ts->get_stats().sector_reads);
+    check(nd >= 23 && ts->get_stats().sector_reads <= 2, "  24 h chart reads the hour tier only");
+    delete ts;
+}
+
+// Courbe 24 h demandée 5 h 30 après le démarrage: l'horloge part de 1 s,
+// la fenêtre commence à 0 et garde les heures closes
+static void early_chart(FAT32& fs) {
+    printf("chart 5.5 h after start\n");
+    TimeSeries ts;
+    check(ts.open(&fs, "/EARLY.TS") && ts.now() < 60, "  fresh file, clock near 1 s");
+    const uint32_t end = 5 * 3600 + 1800;
+    bool ingested = true;
+    for (uint32_t t = 10; t <= end; t += 10) ingested &= ts.ingest_at(t, 200, 500);
+    HostClock::advance_ms(end * 1000u);
+    const uint32_t first = ts.window_start(24);
+    static TSAggregate rows[24];
+    uint16_t got = ts.query(TS_HOUR, first, rows, 23);
+    const uint16_t closed = got;
+    if (ts.current(TS_HOUR, rows[got])) got++;
+    printf("  now %u s, window from %u s: %u closed hour(s) + current\n", (unsigned)ts.now(), (unsigned)first, closed);
+    check(ingested && first == 0, "  window start clamped to 0");
+    check(closed == 5 && rows[0].start == 0 && got == 6 && rows[5].start == 5 * 3600, "  every closed hour and the current one");
+    check(ts.window_start(1) == 5 * 3600 && ts.window_start(6) == 0 && ts.window_start(5) == 3600, "  shorter windows");
+}
+
+int main(int argc, char** argv) {
+    if (!ImageCard::open(argc > 1 ? argv[1] : nullptr)) return 2;
+    SDCard sd;
+    FAT32 fs(&sd);
+    check(fs.init(), "mount");
+    run(fs, "/S2.TS", "2 s, 3 days", 2, 3 * 86400, 0, 0, 0);
+    run(fs, "/S60.TS", "60 s, 40 days (hour ring wraps)", 60, 40 * 86400, 0, 0, 0);
+    run(fs, "/GAP.TS", "10 s, 2 days, 6 h gap", 10, 2 * 86400, 0, 40000, 6 * 3600);
+    run(fs, "/REOPEN.TS", "7 s, 2 days, reopened every 997 samples", 7, 2 * 86400, 997, 0, 0);
+    early_chart(fs);
+    return check_report();
+}
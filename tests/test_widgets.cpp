@@ -0,0 +1,157 @@
+/*
+Nom du fichier : test_widgets.cpp
+Auteur : Guillaume Sahuc
+Date : 19 octobre 2026
+Description : Arbre de widgets (Widget.h) sur l'écran émulé: zones
+              invalidées par chaque changement de propriété, débordement
+              de la liste des zones, et rendu partiel identique au rendu
+              complet sur une suite aléatoire de changements.
+*/
+
+#include "TFT.h"
+#include "Widget.h"
+#include "Check.h"
+#include "PanelEmulator.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::string str(const Rect& r) {
+    char b[48];
+    snprintf(b, sizeof b, "(%d,%d %dx%d)", r.x, r.y, r.w, r.h);
+    return b;
+}
+
+// Zones invalidées = want (dans n'importe quel ordre)
+static void expect(WidgetTree& t, const char* what, std::vector<Rect> want) {
+    std::vector<Rect> got;
+    for (int i = 0; i < t.get_damage_count(); i++) got.push_back(t.get_damage(i));
+    bool ok = got.size() == want.size();
+    for (auto& w : want) {
+        bool found = false;
+        for (auto& g : got) found |= g == w;
+        ok &= found;
+    }
+    check(ok, what);
+    if (!ok) {
+        std::string g, e;
+        for (auto& r : got) g += str(r) + " ";
+        for (auto& r : want) e += str(r) + " ";
+        printf("  got %s\n  expected %s\n", g.empty() ? "(none)" : g.c_str(), e.empty() ? "(none)" : e.c_str());
+    }
+}
+
+static const char* items[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta", "iota", "kappa", "lambda", "mu"};
+static const uint8_t icon_bits[] = {0x18, 0x3C, 0x7E, 0xFF, 0xFF, 0x7E, 0x3C, 0x18};
+
+int main() {
+    PanelEmulator::attach(TFTConfig::PIN_CS, TFTConfig::PIN_DC);
+    TFT tft;
+    tft.init();
+    WidgetTree tree(&tft, COLOR_16BITS_NAVY);
+    Label label(Rect(20, 20, 200, 12), "hello", COLOR_16BITS_WHITE, FontType::FONT_STANDARD, Label::CENTER);
+    Gauge gauge(Rect(20, 40, 102, 10), 0, 100);
+    Icon icon(Rect(200, 40, 8, 8), icon_bits, COLOR_16BITS_YELLOW);
+    ListWidget list(Rect(20, 60, 150, 70), items, 12, 14);     // 5 lignes visibles
+    tree.add(&label);
+    tree.add(&gauge);
+    tree.add(&icon);
+    tree.add(&list);
+    expect(tree, "add 4 widgets", {Rect(20, 20, 200, 12), Rect(20, 40, 102, 10), Rect(200, 40, 8, 8), Rect(20, 60, 150, 70)});
+    tree.render();
+    expect(tree, "after render", {});
+    gauge.set_value(50);
+    expect(tree, "gauge 0 -> 50", {Rect(21, 41, 50, 8)});
+    tree.render();
+    gauge.set_value(50);
+    expect(tree, "gauge 50 -> 50", {});
+    gauge.set_value(37);
+    expect(tree, "gauge 50 -> 37", {Rect(58, 41, 13, 8)});
+    tree.render();
+    gauge.set_value(200);
+    expect(tree, "gauge 37 -> 200 (clamped)", {Rect(58, 41, 63, 8)});
+    tree.render();
+    gauge.set_value(101);
+    expect(tree, "gauge 200 -> 101 (same pixels)", {});
+    label.set_text("hello");
+    expect(tree, "label, same text", {});
+    label.set_text("world");
+    expect(tree, "label, new text", {Rect(20, 20, 200, 12)});
+    tree.render();
+    list.set_selected(2);
+    expect(tree, "list -1 -> 2", {Rect(20, 88, 150, 14)});
+    tree.render();
+    list.set_selected(3);
+    expect(tree, "list 2 -> 3 (adjacent rows merged)", {Rect(20, 88, 150, 28)});
+    tree.render();
+    list.set_selected(0);
+    expect(tree, "list 3 -> 0", {Rect(20, 60, 150, 14), Rect(20, 102, 150, 14)});
+    tree.render();
+    list.set_selected(9);
+    expect(tree, "list 0 -> 9 (scrolls)", {Rect(20, 60, 150, 70)});
+    tree.render();
+    icon.set_visible(false);
+    expect(tree, "icon hidden", {Rect(200, 40, 8, 8)});
+    tree.render();
+    icon.set_color(COLOR_16BITS_RED);
+    expect(tree, "hidden icon recolored", {});
+    icon.set_visible(true);
+    icon.set_bounds(Rect(210, 200, 8, 8));
+    expect(tree, "icon shown and moved", {Rect(200, 40, 8, 8), Rect(210, 200, 8, 8)});
+    tree.render();
+    icon.set_bounds(Rect(236, 236, 8, 8));
+    expect(tree, "icon partly off screen", {Rect(210, 200, 8, 8), Rect(236, 236, 4, 4)});
+    tree.render();
+    gauge.set_value(10);
+    label.set_text("x");
+    expect(tree, "gauge and label", {Rect(31, 41, 90, 8), Rect(20, 20, 200, 12)});
+    tree.render();
+
+    // 12 zones disjointes: au plus MAX_DAMAGE rectangles, tout couvert
+    std::vector<Rect> many;
+    for (int i = 0; i < 12; i++) many.push_back(Rect(i * 20, (i % 3) * 80, 5, 5));
+    for (auto& r : many) tree.invalidate(r);
+    bool covered = true;
+    for (auto& r : many) {
+        bool c = false;
+        for (int i = 0; i < tree.get_damage_count(); i++) c |= tree.get_damage(i).contains(r);
+        covered &= c;
+    }
+    printf("12 disjoint invalidations -> %u rectangles\n", tree.get_damage_count());
+    check(tree.get_damage_count() <= Widget_Config::MAX_DAMAGE && covered, "  at most MAX_DAMAGE, all covered");
+    tree.render();
+
+    // Suite aléatoire: rendu partiel == rendu complet, écran == framebuffer
+    srand(7);
+    int partial_vs_full = 0;
+    long panel_vs_fb = 0;
+    unsigned long pixels = 0;
+    static uint16_t ref[240 * 240];
+    tree.invalidate_all();
+    tree.render();
+    const char* texts[] = {"a", "bb", "ccc", "hello", "world"};
+    for (int step = 0; step < 300; step++) {
+        tree.reset_stats();
+        label.set_text(texts[rand() % 5]);
+        gauge.set_value(rand() % 120);
+        list.set_selected(rand() % 13 - 1);
+        icon.set_visible(rand() % 4 != 0);
+        icon.set_bounds(Rect(150 + rand() % 80, 150 + rand() % 80, 8, 8));
+        icon.set_color((uint16_t)(rand() & 0xFFFF));
+        tree.render();
+        pixels += tree.get_stats().pixels;
+        memcpy(ref, tft.getFramebuffer(), sizeof ref);
+        for (int i = 0; i < 240 * 240; i++) panel_vs_fb += PanelEmulator::panels[0].mem[i] != ref[i];
+        tree.invalidate_all();
+        tree.render(false);
+        partial_vs_full += memcmp(ref, tft.getFramebuffer(), sizeof ref) != 0;
+    }
+    printf("300 random steps: %lu px per frame on average (full screen 57600)\n", pixels / 300);
+    check(partial_vs_full == 0, "partial redraw == full redraw");
+    check(panel_vs_fb == 0, "  panel == framebuffer");
+    tree.reset_stats();
+    for (int i = 0; i < 100; i++) tree.render();
+    check(tree.get_stats().pixels == 0 && tree.get_stats().draws == 0, "unchanged tree draws nothing");
+    return check_report();
+}
@@ -0,0 +1,95 @@
+# Image exFAT (8 secteurs par cluster par défaut):
+#   /Hello World Long Name.txt  5000 o fragmentés (clusters 6 et 8), octet i = i*3
+#   /Anims/FR_001.RAW           contigu (NoFatChain), 8000 o, octet i = i*7
+# SHIFT=16 BIG=1: clusters de 65536 secteurs et FR_001.RAW d'un cluster + 8
+# secteurs, chaque secteur commençant par son numéro (uint32). Fichier creux.
+# FRAMES=n: /Play/FR_000.RAW.. trames 240x240 (en-tête largeur, hauteur puis
+# pixel c = x*7 + y*13 + k*101 gros-boutien); paires contiguës (NoFatChain),
+# impaires en deux morceaux chaînés par la FAT. NCL >= 12 + 30 * n.
+import os, struct, sys
+SEC = 512; SHIFT = int(os.environ.get('SHIFT', '3')); SPC = 1 << SHIFT; CB = SEC * SPC
+FATOFF = 24; FATLEN = 8; HEAP = 64; NCL = int(os.environ.get('NCL', '100')); ROOT = 4
+BIG = os.environ.get('BIG', '0') == '1'
+FRAMES = int(os.environ.get('FRAMES', '0'))
+TOT = HEAP + NCL * SPC
+f = open(sys.argv[1], 'wb'); f.truncate(TOT * SEC)
+def w(off, data): f.seek(off); f.write(data)
+def cl(c): return (HEAP + (c - 2) * SPC) * SEC
+
+bs = bytearray(512); bs[0:3] = b'\xEB\x76\x90'; bs[3:11] = b'EXFAT   '
+struct.pack_into('<QQIIIIIIHHBBBBB', bs, 0x40, 0, TOT, FATOFF, FATLEN, HEAP, NCL, ROOT, 0x1234, 0x100, 0, 9, SHIFT, 1, 0x80, 0)
+bs[510:512] = b'\x55\xAA'; w(0, bs)
+fat = {0: 0xFFFFFFF8, 1: 0xFFFFFFFF, 2: 0xFFFFFFFF, 3: 0xFFFFFFFF, 4: 0xFFFFFFFF, 6: 8, 8: 0xFFFFFFFF}
+# Bitmap d'allocation (cluster 2), table de majuscules (3), racine (4)
+used = [2, 3, 4, 5, 6, 8, 9, 10]
+FRAME_BYTES = 4 + 240 * 240 * 2
+frames = []     # (nom, premier cluster, NoFatChain, clusters)
+if FRAMES:
+    fat[11] = 0xFFFFFFFF; used.append(11)   # répertoire /Play
+    nxt = 12; n = -(-FRAME_BYTES // CB)
+    for k in range(FRAMES):
+        chain = list(range(nxt, nxt + n)) if k % 2 == 0 else \
+                list(range(nxt, nxt + n // 2)) + list(range(nxt + n // 2 + 1, nxt + n + 1))
+        if k % 2:
+            for a, b in zip(chain, chain[1:] + [0xFFFFFFFF]): fat[a] = b
+        frames.append(('FR_%03d.RAW' % k, chain[0], k % 2 == 0, chain))
+        used += chain; nxt = chain[-1] + 1
+fb = bytearray(FATLEN * SEC)
+for k, v in fat.items(): struct.pack_into('<I', fb, 4 * k, v)
+w(FATOFF * SEC, fb)
+BMLEN = (NCL + 7) // 8
+bm = bytearray(BMLEN)
+for c in used: bm[(c - 2) // 8] |= 1 << ((c - 2) % 8)
+w(cl(2), bm)
+up = b''.join(struct.pack('<H', (i - 32) if 0x61 <= i <= 0x7a else i) for i in range(128)) + struct.pack('<HH', 0xFFFF, 65536 - 128 - 1)
+csum = 0
+for b in up: csum = (((0x80000000 if csum & 1 else 0) + (csum >> 1) + b) & 0xFFFFFFFF)
+w(cl(3), up)
+
+def name_hash(n):
+    h = 0
+    for ch in n.upper():
+        c = ord(ch)
+        for b in (c & 0xFF, c >> 8): h = (((0x8000 if h & 1 else 0) + (h >> 1) + b) & 0xFFFF)
+    return h
+
+def fileset(name, attr, clus, length, nofat):
+    n = (len(name) + 14) // 15
+    e = bytearray(32 * (2 + n)); e[0] = 0x85; e[1] = 1 + n; struct.pack_into('<H', e, 4, attr); struct.pack_into('<I', e, 12, (0x5A21 << 16) | 0x6000)
+    s = e[32:64]; s[0] = 0xC0; s[1] = 1 | (2 if nofat else 0); s[3] = len(name); struct.pack_into('<H', s, 4, name_hash(name))
+    struct.pack_into('<IQ', s, 0x14, clus, length); struct.pack_into('<Q', s, 8, length); e[32:64] = s
+    for i in range(n):
+        x = bytearray(32); x[0] = 0xC1
+        for j, ch in enumerate(name[i * 15:(i + 1) * 15]): struct.pack_into('<H', x, 2 + 2 * j, ord(ch))
+        e[64 + 32 * i:96 + 32 * i] = x
+    return bytes(e)
+
+root = bytearray()
+b = bytearray(32); b[0] = 0x81; struct.pack_into('<IQ', b, 0x14, 2, BMLEN); root += b
+u = bytearray(32); u[0] = 0x82; struct.pack_into('<I', u, 4, csum); struct.pack_into('<IQ', u, 0x14, 3, len(up)); root += u
+l = bytearray(32); l[0] = 0x83; l[1] = 4; l[2:10] = 'PICO'.encode('utf-16-le'); root += l
+root += fileset('Anims', 0x10, 5, CB, True)
+root += fileset('Hello World Long Name.txt', 0x20, 6, 5000, False)
+if FRAMES: root += fileset('Play', 0x10, 11, CB, True)
+w(cl(4), root)
+if FRAMES:
+    w(cl(11), b''.join(fileset(name, 0x20, first, FRAME_BYTES, nofat) for name, first, nofat, _ in frames))
+    for k, (_, _, _, chain) in enumerate(frames):
+        px = bytearray(240 * 240 * 2)
+        for y in range(240):
+            for x in range(240):
+                c = (x * 7 + y * 13 + k * 101) & 0xFFFF
+                px[(y * 240 + x) * 2] = c >> 8; px[(y * 240 + x) * 2 + 1] = c & 0xFF
+        data = struct.pack('<HH', 240, 240) + bytes(px)
+        for i, c in enumerate(chain): w(cl(c), data[i * CB:(i + 1) * CB])
+if BIG:
+    n = SPC + 8
+    w(cl(5), fileset('FR_001.RAW', 0x20, 9, n * SEC, True))
+    for k in range(n): w(cl(9) + k * SEC, struct.pack('<I', k))
+else:
+    w(cl(5), fileset('FR_001.RAW', 0x20, 9, 8000, True))
+    w(cl(9), bytes((i * 7) & 0xFF for i in range(8000)))
+t = bytes((i * 3) & 0xFF for i in range(5000))
+w(cl(6), t[:CB])
+if CB < 5000: w(cl(8), t[CB:])
+f.close()
@@ -0,0 +1,44 @@
+# Petite image FAT32 superfloppy: 512 o/secteur, 1 secteur/cluster, 2 FAT
+#   /A.TXT (1200 o de 'a'), /ANIMS/FR_001.RAW (1000 o), étiquette PICO_SD
+# SPF: secteurs par FAT (64 par défaut, 8190 clusters)
+# MODE=corrupt: chaîne croisée, cluster perdu, taille incohérente,
+#               FAT2 différente de FAT1, chaîne interrompue
+import os, struct, sys
+SEC = 512; RES = 32; NFAT = 2; SPF = int(os.environ.get('SPF', '64')); SPC = 1
+MODE = os.environ.get('MODE', 'clean')
+NCL = SPF * 128 - 2
+TOT = RES + NFAT * SPF + NCL * SPC
+img = bytearray(TOT * SEC)
+bs = bytearray(512); bs[0:3] = b'\xEB\x58\x90'; bs[3:11] = b'MSWIN4.1'
+struct.pack_into('<HBHBHHBHHHII', bs, 11, SEC, SPC, RES, NFAT, 0, 0, 0xF8, 0, 32, 64, 0, TOT)
+struct.pack_into('<IHHIHH', bs, 36, SPF, 0, 0, 2, 1, 6)
+bs[82:90] = b'FAT32   '; bs[510:512] = b'\x55\xAA'; img[0:512] = bs
+FATB = RES * SEC; DATA = (RES + NFAT * SPF) * SEC
+fat = {0: 0x0FFFFFF8, 1: 0x0FFFFFFF, 2: 0x0FFFFFFF}
+def cl(c): return DATA + (c - 2) * SPC * SEC
+def ent(name, ext, attr, clus, size):
+    e = bytearray(32); e[0:8] = name.ljust(8).encode(); e[8:11] = ext.ljust(3).encode(); e[11] = attr
+    struct.pack_into('<H', e, 20, clus >> 16); struct.pack_into('<H', e, 26, clus & 0xFFFF); struct.pack_into('<I', e, 28, size); return e
+nextc = [3]
+def alloc(n):
+    s = nextc[0]
+    for i in range(n): fat[s + i] = s + i + 1 if i < n - 1 else 0x0FFFFFFF
+    nextc[0] += n; return s
+root = bytearray()
+root += ent('PICO_SD', '', 0x08, 0, 0)
+a = alloc(3); root += ent('A', 'TXT', 0x20, a, 1200)
+img[cl(a):cl(a) + 1200] = b'a' * 1200
+sub = alloc(1); root += ent('ANIMS', '', 0x10, sub, 0)
+b = alloc(2); d = bytearray(); d += ent('.', '', 0x10, sub, 0); d += ent('..', '', 0x10, 0, 0); d += ent('FR_001', 'RAW', 0x20, b, 1000)
+img[cl(sub):cl(sub) + len(d)] = d
+if MODE == 'corrupt':
+    fat[b + 1] = a + 1                                  # FR_001 croise A.TXT
+    fat[500] = 0x0FFFFFFF                               # cluster perdu (absent de FAT2)
+    struct.pack_into('<I', root, 32 + 28, 5000)         # taille incohérente de A.TXT
+    c = alloc(2); fat[c + 1] = 0                        # B.TXT: chaîne vers un cluster libre
+    root += ent('B', 'TXT', 0x20, c, 1024)
+img[cl(2):cl(2) + len(root)] = root
+for k, v in fat.items():
+    struct.pack_into('<I', img, FATB + 4 * k, v)
+    if not (MODE == 'corrupt' and k == 500): struct.pack_into('<I', img, FATB + SPF * SEC + 4 * k, v)
+open(sys.argv[1], 'wb').write(img)
@@ -0,0 +1,29 @@
+# Trames RGB565 des tests hôte de l'affichage entrelacé (en-tête: largeur,
+# hauteur sur 16 bits petit-boutiens, puis pixels ligne par ligne)
+#   R240_i.RAW: 240x240, R200_i.RAW: 200x199, rangement par lignes
+#   G240_i.GZ:  240x240 rangées par trame (bit 15 de la hauteur), gzip fenêtre 8 Ko
+import os, random, struct, sys, zlib
+out = sys.argv[1]
+os.makedirs(out, exist_ok=True)
+N = 8
+rnd = random.Random(5)
+def frame(w, h, seed):
+    px = bytearray()
+    for y in range(h):
+        for x in range(w):
+            c = ((x * 7 + y * 13 + seed * 101) ^ rnd.getrandbits(2)) & 0xFFFF
+            px += bytes((c >> 8, c & 0xFF))
+    return struct.pack('<HH', w, h) + bytes(px)
+def fields(f):
+    w, h = struct.unpack_from('<HH', f)
+    rows = [f[4 + y * w * 2:4 + (y + 1) * w * 2] for y in range(h)]
+    return struct.pack('<HH', w, h | 0x8000) + b''.join(rows[0::2] + rows[1::2])
+def put(name, data):
+    with open(os.path.join(out, name), 'wb') as f: f.write(data)
+for i in range(N):
+    put('R240_%d.RAW' % i, frame(240, 240, i))
+    put('R200_%d.RAW' % i, frame(200, 199, i + 10))
+    g = frame(240, 240, i + 20)
+    put('G240_%d.RAW' % i, g)
+    c = zlib.compressobj(9, zlib.DEFLATED, 16 + 13)
+    put('G240_%d.GZ' % i, c.compress(fields(g)) + c.flush())
@@ -0,0 +1,53 @@
+# Corpus gzip des tests hôte: pour chaque contenu, niveaux, stratégies et
+# fenêtres (512 o, 8 Ko) -> P_L_S_W.GZ et P_L_S_W.RAW (données attendues)
+#   HDR.GZ: en-tête avec FEXTRA, FNAME, FCOMMENT et FHCRC
+#   E32.GZ: distances > 8 Ko (fenêtre gzip de 32 Ko), refusé par le lecteur
+#   EARTH.BMP / EARTH.BMP.GZ: BMP 24 bits 240x240 et sa version compressée
+import os, random, struct, sys, zlib
+out = sys.argv[1]
+os.makedirs(out, exist_ok=True)
+rnd = random.Random(1)
+def put(name, data):
+    with open(os.path.join(out, name), 'wb') as f: f.write(data)
+
+text = b''.join(b'Capteur %d: %.1f C, humidite %d %%\n' % (i % 7, 20 + (i * 37 % 90) / 10, 40 + i % 30) for i in range(700))
+noise = bytes(rnd.getrandbits(8) for _ in range(6000))
+zeros = bytes(20000)
+frame = b''.join(struct.pack('>H', ((x >> 3) << 11) | ((y >> 2) << 5) | ((x + y) >> 4 & 31)) for y in range(80) for x in range(120))
+mixed = text[:3000] + noise[:2000] + zeros[:3000] + frame[:9000] + text[-500:]
+one = b'x'
+payloads = [text, noise, zeros, frame, mixed, one]
+strategies = [zlib.Z_DEFAULT_STRATEGY, zlib.Z_FILTERED, zlib.Z_HUFFMAN_ONLY, zlib.Z_RLE, zlib.Z_FIXED]
+for p, data in enumerate(payloads):
+    for level in (0, 1, 6, 9):
+        for s, strategy in enumerate(strategies):
+            if level == 0 and s: continue
+            for wbits in (9, 13):
+                c = zlib.compressobj(level, zlib.DEFLATED, 16 + wbits, 9, strategy)
+                name = '%d_%d_%d_%d' % (p, level, s, wbits)
+                put(name + '.GZ', c.compress(data) + c.flush())
+                put(name + '.RAW', data)
+
+# En-tête complet: FTEXT | FHCRC | FEXTRA | FNAME | FCOMMENT
+c = zlib.compressobj(9, zlib.DEFLATED, -13)
+body = c.compress(text) + c.flush()
+hdr = bytearray(b'\x1f\x8b\x08\x1f') + struct.pack('<I', 0) + b'\x02\x03'
+hdr += struct.pack('<H', 6) + b'AB\x02\x00xy' + b'capteurs.txt\x00' + b'releve du jour\x00'
+hdr += struct.pack('<H', zlib.crc32(hdr) & 0xFFFF)
+put('HDR.GZ', bytes(hdr) + body + struct.pack('<II', zlib.crc32(text), len(text)))
+put('HDR.RAW', text)
+
+far = bytes(rnd.getrandbits(8) for _ in range(20000))
+c = zlib.compressobj(9, zlib.DEFLATED, 16 + 15)
+put('E32.GZ', c.compress(far + far) + c.flush())
+
+W = H = 240
+row = W * 3
+px = bytearray()
+for y in range(H - 1, -1, -1):
+    for x in range(W):
+        px += bytes((x & 0xF8, y & 0xFC, 0x80 if (x // 40 + y // 40) & 1 else 0x20))
+bmp = b'BM' + struct.pack('<IHHI', 54 + len(px), 0, 0, 54) + struct.pack('<IiiHHIIiiII', 40, W, H, 1, 24, 0, len(px), 2835, 2835, 0, 0) + bytes(px)
+put('EARTH.BMP', bmp)
+c = zlib.compressobj(9, zlib.DEFLATED, 16 + 13)
+put('EARTH.BMP.GZ', c.compress(bmp) + c.flush())
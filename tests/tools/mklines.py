@@ -0,0 +1,39 @@
+# Fichiers texte des tests hôte de LineReader, chacun aussi en .GZ (fenêtre 8 Ko)
+#   LOG.TXT   journal CRLF de 30000 lignes (~1,5 Mo)
+#   SPLIT.TXT CR sur le dernier octet de chaque lecture de 2048 o, lignes de 2047 o
+#   MIX.TXT   LF, lignes vides, lignes de 200 à 3000 o, sans '\n' final
+#   EMPTY.TXT, ONE.TXT, NL.TXT (que des '\n'), CRLF.TXT
+import os, random, sys, zlib
+out = sys.argv[1]
+os.makedirs(out, exist_ok=True)
+rnd = random.Random(3)
+def put(name, data):
+    for n, d in ((name, data), (name + '.GZ', None)):
+        if d is None:
+            c = zlib.compressobj(9, zlib.DEFLATED, 16 + 13)
+            d = c.compress(data) + c.flush()
+        with open(os.path.join(out, n), 'wb') as f: f.write(d)
+
+put('LOG.TXT', b''.join(b'2026-10-19 %02d:%02d:%02d capteur=%d temperature=%.1f humidite=%d etat=%s\r\n'
+                        % (i // 3600 % 24, i // 60 % 60, i % 60, i % 5, 18 + (i * 13 % 100) / 10, 30 + i % 50,
+                           b'ok' if i % 17 else b'alerte') for i in range(30000)))
+
+split = bytearray()
+while len(split) < 40000:
+    split += b'a' * (2048 - 1 - len(split) % 2048) + b'\r\n'
+    split += b'b' * 2047 + b'\n'
+    split += b'c' * rnd.randrange(1, 300) + b'\r\n'
+put('SPLIT.TXT', bytes(split))
+
+mix = bytearray()
+for i in range(300):
+    k = rnd.randrange(6)
+    if k == 0: mix += b'\n'
+    elif k == 1: mix += bytes(rnd.randrange(97, 123) for _ in range(rnd.randrange(200, 3000))) + b'\n'
+    else: mix += b'ligne %d %s\n' % (i, b'x' * rnd.randrange(0, 80))
+mix += b'fin sans retour'
+put('MIX.TXT', bytes(mix))
+put('EMPTY.TXT', b'')
+put('ONE.TXT', b'une seule ligne')
+put('NL.TXT', b'\n' * 5000)
+put('CRLF.TXT', b'a\r\n\r\nb\rc\r\n')
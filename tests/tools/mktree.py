@@ -0,0 +1,75 @@
+import struct,sys,os
+# Image FAT32 avec une arborescence d'animation: /KEEP.TXT, /OLDANIM/FR_nnn.RAW
+# (161 trames) et /OLDANIM/SUB/S0..S4.BIN. Fichier creux.
+# RES: secteurs réservés (32), SPC: secteurs par cluster (64), NCL: clusters (4000), FRAME: taille d'une trame,
+# FRAG=1: une trame sur deux fragmentée, FILL=1: trames remplies de leur numéro
+SEC=512; RES=int(os.environ.get("RES","32")); NFAT=2; SPC=int(os.environ.get("SPC","64")); FRAME=int(os.environ.get("FRAME","115204"))
+FRAG=os.environ.get("FRAG","0")=="1"
+NCL=int(os.environ.get("NCL","4000"))
+SPF=(NCL+2+127)//128
+TOT=RES+NFAT*SPF+NCL*SPC
+f=open(sys.argv[1],'wb'); f.truncate(TOT*SEC)
+def w(off,data): f.seek(off); f.write(data)
+bs=bytearray(512); bs[0:3]=b'\xEB\x58\x90'; bs[3:11]=b'MSWIN4.1'
+struct.pack_into('<HBHBHHBHHHII',bs,11,SEC,SPC,RES,NFAT,0,0,0xF8,0,32,64,0,TOT)
+struct.pack_into('<IHHIHH',bs,36,SPF,0,0,2,1,6)
+bs[82:90]=b'FAT32   '; bs[510:512]=b'\x55\xAA'; w(0,bs)
+FATB=RES*SEC; DATA=(RES+NFAT*SPF)*SEC; CB=SPC*SEC
+fat={0:0x0FFFFFF8,1:0x0FFFFFFF,2:0x0FFFFFFF}
+def cl(c): return DATA+(c-2)*CB
+def ent(name,ext,attr,clus,size):
+    e=bytearray(32); e[0:8]=name.ljust(8).encode(); e[8:11]=ext.ljust(3).encode(); e[11]=attr
+    struct.pack_into('<H',e,20,clus>>16); struct.pack_into('<H',e,26,clus&0xFFFF); struct.pack_into('<I',e,28,size); return e
+nextc=[3]
+def alloc(n, stride=1):
+    cs=[]
+    for i in range(n):
+        cs.append(nextc[0]); nextc[0]+=stride
+    for i,c in enumerate(cs): fat[c]= cs[i+1] if i<n-1 else 0x0FFFFFFF
+    return cs[0]
+def mkdir(parent, entries):
+    # entries: list of 32-byte entries; allocate enough clusters
+    per=CB//32
+    n=max(1,(len(entries)+2+per-1)//per)
+    c=alloc(n); 
+    data=bytearray(); data+=ent('.','',0x10,c,0); data+=ent('..','',0x10,parent if parent!=2 else 0,0)
+    for e in entries: data+=e
+    # write across chain
+    cc=c; off=0
+    while off < len(data):
+        w(cl(cc), data[off:off+CB]); off+=CB; cc=fat[cc]
+    return c
+root=[ent('PICO_SD','',0x08,0,0)]
+keep=alloc((1500+CB-1)//CB); w(cl(keep), b'k'*1500); root.append(ent('KEEP','TXT',0x20,keep,1500))
+sub_entries=[]
+for i in range(5):
+    n=(3000+CB-1)//CB; c=alloc(n); sub_entries.append(ent('S%d'%i,'BIN',0x20,c,3000))
+frames=[]
+for i in range(161):
+    n=(FRAME+CB-1)//CB
+    c=alloc(n, 2 if (FRAG and i%2==0) else 1)
+    frames.append(ent('FR_%03d'%i,'RAW',0x20,c,FRAME))
+    if os.environ.get("FILL")=="1":
+        cc=c
+        while cc < 0x0FFFFFF8:
+            w(cl(cc), bytes([i & 0xFF])*CB); cc=fat[cc]
+    if FRAG and i%2==0: nextc[0]-=1
+anim_c=[None]
+# the subdir needs the anim cluster as parent: allocate anim dir first
+per=CB//32; nanim=max(1,(len(frames)+3+2+per-1)//per)
+anim=alloc(nanim)
+sub=mkdir(anim, sub_entries)
+ad=bytearray(); ad+=ent('.','',0x10,anim,0); ad+=ent('..','',0x10,0,0)
+for e in frames: ad+=e
+ad+=ent('SUB','',0x10,sub,0)
+cc=anim; off=0
+while off < len(ad):
+    w(cl(cc), ad[off:off+CB]); off+=CB; cc=fat[cc]
+root.append(ent('OLDANIM','',0x10,anim,0))
+w(cl(2), b''.join(root))
+if nextc[0] > NCL+2: sys.exit('NCL=%d trop petit: %d clusters nécessaires' % (NCL, nextc[0]-2))
+fb=bytearray(SPF*SEC)
+for k,v in fat.items(): struct.pack_into('<I',fb,4*k,v)
+w(FATB,fb); w(FATB+SPF*SEC,fb)
+f.close()
+print("clusters used", nextc[0]-3+1, "SPF", SPF)